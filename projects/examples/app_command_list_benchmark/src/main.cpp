@@ -0,0 +1,216 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <scm/core/utilities/boost_warning_disable.h>
+#include <boost/assign/list_of.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <scm/core/utilities/boost_warning_enable.h>
+
+#include <scm/core.h>
+#include <scm/log.h>
+#include <scm/core/math.h>
+#include <scm/core/time/accum_timer.h>
+#include <scm/core/time/high_res_timer.h>
+
+#include <scm/gl_core.h>
+#include <scm/gl_core/window_management/context.h>
+#include <scm/gl_core/window_management/display.h>
+#include <scm/gl_core/window_management/window.h>
+
+namespace {
+
+typedef scm::time::accum_timer<scm::time::high_res_timer>  timer_type;
+typedef scm::gl::uniform_handle<scm::math::vec2f>          vec2f_handle;
+typedef scm::gl::uniform_handle<scm::math::vec4f>          vec4f_handle;
+
+const int           grid_size       = 96;
+const int           thread_count    = 4;
+const int           frame_count     = 50;
+
+const std::string   vs_source =
+    "#version 330 core\n"
+    "layout(location = 0) in vec2 in_position;\n"
+    "uniform vec2 cell_offset;\n"
+    "uniform float cell_size;\n"
+    "void main() {\n"
+    "    vec2 p      = in_position * cell_size + cell_offset;\n"
+    "    gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);\n"
+    "}\n";
+const std::string   fs_source =
+    "#version 330 core\n"
+    "uniform vec4 cell_color;\n"
+    "layout(location = 0) out vec4 out_color;\n"
+    "void main() {\n"
+    "    out_color = cell_color;\n"
+    "}\n";
+
+struct benchmark_setup
+{
+    scm::gl::program_ptr        _program;
+    scm::gl::vertex_array_ptr   _vertex_array;
+    vec2f_handle                _cell_offset;
+    vec4f_handle                _cell_color;
+}; // struct benchmark_setup
+
+// one quad per cell with its own offset and color, every draw needs a uniform update
+void
+record_rows(const benchmark_setup& setup, scm::gl::command_list& commands, int first_row, int end_row)
+{
+    using namespace scm::math;
+
+    const float cell = 1.0f / grid_size;
+
+    commands.bind_program(setup._program);
+    commands.bind_vertex_array(setup._vertex_array);
+
+    for (int y = first_row; y < end_row; ++y) {
+        for (int x = 0; x < grid_size; ++x) {
+            commands.uniform(setup._cell_offset, vec2f(x * cell, y * cell));
+            commands.uniform(setup._cell_color,  vec4f(x * cell, y * cell, 0.5f, 1.0f));
+            commands.apply();
+            commands.draw_arrays(scm::gl::PRIMITIVE_TRIANGLE_STRIP, 0, 4);
+        }
+    }
+}
+
+void
+record_direct(const scm::gl::render_context_ptr& context, const benchmark_setup& setup)
+{
+    using namespace scm::math;
+
+    const float cell = 1.0f / grid_size;
+
+    context->bind_program(setup._program);
+    context->bind_vertex_array(setup._vertex_array);
+
+    for (int y = 0; y < grid_size; ++y) {
+        for (int x = 0; x < grid_size; ++x) {
+            setup._cell_offset.value(vec2f(x * cell, y * cell));
+            setup._cell_color.value(vec4f(x * cell, y * cell, 0.5f, 1.0f));
+            context->apply();
+            context->draw_arrays(scm::gl::PRIMITIVE_TRIANGLE_STRIP, 0, 4);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    scm::shared_ptr<scm::core>      scm_core(new scm::core(argc, argv));
+
+    using namespace scm;
+    using namespace scm::gl;
+    using namespace scm::math;
+    using boost::assign::list_of;
+
+    wm::display_ptr         display;
+    wm::window_ptr          window;
+    wm::context_ptr         window_context;
+    render_device_ptr       device;
+    render_context_ptr      context;
+
+    try {
+        display.reset(new wm::display(""));
+        window.reset(new wm::window(display, "scm::gl command list benchmark", vec2i(0, 0), vec2ui(512, 512),
+                                    wm::surface::format_desc(FORMAT_RGBA_8, FORMAT_D24_S8, true)));
+        window_context.reset(new wm::context(window, wm::context::attribute_desc(4, 3)));
+        window_context->make_current(window);
+        window->show();
+
+        device.reset(new render_device());
+        context = device->main_context();
+    }
+    catch (std::exception& e) {
+        err() << log::error << "unable to initialize rendering device and main context ("
+              << "evoking error: " << e.what() << ")." << log::end;
+        return -1;
+    }
+
+    benchmark_setup setup;
+
+    setup._program = device->create_program(list_of(device->create_shader(STAGE_VERTEX_SHADER,   vs_source, "command_list.glslv"))
+                                                   (device->create_shader(STAGE_FRAGMENT_SHADER, fs_source, "command_list.glslf")),
+                                            "command_list");
+    if (!setup._program) {
+        err() << log::error << "unable to create benchmark program." << log::end;
+        return -1;
+    }
+    setup._program->uniform("cell_size", 1.0f / grid_size);
+    setup._cell_offset = setup._program->resolve_uniform<vec2f>("cell_offset");
+    setup._cell_color  = setup._program->resolve_uniform<vec4f>("cell_color");
+
+    const vec2f         positions[] = { vec2f(0.0f, 0.0f), vec2f(1.0f, 0.0f), vec2f(0.0f, 1.0f), vec2f(1.0f, 1.0f) };
+    buffer_ptr          vertex_buffer = device->create_buffer(BIND_VERTEX_BUFFER, USAGE_STATIC_DRAW, sizeof(positions), positions);
+    setup._vertex_array = device->create_vertex_array(vertex_format(0, 0, TYPE_VEC2F, sizeof(vec2f)),
+                                                      list_of(vertex_buffer));
+
+    if (!setup._cell_offset.valid() || !setup._cell_color.valid() || !setup._vertex_array) {
+        err() << log::error << "unable to create benchmark resources." << log::end;
+        return -1;
+    }
+
+    std::vector<command_list_ptr>   command_lists;
+    for (int t = 0; t < thread_count; ++t) {
+        command_lists.push_back(make_shared<command_list>());
+    }
+
+    timer_type  direct_timer;
+    timer_type  record_timer;
+    timer_type  replay_timer;
+
+    for (int f = 0; f < frame_count; ++f) {
+        context->clear_default_color_buffer();
+
+        direct_timer.start();
+        record_direct(context, setup);
+        direct_timer.stop();
+
+        // every thread records a band of rows into its own list
+        record_timer.start();
+        boost::thread_group recorders;
+        for (int t = 0; t < thread_count; ++t) {
+            command_lists[t]->clear();
+            recorders.create_thread(boost::bind(&record_rows, boost::cref(setup), boost::ref(*command_lists[t]),
+                                                (t * grid_size) / thread_count, ((t + 1) * grid_size) / thread_count));
+        }
+        recorders.join_all();
+        record_timer.stop();
+
+        replay_timer.start();
+        for (int t = 0; t < thread_count; ++t) {
+            context->execute(*command_lists[t]);
+        }
+        replay_timer.stop();
+
+        window->swap_buffers();
+    }
+    context->sync();
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "draws per frame:                  " << grid_size * grid_size << std::endl
+              << "recording threads:                " << thread_count << std::endl
+              << "direct submission:                "
+              << scm::time::to_milliseconds(direct_timer.accumulated_duration()) / frame_count << " ms/frame" << std::endl
+              << "parallel recording:               "
+              << scm::time::to_milliseconds(record_timer.accumulated_duration()) / frame_count << " ms/frame" << std::endl
+              << "replay:                           "
+              << scm::time::to_milliseconds(replay_timer.accumulated_duration()) / frame_count << " ms/frame" << std::endl;
+
+    const bool  no_errors = context->state().ok();
+    if (!no_errors) {
+        err() << log::error << "render context error state: " << context->state().state_string() << log::end;
+    }
+
+    context->reset();
+
+    return no_errors ? 0 : -1;
+}
@@ -0,0 +1,202 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <scm/core/utilities/boost_warning_disable.h>
+#include <boost/assign/list_of.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <scm/core/utilities/boost_warning_enable.h>
+
+#include <scm/core.h>
+#include <scm/log.h>
+#include <scm/core/math.h>
+#include <scm/core/time/accum_timer.h>
+#include <scm/core/time/high_res_timer.h>
+
+#include <scm/gl_core.h>
+#include <scm/gl_core/window_management/context.h>
+#include <scm/gl_core/window_management/display.h>
+#include <scm/gl_core/window_management/window.h>
+
+namespace {
+
+typedef scm::time::accum_timer<scm::time::high_res_timer>  timer_type;
+
+const unsigned      grid_size   = 128;
+const unsigned      draw_count  = grid_size * grid_size;
+const int           frame_count = 50;
+
+// every quad is moved to its grid cell by gl_InstanceID, the per draw quads in the vertex
+// buffer are already placed in their cells and drawn as instance 0
+const std::string   vs_source =
+    "#version 420 core\n"
+    "layout(location = 0) in vec2 in_position;\n"
+    "uniform int grid_size;\n"
+    "void main() {\n"
+    "    vec2 cell   = vec2(gl_InstanceID % grid_size, gl_InstanceID / grid_size);\n"
+    "    vec2 p      = (in_position + cell) / float(grid_size);\n"
+    "    gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);\n"
+    "}\n";
+const std::string   fs_source =
+    "#version 420 core\n"
+    "layout(location = 0) out vec4 out_color;\n"
+    "void main() {\n"
+    "    out_color = vec4(1.0, 0.5, 0.0, 1.0);\n"
+    "}\n";
+
+void
+submit_draw_elements_loop(const scm::gl::render_context_ptr& context)
+{
+    for (unsigned d = 0; d < draw_count; ++d) {
+        context->draw_elements(6, 0, static_cast<int>(4 * d));
+    }
+}
+
+void
+submit_draw_elements_instanced(const scm::gl::render_context_ptr& context)
+{
+    context->draw_elements_instanced(6, static_cast<int>(draw_count));
+}
+
+void
+submit_multi_draw_elements_indirect(const scm::gl::render_context_ptr& context)
+{
+    context->multi_draw_elements_indirect(static_cast<int>(draw_count));
+}
+
+// returns the submitted draws per second including the time the gpu needs to finish them
+double
+draws_per_second(const scm::gl::render_context_ptr&                      context,
+                 const boost::function<void (const scm::gl::render_context_ptr&)>& submit,
+                 const unsigned                                           draws_per_frame)
+{
+    timer_type  timer;
+
+    submit(context); // warm up, driver side validation of the first call
+    context->sync();
+
+    timer.start();
+    for (int f = 0; f < frame_count; ++f) {
+        submit(context);
+    }
+    context->sync();
+    timer.stop();
+
+    return (static_cast<double>(draws_per_frame) * frame_count)
+         / scm::time::to_seconds(timer.accumulated_duration());
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    scm::shared_ptr<scm::core>      scm_core(new scm::core(argc, argv));
+
+    using namespace scm;
+    using namespace scm::gl;
+    using namespace scm::math;
+    using boost::assign::list_of;
+
+    wm::display_ptr         display;
+    wm::window_ptr          window;
+    wm::context_ptr         window_context;
+    render_device_ptr       device;
+    render_context_ptr      context;
+
+    try {
+        display.reset(new wm::display(""));
+        window.reset(new wm::window(display, "scm::gl draw submission benchmark", vec2i(0, 0), vec2ui(512, 512),
+                                    wm::surface::format_desc(FORMAT_RGBA_8, FORMAT_D24_S8, true)));
+        window_context.reset(new wm::context(window, wm::context::attribute_desc(4, 3)));
+        window_context->make_current(window);
+        window->show();
+
+        device.reset(new render_device());
+        context = device->main_context();
+    }
+    catch (std::exception& e) {
+        err() << log::error << "unable to initialize rendering device and main context ("
+              << "evoking error: " << e.what() << ")." << log::end;
+        return -1;
+    }
+
+    program_ptr prog = device->create_program(list_of(device->create_shader(STAGE_VERTEX_SHADER,   vs_source, "draw_submission.glslv"))
+                                                     (device->create_shader(STAGE_FRAGMENT_SHADER, fs_source, "draw_submission.glslf")),
+                                              "draw_submission");
+    if (!prog) {
+        err() << log::error << "unable to create benchmark program." << log::end;
+        return -1;
+    }
+    prog->uniform("grid_size", static_cast<int>(grid_size));
+
+    // one quad per grid cell, 0.8 of the cell size
+    std::vector<vec2f>      positions;
+    positions.reserve(4 * draw_count);
+    for (unsigned d = 0; d < draw_count; ++d) {
+        const vec2f cell(static_cast<float>(d % grid_size), static_cast<float>(d / grid_size));
+        positions.push_back(cell + vec2f(0.1f, 0.1f));
+        positions.push_back(cell + vec2f(0.9f, 0.1f));
+        positions.push_back(cell + vec2f(0.9f, 0.9f));
+        positions.push_back(cell + vec2f(0.1f, 0.9f));
+    }
+    const unsigned          indices[] = { 0, 1, 2, 0, 2, 3 };
+
+    std::vector<render_context::draw_elements_indirect_command> commands(draw_count);
+    for (unsigned d = 0; d < draw_count; ++d) {
+        commands[d]._count          = 6;
+        commands[d]._instance_count = 1;
+        commands[d]._first_index    = 0;
+        commands[d]._base_vertex    = static_cast<int>(4 * d);
+        commands[d]._base_instance  = 0;
+    }
+
+    buffer_ptr      vertex_buffer   = device->create_buffer(BIND_VERTEX_BUFFER, USAGE_STATIC_DRAW,
+                                                            positions.size() * sizeof(vec2f), &positions.front());
+    buffer_ptr      index_buffer    = device->create_buffer(BIND_INDEX_BUFFER, USAGE_STATIC_DRAW,
+                                                            sizeof(indices), indices);
+    buffer_ptr      indirect_buffer = device->create_buffer(BIND_DRAW_INDIRECT_BUFFER, USAGE_STATIC_DRAW,
+                                                            commands.size() * sizeof(render_context::draw_elements_indirect_command),
+                                                            &commands.front());
+    vertex_array_ptr vertex_array   = device->create_vertex_array(vertex_format(0, 0, TYPE_VEC2F, sizeof(vec2f)),
+                                                                  list_of(vertex_buffer));
+
+    if (!vertex_buffer || !index_buffer || !indirect_buffer || !vertex_array) {
+        err() << log::error << "unable to create benchmark geometry." << log::end;
+        return -1;
+    }
+
+    context->bind_program(prog);
+    context->bind_vertex_array(vertex_array);
+    context->bind_index_buffer(index_buffer, PRIMITIVE_TRIANGLE_LIST, TYPE_UINT);
+    context->bind_draw_indirect_buffer(indirect_buffer);
+    context->apply();
+
+    std::cout << std::fixed << std::setprecision(0)
+              << "draws per frame:                  " << draw_count << std::endl
+              << "frames per case:                  " << frame_count << std::endl;
+
+    std::cout << "draw_elements loop:               "
+              << draws_per_second(context, &submit_draw_elements_loop, draw_count) << " draws/s" << std::endl;
+    std::cout << "draw_elements_instanced:          "
+              << draws_per_second(context, &submit_draw_elements_instanced, draw_count) << " instances/s" << std::endl;
+    std::cout << "multi_draw_elements_indirect:     "
+              << draws_per_second(context, &submit_multi_draw_elements_indirect, draw_count) << " draws/s" << std::endl;
+
+    window->swap_buffers();
+
+    const bool  no_errors = context->state().ok();
+    if (!no_errors) {
+        err() << log::error << "render context error state: " << context->state().state_string() << log::end;
+    }
+
+    context->reset();
+
+    return no_errors ? 0 : -1;
+}
@@ -3,10 +3,15 @@
 // Distributed under the Modified BSD License, see license.txt.
 
 #include <algorithm>
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <vector>
 
+#include <scm/core/utilities/boost_warning_disable.h>
+#include <boost/program_options.hpp>
+#include <scm/core/utilities/boost_warning_enable.h>
+
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/uniform_int.hpp>
 #include <boost/random/variate_generator.hpp>
@@ -15,47 +20,57 @@
 #include <scm/log.h>
 #include <scm/core/pointer_types.h>
 #include <scm/core/io/file.h>
+#include <scm/core/platform/platform.h>
 #include <scm/core/time/accum_timer.h>
 #include <scm/core/time/high_res_timer.h>
 
+namespace {
 
-int main(int argc, char **argv)
-{
-    // the usual
-    std::ios_base::sync_with_stdio(false);
-    scm::shared_ptr<scm::core>      scm_core(new scm::core(argc, argv));
-
-    typedef scm::time::accum_timer<scm::time::high_res_timer>  timer_type;
-
-    // what we now try is to generate a very large file
-    //  - check if it is written correctly by reading it back!
-    //  - check if it memory runs full if we use the system cache
-    //  - check what difference it makes not using the file cache
-    //  - check if regular flush operations change the cache fillup
+typedef scm::time::accum_timer<scm::time::high_res_timer>  timer_type;
 
+struct pass_result
+{
+    pass_result() : _unbuffered(false), _write_speed(0.0), _read_speed(0.0), _errors(0) {}
+
+    bool            _unbuffered;  // access mode actually used by the file
+    double          _write_speed; // MiB/s
+    double          _read_speed;  // MiB/s
+    scm::size_t     _errors;
+};
+
+// write the file in (random) blocks, read it back sequentially and compare blocks
+bool
+run_pass(const std::string&          file_name,
+         bool                        disable_system_cache,
+         scm::io::file::size_type    block_size,
+         scm::io::file::size_type    file_size,
+         bool                        random_write,
+         pass_result&                result)
+{
     using namespace scm;
     using namespace scm::io;
 
-    std::string         out_file_name  = "e:/data/large_file_test_out_00.data";
+    std::cout << "---- pass: " << (disable_system_cache ? "unbuffered (async direct I/O) requested" : "system buffered") << std::endl;
+
     shared_ptr<file>    out_file       = make_shared<file>();
 
-    std::cout << "opening output file: " << out_file_name << std::endl;
-    if (!out_file->open(out_file_name,
+    std::cout << "opening output file: " << file_name << std::endl;
+    if (!out_file->open(file_name,
                         std::ios_base::out | std::ios_base::trunc,
-                        true /*disable system cache*/,
+                        disable_system_cache,
                         512 * 1024)) {
-        std::cerr << "unable to open ouput file: " << out_file_name << std::endl;
-        return -1;
+        std::cerr << "unable to open ouput file: " << file_name << std::endl;
+        return false;
     }
 
-    // the important constants ////////////////////////////////////////////////////////////////////
-    file::size_type     out_block_size   = out_file->vss_align_ceil(512ll * 1024);    // KiB
-    file::size_type     out_file_size    = 40ll * 1024 * 1024 * 1024;                 // GiB
-    bool                out_random_write = true;
+    result._unbuffered = out_file->system_cache_disabled();
+    std::cout << "access mode:      " << (result._unbuffered ? "unbuffered (async direct I/O)" : "system buffered") << std::endl;
+
+    file::size_type     out_block_size   = out_file->vss_align_ceil(block_size);
 
     std::cout << "out_block_size:   " << out_block_size << std::endl
-              << "out_file_size:    " << out_file_size  << std::endl
-              << "out_random_write: " << (out_random_write ? "true" : "false") << std::endl;
+              << "out_file_size:    " << file_size  << std::endl
+              << "out_random_write: " << (random_write ? "true" : "false") << std::endl;
 
     shared_array<char>  out_buffer(new char[out_block_size]);
 
@@ -69,15 +84,15 @@ int main(int argc, char **argv)
     }
 
     // writing file ///////////////////////////////////////////////////////////////////////////////
-    file::size_type     out_block_count = out_file_size / out_block_size;
-    std::vector<file::size_type> out_positions;
-    out_positions.reserve(out_block_count);
+    file::size_type     out_block_count = file_size / out_block_size;
+    file::size_type     progress_step   = std::max<file::size_type>(1, out_block_count / 100);
+    std::vector<file::size_type> out_positions(out_block_count);
 
     for (file::size_type out_pos = 0; out_pos < out_block_count; ++out_pos) {
         out_positions[out_pos] = out_pos * out_block_size;
     }
 
-    if (out_random_write) {
+    if (random_write) {
         std::random_shuffle(out_positions.begin(), out_positions.end());
     }
 
@@ -86,15 +101,14 @@ int main(int argc, char **argv)
     write_timer.start();
     for (file::size_type out_pos = 0; out_pos < out_block_count; ++out_pos) {
         if (out_file->write(out_buffer.get(), out_positions[out_pos], out_block_size) != out_block_size) {
-            std::cerr << "error writing to file at position: " << out_pos * out_block_size << std::endl;
+            std::cerr << "error writing to file at position: " << out_positions[out_pos] << std::endl;
         }
-        if (out_pos % (out_block_count / 100) == 0) {
-            //write_timer.stop();
-            //write_timer.start();
+        if (out_pos % progress_step == 0) {
             std::cout << "writing file: " << std::fixed << 100.0 * (static_cast<double>(out_pos) / out_block_count) << "%";
             std::cout << "\xd";
         }
     }
+    out_file->flush_buffers();
     write_timer.stop();
     std::cout << "end writing file." << std::endl;
 
@@ -102,44 +116,128 @@ int main(int argc, char **argv)
 
     double  write_time = time::to_seconds(write_timer.accumulated_duration());
 
-    std::cout << "write time: " << std::fixed << std::setprecision(3) << write_time << "s, "
-              << "write speed: " << (static_cast<double>(out_file_size) / (1024 * 1024)) / write_time << "MiB/s" << std::endl;
+    result._write_speed = (static_cast<double>(out_block_count * out_block_size) / (1024 * 1024)) / write_time;
 
+    std::cout << "write time: " << std::fixed << std::setprecision(3) << write_time << "s, "
+              << "write speed: " << result._write_speed << "MiB/s" << std::endl;
 
     // read back file and compare blocks //////////////////////////////////////////////////////////
     shared_ptr<file>    in_file       = make_shared<file>();
 
-    std::cout << "opening input file: " << out_file_name << std::endl;
-    if (!in_file->open(out_file_name,
+    std::cout << "opening input file: " << file_name << std::endl;
+    if (!in_file->open(file_name,
                        std::ios_base::in,
-                       true /*disable system cache*/,
+                       disable_system_cache,
                        512 * 1024)) {
-        std::cerr << "unable to open input file: " << out_file_name << std::endl;
-        return -1;
+        std::cerr << "unable to open input file: " << file_name << std::endl;
+        return false;
     }
 
     shared_array<char>  in_buffer(new char[out_block_size]);
 
+    timer_type          read_timer;
     std::cout << "starting to reading file..." << std::endl;
     for (file::size_type in_pos = 0; in_pos < out_block_count; ++in_pos) {
+        read_timer.start();
         if (in_file->read(in_buffer.get(), in_pos * out_block_size, out_block_size) != out_block_size) {
             std::cerr << "error reading to file at position: " << in_pos * out_block_size << std::endl;
         }
-        if (in_pos % (out_block_count / 100) == 0) {
-            //write_timer.stop();
-            //write_timer.start();
+        read_timer.stop();
+        if (in_pos % progress_step == 0) {
             std::cout << "reading file: " << std::fixed << 100.0 * (static_cast<double>(in_pos) / out_block_count) << "%";
             std::cout << "\xd";
         }
-        for (file::size_type i = 0; i < out_block_size; ++i) {
-            if (in_buffer[i] != out_buffer[i]) {
-                std::cerr << "found error at file position: " << in_pos * out_block_size << std::endl;
-            }
+        if (memcmp(in_buffer.get(), out_buffer.get(), static_cast<size_t>(out_block_size)) != 0) {
+            std::cerr << "found error at file position: " << in_pos * out_block_size << std::endl;
+            ++result._errors;
         }
     }
     std::cout << "end reading file." << std::endl;
 
-    out_file->close();
+    in_file->close();
+
+    double  read_time = time::to_seconds(read_timer.accumulated_duration());
+
+    result._read_speed = (static_cast<double>(out_block_count * out_block_size) / (1024 * 1024)) / read_time;
+
+    std::cout << "read time: " << std::fixed << std::setprecision(3) << read_time << "s, "
+              << "read speed: " << result._read_speed << "MiB/s" << std::endl;
+
+    return true;
+}
+
+std::string     out_file_name;
+
+} // namespace
+
+static const std::string    scm_application_name = "schism example: large file i/o";
+
+static bool initialize_cmd_line(scm::core& c)
+{
+    using boost::program_options::options_description;
+    using boost::program_options::value;
+
+    options_description  cmd_options("program options");
+
+    // the test file is written to the working directory by default, /tmp often is a tmpfs
+    // which does not support unbuffered access
+    cmd_options.add_options()
+        ("?",                                                                                           "show this help message")
+        ("file,f",  value<std::string>(&out_file_name)->default_value("large_file_test_out_00.data"),   "test file path");
+
+    c.add_command_line_options(cmd_options, scm_application_name);
+    c.command_line_positions().add("file", 1); // max occurances 1
+
+    return true;
+}
+
+static void init_module()
+{
+    scm::module::initializer::add_pre_core_init_function(initialize_cmd_line);
+}
+
+static scm::module::static_initializer  static_initialize(init_module);
+
+int main(int argc, char **argv)
+{
+    // the usual
+    std::ios_base::sync_with_stdio(false);
+    scm::shared_ptr<scm::core>      scm_core(new scm::core(argc, argv));
+
+    // what we now try is to generate a very large file
+    //  - check if it is written correctly by reading it back!
+    //  - check if it memory runs full if we use the system cache
+    //  - check what difference it makes not using the file cache
+    //  - check if regular flush operations change the cache fillup
+
+    using namespace scm;
+    using namespace scm::io;
+
+    std::cout << "test file: " << out_file_name << std::endl;
+
+    // the important constants ////////////////////////////////////////////////////////////////////
+    file::size_type     out_block_size   = 512ll * 1024;                              // KiB
+    file::size_type     out_file_size    = 40ll * 1024 * 1024 * 1024;                 // GiB
+    bool                out_random_write = true;
+
+    pass_result         buffered_result;
+    pass_result         unbuffered_result;
+
+    if (   !run_pass(out_file_name, false, out_block_size, out_file_size, out_random_write, buffered_result)
+        || !run_pass(out_file_name, true,  out_block_size, out_file_size, out_random_write, unbuffered_result)) {
+        return -1;
+    }
+
+    std::cout << "---- summary" << std::endl
+              << std::fixed << std::setprecision(3)
+              << "system buffered: write " << buffered_result._write_speed   << "MiB/s, "
+              << "read "                   << buffered_result._read_speed    << "MiB/s, "
+              << "errors "                 << buffered_result._errors        << std::endl
+              << "unbuffered:      write " << unbuffered_result._write_speed << "MiB/s, "
+              << "read "                   << unbuffered_result._read_speed  << "MiB/s, "
+              << "errors "                 << unbuffered_result._errors
+              << (unbuffered_result._unbuffered ? "" : " (fell back to system buffered access)") << std::endl;
+
     std::cout << "sick, sad world..." << std::endl;
 
     return 0;
@@ -0,0 +1,122 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/ref.hpp>
+
+#include <scm/core.h>
+#include <scm/log.h>
+#include <scm/core/numeric_types.h>
+#include <scm/core/log/async_dispatcher.h>
+#include <scm/core/log/listener.h>
+#include <scm/core/log/message.h>
+#include <scm/core/time/accum_timer.h>
+#include <scm/core/time/high_res_timer.h>
+
+namespace {
+
+typedef scm::time::accum_timer<scm::time::high_res_timer>  timer_type;
+
+// only counts the messages, so the numbers show the cost of formatting and dispatch
+class counting_listener : public scm::log::listener
+{
+public:
+    counting_listener() : _count(0), _bytes(0) {}
+    virtual ~counting_listener() {}
+
+    virtual void notify(const scm::log::message& msg) {
+        ++_count;
+        _bytes += msg.raw_message().size();
+    }
+
+    scm::size_t     _count;
+    scm::size_t     _bytes;
+}; // class counting_listener
+
+const int           message_count = 1000000;
+
+void
+log_debug_stream(scm::log::logger& l)
+{
+    for (int i = 0; i < message_count; ++i) {
+        l.debug() << "frame " << i << " took " << 16.6f << "ms (" << std::hex << i << ")";
+    }
+}
+
+void
+log_debug_statement(scm::log::logger& l)
+{
+    for (int i = 0; i < message_count; ++i) {
+        SCM_LOG_DEBUG(l, "frame " << i << " took " << 16.6f << "ms (" << std::hex << i << ")");
+    }
+}
+
+void
+log_output_stream(scm::log::logger& l)
+{
+    for (int i = 0; i < message_count; ++i) {
+        l.output() << "frame " << i << " took " << 16.6f << "ms (" << std::hex << i << ")";
+    }
+}
+
+double
+ns_per_message(const boost::function<void ()>& run)
+{
+    timer_type  timer;
+    timer.start();
+    run();
+    timer.stop();
+
+    return scm::time::to_nanoseconds(timer.accumulated_duration()) / message_count;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    scm::shared_ptr<scm::core>      scm_core(new scm::core(argc, argv));
+
+    using namespace scm;
+
+    log::logger&                    bench_log = scm::logger("bench");
+    shared_ptr<counting_listener>   counter(new counting_listener());
+
+    bench_log.log_level(log::ll_output);
+    bench_log.add_listener(counter);
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "messages per case:        " << message_count << std::endl
+              << "compiled in log levels:   " << log::level(static_cast<log::level_type>(SCM_LOG_MIN_LEVEL)).to_string()
+              << " and more severe" << std::endl;
+
+    std::cout << "filtered, out_stream:     "
+              << ns_per_message(boost::bind(&log_debug_stream, boost::ref(bench_log))) << "ns/message" << std::endl;
+    std::cout << "filtered, SCM_LOG_DEBUG:  "
+              << ns_per_message(boost::bind(&log_debug_statement, boost::ref(bench_log))) << "ns/message" << std::endl;
+
+    std::cout << "unfiltered, synchronous:  "
+              << ns_per_message(boost::bind(&log_output_stream, boost::ref(bench_log))) << "ns/message" << std::endl;
+
+    {
+        log::async_dispatcher&  dispatch = log::core::get().async_dispatch();
+
+        dispatch.start(1 << 16, log::async_dispatcher::overflow_block);
+        std::cout << "unfiltered, asynchronous: "
+                  << ns_per_message(boost::bind(&log_output_stream, boost::ref(bench_log))) << "ns/message" << std::endl;
+        dispatch.stop();
+    }
+
+    const bool all_delivered = counter->_count == scm::size_t(2 * message_count);
+    std::cout << "delivered messages:       " << counter->_count
+              << (all_delivered ? "" : " (UNEXPECTED)") << std::endl;
+
+    bench_log.del_listener(counter);
+
+    return all_delivered ? 0 : -1;
+}
@@ -0,0 +1,156 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <scm/core.h>
+#include <scm/log.h>
+#include <scm/core/math.h>
+#include <scm/core/memory.h>
+#include <scm/core/numeric_types.h>
+#include <scm/core/time/accum_timer.h>
+#include <scm/core/time/high_res_timer.h>
+#include <scm/core/utilities/thread_pool.h>
+
+#include <scm/gl_core/data_formats.h>
+#include <scm/gl_core/texture_objects/texture_image.h>
+
+#include <scm/gl_util/data/imaging/texture_data_util.h>
+
+namespace {
+
+typedef scm::time::accum_timer<scm::time::high_res_timer>  timer_type;
+
+struct test_case
+{
+    scm::math::vec3ui       _dim;
+    scm::gl::data_format    _format;
+    bool                    _benchmark;
+}; // struct test_case
+
+// deterministic noise with some low frequency structure, float data also gets negative values
+void
+fill_source(std::vector<scm::uint8>& data, scm::gl::data_format fmt)
+{
+    using namespace scm;
+
+    uint32 s = 0x12345678u;
+    if (gl::is_float_type(fmt)) {
+        float*const     d = reinterpret_cast<float*>(&data[0]);
+        const size_t    n = data.size() / sizeof(float);
+        for (size_t i = 0; i < n; ++i) {
+            s = s * 1664525u + 1013904223u;
+            d[i] = static_cast<float>(i % 1021) * 0.37f - static_cast<float>(s >> 20) * 0.11f;
+        }
+    }
+    else {
+        for (size_t i = 0; i < data.size(); ++i) {
+            s = s * 1664525u + 1013904223u;
+            data[i] = static_cast<uint8>((i / 7) + (s >> 29));
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::ios_base::sync_with_stdio(false);
+    scm::shared_ptr<scm::core>      scm_core(new scm::core(argc, argv));
+
+    using namespace scm;
+    using namespace scm::gl;
+    using namespace scm::math;
+
+    const test_case cases[] = {
+        { vec3ui( 256,  256,  256), FORMAT_R_8,      true  },
+        { vec3ui( 256,  256,  256), FORMAT_R_16,     true  },
+        { vec3ui( 256,  256,  256), FORMAT_R_32F,    true  },
+        { vec3ui( 128,  128,  128), FORMAT_RGBA_8,   true  },
+        { vec3ui(4096, 4096,    1), FORMAT_RGBA_8,   true  },
+        { vec3ui( 257,  131,   67), FORMAT_R_8,      false },
+        { vec3ui(  99,  255,  129), FORMAT_R_32F,    false },
+        { vec3ui(  65,   33,   17), FORMAT_RG_16,    false },
+        { vec3ui(  67,   31,   13), FORMAT_RGB_32F,  false },
+        { vec3ui(  45,   77,   23), FORMAT_RGBA_32F, false },
+        { vec3ui(   1,   73,    9), FORMAT_RGBA_8,   false },
+        { vec3ui(1023,  511,    1), FORMAT_R_16,     false }
+    };
+    const size_t    case_count = sizeof(cases) / sizeof(test_case);
+
+    thread_pool     threads;
+    bool            all_passed = true;
+
+    std::cout << "worker threads: " << threads.thread_count() << std::endl;
+
+    for (size_t c = 0; c < case_count; ++c) {
+        const test_case&    tc        = cases[c];
+        const size_t        src_size  = static_cast<size_t>(tc._dim.x) * tc._dim.y * tc._dim.z * size_of_format(tc._format);
+        const unsigned      levels    = util::max_mip_levels(tc._dim);
+        const int           runs      = tc._benchmark ? 3 : 1;
+
+        std::vector<uint8>  src_data(src_size);
+        fill_source(src_data, tc._format);
+
+        std::cout << tc._dim << " " << format_string(tc._format) << " (" << levels << " levels)" << std::endl;
+
+        // current single threaded path
+        std::vector<uint8*> ref_levels;
+        timer_type          ref_timer;
+        for (int r = 0; r < runs; ++r) {
+            for (size_t l = 1; l < ref_levels.size(); ++l) {
+                delete [] ref_levels[l];
+            }
+            ref_levels.clear();
+
+            ref_timer.start();
+            util::generate_mipmaps(tc._dim, tc._format, &src_data[0], ref_levels);
+            ref_timer.stop();
+        }
+
+        // parallel path
+        shared_array<uint8> pyramid;
+        std::vector<uint8*> par_levels;
+        timer_type          par_timer;
+        for (int r = 0; r < runs; ++r) {
+            par_levels.clear();
+
+            par_timer.start();
+            util::generate_mipmaps_parallel(tc._dim, tc._format, &src_data[0], pyramid, par_levels, threads);
+            par_timer.stop();
+        }
+
+        size_t mismatches = (ref_levels.size() == par_levels.size()) ? 0 : 1;
+        for (size_t l = 1; l < ref_levels.size() && l < par_levels.size(); ++l) {
+            const vec3ui    ldim  = util::mip_level_dimensions(tc._dim, static_cast<unsigned>(l));
+            const size_t    lsize = static_cast<size_t>(ldim.x) * ldim.y * ldim.z * size_of_format(tc._format);
+            if (std::memcmp(ref_levels[l], par_levels[l], lsize) != 0) {
+                ++mismatches;
+                std::cout << "  level " << l << " differs" << std::endl;
+            }
+        }
+        all_passed = all_passed && (mismatches == 0);
+
+        if (tc._benchmark) {
+            const double ref_ms = time::to_milliseconds(ref_timer.accumulated_duration()) / runs;
+            const double par_ms = time::to_milliseconds(par_timer.accumulated_duration()) / runs;
+            std::cout << std::fixed << std::setprecision(3)
+                      << "  generate_mipmaps:          " << ref_ms << "ms" << std::endl
+                      << "  generate_mipmaps_parallel: " << par_ms << "ms"
+                      << " (speedup " << ref_ms / par_ms << ")" << std::endl;
+        }
+        std::cout << "  " << (mismatches == 0 ? "results identical" : "RESULTS DIFFER") << std::endl;
+
+        for (size_t l = 1; l < ref_levels.size(); ++l) {
+            delete [] ref_levels[l];
+        }
+    }
+
+    std::cout << (all_passed ? "parallel path matches the single threaded path" : "MISMATCHES FOUND") << std::endl;
+
+    return all_passed ? 0 : -1;
+}
@@ -0,0 +1,214 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <boost/bind.hpp>
+
+#include <scm/core.h>
+#include <scm/log.h>
+#include <scm/core/numeric_types.h>
+#include <scm/core/time/accum_timer.h>
+#include <scm/core/time/high_res_timer.h>
+#include <scm/core/utilities/thread_pool.h>
+
+#include <scm/gl_util/data/volume/segy/segy_ibm_float.h>
+
+namespace {
+
+typedef scm::time::accum_timer<scm::time::high_res_timer>  timer_type;
+
+// the original conversion routine of the segy volume reader, used as reference
+scm::uint32
+reference_ibm_to_ieee(scm::uint32 ibm)
+{
+    int fc = static_cast<int>(ibm);
+    int fmant;
+    int t;
+
+    if (fc) {
+        fmant = 0x00ffffff & fc;
+        t = ((0x7f000000 & fc) >> 22) - 130;
+        if (t <= 0) {
+            fc = 0;
+        } else {
+            while (!(fmant & 0x00800000) && t != -1) {
+                --t;
+                fmant <<= 1;
+            }
+            if (t > 254) {
+                fc = (0x80000000 & fc) | 0x7f7fffff;
+            }
+            else if (t <= 0) {
+                fc = 0;
+            }
+            else {
+                fc = (0x80000000 & fc) | (t << 23) | (0x007fffff & fmant);
+            }
+        }
+    }
+    return static_cast<scm::uint32>(fc);
+}
+
+scm::uint32
+swap_word(scm::uint32 v)
+{
+    return (v >> 24) | ((v >> 8) & 0x0000ff00u) | ((v << 8) & 0x00ff0000u) | (v << 24);
+}
+
+const scm::size_t   values_per_block = 1u << 20;
+
+// check all 2^32 bit patterns in blocks of values_per_block values, every other block
+// is converted from big endian source data
+void
+check_blocks(scm::gl::data::ibm_float_kernel kernel,
+             scm::size_t                     block_begin,
+             scm::size_t                     block_end,
+             scm::size_t*                    errors)
+{
+    using namespace scm;
+
+    std::vector<uint32> src(values_per_block);
+    std::vector<float>  dst(values_per_block);
+    size_t              err = 0;
+
+    for (size_t b = block_begin; b < block_end; ++b) {
+        const uint64    base       = static_cast<uint64>(b) * values_per_block;
+        const bool      swap_bytes = (b & 1) != 0;
+
+        for (size_t i = 0; i < values_per_block; ++i) {
+            const uint32 v = static_cast<uint32>(base + i);
+            src[i] = swap_bytes ? swap_word(v) : v;
+        }
+
+        // odd counts exercise the scalar tails of the vector kernels
+        const size_t count = values_per_block - (b % 8);
+        gl::data::convert_ibm_to_ieee(kernel, &dst[0], &src[0], count, swap_bytes);
+
+        for (size_t i = 0; i < count; ++i) {
+            uint32 r;
+            std::memcpy(&r, &dst[i], sizeof(uint32));
+            if (r != reference_ibm_to_ieee(static_cast<uint32>(base + i))) {
+                ++err;
+            }
+        }
+    }
+
+    *errors = err;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::ios_base::sync_with_stdio(false);
+    scm::shared_ptr<scm::core>      scm_core(new scm::core(argc, argv));
+
+    using namespace scm;
+    using namespace scm::gl::data;
+
+    thread_pool         threads;
+    const size_t        block_count = (size_t(1) << 32) / values_per_block;
+    const size_t        value_count = 64 * values_per_block;
+    bool                all_passed  = true;
+
+    std::cout << "selected kernel: " << ibm_float_kernel_name(ibm_float_kernel_selected()) << std::endl
+              << "worker threads:  " << threads.thread_count() << std::endl;
+
+    // correctness against the original routine ///////////////////////////////////////////////////
+    for (int k = IBM_FLOAT_KERNEL_SCALAR; k <= IBM_FLOAT_KERNEL_AVX2; ++k) {
+        const ibm_float_kernel kernel = static_cast<ibm_float_kernel>(k);
+        if (!ibm_float_kernel_supported(kernel)) {
+            std::cout << ibm_float_kernel_name(kernel) << ": not supported by host cpu" << std::endl;
+            continue;
+        }
+
+        const size_t        task_count = threads.thread_count();
+        std::vector<size_t> errors(task_count, 0);
+        for (size_t t = 0; t < task_count; ++t) {
+            threads.submit(boost::bind(&check_blocks, kernel,
+                                       (block_count * t) / task_count,
+                                       (block_count * (t + 1)) / task_count,
+                                       &errors[t]));
+        }
+        threads.wait_idle();
+
+        size_t error_count = 0;
+        for (size_t t = 0; t < task_count; ++t) {
+            error_count += errors[t];
+        }
+        all_passed = all_passed && (error_count == 0);
+
+        std::cout << ibm_float_kernel_name(kernel) << ": "
+                  << "checked all 2^32 values, mismatches " << error_count << std::endl;
+    }
+
+    // throughput /////////////////////////////////////////////////////////////////////////////////
+    std::vector<uint32> src(value_count);
+    std::vector<float>  dst(value_count);
+    for (size_t i = 0; i < value_count; ++i) {
+        src[i] = swap_word(0x42000000u | static_cast<uint32>(i & 0x00ffffffu));
+    }
+
+    const double        data_mib = static_cast<double>(value_count * sizeof(float)) / (1024 * 1024);
+    const int           runs     = 10;
+
+    {
+        timer_type      timer;
+        timer.start();
+        for (int r = 0; r < runs; ++r) {
+            for (size_t i = 0; i < value_count; ++i) {
+                const uint32 v = reference_ibm_to_ieee(swap_word(src[i]));
+                std::memcpy(&dst[i], &v, sizeof(uint32));
+            }
+        }
+        timer.stop();
+        std::cout << std::fixed << std::setprecision(3)
+                  << "original routine: "
+                  << (runs * data_mib) / time::to_seconds(timer.accumulated_duration()) << "MiB/s" << std::endl;
+    }
+
+    for (int k = IBM_FLOAT_KERNEL_SCALAR; k <= IBM_FLOAT_KERNEL_AVX2; ++k) {
+        const ibm_float_kernel kernel = static_cast<ibm_float_kernel>(k);
+        if (!ibm_float_kernel_supported(kernel)) {
+            continue;
+        }
+
+        timer_type      timer;
+        timer.start();
+        for (int r = 0; r < runs; ++r) {
+            convert_ibm_to_ieee(kernel, &dst[0], &src[0], value_count, true);
+        }
+        timer.stop();
+        std::cout << std::fixed << std::setprecision(3)
+                  << ibm_float_kernel_name(kernel) << " kernel: "
+                  << (runs * data_mib) / time::to_seconds(timer.accumulated_duration()) << "MiB/s" << std::endl;
+    }
+
+    {
+        struct convert_range {
+            static void run(const uint32* s, float* d, size_t b, size_t e) {
+                convert_ibm_to_ieee(d + b, s + b, e - b, true);
+            }
+        };
+
+        timer_type      timer;
+        timer.start();
+        for (int r = 0; r < runs; ++r) {
+            threads.parallel_for(value_count, 64 * 1024,
+                                 boost::bind(&convert_range::run, &src[0], &dst[0], _1, _2));
+        }
+        timer.stop();
+        std::cout << std::fixed << std::setprecision(3)
+                  << "parallel " << ibm_float_kernel_name(ibm_float_kernel_selected()) << " kernel: "
+                  << (runs * data_mib) / time::to_seconds(timer.accumulated_duration()) << "MiB/s" << std::endl;
+    }
+
+    std::cout << (all_passed ? "all kernels match the original routine" : "MISMATCHES FOUND") << std::endl;
+
+    return all_passed ? 0 : -1;
+}
@@ -0,0 +1,135 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include <exception>
+#include <iostream>
+
+#include <scm/core.h>
+#include <scm/log.h>
+#include <scm/core/math.h>
+
+#include <scm/gl_core.h>
+#include <scm/gl_core/window_management/context.h>
+#include <scm/gl_core/window_management/display.h>
+#include <scm/gl_core/window_management/window.h>
+
+namespace {
+
+// the frame capacity is rounded to the uniform buffer offset alignment only, it is no multiple
+// of the vertex strides used below
+const scm::size_t   frame_capacity  = 1000;
+const int           frame_count     = 3;
+const int           test_frames     = 2 * frame_count;
+
+const scm::size_t   vertex_strides[] = { 12, 20, 28 };
+const int           stride_count     = sizeof(vertex_strides) / sizeof(vertex_strides[0]);
+
+// allocates vertex data with the vertex stride as alignment behind a uniform block, the offset
+// has to be a whole base vertex and lie in the region of the current frame
+bool
+check_frame(const scm::gl::render_context_ptr&    context,
+            const scm::gl::stream_allocator_ptr&  allocator,
+            int                                   frame)
+{
+    using namespace scm;
+    using namespace scm::gl;
+
+    bool success = true;
+
+    allocator->begin_frame(context);
+
+    const stream_allocation ubo_alloc = allocator->allocate(68);
+    if (!ubo_alloc.valid()) {
+        err() << log::error << "frame " << frame << ": uniform block allocation failed." << log::end;
+        success = false;
+    }
+
+    for (int s = 0; s < stride_count; ++s) {
+        const scm::size_t       stride = vertex_strides[s];
+        const stream_allocation a      = allocator->allocate(5 * stride, stride);
+
+        if (!a.valid()) {
+            err() << log::error << "frame " << frame << ": vertex allocation failed (stride " << stride << ")." << log::end;
+            success = false;
+            continue;
+        }
+
+        const scm::size_t region = (a._offset / allocator->frame_capacity());
+        const scm::size_t data   = reinterpret_cast<scm::size_t>(a._data) - reinterpret_cast<scm::size_t>(ubo_alloc._data);
+
+        if (0 != a._offset % stride) {
+            err() << log::error << "frame " << frame << ": offset " << a._offset
+                  << " is no multiple of the vertex stride " << stride << "." << log::end;
+            success = false;
+        }
+        if (region != static_cast<scm::size_t>(frame % frame_count)) {
+            err() << log::error << "frame " << frame << ": offset " << a._offset
+                  << " outside of the frame region " << frame % frame_count << "." << log::end;
+            success = false;
+        }
+        if (data != a._offset - ubo_alloc._offset) {
+            err() << log::error << "frame " << frame << ": data pointer does not match the offset " << a._offset << "." << log::end;
+            success = false;
+        }
+    }
+
+    allocator->end_frame(context);
+
+    return success;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    scm::shared_ptr<scm::core>      scm_core(new scm::core(argc, argv));
+
+    using namespace scm;
+    using namespace scm::gl;
+    using namespace scm::math;
+
+    wm::display_ptr         display;
+    wm::window_ptr          window;
+    wm::context_ptr         window_context;
+    render_device_ptr       device;
+    render_context_ptr      context;
+
+    try {
+        display.reset(new wm::display(""));
+        window.reset(new wm::window(display, "scm::gl stream allocator test", vec2i(0, 0), vec2ui(256, 256),
+                                    wm::surface::format_desc(FORMAT_RGBA_8, FORMAT_D24_S8, true)));
+        window_context.reset(new wm::context(window, wm::context::attribute_desc(4, 3)));
+        window_context->make_current(window);
+        window->show();
+
+        device.reset(new render_device());
+        context = device->main_context();
+    }
+    catch (std::exception& e) {
+        err() << log::error << "unable to initialize rendering device and main context ("
+              << "evoking error: " << e.what() << ")." << log::end;
+        return -1;
+    }
+
+    stream_allocator_ptr    allocator = device->create_stream_allocator(frame_capacity, frame_count);
+    if (!allocator) {
+        err() << log::error << "unable to create stream allocator." << log::end;
+        return -1;
+    }
+
+    std::cout << "frame capacity: " << allocator->frame_capacity() << "byte, "
+              << "frames: " << allocator->frame_count() << std::endl;
+
+    bool success = true;
+    for (int f = 0; f < test_frames; ++f) {
+        const bool frame_success = check_frame(context, allocator, f);
+        std::cout << "frame " << f << ": " << (frame_success ? "passed" : "failed") << std::endl;
+        success = success && frame_success;
+    }
+
+    allocator.reset();
+    context->reset();
+
+    return success ? 0 : -1;
+}
@@ -0,0 +1,210 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <scm/core/utilities/boost_warning_disable.h>
+#include <boost/assign/list_of.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <scm/core/utilities/boost_warning_enable.h>
+
+#include <scm/core.h>
+#include <scm/log.h>
+#include <scm/core/math.h>
+#include <scm/core/time/accum_timer.h>
+#include <scm/core/time/high_res_timer.h>
+
+#include <scm/gl_core.h>
+#include <scm/gl_core/window_management/context.h>
+#include <scm/gl_core/window_management/display.h>
+#include <scm/gl_core/window_management/window.h>
+
+namespace {
+
+typedef scm::time::accum_timer<scm::time::high_res_timer>  timer_type;
+typedef scm::gl::uniform_handle<scm::math::vec4f>          vec4f_handle;
+
+const int           uniform_count       = 128;
+const int           changed_per_frame   = 4;
+const int           frame_count         = 10000;
+
+std::string
+uniform_name(int i)
+{
+    std::ostringstream  n;
+    n << "u_param_" << i;
+    return n.str();
+}
+
+// all uniforms are used in the fragment shader, the compiler must not remove any of them
+std::string
+fragment_source()
+{
+    std::ostringstream  s;
+    s << "#version 330 core\n";
+    for (int i = 0; i < uniform_count; ++i) {
+        s << "uniform vec4 " << uniform_name(i) << ";\n";
+    }
+    s << "layout(location = 0) out vec4 out_color;\n"
+      << "void main() {\n"
+      << "    vec4 c = vec4(0.0);\n";
+    for (int i = 0; i < uniform_count; ++i) {
+        s << "    c += " << uniform_name(i) << ";\n";
+    }
+    s << "    out_color = c;\n"
+      << "}\n";
+    return s.str();
+}
+
+const std::string   vs_source =
+    "#version 330 core\n"
+    "void main() {\n"
+    "    gl_Position = vec4(0.0, 0.0, 0.0, 1.0);\n"
+    "}\n";
+
+struct benchmark_setup
+{
+    scm::gl::program_ptr        _program;
+    std::vector<std::string>    _names;
+    std::vector<vec4f_handle>   _handles;
+}; // struct benchmark_setup
+
+// the values change every frame, otherwise the uniforms are not flagged for an update
+scm::math::vec4f
+frame_value(int frame, int i)
+{
+    return scm::math::vec4f(static_cast<float>(frame), static_cast<float>(i), 0.0f, 1.0f);
+}
+
+void
+update_all_by_name(const benchmark_setup& setup, int frame)
+{
+    for (int i = 0; i < uniform_count; ++i) {
+        setup._program->uniform(setup._names[i], frame_value(frame, i));
+    }
+}
+
+void
+update_all_by_handle(const benchmark_setup& setup, int frame)
+{
+    for (int i = 0; i < uniform_count; ++i) {
+        setup._handles[i].value(frame_value(frame, i));
+    }
+}
+
+void
+update_few_by_handle(const benchmark_setup& setup, int frame)
+{
+    for (int i = 0; i < changed_per_frame; ++i) {
+        const int u = (frame * changed_per_frame + i) % uniform_count;
+        setup._handles[u].value(frame_value(frame, u));
+    }
+}
+
+// returns the cpu time per frame in microseconds for setting the uniforms and applying the program
+double
+frame_time_us(const scm::gl::render_context_ptr&                          context,
+              const benchmark_setup&                                      setup,
+              const boost::function<void (const benchmark_setup&, int)>&  update)
+{
+    timer_type  timer;
+
+    update(setup, 0); // warm up
+    context->apply();
+    context->sync();
+
+    timer.start();
+    for (int f = 1; f <= frame_count; ++f) {
+        update(setup, f);
+        context->apply();
+    }
+    timer.stop();
+    context->sync();
+
+    return scm::time::to_microseconds(timer.accumulated_duration()) / frame_count;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    scm::shared_ptr<scm::core>      scm_core(new scm::core(argc, argv));
+
+    using namespace scm;
+    using namespace scm::gl;
+    using namespace scm::math;
+    using boost::assign::list_of;
+
+    wm::display_ptr         display;
+    wm::window_ptr          window;
+    wm::context_ptr         window_context;
+    render_device_ptr       device;
+    render_context_ptr      context;
+
+    try {
+        display.reset(new wm::display(""));
+        window.reset(new wm::window(display, "scm::gl uniform update benchmark", vec2i(0, 0), vec2ui(256, 256),
+                                    wm::surface::format_desc(FORMAT_RGBA_8, FORMAT_D24_S8, true)));
+        window_context.reset(new wm::context(window, wm::context::attribute_desc(4, 3)));
+        window_context->make_current(window);
+        window->show();
+
+        device.reset(new render_device());
+        context = device->main_context();
+    }
+    catch (std::exception& e) {
+        err() << log::error << "unable to initialize rendering device and main context ("
+              << "evoking error: " << e.what() << ")." << log::end;
+        return -1;
+    }
+
+    benchmark_setup setup;
+
+    setup._program = device->create_program(list_of(device->create_shader(STAGE_VERTEX_SHADER,   vs_source,         "uniform_update.glslv"))
+                                                   (device->create_shader(STAGE_FRAGMENT_SHADER, fragment_source(), "uniform_update.glslf")),
+                                            "uniform_update");
+    if (!setup._program) {
+        err() << log::error << "unable to create benchmark program." << log::end;
+        return -1;
+    }
+
+    for (int i = 0; i < uniform_count; ++i) {
+        setup._names.push_back(uniform_name(i));
+        setup._handles.push_back(setup._program->resolve_uniform<vec4f>(setup._names.back()));
+        if (!setup._handles.back().valid()) {
+            err() << log::error << "unable to resolve uniform " << setup._names.back() << "." << log::end;
+            return -1;
+        }
+    }
+
+    context->bind_program(setup._program);
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "uniforms in program:              " << uniform_count << std::endl
+              << "frames per case:                  " << frame_count << std::endl;
+
+    std::cout << "all uniforms by name:             "
+              << frame_time_us(context, setup, &update_all_by_name) << " us/frame" << std::endl;
+    std::cout << "all uniforms by handle:           "
+              << frame_time_us(context, setup, &update_all_by_handle) << " us/frame" << std::endl;
+    std::cout << changed_per_frame << " uniforms by handle:             "
+              << frame_time_us(context, setup, &update_few_by_handle) << " us/frame" << std::endl;
+
+    window->swap_buffers();
+
+    const bool  no_errors = context->state().ok();
+    if (!no_errors) {
+        err() << log::error << "render context error state: " << context->state().state_string() << log::end;
+    }
+
+    context->reset();
+
+    return no_errors ? 0 : -1;
+}
@@ -220,7 +220,7 @@ demo_app::load_volume(scm::gl::render_device& in_device, const std::string& in_f
     using namespace scm::math;
     using namespace boost::filesystem;
 
-    scoped_ptr<gl::volume_reader> vol_reader;
+    scoped_ptr<gl::volume_reader_blocked> vol_reader;
     path                    file_path(in_file_name);
     std::string             file_name       = file_path.filename().string();
     std::string             file_extension  = file_path.extension().string();
@@ -255,24 +255,31 @@ demo_app::load_volume(scm::gl::render_device& in_device, const std::string& in_f
         return (texture_3d_ptr());
     }
 
+    if (volume_data_format == FORMAT_NULL) {
+        std::cout << "demo_app::load_volume(): unable to determine volume data format ('" << in_file_name << "')." << std::endl;
+        return (texture_3d_ptr());
+    }
+
     scm::shared_array<unsigned char>    read_buffer;
     scm::size_t                         read_buffer_size =   data_dimensions.x * data_dimensions.y * data_dimensions.z
                                                            * size_of_format(volume_data_format);
 
-    read_buffer.reset(new unsigned char[read_buffer_size]);
+    std::vector<void*> in_data;
 
-    if (!vol_reader->read(data_offset, data_dimensions, read_buffer.get())) {
-        std::cout << "demo_app::load_volume(): unable to read data from file ('" << in_file_name << "')." << std::endl;
-        return (texture_3d_ptr());
+    // upload straight from the file mapping, fall back to reading into system memory
+    if (vol_reader->map_volume_data(io::MAPPING_ACCESS_SEQUENTIAL)) {
+        in_data.push_back(const_cast<void*>(vol_reader->mapped_volume_data()));
     }
+    else {
+        read_buffer.reset(new unsigned char[read_buffer_size]);
 
-    if (volume_data_format == FORMAT_NULL) {
-        std::cout << "demo_app::load_volume(): unable to determine volume data format ('" << in_file_name << "')." << std::endl;
-        return (texture_3d_ptr());
+        if (!vol_reader->read(data_offset, data_dimensions, read_buffer.get())) {
+            std::cout << "demo_app::load_volume(): unable to read data from file ('" << in_file_name << "')." << std::endl;
+            return (texture_3d_ptr());
+        }
+        in_data.push_back(read_buffer.get());
     }
 
-    std::vector<void*> in_data;
-    in_data.push_back(read_buffer.get());
     texture_3d_ptr new_volume_tex =
         in_device.create_texture_3d(data_dimensions, volume_data_format, 1, volume_data_format, in_data);
 
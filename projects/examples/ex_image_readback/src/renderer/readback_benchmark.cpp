@@ -426,6 +426,10 @@ readback_benchmark::draw_model(const gl::render_context_ptr& context)
     //context->sync();
         _model->draw_raw(context);
     //context->sync();
+#ifdef SCM_TEST_TEXTURE_IMAGE_STORE
+        // the image stores have to be visible to the readback (flush() no longer issues a barrier)
+        context->memory_barrier(BARRIER_SHADER_IMAGE_ACCESS | BARRIER_TEXTURE_FETCH | BARRIER_TEXTURE_UPDATE | BARRIER_PIXEL_BUFFER);
+#endif // SCM_TEST_TEXTURE_IMAGE_STORE
     } _gpu_timer_draw->stop();
 }
 
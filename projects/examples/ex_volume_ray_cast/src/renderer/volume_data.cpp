@@ -5,6 +5,7 @@
 #include "volume_data.h"
 
 #include <algorithm>
+#include <cmath>
 #include <exception>
 #include <limits>
 #include <stdexcept>
@@ -20,6 +21,7 @@
 #include <scm/core/math.h>
 #include <scm/core/memory.h>
 #include <scm/core/numeric_types.h>
+#include <scm/core/io/file.h>
 #include <scm/core/time/high_res_timer.h>
 
 #include <scm/gl_util/data/analysis/transfer_function/build_lookup_table.h>
@@ -37,6 +39,17 @@
 #include <scm/gl_util/data/volume/volume_reader_raw.h>
 #include <scm/gl_util/data/volume/volume_reader_segy.h>
 #include <scm/gl_util/data/volume/volume_reader_vgeo.h>
+#include <scm/gl_util/data/volume/ooc/volume_brick_cache.h>
+#include <scm/gl_util/data/volume/ooc/volume_brick_layout.h>
+
+namespace {
+
+// gpu memory used for the brick atlas of bricked volumes
+const scm::size_t   brick_atlas_budget          = 256 * 1024 * 1024;
+// bricks are refined while the view is closer than brick_lod_scale brick extents
+const float         brick_lod_scale             = 2.0f;
+
+} // namespace
 
 namespace scm {
 namespace data {
@@ -53,13 +66,29 @@ volume_data::volume_data(const gl::render_device_ptr& device,
     using namespace scm::gl;
     using namespace scm::math;
 
-    out() << log::info << "volume_data::volume_data(): loading raw volume..." << log::end;
-    _volume_raw = load_volume(device, file_name);
-    if (!_volume_raw) {
-        throw std::runtime_error("volume_data::volume_data(): error loading volume data from file: " + file_name);
+    if (boost::algorithm::iends_with(file_name, ".sbv")) {
+        out() << log::info << "volume_data::volume_data(): opening bricked volume..." << log::end;
+        _brick_cache = load_brick_volume(device, file_name);
+        if (!_brick_cache) {
+            throw std::runtime_error("volume_data::volume_data(): error opening bricked volume file: " + file_name);
+        }
+        _data_dimensions = _brick_cache->layout().volume_dimensions();
+        _max_lod         = static_cast<float>(_brick_cache->layout().level_count()) - 1.0f;
+        _min_value       = 0.0f;
+        _max_value       = 1.0f;
+        out() << log::info << "volume_data::volume_data(): opening bricked volume done." << log::end;
+    }
+    else {
+        out() << log::info << "volume_data::volume_data(): loading raw volume..." << log::end;
+        _volume_raw = load_volume(device, file_name);
+        if (!_volume_raw) {
+            throw std::runtime_error("volume_data::volume_data(): error loading volume data from file: " + file_name);
+        }
+        _data_dimensions = _volume_raw->descriptor()._size;
+        _max_lod         = static_cast<float>(gl::util::max_mip_levels(_data_dimensions)) - 1.0f;
+        out() << log::info << "volume_data::volume_data(): loading raw volume done." << log::end;
     }
     _sstate_linear = device->create_sampler_state(FILTER_MIN_MAG_LINEAR, WRAP_CLAMP_TO_EDGE);
-    out() << log::info << "volume_data::volume_data(): loading raw volume done." << log::end;
 
     out() << log::info << "volume_data::volume_data(): generating color map..." << log::end;
     _color_alpha_map = create_color_alpha_map(device, 256);
@@ -72,12 +101,10 @@ volume_data::volume_data(const gl::render_device_ptr& device,
     _color_alpha_map_dirty = false;
     out() << log::info << "volume_data::volume_data(): generating color map done." << log::end;
 
-    _data_dimensions = _volume_raw->descriptor()._size;
-    _max_lod         = static_cast<float>(gl::util::max_mip_levels(_data_dimensions)) - 1.0f;
     unsigned max_dim = max(max(_data_dimensions.x,
                                _data_dimensions.y),
                                _data_dimensions.z);
-    _extends         = vec3f(_volume_raw->descriptor()._size) / max_dim;
+    _extends         = vec3f(_data_dimensions) / max_dim;
     _bbox            = box(math::vec3f(0.0f), _extends);
     _transform       = make_translation(-_extends / 2.0f);
 
@@ -94,7 +121,8 @@ volume_data::volume_data(const gl::render_device_ptr& device,
     out() << log::info << "volume_data::volume_data(): successfully loaded volume file: " << file_name << log::end;
 
 #if SCM_TEXT_NV_BINDLESS_TEXTURES == 1
-    if (   !device->main_context()->make_resident(_volume_raw, _sstate_linear)
+    if (   !_volume_raw
+        || !device->main_context()->make_resident(_volume_raw, _sstate_linear)
         || !device->main_context()->make_resident(_color_alpha_map, _sstate_linear)) {
         out() << log::info << "volume_data::volume_data(): unable to make texture resident." << log::end;
     }
@@ -125,6 +153,7 @@ volume_data::~volume_data()
     _bbox_geometry.reset();
 
     _volume_raw.reset();
+    _brick_cache.reset();
     _color_alpha_map.reset();
 
     _volume_block.reset();
@@ -262,6 +291,12 @@ volume_data::volume_raw() const
     return _volume_raw;
 }
 
+const gl::volume_brick_cache_ptr&
+volume_data::brick_cache() const
+{
+    return _brick_cache;
+}
+
 const gl::texture_1d_ptr&
 volume_data::color_alpha_map() const
 {
@@ -395,12 +430,13 @@ volume_data::load_volume(const gl::render_device_ptr& in_device,
     }
     out() << "min_value: " << _min_value << ", max_value: " << _max_value << log::end;
 
+    shared_array<uint8> mip_pyramid;
     std::vector<uint8*> mip_data;
     std::vector<void*>  mip_init_data;
 
     out() << "generating mip map hierarchy..." << log::end;
     timer.start();
-    gl::util::generate_mipmaps(data_dimensions, data_format, read_buffer.get(), mip_data);
+    gl::util::generate_mipmaps_parallel(data_dimensions, data_format, read_buffer.get(), mip_pyramid, mip_data);
     timer.stop();
     out() << "generating mip map hierarchy done"
           << " (elapsed time: " << std::fixed << std::setprecision(3)
@@ -427,13 +463,51 @@ volume_data::load_volume(const gl::render_device_ptr& in_device,
           << " (elapsed time: " << std::fixed << std::setprecision(3)
           << time::to_seconds(timer.get_time()) << "s)" << log::end;
 
-    std::for_each(mip_data.begin() + 1, mip_data.end(), [&mip_init_data](uint8* v) {delete [] v; });
-
     out() << log::outdent;
 
     return new_volume_tex;
 }
 
+gl::volume_brick_cache_ptr
+volume_data::load_brick_volume(const gl::render_device_ptr& in_device,
+                               const std::string&           in_file_name)
+{
+    using namespace scm::gl;
+    using namespace scm::math;
+
+    volume_brick_layout bl;
+    {
+        io::file    brick_file;
+        if (   !brick_file.open(in_file_name, std::ios_base::in, false)
+            || !bl.read_header(brick_file)) {
+            err() << log::error
+                  << "volume_data::load_brick_volume(): unable to read bricked volume header ('" << in_file_name << "')." << log::end;
+            return volume_brick_cache_ptr();
+        }
+    }
+
+    // cubic atlas within the memory budget, at least one brick
+    const double    budget_bricks = static_cast<double>(brick_atlas_budget) / static_cast<double>(bl.brick_data_size());
+    const unsigned  max_slots     = static_cast<unsigned>(in_device->capabilities()._max_texture_3d_size) / bl.brick_data_dimensions();
+    const unsigned  slots         = clamp(static_cast<unsigned>(std::pow(budget_bricks, 1.0 / 3.0)), 1u, max(max_slots, 1u));
+
+    out() << log::indent
+          << "bricked volume (dimensions: " << bl.volume_dimensions() << ", format: " << format_string(bl.format())
+          << ", levels: " << bl.level_count() << ", brick size: " << bl.brick_size() << ")" << log::nline
+          << "brick atlas slots: " << vec3ui(slots) << log::end
+          << log::outdent;
+
+    try {
+        volume_brick_cache_ptr cache(new volume_brick_cache(in_device, in_file_name, vec3ui(slots), true));
+        return cache;
+    }
+    catch (const std::exception& e) {
+        err() << log::error
+              << "volume_data::load_brick_volume(): error creating brick cache ('" << in_file_name << "'): " << e.what() << log::end;
+        return volume_brick_cache_ptr();
+    }
+}
+
 gl::texture_1d_ptr
 volume_data::create_color_alpha_map(const gl::render_device_ptr& in_device,
                                           unsigned               in_size) const
@@ -546,6 +620,17 @@ volume_data::update(const gl::render_context_ptr& context,
         _color_alpha_map_dirty = false;
     }
 
+    if (_brick_cache) {
+        // view position in level 0 voxels, the renderer samples the finest resident bricks
+        const mat4f     m_inv   = inverse(cam.view_matrix() * transform());
+        const vec4f     os_cpos = m_inv.column(3) / m_inv.column(3).w;
+        const vec3f     vx_cpos = vec3f(os_cpos.x, os_cpos.y, os_cpos.z) / extends() * vec3f(_data_dimensions);
+        const vec3ui&   slots   = _brick_cache->atlas_slots();
+
+        _brick_cache->request_view_dependent(vx_cpos, brick_lod_scale, (slots.x * slots.y * slots.z) / 2);
+        _brick_cache->update(context);
+    }
+
 
     float max_dim = static_cast<float>(max(max(_data_dimensions.x,
                                                _data_dimensions.y),
@@ -571,7 +656,7 @@ volume_data::update(const gl::render_context_ptr& context,
         _volume_block->_mvp_matrix_inverse           = inverse(_volume_block->_mvp_matrix);
 
 #if SCM_TEXT_NV_BINDLESS_TEXTURES == 1
-        _volume_block->_volume_texture              = _volume_raw->native_handle();
+        _volume_block->_volume_texture              = _volume_raw ? _volume_raw->native_handle() : 0;
         _volume_block->_color_map                   = _color_alpha_map->native_handle();
 #endif // SCM_TEXT_NV_BINDLESS_TEXTURES == 1
 
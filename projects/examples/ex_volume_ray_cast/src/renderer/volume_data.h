@@ -17,6 +17,7 @@
 #include <scm/gl_core/constants.h>
 #include <scm/gl_core/primitives/box.h>
 
+#include <scm/gl_util/data/volume/ooc/ooc_fwd.h>
 #include <scm/gl_util/primitives/primitives_fwd.h>
 #include <scm/gl_util/viewer/viewer_fwd.h>
 
@@ -94,6 +95,8 @@ public:
     const gl::texture_buffer_ptr&       texture_handles() const;
 
     const gl::texture_3d_ptr&           volume_raw() const;
+    // bricked volume files (.sbv) are rendered from the brick cache instead of volume_raw
+    const gl::volume_brick_cache_ptr&   brick_cache() const;
     const gl::texture_1d_ptr&           color_alpha_map() const;
 
     const color_map_ptr&                color_map() const;
@@ -107,6 +110,8 @@ public:
 protected:
     gl::texture_3d_ptr                  load_volume(const gl::render_device_ptr& in_device,
                                                     const std::string&           in_file_name);
+    gl::volume_brick_cache_ptr          load_brick_volume(const gl::render_device_ptr& in_device,
+                                                          const std::string&           in_file_name);
     gl::texture_1d_ptr                  create_color_alpha_map(const gl::render_device_ptr& in_device,
                                                                      unsigned               in_size) const;
     bool                                update_color_alpha_map(const gl::render_context_ptr& context) const;
@@ -135,6 +140,7 @@ protected:
 
     gl::texture_buffer_ptr              _texture_handles;
     gl::texture_3d_ptr                  _volume_raw;
+    gl::volume_brick_cache_ptr          _brick_cache;
     gl::texture_1d_ptr                  _color_alpha_map;
     bool                                _color_alpha_map_dirty;
     gl::sampler_state_ptr               _sstate_linear;
@@ -22,6 +22,7 @@
 #include <scm/gl_util/primitives/box_volume.h>
 #include <scm/gl_util/viewer/camera.h>
 #include <scm/gl_util/viewer/camera_uniform_block.h>
+#include <scm/gl_util/data/volume/ooc/volume_brick_cache.h>
 
 #include <renderer/renderer_config.h>
 #include <renderer/volume_data.h>
@@ -37,6 +38,7 @@ volume_renderer::volume_renderer(const gl::render_device_ptr& device)
     using boost::assign::list_of;
 
     camera_uniform_block::add_block_include_string(device);
+    volume_brick_cache::add_lookup_include_string(device);
 
     _camera_block.reset(new gl::camera_uniform_block(device));
 
@@ -75,6 +77,7 @@ volume_renderer::volume_renderer(const gl::render_device_ptr& device)
 volume_renderer::~volume_renderer()
 {
     _program.reset();
+    _program_bricked.reset();
     
     _dstate.reset();
     _bstate.reset();
@@ -95,16 +98,18 @@ volume_renderer::draw(const gl::render_context_ptr& context,
     using namespace scm::gl;
     using namespace scm::math;
 
+    const program_ptr& prog = vdata->brick_cache() ? _program_bricked : _program;
+
     switch (mode) {
         case volume_raw:
-            _program->uniform_subroutine(STAGE_FRAGMENT_SHADER, "volume_color_lookup", "raw_lookup");
+            prog->uniform_subroutine(STAGE_FRAGMENT_SHADER, "volume_color_lookup", "raw_lookup");
             break;
         case volume_color_map:
-            _program->uniform_subroutine(STAGE_FRAGMENT_SHADER, "volume_color_lookup", "raw_color_map_lookup");
+            prog->uniform_subroutine(STAGE_FRAGMENT_SHADER, "volume_color_lookup", "raw_color_map_lookup");
             break;
     }
 
-    _program->uniform("volume_lod", vdata->selected_lod());
+    prog->uniform("volume_lod", vdata->selected_lod());
 
     context_state_objects_guard     csg(context);
     context_texture_units_guard     tug(context);
@@ -119,12 +124,17 @@ volume_renderer::draw(const gl::render_context_ptr& context,
     context->bind_uniform_buffer(_camera_block->block().block_buffer(), 0);
     context->bind_uniform_buffer(vdata->volume_block().block_buffer(),  1);
 
-    context->bind_program(_program);
+    context->bind_program(prog);
 
     context->reset_texture_units();
 
+    if (vdata->brick_cache()) {
+        vdata->brick_cache()->bind_lookup(context, prog, 0, 3);
+    }
 #if SCM_TEXT_NV_BINDLESS_TEXTURES != 1
-    context->bind_texture(vdata->volume_raw(),      _sstate_lin_mip, 0);
+    else {
+        context->bind_texture(vdata->volume_raw(),  _sstate_lin_mip, 0);
+    }
     context->bind_texture(vdata->color_alpha_map(), _sstate_lin,     2);
 #else
     context->bind_texture(vdata->texture_handles(), _sstate_nearest, 4);
@@ -152,32 +162,52 @@ volume_renderer::reload_shaders(const gl::render_device_ptr& device)
                << "volume_renderer::reload_shaders(): "
                << "reloading shader strings." << log::end;
 
-    // ray casting program ////////////////////////////////////////////////////////////////////////
-    shader_macro_array sm;
-    sm(shader_macro("SCM_TEXT_NV_BINDLESS_TEXTURES", SCM_TEXT_NV_BINDLESS_TEXTURES == 1 ? "1" : "0"));
-
-    program_ptr prog_rcraw  = device->create_program(list_of(device->create_shader_from_file(STAGE_VERTEX_SHADER,   "../../../src/renderer/shader/volume_ray_cast.glslv"))
-                                                            (device->create_shader_from_file(STAGE_FRAGMENT_SHADER, "../../../src/renderer/shader/volume_ray_cast.glslf",
-                                                                                             sm)),
-                                                     "volume_renderer::program");
+    // ray casting programs ///////////////////////////////////////////////////////////////////////
+    program_ptr prog_rcraw      = load_program(device, false);
+    program_ptr prog_rcbricked  = load_program(device, true);
 
-    if (!prog_rcraw) {
+    if (!prog_rcraw || !prog_rcbricked) {
         scm::err() << log::error
                    << "volume_renderer::reload_shaders(): "
                    << "error loading program" << log::end;
         return false;
     }
     else {
-        _program = prog_rcraw;
+        _program         = prog_rcraw;
+        _program_bricked = prog_rcbricked;
     }
 
-    _program->uniform("volume_raw",     0);
-    _program->uniform("color_map",      2);
+    return true;
+}
+
+gl::program_ptr
+volume_renderer::load_program(const gl::render_device_ptr& device,
+                              const bool                   bricked) const
+{
+    using namespace scm;
+    using namespace scm::gl;
+    using boost::assign::list_of;
 
-    _program->uniform_buffer("camera_matrices",     0);
-    _program->uniform_buffer("volume_uniform_data", 1);
+    shader_macro_array sm;
+    sm(shader_macro("SCM_TEXT_NV_BINDLESS_TEXTURES", SCM_TEXT_NV_BINDLESS_TEXTURES == 1 ? "1" : "0"))
+      (shader_macro("SCM_VOLUME_BRICK_CACHE",        bricked ? "1" : "0"));
+
+    program_ptr prog = device->create_program(list_of(device->create_shader_from_file(STAGE_VERTEX_SHADER,   "../../../src/renderer/shader/volume_ray_cast.glslv"))
+                                                     (device->create_shader_from_file(STAGE_FRAGMENT_SHADER, "../../../src/renderer/shader/volume_ray_cast.glslf",
+                                                                                      sm)),
+                                              bricked ? "volume_renderer::program_bricked" : "volume_renderer::program");
+
+    if (prog) {
+        if (!bricked) {
+            prog->uniform("volume_raw", 0);
+        }
+        prog->uniform("color_map",      2);
+
+        prog->uniform_buffer("camera_matrices",     0);
+        prog->uniform_buffer("volume_uniform_data", 1);
+    }
 
-    return true;
+    return prog;
 }
 
 } // namespace data
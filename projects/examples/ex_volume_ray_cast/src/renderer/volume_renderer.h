@@ -34,8 +34,13 @@ public:
 
     bool                            reload_shaders(const gl::render_device_ptr& device);
 
+protected:
+    gl::program_ptr                 load_program(const gl::render_device_ptr& device,
+                                                 const bool                   bricked) const;
+
 protected:
     gl::program_ptr                 _program;
+    gl::program_ptr                 _program_bricked;   // samples bricked volumes through the brick cache
 
     gl::depth_stencil_state_ptr     _dstate;
     gl::blend_state_ptr             _bstate;
@@ -360,12 +360,13 @@ volume_data::load_volume(const gl::render_device_ptr& in_device,
     }
     out() << "min_value: " << _min_value << ", max_value: " << _max_value << log::end;
 
+    shared_array<uint8> mip_pyramid;
     std::vector<uint8*> mip_data;
     std::vector<void*>  mip_init_data;
 
     out() << "generating mip map hierarchy..." << log::end;
     timer.start();
-    gl::util::generate_mipmaps(data_dimensions, data_format, read_buffer.get(), mip_data);
+    gl::util::generate_mipmaps_parallel(data_dimensions, data_format, read_buffer.get(), mip_pyramid, mip_data);
     timer.stop();
     out() << "generating mip map hierarchy done"
           << " (elapsed time: " << std::fixed << std::setprecision(3)
@@ -392,8 +393,6 @@ volume_data::load_volume(const gl::render_device_ptr& in_device,
           << " (elapsed time: " << std::fixed << std::setprecision(3)
           << time::to_seconds(timer.get_time()) << "s)" << log::end;
 
-    std::for_each(mip_data.begin() + 1, mip_data.end(), [&mip_init_data](uint8* v) {delete [] v; });
-
     out() << log::outdent;
 
     return new_volume_tex;
@@ -77,6 +77,14 @@ file::read(void*        output_buffer,
     return _file_core->read(output_buffer, start_position, num_bytes_to_read);
 }
 
+file::size_type
+file::read(const file_span_vector& spans,
+           size_type               max_coalesce_gap)
+{
+    assert(_file_core);
+    return _file_core->read(spans, max_coalesce_gap);
+}
+
 file::size_type
 file::write(const void* input_buffer,
             offset_type start_position,
@@ -137,6 +145,13 @@ file::optimal_buffer_size() const
     return _file_core->optimal_buffer_size();
 }
 
+bool
+file::system_cache_disabled() const
+{
+    assert(_file_core);
+    return _file_core->system_cache_disabled();
+}
+
 file::size_type
 file::size() const
 {
@@ -7,6 +7,7 @@
 
 #include <ios>
 #include <string>
+#include <vector>
 
 #include <scm/core/numeric_types.h>
 #include <scm/core/memory.h>
@@ -27,6 +28,17 @@ const scm::uint32   default_asynchronous_requests   = 8u;
 
 class file_core;
 
+// one contiguous region of a vectored read operation
+struct file_span
+{
+    file_span() : _position(0), _size(0), _buffer(0) {}
+    file_span(offset_type p, size_type s, void* b) : _position(p), _size(s), _buffer(b) {}
+
+    offset_type     _position;  // start position in the file
+    size_type       _size;      // number of bytes to read
+    void*           _buffer;    // destination of the read bytes
+}; // struct file_span
+
 class __scm_export(core) file
 {
 public:
@@ -51,6 +63,11 @@ public:
     size_type                   read(void*           output_buffer,
                                      offset_type     start_position,
                                      size_type       num_bytes_to_read);
+    // vectored read: spans closer than max_coalesce_gap bytes in the file are read
+    // by a single I/O request, all requests are completed before returning.
+    // returns the number of bytes read into the span buffers
+    size_type                   read(const file_span_vector& spans,
+                                     size_type               max_coalesce_gap = detail::default_io_block_size);
     size_type                   write(const void*    input_buffer,
                                       offset_type    start_position,
                                       size_type      num_bytes_to_write);
@@ -64,6 +81,9 @@ public:
     offset_type                 vss_align_ceil(const offset_type in_val) const;
 
     size_type                   optimal_buffer_size() const;
+    // false if the file is system buffered, open() falls back to buffered access if the
+    // file system does not support unbuffered access (e.g. tmpfs)
+    bool                        system_cache_disabled() const;
 
     size_type                   size() const;
     const std::string&          file_path() const;
@@ -4,6 +4,24 @@
 
 #include "file_core.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <scm/core/math/math.h>
+#include <scm/core/utilities/foreach.h>
+
+namespace {
+
+bool
+file_span_position_less(const scm::io::file_span& lhs,
+                        const scm::io::file_span& rhs)
+{
+    return lhs._position < rhs._position;
+}
+
+} // namespace
+
 namespace scm {
 namespace io {
 
@@ -16,6 +34,35 @@ file_core::~file_core()
 {
 }
 
+file_core::size_type
+file_core::read(const file_span_vector& spans,
+                size_type               max_coalesce_gap)
+{
+    detail::file_span_run_vector    runs;
+    scm::shared_array<char_type>    staging_buffer;
+    size_type                       staging_buffer_size = 0;
+    size_type                       bytes_read          = 0;
+
+    coalesce_spans(spans, max_coalesce_gap, runs);
+
+    foreach (const detail::file_span_run& run, runs) {
+        if (   run._spans.size() == 1
+            && run._spans.front()._size == run._size) {
+            // single span, read directly into the destination
+            size_type run_bytes_read = read(run._spans.front()._buffer, run._position, run._size);
+            if (run_bytes_read != run._size) {
+                return (bytes_read + math::max<size_type>(0, run_bytes_read));
+            }
+            bytes_read += run_bytes_read;
+        }
+        else if (!read_run_staged(run, staging_buffer, staging_buffer_size, bytes_read)) {
+            return (bytes_read);
+        }
+    }
+
+    return (bytes_read);
+}
+
 // fixed functionality
 file_core::offset_type
 file_core::seek(offset_type                off,
@@ -101,11 +148,86 @@ file_core::reset_values()
     _async_request_buffer_size  = 0;
 }
 
+bool
+file_core::system_cache_disabled() const
+{
+    return async_io_mode();
+}
+
 bool
 file_core::async_io_mode() const
 {
     return (_async_requests != 0 && _async_request_buffer_size != 0);
 }
 
+void
+file_core::coalesce_spans(const file_span_vector&        spans,
+                          size_type                      max_coalesce_gap,
+                          detail::file_span_run_vector&  runs) const
+{
+    file_span_vector    sorted_spans;
+
+    sorted_spans.reserve(spans.size());
+    foreach (const file_span& s, spans) {
+        if (s._size > 0) {
+            sorted_spans.push_back(s);
+        }
+    }
+    std::stable_sort(sorted_spans.begin(), sorted_spans.end(), file_span_position_less);
+
+    runs.clear();
+
+    foreach (const file_span& s, sorted_spans) {
+        if (!runs.empty()) {
+            detail::file_span_run&  cur_run     = runs.back();
+            offset_type             cur_run_end = cur_run._position + cur_run._size;
+            offset_type             new_run_end = math::max(cur_run_end, s._position + s._size);
+
+            if (   s._position <= cur_run_end + max_coalesce_gap
+                && new_run_end - cur_run._position <= detail::max_coalesced_request_size) {
+                cur_run._size = new_run_end - cur_run._position;
+                cur_run._spans.push_back(s);
+                continue;
+            }
+        }
+
+        runs.push_back(detail::file_span_run());
+        runs.back()._position = s._position;
+        runs.back()._size     = s._size;
+        runs.back()._spans.push_back(s);
+    }
+}
+
+bool
+file_core::read_run_staged(const detail::file_span_run&  run,
+                           scm::shared_array<char_type>& staging_buffer,
+                           size_type&                    staging_buffer_size,
+                           size_type&                    bytes_read)
+{
+    // read the complete run into the staging buffer and scatter it to the span buffers
+    if (staging_buffer_size < run._size) {
+        staging_buffer.reset(new char_type[static_cast<size_t>(run._size)]);
+        staging_buffer_size = run._size;
+    }
+
+    size_type run_bytes_read = read(staging_buffer.get(), run._position, run._size);
+
+    if (run_bytes_read <= 0) {
+        return (false);
+    }
+
+    foreach (const file_span& s, run._spans) {
+        size_type src_off    = s._position - run._position;
+        size_type copy_bytes = math::min(s._size, run_bytes_read - src_off);
+
+        if (copy_bytes > 0) {
+            memcpy(s._buffer, staging_buffer.get() + src_off, static_cast<size_t>(copy_bytes));
+            bytes_read += copy_bytes;
+        }
+    }
+
+    return (run_bytes_read == run._size);
+}
+
 } // namepspace io
 } // namepspace scm
@@ -5,12 +5,32 @@
 #ifndef SCM_CORE_IO_FILE_CORE_H_INCLUDED
 #define SCM_CORE_IO_FILE_CORE_H_INCLUDED
 
+#include <vector>
+
 #include <boost/noncopyable.hpp>
 
 #include <scm/core/io/file.h>
 
 namespace scm {
 namespace io {
+namespace detail {
+
+// maximum size of a read request resulting from coalescing multiple file spans
+const scm::int64    max_coalesced_request_size      = 16ll * 1024 * 1024;
+
+// a contiguous file range covering a set of sorted file spans
+struct file_span_run
+{
+    file_span_run() : _position(0), _size(0) {}
+
+    offset_type         _position;
+    size_type           _size;
+    file_span_vector    _spans;
+}; // struct file_span_run
+
+typedef std::vector<file_span_run>  file_span_run_vector;
+
+} // namespace detail
 
 class file_core : boost::noncopyable
 {
@@ -34,6 +54,8 @@ public:
     virtual size_type           read(void*           output_buffer,
                                      offset_type     start_position,
                                      size_type       num_bytes_to_read) = 0;
+    virtual size_type           read(const file_span_vector& spans,
+                                     size_type               max_coalesce_gap);
     virtual size_type           write(const void*    input_buffer,
                                       offset_type    start_position,
                                       size_type      num_bytes_to_write) = 0;
@@ -46,6 +68,7 @@ public:
     offset_type                 seek(offset_type                off,
                                      std::ios_base::seek_dir    way);
     size_type                   optimal_buffer_size() const;
+    bool                        system_cache_disabled() const;
 
     size_type                   size() const;
     const std::string&          file_path() const;
@@ -58,6 +81,14 @@ protected:
     virtual void                reset_values();
     virtual bool                async_io_mode() const;
 
+    void                        coalesce_spans(const file_span_vector&        spans,
+                                               size_type                      max_coalesce_gap,
+                                               detail::file_span_run_vector&  runs) const;
+    bool                        read_run_staged(const detail::file_span_run&  run,
+                                                scm::shared_array<char_type>& staging_buffer,
+                                                size_type&                    staging_buffer_size,
+                                                size_type&                    bytes_read);
+
 protected:
     offset_type                 _position;
 
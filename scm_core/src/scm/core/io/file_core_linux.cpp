@@ -8,10 +8,17 @@
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <aio.h>
+#include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #include <cassert>
+#include <queue>
 
 #include <boost/bind.hpp>
 #include <boost/filesystem.hpp>
@@ -79,6 +86,7 @@ file_open(const std::string& fn, int open_flags, mode_t create_mode) {
             case EEXIST:    ret_error.assign("pathname already exists and O_CREAT and O_EXCL were used"); break;
             case EFAULT:    ret_error.assign("pathname points outside your accessible address space"); break;
             case EISDIR:    ret_error.assign("pathname refers to a directory and the access requested involved writing"); break;
+            case EINVAL:    ret_error.assign("invalid open flags (file system does not support O_DIRECT?)"); break;
             default:        ret_error.assign("unknown error"); break;
         }
         scm::err() << log::error
@@ -92,6 +100,117 @@ file_open(const std::string& fn, int open_flags, mode_t create_mode) {
     }
 }
 
+struct aio_request : public aiocb
+{
+    aio_request(const file_core::size_type size,
+                const file_core::size_type alignment);
+    ~aio_request(); // needs to be non-virtual
+
+    void                                            position(const file_core::offset_type pos);
+    file_core::offset_type                          position() const;
+
+    void                                            bytes_to_process(const file_core::size_type size);
+    file_core::size_type                            bytes_to_process() const;
+
+    void                                            run_index(const scm::size_t r);
+    scm::size_t                                     run_index() const;
+
+    const scm::shared_ptr<file_core::char_type>&    buffer() const;
+
+private:
+    file_core::size_type                            _bytes_to_process;
+    scm::size_t                                     _run_index;
+    scm::shared_ptr<file_core::char_type>           _rw_buffer;
+}; // struct aio_request
+
+typedef std::queue<request_ptr>                     request_ptr_queue;
+
+// volume sector aligned part of a file span run handled by a single request
+struct read_chunk
+{
+    read_chunk(scm::size_t r, file_core::offset_type p, file_core::size_type s)
+      : _run_index(r), _position(p), _size(s) {}
+
+    scm::size_t             _run_index;
+    file_core::offset_type  _position;
+    file_core::size_type    _size;
+}; // struct read_chunk
+
+aio_request::aio_request(const file_core::size_type size,
+                         const file_core::size_type alignment)
+  : _bytes_to_process(0)
+  , _run_index(0)
+{
+    memset(static_cast<aiocb*>(this), 0, sizeof(aiocb));
+
+    aio_sigevent.sigev_notify = SIGEV_NONE;
+
+    // O_DIRECT requires the transfer buffers to be aligned to the volume sector size
+    void* buf = 0;
+    if (0 == posix_memalign(&buf, static_cast<size_t>(alignment), static_cast<size_t>(size))) {
+        _rw_buffer.reset(static_cast<file_core::char_type*>(buf), ::free);
+    }
+    assert(_rw_buffer);
+
+    aio_buf = _rw_buffer.get();
+}
+
+aio_request::~aio_request()
+{
+    _rw_buffer.reset();
+}
+
+void
+aio_request::position(const file_core::offset_type pos)
+{
+    aio_offset = pos;
+}
+
+file_core::offset_type
+aio_request::position() const
+{
+    return (aio_offset);
+}
+
+void
+aio_request::bytes_to_process(const file_core::size_type size)
+{
+    _bytes_to_process = size;
+    aio_nbytes        = static_cast<size_t>(size);
+}
+
+file_core::size_type
+aio_request::bytes_to_process() const
+{
+    return (_bytes_to_process);
+}
+
+void
+aio_request::run_index(const scm::size_t r)
+{
+    _run_index = r;
+}
+
+scm::size_t
+aio_request::run_index() const
+{
+    return (_run_index);
+}
+
+const scm::shared_ptr<file_core::char_type>&
+aio_request::buffer() const
+{
+    return (_rw_buffer);
+}
+
+struct io_result
+{
+    io_result() : _bytes_processed(0), _req(0) {}
+
+    ssize_t         _bytes_processed;
+    aio_request*    _req;
+};
+
 } // namespace detail
 
 
@@ -181,13 +300,30 @@ file_core_linux::open(const std::string&       file_path,
         }
     }
 
+    // do open
     if (disable_system_cache) {
-        //flags_and_attributes |= FILE_FLAG_NO_BUFFERING | FILE_FLAG_OVERLAPPED;
-        // TODO implement async I/O
-    }
+        int direct_flags = open_flags | O_DIRECT;
 
-    // do open
-    _file_handle = detail::file_open(complete_input_file_path.string(), open_flags, create_mode);
+        if (open_mode & std::ios_base::out) {
+            // unbuffered writes read back partial sectors before writing them (write_async)
+            direct_flags = (direct_flags & ~O_ACCMODE) | O_RDWR;
+        }
+
+        _file_handle = detail::file_open(complete_input_file_path.string(), direct_flags, create_mode);
+
+        if (!_file_handle) {
+            // some file systems (e.g. tmpfs) do not support unbuffered access
+            scm::err() << log::warning
+                       << "file_core_linux::open(): "
+                       << "unable to open file for unbuffered access, falling back to system buffered access: "
+                       << "'" << complete_input_file_path.string() << "'" << log::end;
+
+            disable_system_cache = false;
+        }
+    }
+    if (!disable_system_cache) {
+        _file_handle = detail::file_open(complete_input_file_path.string(), open_flags, create_mode);
+    }
 
     if (!_file_handle) {
         scm::err() << log::error
@@ -198,6 +334,33 @@ file_core_linux::open(const std::string&       file_path,
         return (false);
     }
 
+    // retrieve the sector size information
+    struct stat64   file_stat;
+
+    if (0 != fstat64(*_file_handle, &file_stat)) {
+        scm::err() << log::error
+                   << "file_core_linux::open(): "
+                   << "error retrieving sector size information "
+                   << "on device of file '" << complete_input_file_path.string() << "'" << log::end;
+
+        _file_handle.reset();
+        return (false);
+    }
+
+    // st_blksize is a multiple of the logical block size of the device, which
+    // satisfies the O_DIRECT alignment restrictions on offsets, lengths and buffers
+    _volume_sector_size = file_stat.st_blksize > 0 ? static_cast<scm::int32>(file_stat.st_blksize) : 4096;
+
+    assert(_volume_sector_size != 0);
+
+    if (disable_system_cache) {
+        // calculate the correct read write buffer size (round up to full multiple of bytes per sector)
+        _async_request_buffer_size  = static_cast<scm::int32>(vss_align_ceil(math::max<scm::uint32>(read_write_buffer_size, 1u)));
+        _async_requests             = math::max<scm::uint32>(read_write_asynchronous_requests, 1u);
+
+        assert(_async_request_buffer_size % _volume_sector_size == 0);
+    }
+
     if (   open_mode & std::ios_base::ate
         || open_mode & std::ios_base::app) {
 
@@ -226,7 +389,21 @@ void
 file_core_linux::close()
 {
     if (is_open()) {
-        // in async write mode truncate the file
+        // if we are non system buffered, it is possible to be too large
+        // because of volume sector size alignment restrictions
+        if (   async_io_mode()
+            && _open_mode & std::ios_base::out) {
+            if (_file_size != actual_file_size()) {
+                if (0 != ftruncate64(*_file_handle, _file_size)) {
+                    scm::err() << log::error
+                               << "file_core_linux::close(): "
+                               << "error truncating end of file: "
+                               << "'" << _file_path << "'" << log::end;
+                    throw std::ios_base::failure(  std::string("file_core_linux::close(): error truncating end of file: ")
+                                                 + _file_path);
+                }
+            }
+        }
     }
     reset_values();
 }
@@ -250,13 +427,12 @@ file_core_linux::read(void*       output_buffer,
         return (0);
     }
 
-//    // non system buffered read operation
-//    if (async_io_mode()) {
-//        bytes_read = read_async(output_buffer, num_bytes_to_read);
-//    }
-//    // normal system buffered operation
-//    else
-    {
+    // non system buffered read operation
+    if (async_io_mode()) {
+        return (read_async(output_buffer, start_position, num_bytes_to_read));
+    }
+    // normal system buffered operation
+    else {
         ssize_t file_bytes_read = 0;
 
         file_bytes_read = ::pread64(*_file_handle, output_byte_buffer, num_bytes_to_read, _position);
@@ -289,6 +465,37 @@ file_core_linux::read(void*       output_buffer,
     return (bytes_read);
 }
 
+file_core_linux::size_type
+file_core_linux::read(const file_span_vector& spans,
+                      size_type               max_coalesce_gap)
+{
+    assert(is_open());
+
+    detail::file_span_run_vector    runs;
+
+    coalesce_spans(spans, max_coalesce_gap, runs);
+
+    // non system buffered read operation, all runs are issued concurrently
+    if (async_io_mode()) {
+        return (read_async(runs));
+    }
+    // normal system buffered operation, one vectored read per run
+    else {
+        size_type                       gap_buffer_size = math::min<size_type>(math::max<size_type>(max_coalesce_gap, 1),
+                                                                               detail::default_io_block_size);
+        scm::scoped_array<char_type>    gap_buffer(new char_type[static_cast<size_t>(gap_buffer_size)]);
+        size_type                       bytes_read = 0;
+
+        foreach (const detail::file_span_run& run, runs) {
+            if (!read_vectored(run, gap_buffer.get(), gap_buffer_size, bytes_read)) {
+                break;
+            }
+        }
+
+        return (bytes_read);
+    }
+}
+
 file_core_linux::size_type
 file_core_linux::write(const void* input_buffer,
                        offset_type start_position,
@@ -306,17 +513,13 @@ file_core_linux::write(const void* input_buffer,
     offset_type     bytes_written       = 0;
 
     _position = start_position;
-//    // non system buffered read operation
-//    if (async_io_mode()) {
-//        //scm::err() << log::error
-//        //           << "file_win::write(): "
-//        //           << "file was opened for async read operations (async write not supported)" << log::end;
-//        //return (0);
-//        bytes_written = write_async(input_buffer, num_bytes_to_write);
-//    }
-//    // normal system buffered operation
-//    else
-    {
+
+    // non system buffered write operation
+    if (async_io_mode()) {
+        bytes_written = write_async(input_buffer, start_position, num_bytes_to_write);
+    }
+    // normal system buffered operation
+    else {
         ssize_t file_bytes_written  = 0;
 
         file_bytes_written = ::pwrite64(*_file_handle, input_byte_buffer, num_bytes_to_write, _position);
@@ -337,6 +540,9 @@ file_core_linux::write(const void* input_buffer,
                        << "file_core_linux::write(): "
                        << "unknown error writing to file " << _file_path << log::end;
         }
+        if (_file_size < _position) {
+            _file_size = _position;
+        }
     }
 
     return (bytes_written);
@@ -347,7 +553,7 @@ file_core_linux::flush_buffers() const
 {
     assert(is_open());
 
-    return (true);//FlushFileBuffers(_file_handle.get()) == TRUE ? true : false);
+    return (::fdatasync(*_file_handle) == 0 ? true : false);
 }
 
 file_core_linux::offset_type
@@ -372,10 +578,538 @@ file_core_linux::set_end_of_file()
             return (-1);
         }
 
+        _file_size = _position;
+
         return (_position);
     }
 
-    return (1);
+    return (-1);
+}
+
+file_core_linux::size_type
+file_core_linux::read_async(void*       output_buffer,
+                            offset_type start_position,
+                            size_type   num_bytes_to_read)
+{
+    assert(async_io_mode());
+
+    _position   = start_position;
+
+    if (_position >= _file_size) {
+        // eof
+        return (-1);
+    }
+
+    detail::file_span_run_vector    runs(1);
+
+    runs.front()._position = start_position;
+    runs.front()._size     = num_bytes_to_read;
+    runs.front()._spans.push_back(file_span(start_position, num_bytes_to_read, output_buffer));
+
+    size_type   bytes_read = read_async(runs);
+
+    _position = _position + bytes_read;
+
+    return (bytes_read);
+}
+
+file_core_linux::size_type
+file_core_linux::read_async(const detail::file_span_run_vector& runs)
+{
+    assert(async_io_mode());
+
+    using detail::aio_request;
+    using detail::read_chunk;
+    using detail::request_ptr;
+    using detail::request_ptr_queue;
+    using detail::request_ptr_map;
+
+    request_ptr_queue       free_requests;
+    request_ptr_map         running_requests;
+
+    // split the runs into volume sector aligned chunks of at most the request buffer size
+    std::vector<read_chunk> read_chunks;
+
+    for (scm::size_t r = 0; r < runs.size(); ++r) {
+        size_type   position_vss            = vss_align_floor(runs[r]._position);
+        size_type   read_end_position_vss   = vss_align_ceil(math::min(runs[r]._position + runs[r]._size, _file_size));
+
+        for (size_type p = position_vss; p < read_end_position_vss; p += _async_request_buffer_size) {
+            read_chunks.push_back(read_chunk(r, p, math::min<size_type>(read_end_position_vss - p, _async_request_buffer_size)));
+        }
+    }
+
+    if (read_chunks.empty()) {
+        return (0);
+    }
+
+    size_type   bytes_read              = 0;
+    scm::size_t next_read_chunk         = 0;
+    scm::int32  allocate_requests       = scm::math::min<scm::int32>(_async_requests, static_cast<scm::int32>(read_chunks.size()));
+
+    // allocate the request structs
+    for (scm::int32 i = 0; i < allocate_requests; ++i) {
+        request_ptr new_request(new aio_request(_async_request_buffer_size, _volume_sector_size));
+        new_request->aio_fildes = *_file_handle;
+        free_requests.push(new_request);
+    }
+
+    do {
+        // fill up request queue
+        while (!free_requests.empty() && next_read_chunk < read_chunks.size()) {
+            // retrieve a free request structure
+            request_ptr         read_request = free_requests.front();
+            const read_chunk&   chunk        = read_chunks[next_read_chunk];
+            free_requests.pop();
+
+            // setup request structure
+            read_request->position(chunk._position);
+            read_request->bytes_to_process(chunk._size);
+            read_request->run_index(chunk._run_index);
+
+            ++next_read_chunk;
+            running_requests.insert(request_ptr_map::value_type(read_request.get(), read_request));
+
+            if (!read_async_request(read_request)) {
+                running_requests.erase(read_request.get());
+                cancel_async_io(running_requests);
+                return (bytes_read);
+            }
+
+            assert(free_requests.size() + running_requests.size() == static_cast<scm::size_t>(allocate_requests));
+        }
+
+        // ok now wait for requests to be filled
+        if (!running_requests.empty()) {
+            std::vector<detail::io_result>  results;
+
+            if (!query_async_results(running_requests, results)) {
+                cancel_async_io(running_requests);
+                return (bytes_read);
+            }
+
+            assert(!results.empty());
+
+            // evaluate io results
+            foreach (const detail::io_result& result, results) {
+
+                if (result._bytes_processed != result._req->bytes_to_process()) {
+                    if (result._req->position() + result._bytes_processed < _file_size) {
+                        scm::err() << log::error
+                                   << "file_core_linux::read_async(): read result with different than requested length "
+                                   << "(requested: " << result._req->bytes_to_process()
+                                   << ", read: " << result._bytes_processed << ")" << log::end;
+
+                        cancel_async_io(running_requests);
+                        return (bytes_read);
+                    }
+                }
+                // copy the data from the request buffer to the span buffers of the run
+                const offset_type   req_begin   = result._req->position();
+                const offset_type   req_end     = req_begin + result._bytes_processed;
+
+                foreach (const file_span& span, runs[result._req->run_index()]._spans) {
+                    if (span._position >= req_end) {
+                        break; // spans are sorted by position
+                    }
+
+                    offset_type copy_begin = math::max(span._position, req_begin);
+                    offset_type copy_end   = math::min(span._position + span._size, req_end);
+
+                    if (copy_begin < copy_end) {
+                        char_type*       copy_dst = reinterpret_cast<char_type*>(span._buffer) + (copy_begin - span._position);
+                        const char_type* copy_src = result._req->buffer().get()               + (copy_begin - req_begin);
+
+                        memcpy(copy_dst, copy_src, static_cast<size_t>(copy_end - copy_begin));
+
+                        bytes_read += copy_end - copy_begin;
+                    }
+                }
+
+                // find our request structure in the map
+                // add the pointer to the free list and remove it from the used map
+                request_ptr_map::iterator   result_request = running_requests.find(result._req);
+
+                if (result_request != running_requests.end()) {
+                    free_requests.push(result_request->second);
+                    running_requests.erase(result_request);
+                }
+                else {
+                    scm::err() << log::error
+                               << "file_core_linux::read_async(): error finding result read request in running request list" << log::end;
+
+                    cancel_async_io(running_requests);
+                    return (bytes_read);
+                }
+                assert(free_requests.size() + running_requests.size() == static_cast<scm::size_t>(allocate_requests));
+            }
+        }
+    } while(!(running_requests.empty() && next_read_chunk >= read_chunks.size()));
+
+    return (bytes_read);
+}
+
+bool
+file_core_linux::read_vectored(const detail::file_span_run&  run,
+                               char_type*                    gap_buffer,
+                               size_type                     gap_buffer_size,
+                               size_type&                    bytes_read)
+{
+    std::vector<iovec>  io_vecs;
+    std::vector<bool>   io_vec_is_gap;
+    offset_type         cur_position = run._position;
+
+    io_vecs.reserve(run._spans.size() * 2);
+    io_vec_is_gap.reserve(run._spans.size() * 2);
+
+    foreach (const file_span& span, run._spans) {
+        if (span._position < cur_position) {
+            // overlapping span, can not be expressed as part of the vectored read
+            ssize_t span_bytes_read = ::pread64(*_file_handle, span._buffer, span._size, span._position);
+            if (span_bytes_read == -1) {
+                scm::err() << log::error
+                           << "file_core_linux::read_vectored(): "
+                           << "error reading from file " << _file_path
+                           << " (" << strerror(errno) << ")" << log::end;
+                return (false);
+            }
+            bytes_read += span_bytes_read;
+            continue;
+        }
+        while (span._position > cur_position) {
+            // read the gap between the spans into the scratch buffer
+            iovec   gap_vec;
+            gap_vec.iov_base = gap_buffer;
+            gap_vec.iov_len  = static_cast<size_t>(math::min(span._position - cur_position, gap_buffer_size));
+            io_vecs.push_back(gap_vec);
+            io_vec_is_gap.push_back(true);
+
+            cur_position += gap_vec.iov_len;
+        }
+
+        iovec   span_vec;
+        span_vec.iov_base = span._buffer;
+        span_vec.iov_len  = static_cast<size_t>(span._size);
+        io_vecs.push_back(span_vec);
+        io_vec_is_gap.push_back(false);
+
+        cur_position = span._position + span._size;
+    }
+
+    // issue the vectored reads in groups of at most IOV_MAX entries
+    offset_type read_position = run._position;
+
+    for (scm::size_t v = 0; v < io_vecs.size(); v += IOV_MAX) {
+        const int   vec_count     = static_cast<int>(math::min<scm::size_t>(io_vecs.size() - v, IOV_MAX));
+        ssize_t     expected_size = 0;
+
+        for (int i = 0; i < vec_count; ++i) {
+            expected_size += io_vecs[v + i].iov_len;
+        }
+
+        ssize_t group_bytes_read = ::preadv64(*_file_handle, &io_vecs[v], vec_count, read_position);
+
+        if (group_bytes_read == -1) {
+            scm::err() << log::error
+                       << "file_core_linux::read_vectored(): "
+                       << "error reading from file " << _file_path
+                       << " (" << strerror(errno) << ")" << log::end;
+            return (false);
+        }
+
+        // account only for the bytes read into span buffers
+        ssize_t group_bytes_left = group_bytes_read;
+        for (int i = 0; i < vec_count && group_bytes_left > 0; ++i) {
+            ssize_t vec_bytes = math::min<ssize_t>(group_bytes_left, io_vecs[v + i].iov_len);
+            if (!io_vec_is_gap[v + i]) {
+                bytes_read += vec_bytes;
+            }
+            group_bytes_left -= vec_bytes;
+        }
+
+        if (group_bytes_read != expected_size) {
+            // eof
+            return (false);
+        }
+
+        read_position += group_bytes_read;
+    }
+
+    return (true);
+}
+
+bool
+file_core_linux::read_async_request(const detail::request_ptr& req) const
+{
+    if (0 != ::aio_read(req.get())) {
+        scm::err() << log::error
+                   << "file_core_linux::read_async_request(): "
+                   << "error starting read request "
+                   << "(file: "      << _file_path
+                   << ", position: " << std::hex << "0x" << req->position()
+                   << ", length: "   << std::dec << req->bytes_to_process()
+                   << ", error: "    << strerror(errno) << ")" << log::end;
+        return (false);
+    }
+
+    return (true);
+}
+
+file_core_linux::size_type
+file_core_linux::write_async(const void* input_buffer,
+                             offset_type start_position,
+                             size_type   num_bytes_to_write)
+{
+    assert(async_io_mode());
+
+    using detail::aio_request;
+    using detail::request_ptr;
+    using detail::request_ptr_queue;
+    using detail::request_ptr_map;
+
+    request_ptr_queue       free_requests;
+    request_ptr_map         running_requests;
+
+    const char* input_byte_buffer  = reinterpret_cast<const char*>(input_buffer);
+
+    _position = start_position;
+
+    size_type   position_vss            = vss_align_floor(_position);
+    size_type   position_end_vss        = vss_align_ceil(_position + num_bytes_to_write);
+    size_type   bytes_to_write_vss      = position_end_vss - position_vss;
+
+    size_type   bytes_written           = 0;
+    size_type   next_write_request_pos  = position_vss;
+
+    // a partial last sector is read back and merged with the written data (read-modify-write),
+    // the part behind the end of the file is padded with zeros and cut off again on
+    // close/set_end_of_file, partial first sectors are not supported
+    if (position_vss != _position) {
+        scm::err() << log::error
+                   << "file_core_linux::write_async(): write start position not volume sector size aligned"
+                   << " (position: " << std::hex << "0x" << _position
+                   << ", file: " << _file_path << ")" << log::end;
+        return (0);
+    }
+
+    scm::int32 allocate_requests = scm::math::min<scm::int32>(_async_requests, static_cast<scm::int32>(bytes_to_write_vss / _async_request_buffer_size + 1));
+
+    // allocate the request structs
+    for (scm::int32 i = 0; i < allocate_requests; ++i) {
+        request_ptr new_request(new aio_request(_async_request_buffer_size, _volume_sector_size));
+        new_request->aio_fildes = *_file_handle;
+        free_requests.push(new_request);
+    }
+
+    do {
+        // fill up request queue
+        while (!free_requests.empty() && next_write_request_pos < position_end_vss) {
+            // retrieve a free request structure
+            request_ptr  write_request = free_requests.front();
+            free_requests.pop();
+
+            size_type bytes_left                = position_end_vss - next_write_request_pos;
+            size_type request_bytes_to_write    = scm::math::min<size_type>(bytes_left, _async_request_buffer_size);
+
+            // setup request structure
+            write_request->position(next_write_request_pos);
+            write_request->bytes_to_process(request_bytes_to_write);
+
+            // copy the request data to the request buffer
+            size_type   copy_read_off       = write_request->position() - position_vss;
+            size_type   copy_write_bytes    = math::min<size_type>(request_bytes_to_write, num_bytes_to_write - copy_read_off);
+
+            const char_type* copy_src       = input_byte_buffer             + copy_read_off;
+            char_type*       copy_dst       = write_request->buffer().get();
+
+            size_type   tail_bytes_read     = 0;
+
+            if (copy_write_bytes < request_bytes_to_write) {
+                // the partial last sector, preserve the existing file data behind the written range
+                const size_type     tail_offset     = vss_align_floor(copy_write_bytes);
+                const offset_type   tail_position   = write_request->position() + tail_offset;
+
+                if (tail_position < _file_size) {
+                    ssize_t sector_bytes_read = ::pread64(*_file_handle, copy_dst + tail_offset, _volume_sector_size, tail_position);
+
+                    if (sector_bytes_read == -1) {
+                        scm::err() << log::error
+                                   << "file_core_linux::write_async(): "
+                                   << "error reading last sector for partial sector write "
+                                   << "(position: " << std::hex << "0x" << tail_position
+                                   << ", file: "    << _file_path
+                                   << ", error: "   << strerror(errno) << ")" << log::end;
+
+                        cancel_async_io(running_requests);
+                        return (bytes_written);
+                    }
+                    tail_bytes_read = tail_offset + sector_bytes_read;
+                }
+            }
+
+            memcpy(copy_dst, copy_src, static_cast<size_t>(copy_write_bytes));
+            if (math::max(copy_write_bytes, tail_bytes_read) < request_bytes_to_write) {
+                const size_type pad_offset = math::max(copy_write_bytes, tail_bytes_read);
+                memset(copy_dst + pad_offset, 0, static_cast<size_t>(request_bytes_to_write - pad_offset));
+            }
+
+            next_write_request_pos += request_bytes_to_write;
+            running_requests.insert(request_ptr_map::value_type(write_request.get(), write_request));
+
+            if (!write_async_request(write_request)) {
+                running_requests.erase(write_request.get());
+                cancel_async_io(running_requests);
+                return (bytes_written);
+            }
+
+            assert(free_requests.size() + running_requests.size() == static_cast<scm::size_t>(allocate_requests));
+        }
+
+        // ok now wait for requests to be filled
+        if (!running_requests.empty()) {
+            std::vector<detail::io_result>  results;
+
+            if (!query_async_results(running_requests, results)) {
+                cancel_async_io(running_requests);
+                return (bytes_written);
+            }
+
+            assert(!results.empty());
+
+            // evaluate io results
+            foreach (const detail::io_result& result, results) {
+                if (result._bytes_processed != result._req->bytes_to_process()) {
+                    scm::err() << log::error
+                               << "file_core_linux::write_async(): write result with different than requested length "
+                               << "(requested: " << result._req->bytes_to_process()
+                               << ", written: " << result._bytes_processed << ")" << log::end;
+
+                    cancel_async_io(running_requests);
+                    return (bytes_written);
+                }
+
+                // do not account for the padding of the last sector
+                bytes_written += math::min<size_type>(result._bytes_processed,
+                                                      num_bytes_to_write - (result._req->position() - position_vss));
+
+                // find our request structure in the map
+                // add the pointer to the free list and remove it from the used map
+                request_ptr_map::iterator   result_request = running_requests.find(result._req);
+
+                if (result_request != running_requests.end()) {
+                    free_requests.push(result_request->second);
+                    running_requests.erase(result_request);
+                }
+                else {
+                    scm::err() << log::error
+                               << "file_core_linux::write_async(): error finding result write request in running request list" << log::end;
+
+                    cancel_async_io(running_requests);
+                    return (bytes_written);
+                }
+                assert(free_requests.size() + running_requests.size() == static_cast<scm::size_t>(allocate_requests));
+            }
+        }
+    } while(bytes_written < num_bytes_to_write);
+
+    if (bytes_written == num_bytes_to_write) {
+        _position = _position + bytes_written;
+    }
+    if (_file_size < _position) {
+        _file_size = _position;
+    }
+
+    return (bytes_written);
+}
+
+bool
+file_core_linux::write_async_request(const detail::request_ptr& req) const
+{
+    if (0 != ::aio_write(req.get())) {
+        scm::err() << log::error
+                   << "file_core_linux::write_async_request(): "
+                   << "error starting write request "
+                   << "(file: "      << _file_path
+                   << ", position: " << std::hex << "0x" << req->position()
+                   << ", length: "   << std::dec << req->bytes_to_process()
+                   << ", error: "    << strerror(errno) << ")" << log::end;
+        return (false);
+    }
+
+    return (true);
+}
+
+bool
+file_core_linux::query_async_results(const detail::request_ptr_map&  running_requests,
+                                     std::vector<detail::io_result>& results_vec) const
+{
+    using detail::aio_request;
+    using detail::io_result;
+    using detail::request_ptr_map;
+
+    assert(results_vec.empty());
+
+    std::vector<const aiocb*>   wait_list;
+    wait_list.reserve(running_requests.size());
+
+    for (request_ptr_map::const_iterator r = running_requests.begin(); r != running_requests.end(); ++r) {
+        wait_list.push_back(r->first);
+    }
+
+    // block until at least one request completed
+    while (0 != ::aio_suspend(&wait_list.front(), static_cast<int>(wait_list.size()), 0)) {
+        if (errno != EINTR) {
+            scm::err() << log::error
+                       << "file_core_linux::query_async_results(): aio_suspend returned with error "
+                       << "(" << strerror(errno) << ")" << log::end;
+            return (false);
+        }
+    }
+
+    // collect all completed requests
+    for (request_ptr_map::const_iterator r = running_requests.begin(); r != running_requests.end(); ++r) {
+        int req_error = ::aio_error(r->first);
+
+        if (req_error == EINPROGRESS) {
+            continue;
+        }
+        else if (req_error != 0) {
+            scm::err() << log::error
+                       << "file_core_linux::query_async_results(): request returned with error "
+                       << "(file: "      << _file_path
+                       << ", position: " << std::hex << "0x" << r->first->position()
+                       << ", length: "   << std::dec << r->first->bytes_to_process()
+                       << ", error: "    << strerror(req_error) << ")" << log::end;
+            return (false);
+        }
+
+        io_result new_result;
+
+        new_result._bytes_processed = ::aio_return(r->first);
+        new_result._req             = r->first;
+
+        results_vec.push_back(new_result);
+    }
+
+    return (true);
+}
+
+void
+file_core_linux::cancel_async_io(const detail::request_ptr_map& running_requests) const
+{
+    using detail::request_ptr_map;
+
+    if (AIO_ALLDONE != ::aio_cancel(*_file_handle, 0)) {
+        // the request buffers are released when the calling read/write operation returns,
+        // so we have to wait for all requests which could not be canceled to finish
+        for (request_ptr_map::const_iterator r = running_requests.begin(); r != running_requests.end(); ++r) {
+            const aiocb* wait_list[1] = { r->first };
+            while (::aio_error(r->first) == EINPROGRESS) {
+                ::aio_suspend(wait_list, 1, 0);
+            }
+            ::aio_return(r->first);
+        }
+    }
 }
 
 file_core_linux::size_type
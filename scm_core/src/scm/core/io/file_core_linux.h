@@ -10,6 +10,7 @@
 #if SCM_PLATFORM == SCM_PLATFORM_LINUX
 
 #include <ios>
+#include <map>
 #include <vector>
 
 #include <scm/core/memory.h>
@@ -18,6 +19,15 @@
 
 namespace scm {
 namespace io {
+namespace detail {
+
+struct aio_request;
+struct io_result;
+
+typedef scm::shared_ptr<aio_request>                request_ptr;
+typedef std::map<aio_request*, request_ptr>         request_ptr_map;
+
+} // namespace detail
 
 class file_core_linux : public file_core
 {
@@ -40,6 +50,8 @@ public:
     size_type                   read(void*           output_buffer,
                                      offset_type     start_position,
                                      size_type       num_bytes_to_read);
+    size_type                   read(const file_span_vector& spans,
+                                     size_type               max_coalesce_gap);
     size_type                   write(const void*    input_buffer,
                                       offset_type    start_position,
                                       size_type      num_bytes_to_write);
@@ -50,6 +62,27 @@ public:
     // end file_core interface
 
 private:
+    size_type                   read_async(void*        output_buffer,
+                                           offset_type  start_position,
+                                           size_type    num_bytes_to_read);
+    size_type                   read_async(const detail::file_span_run_vector& runs);
+    bool                        read_async_request(const detail::request_ptr& req) const;
+
+    bool                        read_vectored(const detail::file_span_run&  run,
+                                              char_type*                    gap_buffer,
+                                              size_type                     gap_buffer_size,
+                                              size_type&                    bytes_read);
+
+    size_type                   write_async(const void* input_buffer,
+                                            offset_type start_position,
+                                            size_type   num_bytes_to_write);
+    bool                        write_async_request(const detail::request_ptr& req) const;
+
+    bool                        query_async_results(const detail::request_ptr_map&  running_requests,
+                                                    std::vector<detail::io_result>& results) const;
+
+    void                        cancel_async_io(const detail::request_ptr_map& running_requests) const;
+
     size_type                   actual_file_size() const;
     bool                        set_file_pointer(offset_type new_pos);
 
@@ -0,0 +1,284 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "file_mapping.h"
+
+#include <limits>
+
+#include <scm/core/platform/windows.h>
+
+#if SCM_PLATFORM != SCM_PLATFORM_WINDOWS
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#endif // SCM_PLATFORM != SCM_PLATFORM_WINDOWS
+
+#include <boost/filesystem.hpp>
+
+#include <scm/log.h>
+
+namespace scm {
+namespace io {
+namespace detail {
+
+#if SCM_PLATFORM == SCM_PLATFORM_WINDOWS
+
+DWORD
+file_flags_from_hint(mapping_access_hint h)
+{
+    switch (h) {
+        case MAPPING_ACCESS_SEQUENTIAL: return (FILE_FLAG_SEQUENTIAL_SCAN);
+        case MAPPING_ACCESS_RANDOM:     return (FILE_FLAG_RANDOM_ACCESS);
+        default:                        return (FILE_ATTRIBUTE_NORMAL);
+    }
+}
+
+#else // SCM_PLATFORM == SCM_PLATFORM_WINDOWS
+
+int
+madvise_from_hint(mapping_access_hint h)
+{
+    switch (h) {
+        case MAPPING_ACCESS_SEQUENTIAL: return (MADV_SEQUENTIAL);
+        case MAPPING_ACCESS_RANDOM:     return (MADV_RANDOM);
+        case MAPPING_ACCESS_WILL_NEED:  return (MADV_WILLNEED);
+        case MAPPING_ACCESS_DONT_NEED:  return (MADV_DONTNEED);
+        default:                        return (MADV_NORMAL);
+    }
+}
+
+#endif // SCM_PLATFORM == SCM_PLATFORM_WINDOWS
+
+} // namespace detail
+
+file_mapping::file_mapping()
+  : _data(0)
+  , _size(0)
+  , _mapping_handle(0)
+{
+}
+
+file_mapping::~file_mapping()
+{
+    close();
+}
+
+bool
+file_mapping::open(const std::string&     file_path,
+                   mapping_access_hint    access_hint)
+{
+    using namespace boost::filesystem;
+
+    if (is_open()) {
+        close();
+    }
+
+    path    input_file_path(file_path);
+    path    complete_input_file_path(system_complete(input_file_path));
+
+    if (!exists(complete_input_file_path) || is_directory(complete_input_file_path)) {
+        scm::err() << log::error
+                   << "file_mapping::open(): "
+                   << "file does not exist or is a directory: "
+                   << "'" << complete_input_file_path.string() << "'" << log::end;
+        return (false);
+    }
+
+    size_type   file_size = static_cast<size_type>(boost::filesystem::file_size(complete_input_file_path));
+
+    if (file_size <= 0) {
+        scm::err() << log::error
+                   << "file_mapping::open(): "
+                   << "unable to map empty file: "
+                   << "'" << complete_input_file_path.string() << "'" << log::end;
+        return (false);
+    }
+
+    if (static_cast<scm::uint64>(file_size) > static_cast<scm::uint64>((std::numeric_limits<scm::size_t>::max)())) {
+        scm::err() << log::error
+                   << "file_mapping::open(): "
+                   << "file too large to map into the address space: "
+                   << "'" << complete_input_file_path.string() << "'" << log::end;
+        return (false);
+    }
+
+#if SCM_PLATFORM == SCM_PLATFORM_WINDOWS
+
+    HANDLE  file_handle = CreateFile(complete_input_file_path.string().c_str(),
+                                     GENERIC_READ,
+                                     FILE_SHARE_READ,
+                                     0,
+                                     OPEN_EXISTING,
+                                     detail::file_flags_from_hint(access_hint),
+                                     0);
+
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        scm::err() << log::error
+                   << "file_mapping::open(): "
+                   << "error opening file: "
+                   << "'" << complete_input_file_path.string() << "'" << log::end;
+        return (false);
+    }
+
+    // the mapping object keeps a reference to the file, so the handle can be closed right away
+    HANDLE  mapping_handle = CreateFileMapping(file_handle, 0, PAGE_READONLY, 0, 0, 0);
+    CloseHandle(file_handle);
+
+    if (mapping_handle == 0) {
+        scm::err() << log::error
+                   << "file_mapping::open(): "
+                   << "error creating file mapping: "
+                   << "'" << complete_input_file_path.string() << "'" << log::end;
+        return (false);
+    }
+
+    void*   mapped_data = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+
+    if (mapped_data == 0) {
+        CloseHandle(mapping_handle);
+        scm::err() << log::error
+                   << "file_mapping::open(): "
+                   << "error mapping view of file: "
+                   << "'" << complete_input_file_path.string() << "'" << log::end;
+        return (false);
+    }
+
+    _mapping_handle = mapping_handle;
+
+#else // SCM_PLATFORM == SCM_PLATFORM_WINDOWS
+
+    int     file_handle = ::open(complete_input_file_path.string().c_str(), O_RDONLY);
+
+    if (file_handle < 0) {
+        scm::err() << log::error
+                   << "file_mapping::open(): "
+                   << "error opening file: "
+                   << "'" << complete_input_file_path.string() << "'"
+                   << " (" << strerror(errno) << ")" << log::end;
+        return (false);
+    }
+
+    // the mapping keeps a reference to the file, so the descriptor can be closed right away
+    void*   mapped_data = ::mmap(0, static_cast<scm::size_t>(file_size), PROT_READ, MAP_SHARED, file_handle, 0);
+    ::close(file_handle);
+
+    if (mapped_data == MAP_FAILED) {
+        scm::err() << log::error
+                   << "file_mapping::open(): "
+                   << "error mapping file: "
+                   << "'" << complete_input_file_path.string() << "'"
+                   << " (" << strerror(errno) << ")" << log::end;
+        return (false);
+    }
+
+#endif // SCM_PLATFORM == SCM_PLATFORM_WINDOWS
+
+    _data       = reinterpret_cast<const char*>(mapped_data);
+    _size       = file_size;
+    _file_path  = complete_input_file_path.string();
+
+    if (access_hint != MAPPING_ACCESS_NORMAL) {
+        advise(access_hint);
+    }
+
+    return (true);
+}
+
+bool
+file_mapping::is_open() const
+{
+    return (_data != 0);
+}
+
+void
+file_mapping::close()
+{
+    if (!is_open()) {
+        return;
+    }
+
+#if SCM_PLATFORM == SCM_PLATFORM_WINDOWS
+    UnmapViewOfFile(_data);
+    CloseHandle(_mapping_handle);
+#else // SCM_PLATFORM == SCM_PLATFORM_WINDOWS
+    if (::munmap(const_cast<char*>(_data), static_cast<scm::size_t>(_size)) != 0) {
+        scm::err() << log::error
+                   << "file_mapping::close(): "
+                   << "error unmapping file: "
+                   << "'" << _file_path << "'"
+                   << " (" << strerror(errno) << ")" << log::end;
+    }
+#endif // SCM_PLATFORM == SCM_PLATFORM_WINDOWS
+
+    _data           = 0;
+    _size           = 0;
+    _mapping_handle = 0;
+    _file_path.clear();
+}
+
+bool
+file_mapping::advise(mapping_access_hint  access_hint,
+                     offset_type          start_position,
+                     size_type            num_bytes) const
+{
+    if (!is_open()) {
+        return (false);
+    }
+
+    if (start_position < 0 || start_position >= _size) {
+        return (false);
+    }
+
+    if (num_bytes <= 0 || start_position + num_bytes > _size) {
+        num_bytes = _size - start_position;
+    }
+
+#if SCM_PLATFORM == SCM_PLATFORM_WINDOWS
+    // the sequential and random access hints are applied when opening the file,
+    // there is no portable per-range hint available
+    return (true);
+#else // SCM_PLATFORM == SCM_PLATFORM_WINDOWS
+    // madvise requires a page aligned start address
+    const offset_type   page_size   = static_cast<offset_type>(sysconf(_SC_PAGESIZE));
+    const offset_type   start_align = (start_position / page_size) * page_size;
+
+    if (::madvise(const_cast<char*>(_data) + start_align,
+                  static_cast<scm::size_t>(num_bytes + (start_position - start_align)),
+                  detail::madvise_from_hint(access_hint)) != 0) {
+        scm::err() << log::warning
+                   << "file_mapping::advise(): "
+                   << "error applying access hint to mapping: "
+                   << "'" << _file_path << "'"
+                   << " (" << strerror(errno) << ")" << log::end;
+        return (false);
+    }
+
+    return (true);
+#endif // SCM_PLATFORM == SCM_PLATFORM_WINDOWS
+}
+
+const char*
+file_mapping::data() const
+{
+    return (_data);
+}
+
+file_mapping::size_type
+file_mapping::size() const
+{
+    return (_size);
+}
+
+const std::string&
+file_mapping::file_path() const
+{
+    return (_file_path);
+}
+
+} // namespace io
+} // namespace scm
@@ -0,0 +1,72 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_IO_FILE_MAPPING_H_INCLUDED
+#define SCM_IO_FILE_MAPPING_H_INCLUDED
+
+#include <string>
+
+#include <boost/noncopyable.hpp>
+
+#include <scm/core/numeric_types.h>
+
+#include <scm/core/io/io_fwd.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace io {
+
+// expected access pattern to a mapped file region, forwarded to the
+// virtual memory system to tune read-ahead and page eviction
+enum mapping_access_hint {
+    MAPPING_ACCESS_NORMAL       = 0x00,
+    MAPPING_ACCESS_SEQUENTIAL,
+    MAPPING_ACCESS_RANDOM,
+    MAPPING_ACCESS_WILL_NEED,
+    MAPPING_ACCESS_DONT_NEED
+}; // enum mapping_access_hint
+
+// read-only memory mapping of a complete file
+class __scm_export(core) file_mapping : boost::noncopyable
+{
+public:
+    typedef scm::io::size_type      size_type;
+    typedef scm::io::offset_type    offset_type;
+
+public:
+    file_mapping();
+    virtual ~file_mapping();
+
+    bool                        open(const std::string&     file_path,
+                                     mapping_access_hint    access_hint = MAPPING_ACCESS_NORMAL);
+    bool                        is_open() const;
+    void                        close();
+
+    // apply an access hint to a range of the mapping, num_bytes == 0 covers
+    // the range from start_position to the end of the file
+    bool                        advise(mapping_access_hint  access_hint,
+                                       offset_type          start_position = 0,
+                                       size_type            num_bytes      = 0) const;
+
+    const char*                 data() const;
+    size_type                   size() const;
+    const std::string&          file_path() const;
+
+private:
+    const char*                 _data;
+    size_type                   _size;
+    std::string                 _file_path;
+
+    void*                       _mapping_handle;
+
+}; // class file_mapping
+
+} // namespace io
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_IO_FILE_MAPPING_H_INCLUDED
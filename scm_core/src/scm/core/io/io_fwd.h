@@ -5,12 +5,16 @@
 #ifndef SCM_CORE_IO_FWD_H_INCLUDED
 #define SCM_CORE_IO_FWD_H_INCLUDED
 
+#include <vector>
+
 #include <scm/core/memory.h>
 
 namespace scm {
 namespace io {
 
 class file;
+class file_mapping;
+struct file_span;
 
 typedef scm::int64      size_type;
 typedef size_type       offset_type;
@@ -20,6 +24,11 @@ typedef shared_ptr<const file>  file_const_ptr;
 typedef weak_ptr<file>          file_weak_ptr;
 typedef weak_ptr<const file>    file_weak_const_ptr;
 
+typedef shared_ptr<file_mapping>        file_mapping_ptr;
+typedef shared_ptr<const file_mapping>  file_mapping_const_ptr;
+
+typedef std::vector<file_span>  file_span_vector;
+
 } // namespace io
 } // namespace scm
 
@@ -0,0 +1,484 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "async_dispatcher.h"
+
+#include <cassert>
+#include <cstddef>
+#include <sstream>
+
+#include <scm/core/utilities/boost_warning_disable.h>
+#include <boost/bind.hpp>
+#include <boost/thread/tss.hpp>
+#include <scm/core/utilities/boost_warning_enable.h>
+
+#include <scm/time.h>
+#include <scm/core/log/logger.h>
+#include <scm/core/log/message.h>
+
+#if SCM_COMPILER == SCM_COMPILER_MSVC
+#   include <intrin.h>
+#endif
+
+namespace {
+
+// minimal atomic operations on scm::size_t, the queue positions and sequence numbers
+// are only accessed through these
+inline
+scm::size_t
+atomic_load_acquire(const volatile scm::size_t& v)
+{
+#if SCM_COMPILER == SCM_COMPILER_MSVC
+    const scm::size_t r = v; // volatile reads have acquire semantics
+    _ReadWriteBarrier();
+    return r;
+#elif defined(__ATOMIC_ACQUIRE)
+    return __atomic_load_n(&v, __ATOMIC_ACQUIRE);
+#else
+    const scm::size_t r = v;
+    __sync_synchronize();
+    return r;
+#endif
+}
+
+inline
+void
+atomic_store_release(volatile scm::size_t& v, scm::size_t n)
+{
+#if SCM_COMPILER == SCM_COMPILER_MSVC
+    _ReadWriteBarrier();
+    v = n; // volatile writes have release semantics
+#elif defined(__ATOMIC_RELEASE)
+    __atomic_store_n(&v, n, __ATOMIC_RELEASE);
+#else
+    __sync_synchronize();
+    v = n;
+#endif
+}
+
+inline
+bool
+atomic_compare_exchange(volatile scm::size_t& v, scm::size_t expected, scm::size_t desired)
+{
+#if SCM_COMPILER == SCM_COMPILER_MSVC
+#   if SCM_ARCHITECTURE_TYPE == SCM_ARCHITECTURE_64
+    return _InterlockedCompareExchange64(reinterpret_cast<volatile __int64*>(&v),
+                                         static_cast<__int64>(desired),
+                                         static_cast<__int64>(expected)) == static_cast<__int64>(expected);
+#   else
+    return _InterlockedCompareExchange(reinterpret_cast<volatile long*>(&v),
+                                       static_cast<long>(desired),
+                                       static_cast<long>(expected)) == static_cast<long>(expected);
+#   endif
+#else
+    return __sync_bool_compare_and_swap(&v, expected, desired);
+#endif
+}
+
+inline
+scm::size_t
+atomic_fetch_add(volatile scm::size_t& v, scm::size_t a)
+{
+#if SCM_COMPILER == SCM_COMPILER_MSVC
+#   if SCM_ARCHITECTURE_TYPE == SCM_ARCHITECTURE_64
+    return static_cast<scm::size_t>(_InterlockedExchangeAdd64(reinterpret_cast<volatile __int64*>(&v),
+                                                              static_cast<__int64>(a)));
+#   else
+    return static_cast<scm::size_t>(_InterlockedExchangeAdd(reinterpret_cast<volatile long*>(&v),
+                                                            static_cast<long>(a)));
+#   endif
+#else
+    return __sync_fetch_and_add(&v, a);
+#endif
+}
+
+inline
+scm::size_t
+atomic_exchange_zero(volatile scm::size_t& v)
+{
+    scm::size_t c = atomic_load_acquire(v);
+    while (!atomic_compare_exchange(v, c, 0)) {
+        c = atomic_load_acquire(v);
+    }
+    return c;
+}
+
+inline
+void
+atomic_full_fence()
+{
+#if SCM_COMPILER == SCM_COMPILER_MSVC
+    volatile long f = 0;
+    _InterlockedOr(&f, 0);
+#else
+    __sync_synchronize();
+#endif
+}
+
+// the dispatcher a thread is flushing, listeners logging from within the flush must not
+// wait for the queue they are drained from
+void
+no_cleanup(scm::log::async_dispatcher*)
+{
+}
+
+boost::thread_specific_ptr<scm::log::async_dispatcher>&
+flushing_dispatcher()
+{
+    // never destroyed, so logging stays possible during static destruction
+    static boost::thread_specific_ptr<scm::log::async_dispatcher>* d
+        = new boost::thread_specific_ptr<scm::log::async_dispatcher>(&no_cleanup);
+    return *d;
+}
+
+class flushing_dispatcher_guard : boost::noncopyable
+{
+public:
+    explicit flushing_dispatcher_guard(scm::log::async_dispatcher* d)
+      : _previous(flushing_dispatcher().get())
+    {
+        flushing_dispatcher().reset(d);
+    }
+    ~flushing_dispatcher_guard()
+    {
+        flushing_dispatcher().reset(_previous);
+    }
+
+private:
+    scm::log::async_dispatcher* _previous;
+}; // class flushing_dispatcher_guard
+
+} // namespace
+
+namespace scm {
+namespace log {
+
+async_dispatcher::record::record()
+  : _sequence(0),
+    _sender(0),
+    _log_level(ll_output),
+    _indent_level(0)
+{
+}
+
+async_dispatcher::async_dispatcher(logger& report_log)
+  : _report_log(report_log),
+    _index_mask(0),
+    _policy(overflow_block),
+    _running(0),
+    _enqueue_pos(0),
+    _dequeue_pos(0),
+    _dropped_total(0),
+    _dropped_unreported(0),
+    _drain_waiting(0),
+    _stop_requested(false)
+{
+}
+
+async_dispatcher::~async_dispatcher()
+{
+    stop();
+}
+
+bool
+async_dispatcher::start(scm::size_t     capacity,
+                        overflow_policy policy)
+{
+    if (running()) {
+        return false;
+    }
+
+    scm::size_t record_count = 2;
+    while (record_count < capacity) {
+        record_count <<= 1;
+    }
+
+    { // no consumer may run while the queue is replaced
+        boost::mutex::scoped_lock   drain_lock(_drain_mutex);
+
+        _records.reset(new record[record_count]);
+        for (scm::size_t i = 0; i < record_count; ++i) {
+            _records[i]._sequence = i;
+        }
+        _index_mask         = record_count - 1;
+        _policy             = policy;
+        _enqueue_pos        = 0;
+        _dequeue_pos        = 0;
+        _dropped_total      = 0;
+        _dropped_unreported = 0;
+        _stop_requested     = false;
+    }
+
+    try {
+        _drain_thread.reset(new boost::thread(boost::bind(&async_dispatcher::drain_thread_main, this)));
+        _drain_thread_id = _drain_thread->get_id();
+    }
+    catch (const boost::thread_resource_error&) {
+        _drain_thread.reset();
+        return false;
+    }
+
+    atomic_store_release(_running, 1);
+
+    return true;
+}
+
+void
+async_dispatcher::stop()
+{
+    if (!_drain_thread) {
+        return;
+    }
+
+    // new messages are dispatched synchronously from here on
+    atomic_store_release(_running, 0);
+
+    {
+        boost::mutex::scoped_lock   wake_lock(_wake_mutex);
+        _stop_requested = true;
+    }
+    _wake_condition.notify_one();
+
+    _drain_thread->join();
+    _drain_thread.reset();
+    _drain_thread_id = boost::thread::id();
+
+    flush();
+}
+
+bool
+async_dispatcher::running() const
+{
+    return atomic_load_acquire(_running) != 0;
+}
+
+scm::size_t
+async_dispatcher::capacity() const
+{
+    return _records ? _index_mask + 1 : 0;
+}
+
+async_dispatcher::overflow_policy
+async_dispatcher::policy() const
+{
+    return _policy;
+}
+
+scm::size_t
+async_dispatcher::dropped_messages() const
+{
+    return atomic_load_acquire(_dropped_total);
+}
+
+bool
+async_dispatcher::push(logger&            sender,
+                       const level&       lev,
+                       const string_type& msg)
+{
+    if (   !running()
+        || boost::this_thread::get_id() == _drain_thread_id
+        || flushing_dispatcher().get() == this)
+    {
+        return false;
+    }
+
+    const bool  fatal_message = (lev == ll_fatal);
+    scm::size_t pos           = 0;
+
+    if (!try_push(sender, lev, msg, pos)) {
+        if (_policy == overflow_block || fatal_message) {
+            do {
+                wake_drain_thread();
+                boost::this_thread::yield();
+            } while (!try_push(sender, lev, msg, pos));
+        }
+        else {
+            atomic_fetch_add(_dropped_total, 1);
+            if (_policy == overflow_count) {
+                atomic_fetch_add(_dropped_unreported, 1);
+            }
+            wake_drain_thread();
+            return true;
+        }
+    }
+
+    if (fatal_message || !running()) {
+        // fatal messages have to reach the listeners before the caller goes down, a
+        // message pushed while stopping may have been missed by the final drain
+        flush_until(pos);
+    }
+    else {
+        wake_drain_thread();
+    }
+
+    return true;
+}
+
+void
+async_dispatcher::flush()
+{
+    if (flushing_dispatcher().get() == this) {
+        return; // called from a listener, the outer flush drains the queue
+    }
+
+    flushing_dispatcher_guard   flushing(this);
+    boost::mutex::scoped_lock   drain_lock(_drain_mutex);
+    while (drain_queue()) {
+    }
+}
+
+bool
+async_dispatcher::try_push(logger&            sender,
+                           const level&       lev,
+                           const string_type& msg,
+                           scm::size_t&       out_pos)
+{
+    // bounded mpmc queue scheme of Dmitry Vyukov, the sequence number of a record tells
+    // whether it is free for the position (seq == pos) or holds a message (seq == pos + 1)
+    scm::size_t pos = atomic_load_acquire(_enqueue_pos);
+    record*     rec = 0;
+
+    for (;;) {
+        rec = &_records[pos & _index_mask];
+
+        const scm::size_t       seq = atomic_load_acquire(rec->_sequence);
+        const std::ptrdiff_t    dif = static_cast<std::ptrdiff_t>(seq - pos);
+
+        if (dif == 0) {
+            if (atomic_compare_exchange(_enqueue_pos, pos, pos + 1)) {
+                break;
+            }
+            pos = atomic_load_acquire(_enqueue_pos);
+        }
+        else if (dif < 0) {
+            return false; // queue full
+        }
+        else {
+            pos = atomic_load_acquire(_enqueue_pos);
+        }
+    }
+
+    rec->_sender        = &sender;
+    rec->_log_level     = lev.log_level();
+    rec->_indent_level  = sender.indent_level();
+    rec->_time          = time::universal_time();
+    rec->_date          = rec->_time.date();
+    rec->_message.assign(msg); // reuses the capacity of earlier messages in this slot
+
+    atomic_store_release(rec->_sequence, pos + 1);
+
+    out_pos = pos;
+
+    return true;
+}
+
+void
+async_dispatcher::flush_until(scm::size_t pos)
+{
+    flushing_dispatcher_guard   flushing(this);
+    boost::mutex::scoped_lock   drain_lock(_drain_mutex);
+
+    // messages queued before pos may still be written by their producers, the drain stops
+    // at the first unpublished slot, so wait for them instead of returning early
+    while (static_cast<std::ptrdiff_t>(atomic_load_acquire(_dequeue_pos) - pos) <= 0) {
+        if (!drain_queue()) {
+            boost::this_thread::yield();
+        }
+    }
+}
+
+bool
+async_dispatcher::drain_queue()
+{
+    // _drain_mutex has to be held by the caller
+    bool drained_any = false;
+
+    for (;;) {
+        record&             rec = _records[_dequeue_pos & _index_mask];
+        const scm::size_t   seq = atomic_load_acquire(rec._sequence);
+
+        if (seq != _dequeue_pos + 1) {
+            break; // empty or the producer of this slot is not done yet
+        }
+
+        {
+            const message msg(*rec._sender, rec._log_level, rec._message,
+                              rec._indent_level, rec._date, rec._time);
+            rec._sender->process_message(msg);
+        }
+
+        atomic_store_release(rec._sequence, _dequeue_pos + _index_mask + 1);
+        atomic_store_release(_dequeue_pos, _dequeue_pos + 1);
+        drained_any = true;
+    }
+
+    report_dropped_messages();
+
+    return drained_any;
+}
+
+void
+async_dispatcher::report_dropped_messages()
+{
+    if (atomic_load_acquire(_dropped_unreported) == 0) {
+        return;
+    }
+
+    const scm::size_t   dropped = atomic_exchange_zero(_dropped_unreported);
+    std::ostringstream  report;
+
+    report << "async_dispatcher::report_dropped_messages(): "
+           << dropped << " log messages dropped (message queue full, capacity " << capacity() << ")";
+
+    const message msg(_report_log, ll_warning, report.str());
+    _report_log.process_message(msg);
+}
+
+void
+async_dispatcher::wake_drain_thread()
+{
+    // pairs with the fence in drain_thread_main between raising _drain_waiting and
+    // checking the queue again, so either side sees the other
+    atomic_full_fence();
+    if (atomic_load_acquire(_drain_waiting) != 0) {
+        boost::mutex::scoped_lock   wake_lock(_wake_mutex);
+        _wake_condition.notify_one();
+    }
+}
+
+void
+async_dispatcher::drain_thread_main()
+{
+    for (;;) {
+        bool drained_any = false;
+        {
+            boost::mutex::scoped_lock   drain_lock(_drain_mutex);
+            drained_any = drain_queue();
+        }
+
+        if (!drained_any) {
+            boost::mutex::scoped_lock   wake_lock(_wake_mutex);
+
+            if (_stop_requested) {
+                break;
+            }
+
+            atomic_store_release(_drain_waiting, 1);
+            atomic_full_fence();
+
+            const scm::size_t   pos  = atomic_load_acquire(_dequeue_pos);
+            const record&       next = _records[pos & _index_mask];
+            if (   atomic_load_acquire(next._sequence) != pos + 1
+                && atomic_load_acquire(_dropped_unreported) == 0)
+            {
+                // the timeout only guards against missed wake ups
+                _wake_condition.timed_wait(wake_lock, boost::posix_time::milliseconds(100));
+            }
+            atomic_store_release(_drain_waiting, 0);
+        }
+    }
+}
+
+} // namespace log
+} // namespace scm
@@ -0,0 +1,139 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_CORE_LOG_ASYNC_DISPATCHER_H_INCLUDED
+#define SCM_CORE_LOG_ASYNC_DISPATCHER_H_INCLUDED
+
+#include <string>
+
+#include <scm/core/utilities/boost_warning_disable.h>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <scm/core/utilities/boost_warning_enable.h>
+
+#include <scm/core/memory.h>
+#include <scm/core/numeric_types.h>
+#include <scm/core/log/level.h>
+#include <scm/core/time/time_types.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace log {
+
+class logger;
+
+// asynchronous message dispatch of the logging core
+//  - producers copy the formatted message into a bounded multi producer single consumer
+//    ring buffer without taking any lock, a dedicated drain thread hands the messages
+//    to the listeners of the sending logger and its parents
+//  - the overflow policy decides what happens to messages arriving at a full queue
+//  - fatal messages flush the queue on the calling thread before returning, so they
+//    reached all listeners when the logging call returns
+//  - start() and stop() are meant to be called while no other thread is logging
+class __scm_export(core) async_dispatcher : boost::noncopyable
+{
+public:
+    typedef std::string         string_type;
+
+    enum overflow_policy {
+        overflow_drop       = 0x00, // discard new messages while the queue is full
+        overflow_block,             // wait for the drain thread to free a slot
+        overflow_count              // discard, the drain thread reports the number of lost messages
+    }; // enum overflow_policy
+
+public:
+    // the number of dropped messages is reported through report_log (overflow_count)
+    explicit async_dispatcher(logger& report_log);
+    virtual ~async_dispatcher();
+
+    // capacity is rounded up to the next power of two
+    bool                        start(scm::size_t     capacity = 4096,
+                                      overflow_policy policy   = overflow_block);
+    // stops the drain thread, queued messages are dispatched before returning
+    void                        stop();
+    bool                        running() const;
+
+    scm::size_t                 capacity() const;
+    overflow_policy             policy() const;
+    // messages discarded because of a full queue since start()
+    scm::size_t                 dropped_messages() const;
+
+    // returns false if the message has to be dispatched synchronously by the caller
+    // (dispatcher not running or called from within the drain thread or a flush)
+    bool                        push(logger&            sender,
+                                     const level&       lev,
+                                     const string_type& msg);
+    // dispatch all queued messages on the calling thread, no-op if called from a listener
+    // during a flush of the calling thread
+    void                        flush();
+
+private:
+    struct record
+    {
+        record();
+
+        volatile scm::size_t    _sequence;
+        logger*                 _sender;
+        level_type              _log_level;
+        int                     _indent_level;
+        time::date              _date;
+        time::ptime             _time;
+        string_type             _message;
+    }; // struct record
+
+private:
+    // out_pos receives the queue position of the pushed message
+    bool                        try_push(logger&            sender,
+                                         const level&       lev,
+                                         const string_type& msg,
+                                         scm::size_t&       out_pos);
+    bool                        drain_queue();
+    // dispatch on the calling thread until the message at pos reached the listeners
+    void                        flush_until(scm::size_t pos);
+    void                        report_dropped_messages();
+    void                        wake_drain_thread();
+    void                        drain_thread_main();
+
+private:
+    logger&                     _report_log;
+
+    boost::scoped_array<record> _records;
+    scm::size_t                 _index_mask;
+    overflow_policy             _policy;
+    volatile scm::size_t        _running;
+
+    // producer and consumer positions on separate cache lines
+    char                        _pad0[64];
+    volatile scm::size_t        _enqueue_pos;
+    char                        _pad1[64];
+    volatile scm::size_t        _dequeue_pos;
+    char                        _pad2[64];
+
+    volatile scm::size_t        _dropped_total;
+    volatile scm::size_t        _dropped_unreported;
+
+    // only one thread consumes at a time, the drain thread or a flushing producer
+    boost::mutex                _drain_mutex;
+
+    boost::mutex                _wake_mutex;
+    boost::condition_variable   _wake_condition;
+    volatile scm::size_t        _drain_waiting;
+    bool                        _stop_requested;
+
+    scm::scoped_ptr<boost::thread>  _drain_thread;
+    boost::thread::id           _drain_thread_id;
+
+}; // class async_dispatcher
+
+} // namespace log
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_CORE_LOG_ASYNC_DISPATCHER_H_INCLUDED
@@ -7,6 +7,7 @@
 #include <iostream>
 #include <cassert>
 
+#include <scm/core/log/async_dispatcher.h>
 #include <scm/core/log/logger.h>
 #include <scm/core/utilities/foreach.h>
 
@@ -23,10 +24,15 @@ logging_core::logging_core()
     _default_logger = _loggers[default_log_name];
 
     assert(!_default_logger.expired());
+
+    _async_dispatcher.reset(new async_dispatcher(*_loggers[default_log_name]));
 }
 
 logging_core::~logging_core()
 {
+    // dispatch outstanding messages while all loggers are still alive
+    _async_dispatcher->stop();
+
     foreach_reverse (logger_container::value_type& log_it, _loggers) {
         if (!log_it.second.unique()) {
             std::cerr << "logging_core::~logging_core(): <error> possible dangeling logger instance ("
@@ -45,6 +51,14 @@ logging_core::default_log() const
     return (*(_default_logger.lock()));
 }
 
+async_dispatcher&
+logging_core::async_dispatch() const
+{
+    assert(_async_dispatcher);
+
+    return (*_async_dispatcher);
+}
+
 logger&
 logging_core::get_logger(const std::string& log_name)
 {
@@ -22,6 +22,7 @@
 namespace scm {
 namespace log {
 
+class async_dispatcher;
 class logger;
 
 class __scm_export(core) logging_core : boost::noncopyable
@@ -40,6 +41,9 @@ public:
     logger&                                     default_log() const;
     logger&                                     get_logger(const std::string& log_name);
 
+    // asynchronous message dispatch, synchronous until started
+    async_dispatcher&                           async_dispatch() const;
+
 private:
     std::string                                 retrieve_parent_name(const std::string& name) const;
     logger_ptr                                  get_logger_ptr(const std::string& log_name);
@@ -50,6 +54,8 @@ private:
 
     scm::weak_ptr<logger>                       _default_logger;
 
+    scm::scoped_ptr<async_dispatcher>           _async_dispatcher;
+
     friend __scm_export(core) std::ostream& operator<<(std::ostream& os, const logging_core& rhs);
 
 }; // class core
@@ -12,17 +12,36 @@
 #include <scm/core/platform/platform.h>
 #include <scm/core/utilities/platform_warning_disable.h>
 
+// numeric log level values for preprocessor tests
+#define SCM_LOG_LEVEL_FATAL         1
+#define SCM_LOG_LEVEL_ERROR         2
+#define SCM_LOG_LEVEL_WARNING       3
+#define SCM_LOG_LEVEL_INFO          4
+#define SCM_LOG_LEVEL_OUTPUT        5
+#define SCM_LOG_LEVEL_DEBUG         6
+#define SCM_LOG_LEVEL_TRACE         7
+
+// least severe level of the SCM_LOG_* statements (see scm/log.h) compiled into the
+// code, statements of less severe levels compile to nothing
+#ifndef SCM_LOG_MIN_LEVEL
+#   if SCM_DEBUG
+#       define SCM_LOG_MIN_LEVEL    SCM_LOG_LEVEL_TRACE
+#   else
+#       define SCM_LOG_MIN_LEVEL    SCM_LOG_LEVEL_OUTPUT
+#   endif
+#endif // SCM_LOG_MIN_LEVEL
+
 namespace scm {
 namespace log {
 
 typedef enum {
-    ll_fatal       = 0x01,
-    ll_error,
-    ll_warning,
-    ll_info,
-    ll_output,
-    ll_debug,
-    ll_trace
+    ll_fatal       = SCM_LOG_LEVEL_FATAL,
+    ll_error       = SCM_LOG_LEVEL_ERROR,
+    ll_warning     = SCM_LOG_LEVEL_WARNING,
+    ll_info        = SCM_LOG_LEVEL_INFO,
+    ll_output      = SCM_LOG_LEVEL_OUTPUT,
+    ll_debug       = SCM_LOG_LEVEL_DEBUG,
+    ll_trace       = SCM_LOG_LEVEL_TRACE
 } level_type;
 
 class __scm_export(core) level : boost::less_than_comparable<level,
@@ -6,6 +6,8 @@
 
 #include <cassert>
 
+#include <scm/core/log/async_dispatcher.h>
+#include <scm/core/log/core.h>
 #include <scm/core/log/listener.h>
 #include <scm/core/log/message.h>
 #include <scm/core/log/out_stream.h>
@@ -20,6 +22,7 @@ logger::logger(const string_type&       log_name,
   : _name(log_name),
     _log_level(log_lev),
     _parent(parent),
+    _listener_count(0),
     _indent_fill_char(char_type(' ')),
     _indent_level(0),
     _max_indent_level(8),
@@ -50,9 +53,26 @@ logger::name() const
     return (_name);
 }
 
+bool
+logger::enabled(const level& lev) const
+{
+    for (const logger* l = this; l != 0; l = l->_parent.get()) {
+        if (lev <= l->_log_level && l->_listener_count > 0) {
+            return (true);
+        }
+    }
+    return (false);
+}
+
 void
 logger::log(const level& lev, const string_type& msg)
 {
+    if (!enabled(lev)) {
+        return;
+    }
+    if (core::get().async_dispatch().push(*this, lev, msg)) {
+        return;
+    }
     process_message(message(*this, lev, msg));
 }
 
@@ -119,6 +139,7 @@ logger::add_listener(const listener_ptr l)
 
     boost::mutex::scoped_lock lock(_listeners_mutex);
     _listeners.insert(l);
+    _listener_count = _listeners.size();
 }
 
 void
@@ -128,6 +149,7 @@ logger::del_listener(const listener_ptr l)
 
     boost::mutex::scoped_lock lock(_listeners_mutex);
     _listeners.erase(l);
+    _listener_count = _listeners.size();
 }
 
 void
@@ -135,6 +157,7 @@ logger::clear_listeners()
 {
     boost::mutex::scoped_lock lock(_listeners_mutex);
     _listeners.clear();
+    _listener_count = 0;
 }
 
 logger::char_type
@@ -14,6 +14,7 @@
 #include <scm/core/utilities/boost_warning_enable.h>
 
 #include <scm/core/memory.h>
+#include <scm/core/numeric_types.h>
 #include <scm/core/log/level.h>
 
 #include <scm/core/platform/platform.h>
@@ -22,6 +23,7 @@
 namespace scm {
 namespace log {
 
+class async_dispatcher;
 class listener;
 class message;
 class out_stream;
@@ -52,6 +54,10 @@ public:
 
     const string_type&              name() const;
 
+    // true if a message of level lev reaches at least one listener of this logger or
+    // its parents, used to skip formatting of filtered messages
+    bool                            enabled(const level& lev) const;
+
     void                            log(const level& lev, const string_type& msg);
 
     out_stream                      trace();
@@ -78,12 +84,15 @@ public:
 private:
     void                            process_message(const message& msg);
 
+    friend class async_dispatcher;
+
 private:
     logger_ptr                      _parent;
     level                           _log_level;
     string_type                     _name;
 
     listener_container              _listeners;
+    scm::size_t                     _listener_count; // read without lock by enabled()
     boost::mutex                    _listeners_mutex;
 
     char_type                       _indent_fill_char;
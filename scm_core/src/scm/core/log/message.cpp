@@ -15,10 +15,22 @@ namespace log {
 message::message(const logger_type& ref_log, const level& lev, const string_type& msg)
   : _sending_logger(ref_log),
     _log_level(lev),
+    _indent_level(ref_log.indent_level()),
     _message(msg)
 {
-    _date   = time::universal_date();
     _time   = time::universal_time();
+    _date   = _time.date();
+}
+
+message::message(const logger_type& ref_log, const level& lev, const string_type& msg,
+                 int indent_level, const time::date& msg_date, const time::ptime& msg_time)
+  : _sending_logger(ref_log),
+    _log_level(lev),
+    _indent_level(indent_level),
+    _message(msg),
+    _date(msg_date),
+    _time(msg_time)
+{
 }
 
 message::~message()
@@ -54,7 +66,7 @@ message::decorate_message(const string_type& decoration,
     stream_type     raw_msg_stream(in_message);
     string_type     raw_msg_line;
     bool            indent_decoration = false;
-    scm::size_t     log_indention_width = sending_logger().indent_level() * sending_logger().indent_width();
+    scm::size_t     log_indention_width = _indent_level * sending_logger().indent_width();
 
     while (std::getline(raw_msg_stream, raw_msg_line)) {
         if (   (0 < decoration_indent)
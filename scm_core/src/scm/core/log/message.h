@@ -29,6 +29,9 @@ public:
 
 public:
     message(const logger_type& ref_log, const level& lev, const string_type& msg);
+    // message recorded earlier with the indention level and time of its creation
+    message(const logger_type& ref_log, const level& lev, const string_type& msg,
+            int indent_level, const time::date& msg_date, const time::ptime& msg_time);
     virtual ~message();
 
     const logger_type&      sending_logger() const;
@@ -49,6 +52,7 @@ private:
 private:
     const logger_type&      _sending_logger;
     level                   _log_level;
+    int                     _indent_level;
     string_type             _message;
     mutable string_type     _plain_message;
     mutable string_type     _decorated_message;
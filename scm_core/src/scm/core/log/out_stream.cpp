@@ -4,31 +4,167 @@
 
 #include "out_stream.h"
 
+#include <algorithm>
+#include <vector>
+
+#include <scm/core/utilities/boost_warning_disable.h>
+#include <boost/thread/tss.hpp>
 #include <boost/utility.hpp>
+#include <scm/core/utilities/boost_warning_enable.h>
 
 #include <scm/core/log/logger.h>
 
 namespace scm {
 namespace log {
+namespace detail {
+
+// stream buffer writing directly into a string which keeps its capacity between messages
+class format_streambuf : public std::basic_streambuf<out_stream::char_type>
+{
+public:
+    typedef out_stream::char_type                   char_type;
+    typedef out_stream::string_type                 string_type;
+    typedef std::char_traits<char_type>             traits_type;
+    typedef traits_type::int_type                   int_type;
+
+public:
+    format_streambuf() : _text(256, char_type(0)) {
+        reset();
+    }
+
+    bool                empty() const {
+        return (pptr() == pbase());
+    }
+    // the buffer has to be reset before writing to it again
+    const string_type&  text() {
+        _text.resize(pptr() - pbase());
+        return (_text);
+    }
+    void                reset() {
+        _text.resize(_text.capacity());
+        setp(&_text[0], &_text[0] + _text.size());
+    }
+
+protected:
+    virtual int_type    overflow(int_type c) {
+        if (traits_type::eq_int_type(c, traits_type::eof())) {
+            return (traits_type::not_eof(c));
+        }
+        const std::ptrdiff_t used = pptr() - pbase();
+
+        _text.resize((std::max)(_text.size() * 2, string_type::size_type(256)));
+        setp(&_text[0], &_text[0] + _text.size());
+        pbump(static_cast<int>(used));
+
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+
+        return (c);
+    }
+
+private:
+    string_type         _text;
+
+}; // class format_streambuf
+
+class format_buffer
+{
+public:
+    typedef out_stream::ostream_type    ostream_type;
+
+public:
+    format_buffer() : _stream(&_streambuf), _in_use(false) {
+        _default_flags      = _stream.flags();
+        _default_precision  = _stream.precision();
+        _default_fill       = _stream.fill();
+    }
+
+    void                begin_message() {
+        _in_use = true;
+        _stream.clear();
+        _stream.flags(_default_flags);
+        _stream.precision(_default_precision);
+        _stream.width(0);
+        _stream.fill(_default_fill);
+    }
+
+    format_streambuf    _streambuf;
+    ostream_type        _stream;
+    bool                _in_use;
+
+    std::ios_base::fmtflags     _default_flags;
+    std::streamsize             _default_precision;
+    ostream_type::char_type     _default_fill;
+
+}; // class format_buffer
+
+// per thread format buffers, a thread usually needs only one, more are created when
+// several out_streams are alive at the same time (e.g. logging while formatting)
+class format_buffer_pool
+{
+public:
+    ~format_buffer_pool() {
+        for (std::size_t i = 0; i < _buffers.size(); ++i) {
+            delete _buffers[i];
+        }
+    }
+
+    format_buffer*      acquire() {
+        for (std::size_t i = 0; i < _buffers.size(); ++i) {
+            if (!_buffers[i]->_in_use) {
+                _buffers[i]->begin_message();
+                return (_buffers[i]);
+            }
+        }
+        _buffers.push_back(new format_buffer());
+        _buffers.back()->begin_message();
+        return (_buffers.back());
+    }
+
+private:
+    std::vector<format_buffer*>     _buffers;
+
+}; // class format_buffer_pool
+
+format_buffer_pool&
+thread_format_buffers()
+{
+    // never destroyed, so logging stays possible during static destruction
+    static boost::thread_specific_ptr<format_buffer_pool>* pools = new boost::thread_specific_ptr<format_buffer_pool>();
+
+    format_buffer_pool* p = pools->get();
+    if (p == 0) {
+        p = new format_buffer_pool();
+        pools->reset(p);
+    }
+    return (*p);
+}
+
+} // namespace detail
 
 out_stream::out_stream(scm::log::level_type log_lev,
                        scm::log::logger&    ref_logger)
   : _log_level(log_lev),
     _message_level(log_lev),
-    _logger(boost::addressof(ref_logger))
+    _logger(boost::addressof(ref_logger)),
+    _buffer(0)
 {
+    _enabled = _logger->enabled(_message_level);
 }
 
 out_stream::out_stream(const out_stream& os)
   : _log_level(os._log_level),
     _message_level(os._message_level),
-    _logger(os._logger)
+    _logger(os._logger),
+    _enabled(os._enabled),
+    _buffer(0)
 {
 }
 
 out_stream::~out_stream()
 {
     flush();
+    release_buffer();
 }
 
 out_stream&
@@ -37,6 +173,7 @@ out_stream::operator=(const out_stream& os)
     _log_level      = os._log_level;
     _message_level  = os._message_level;
     _logger         = os._logger;
+    _enabled        = os._enabled;
 
     return (*this);
 }
@@ -54,6 +191,13 @@ out_stream::switch_log_level(const scm::log::level& lev)
         flush();
     }
     _message_level = lev;
+    _enabled       = _message_level <= _log_level && _logger->enabled(_message_level);
+}
+
+bool
+out_stream::enabled() const
+{
+    return (_enabled);
 }
 
 logger&
@@ -71,24 +215,48 @@ out_stream::associated_logger() const
 void
 out_stream::flush()
 {
-    if (!_ostream.str().empty()) {
-        _logger->log(_message_level, _ostream.str());
+    if (_buffer == 0 || _buffer->_streambuf.empty()) {
+        return;
     }
 
-    _ostream.clear();
-    _ostream.str("");
+    _logger->log(_message_level, _buffer->_streambuf.text());
+
+    _buffer->_streambuf.reset();
+    _buffer->_stream.clear();
 }
 
 out_stream::ostream_type&
 out_stream::ostream()
 {
-    return (_ostream);
+    if (_buffer == 0) {
+        acquire_buffer();
+    }
+    return (_buffer->_stream);
 }
 
 const out_stream::ostream_type&
 out_stream::ostream() const
 {
-    return (_ostream);
+    if (_buffer == 0) {
+        acquire_buffer();
+    }
+    return (_buffer->_stream);
+}
+
+void
+out_stream::acquire_buffer() const
+{
+    _buffer = detail::thread_format_buffers().acquire();
+}
+
+void
+out_stream::release_buffer()
+{
+    if (_buffer) {
+        _buffer->_streambuf.reset();
+        _buffer->_in_use = false;
+        _buffer          = 0;
+    }
 }
 
 out_stream&
@@ -103,8 +271,8 @@ out_stream::operator<<(out_stream& (*manip_func)(out_stream&))
 out_stream&
 out_stream::operator<<(std::ios_base& (*_Pfn)(std::ios_base&))
 {
-    if (_message_level <= _log_level) {
-        _ostream << _Pfn;
+    if (_enabled) {
+        ostream() << _Pfn;
     }
     return (*this);
 }
@@ -5,8 +5,8 @@
 #ifndef SCM_CORE_LOG_OUT_STREAM_H_INCLUDED
 #define SCM_CORE_LOG_OUT_STREAM_H_INCLUDED
 
+#include <ostream>
 #include <string>
-#include <sstream>
 
 #include <boost/format/format_fwd.hpp>
 
@@ -19,13 +19,19 @@
 namespace scm {
 namespace log {
 
+namespace detail {
+class format_buffer;
+} // namespace detail
+
+// messages are formatted into reusable per thread buffers, nothing is formatted if the
+// message level does not reach any listener of the associated logger
 class __scm_export(core) out_stream
 {
 public:
-    typedef logger                      logger_type;
-    typedef logger_type::char_type      char_type;
-    typedef logger_type::string_type    string_type;
-    typedef logger_type::ostream_type   ostream_type;
+    typedef logger                              logger_type;
+    typedef logger_type::char_type              char_type;
+    typedef logger_type::string_type            string_type;
+    typedef std::basic_ostream<char_type>       ostream_type;
 
 public:
     out_stream(scm::log::level_type log_lev,
@@ -37,6 +43,8 @@ public:
 
     const level&            log_level() const;
     void                    switch_log_level(const scm::log::level& lev);
+    // the current message level reaches a listener
+    bool                    enabled() const;
 
     logger&                 associated_logger();
     const logger&           associated_logger() const;
@@ -51,12 +59,17 @@ public:
     out_stream&             operator<<(out_stream& (*manip_func)(out_stream&));
     out_stream&             operator<<(std::ios_base& (*_Pfn)(std::ios_base&));
 
+protected:
+    void                    acquire_buffer() const;
+    void                    release_buffer();
+
 protected:
     logger*                 _logger;
     level                   _log_level;
     level                   _message_level;
+    bool                    _enabled;
 
-    ostream_type            _ostream;
+    mutable detail::format_buffer*  _buffer;
 
 }; // out_stream
 
@@ -13,8 +13,8 @@ template<typename T>
 out_stream&
 out_stream::operator<<(const T& rhs)
 {
-    if (_message_level <= _log_level) {
-        _ostream << rhs;
+    if (_enabled) {
+        ostream() << rhs;
     }
 
     return (*this);
@@ -61,7 +61,7 @@ fatal(out_stream& os)
 out_stream&
 nline(out_stream& os)
 {
-    if (os.log_level() <= os.associated_logger().log_level()) {
+    if (os.enabled()) {
         out_stream::ostream_type& oss = os.ostream();
         oss.put(oss.widen('\n'));
     }
@@ -70,7 +70,7 @@ nline(out_stream& os)
 
 out_stream& end(out_stream& os)
 {
-    if (os.log_level() <= os.associated_logger().log_level()) {
+    if (os.enabled()) {
         os.ostream() << std::endl; 
         os.flush();
     }
@@ -0,0 +1,222 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+
+#include <boost/bind.hpp>
+
+#include <scm/log.h>
+
+namespace {
+
+// work distribution state of a single parallel_for() call, the ranges are handed
+// out to the participating threads in order of their requests
+struct parallel_range_state
+{
+    parallel_range_state(scm::size_t                                  count,
+                         scm::size_t                                  grain,
+                         const scm::thread_pool::range_task_type&     task)
+      : _count(count)
+      , _grain(grain)
+      , _next(0)
+      , _active_helpers(0)
+      , _task(task)
+    {
+    }
+
+    bool next_range(scm::size_t& begin, scm::size_t& end) {
+        boost::mutex::scoped_lock   lock(_mutex);
+        if (_next >= _count) {
+            return false;
+        }
+        begin  = _next;
+        end    = std::min(_count, _next + _grain);
+        _next  = end;
+        return true;
+    }
+
+    void process_ranges() {
+        scm::size_t b = 0;
+        scm::size_t e = 0;
+        while (next_range(b, e)) {
+            _task(b, e);
+        }
+    }
+
+    void wait_helpers() {
+        boost::mutex::scoped_lock   lock(_mutex);
+        while (_active_helpers > 0) {
+            _helpers_done.wait(lock);
+        }
+    }
+
+    const scm::size_t                           _count;
+    const scm::size_t                           _grain;
+    scm::size_t                                 _next;
+
+    unsigned                                    _active_helpers;
+    boost::mutex                                _mutex;
+    boost::condition_variable                   _helpers_done;
+
+    const scm::thread_pool::range_task_type&    _task;
+}; // struct parallel_range_state
+
+// signals the end of a helper task even if the range task throws
+struct parallel_range_helper_guard
+{
+    explicit parallel_range_helper_guard(parallel_range_state& s) : _state(s) {}
+    ~parallel_range_helper_guard() {
+        {
+            boost::mutex::scoped_lock   lock(_state._mutex);
+            --_state._active_helpers;
+        }
+        _state._helpers_done.notify_all();
+    }
+    parallel_range_state&   _state;
+}; // struct parallel_range_helper_guard
+
+void
+parallel_range_helper(parallel_range_state* s)
+{
+    parallel_range_helper_guard guard(*s);
+    s->process_ranges();
+}
+
+} // namespace
+
+namespace scm {
+
+thread_pool::thread_pool(unsigned thread_count)
+  : _active_tasks(0)
+  , _running(true)
+  , _thread_count(thread_count)
+{
+    if (_thread_count == 0) {
+        _thread_count = std::max(1u, boost::thread::hardware_concurrency());
+    }
+
+    for (unsigned i = 0; i < _thread_count; ++i) {
+        _threads.create_thread(boost::bind(&thread_pool::run, this));
+    }
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        boost::mutex::scoped_lock   lock(_mutex);
+        _running = false;
+    }
+    _task_condition.notify_all();
+    _threads.join_all();
+}
+
+unsigned
+thread_pool::thread_count() const
+{
+    return _thread_count;
+}
+
+void
+thread_pool::submit(const task_type& task)
+{
+    {
+        boost::mutex::scoped_lock   lock(_mutex);
+        _tasks.push_back(task);
+    }
+    _task_condition.notify_one();
+}
+
+void
+thread_pool::wait_idle()
+{
+    boost::mutex::scoped_lock   lock(_mutex);
+    while (!_tasks.empty() || _active_tasks > 0) {
+        _idle_condition.wait(lock);
+    }
+}
+
+void
+thread_pool::parallel_for(scm::size_t            count,
+                          scm::size_t            grain,
+                          const range_task_type& task)
+{
+    grain = std::max<scm::size_t>(1, grain);
+
+    const scm::size_t range_count = (count + grain - 1) / grain;
+
+    if (range_count == 0) {
+        return;
+    }
+    if (range_count == 1) {
+        task(0, count);
+        return;
+    }
+
+    parallel_range_state    state(count, grain, task);
+    const unsigned          helper_count = static_cast<unsigned>(std::min<scm::size_t>(_thread_count, range_count - 1));
+
+    state._active_helpers = helper_count;
+    for (unsigned h = 0; h < helper_count; ++h) {
+        submit(boost::bind(&parallel_range_helper, &state));
+    }
+
+    // the state lives on this stack frame, so wait for all helpers to leave it
+    try {
+        state.process_ranges();
+    }
+    catch (...) {
+        state.wait_helpers();
+        throw;
+    }
+    state.wait_helpers();
+}
+
+void
+thread_pool::run()
+{
+    for (;;) {
+        task_type   task;
+        {
+            boost::mutex::scoped_lock   lock(_mutex);
+
+            while (_running && _tasks.empty()) {
+                _task_condition.wait(lock);
+            }
+            if (!_running) {
+                return;
+            }
+
+            task.swap(_tasks.front());
+            _tasks.pop_front();
+            ++_active_tasks;
+        }
+
+        try {
+            task();
+        }
+        catch (std::exception& e) {
+            scm::err() << log::error
+                       << "thread_pool::run(): "
+                       << "unhandled exception in task: " << e.what() << log::end;
+        }
+        catch (...) {
+            scm::err() << log::error
+                       << "thread_pool::run(): "
+                       << "unhandled unknown exception in task." << log::end;
+        }
+
+        {
+            boost::mutex::scoped_lock   lock(_mutex);
+            --_active_tasks;
+            if (_tasks.empty() && _active_tasks == 0) {
+                _idle_condition.notify_all();
+            }
+        }
+    }
+}
+
+} // namespace scm
@@ -0,0 +1,73 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_CORE_UTILITIES_THREAD_POOL_H_INCLUDED
+#define SCM_CORE_UTILITIES_THREAD_POOL_H_INCLUDED
+
+#include <deque>
+
+#include <scm/core/utilities/boost_warning_disable.h>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <scm/core/utilities/boost_warning_enable.h>
+
+#include <scm/core/numeric_types.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+
+// fixed set of worker threads executing submitted tasks in submission order
+//  - tasks are not supposed to throw, escaping exceptions are logged and dropped
+//  - parallel_for() must not be called from within a task of the same pool
+class __scm_export(core) thread_pool : boost::noncopyable
+{
+public:
+    typedef boost::function<void ()>                            task_type;
+    typedef boost::function<void (scm::size_t, scm::size_t)>    range_task_type;
+
+public:
+    // thread_count = 0 creates one thread per hardware thread
+    explicit thread_pool(unsigned thread_count = 0);
+    virtual ~thread_pool();
+
+    unsigned                    thread_count() const;
+
+    void                        submit(const task_type& task);
+    // block until all submitted tasks are finished
+    void                        wait_idle();
+
+    // call task(begin, end) for consecutive ranges of at most grain elements
+    // covering [0, count), the calling thread works on ranges too and the
+    // call returns when all ranges are processed
+    void                        parallel_for(scm::size_t            count,
+                                             scm::size_t            grain,
+                                             const range_task_type& task);
+
+protected:
+    void                        run();
+
+protected:
+    mutable boost::mutex        _mutex;
+    boost::condition_variable   _task_condition;
+    boost::condition_variable   _idle_condition;
+
+    std::deque<task_type>       _tasks;
+    unsigned                    _active_tasks;
+    bool                        _running;
+
+    boost::thread_group         _threads;
+    unsigned                    _thread_count;
+
+}; // class thread_pool
+
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_CORE_UTILITIES_THREAD_POOL_H_INCLUDED
@@ -7,6 +7,8 @@
 
 #include <string>
 
+#include <boost/preprocessor/expand.hpp>
+
 #include <scm/core/log/core.h>
 #include <scm/core/log/logger.h>
 #include <scm/core/log/out_stream.h>
@@ -27,6 +29,43 @@ __scm_export(core) log::out_stream  err();
 
 } // namespace scm
 
+// log statements checking the level before formatting the message, statements less severe
+// than SCM_LOG_MIN_LEVEL compile to nothing
+//  usage: SCM_LOG_DEBUG(scm::logger("scm.app"), "value: " << v);
+#define SCM_LOG_STATEMENT(LOG, LEV, X)                                                  \
+    do {                                                                                \
+        scm::log::logger& scm_log_statement_logger = (LOG);                             \
+        if (scm_log_statement_logger.enabled(LEV)) {                                    \
+            scm::log::out_stream(LEV, scm_log_statement_logger) << BOOST_PP_EXPAND(X)   \
+                                                               << scm::log::end;        \
+        }                                                                               \
+    } while (false)
+
+#define SCM_LOG_FATAL(LOG, X)   SCM_LOG_STATEMENT(LOG, scm::log::ll_fatal, X)
+#define SCM_LOG_ERROR(LOG, X)   SCM_LOG_STATEMENT(LOG, scm::log::ll_error, X)
+#define SCM_LOG_WARNING(LOG, X) SCM_LOG_STATEMENT(LOG, scm::log::ll_warning, X)
+
+#if SCM_LOG_MIN_LEVEL >= SCM_LOG_LEVEL_INFO
+#   define SCM_LOG_INFO(LOG, X)     SCM_LOG_STATEMENT(LOG, scm::log::ll_info, X)
+#else
+#   define SCM_LOG_INFO(LOG, X)     static_cast<void>(0)
+#endif
+#if SCM_LOG_MIN_LEVEL >= SCM_LOG_LEVEL_OUTPUT
+#   define SCM_LOG_OUTPUT(LOG, X)   SCM_LOG_STATEMENT(LOG, scm::log::ll_output, X)
+#else
+#   define SCM_LOG_OUTPUT(LOG, X)   static_cast<void>(0)
+#endif
+#if SCM_LOG_MIN_LEVEL >= SCM_LOG_LEVEL_DEBUG
+#   define SCM_LOG_DEBUG(LOG, X)    SCM_LOG_STATEMENT(LOG, scm::log::ll_debug, X)
+#else
+#   define SCM_LOG_DEBUG(LOG, X)    static_cast<void>(0)
+#endif
+#if SCM_LOG_MIN_LEVEL >= SCM_LOG_LEVEL_TRACE
+#   define SCM_LOG_TRACE(LOG, X)    SCM_LOG_STATEMENT(LOG, scm::log::ll_trace, X)
+#else
+#   define SCM_LOG_TRACE(LOG, X)    static_cast<void>(0)
+#endif
+
 #include <scm/core/utilities/platform_warning_enable.h>
 
 #endif // SCM_CORE_LOG_H_INCLUDED
@@ -269,6 +269,60 @@ buffer::buffer_data(const render_device& ren_dev,
     }
 }
 
+bool
+buffer::buffer_storage(const render_device& ren_dev,
+                       const buffer_desc&   in_desc,
+                       const void*          initial_data,
+                       const access_mode    in_map_access)
+{
+    const opengl::gl_core& glcore = ren_dev.opengl_api();
+
+    gl_assert(glcore, entering buffer::buffer_storage());
+
+    util::gl_error          glerror(glcore);
+
+    if (0 == object_id()) {
+        state().set(object_state::OS_ERROR_INVALID_OPERATION);
+        return false;
+    }
+
+    if (!glcore.extension_ARB_buffer_storage) {
+        state().set(object_state::OS_ERROR_INVALID_OPERATION);
+        return false;
+    }
+
+    // the storage has to allow every mapping later requested with in_map_access
+    const unsigned storage_flags =   util::gl_buffer_access_mode(in_map_access)
+                                   & (  GL_MAP_READ_BIT | GL_MAP_WRITE_BIT
+                                      | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+
+    if (SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS && 0 != glcore.glNamedBufferStorageEXT) {
+        glcore.glNamedBufferStorageEXT(object_id(),
+                                       in_desc._size,
+                                       initial_data,
+                                       storage_flags);
+    }
+    else {
+        util::buffer_binding_guard save_guard(glcore, object_target(), object_binding());
+
+        glcore.glBindBuffer(object_target(), object_id());
+        glcore.glBufferStorage(object_target(),
+                               in_desc._size,
+                               initial_data,
+                               storage_flags);
+    }
+
+    if (glerror) {
+        _descriptor = buffer_desc();
+        state().set(glerror.to_object_state());
+        return false;
+    }
+    else {
+        _descriptor = in_desc;
+        return true;
+    }
+}
+
 bool
 buffer::buffer_sub_data(const render_device& ren_dev,
                         scm::size_t          offset,
@@ -69,6 +69,12 @@ protected:
     bool                        buffer_data(const render_device& ren_dev,
                                             const buffer_desc&   in_desc,
                                             const void*          initial_data);
+    // immutable storage (ARB_buffer_storage) for buffers mapped with the persistent access modes,
+    // the buffer can not be reallocated using buffer_data afterwards
+    bool                        buffer_storage(const render_device& ren_dev,
+                                               const buffer_desc&   in_desc,
+                                               const void*          initial_data,
+                                               const access_mode    in_map_access);
     bool                        buffer_sub_data(const render_device& ren_dev,
                                                 scm::size_t          offset,
                                                 scm::size_t          size,
@@ -102,6 +108,7 @@ protected:
 
     friend class render_device;
     friend class render_context;
+    friend class stream_allocator;
     friend class frame_buffer;
     friend class vertex_array;
     friend class texture_buffer;
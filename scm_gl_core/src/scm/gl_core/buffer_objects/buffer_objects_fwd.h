@@ -11,6 +11,7 @@ namespace scm {
 namespace gl {
 
 class buffer;
+class stream_allocator;
 class stream_output_setup;
 class transform_feedback;
 class vertex_format;
@@ -18,6 +19,8 @@ class vertex_array;
 
 typedef shared_ptr<buffer>                      buffer_ptr;
 typedef shared_ptr<const buffer>                buffer_cptr;
+typedef shared_ptr<stream_allocator>            stream_allocator_ptr;
+typedef shared_ptr<const stream_allocator>      stream_allocator_cptr;
 typedef shared_ptr<transform_feedback>          transform_feedback_ptr;
 typedef shared_ptr<const transform_feedback>    transform_feedback_cptr;
 typedef shared_ptr<vertex_format>               vertex_format_ptr;
@@ -0,0 +1,173 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "stream_allocator.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include <scm/gl_core/log.h>
+#include <scm/gl_core/buffer_objects/buffer.h>
+#include <scm/gl_core/render_device/context.h>
+#include <scm/gl_core/render_device/device.h>
+#include <scm/gl_core/sync_objects/fence_sync.h>
+
+namespace scm {
+namespace gl {
+namespace {
+
+inline
+scm::size_t
+align_offset(scm::size_t in_offset, scm::size_t in_alignment)
+{
+    return ((in_offset + in_alignment - 1) / in_alignment) * in_alignment;
+}
+
+} // namespace
+
+stream_allocator::stream_allocator(render_device& in_device,
+                                   scm::size_t    in_frame_capacity,
+                                   int            in_frame_count)
+  : render_device_child(in_device)
+  , _buffer_data(0)
+  , _frame_capacity(0)
+  , _default_alignment(1)
+  , _current_frame(0)
+  , _current_offset(0)
+{
+    if (   0 >= in_frame_count
+        || 0 == in_frame_capacity) {
+        state().set(object_state::OS_ERROR_INVALID_VALUE);
+        return;
+    }
+
+    _default_alignment = static_cast<scm::size_t>((std::max)(1, in_device.capabilities()._uniform_buffer_offset_alignment));
+    _frame_capacity    = align_offset(in_frame_capacity, _default_alignment);
+    _frame_fences.resize(in_frame_count);
+    // the first begin_frame() starts at region 0
+    _current_frame     = in_frame_count - 1;
+
+    const scm::size_t buffer_size = _frame_capacity * in_frame_count;
+
+    // the buffer object is created without storage, the immutable storage is allocated below
+    _buffer = in_device.create_buffer(BIND_UNIFORM_BUFFER, USAGE_STREAM_DRAW, 0);
+    if (!_buffer) {
+        state().set(object_state::OS_BAD);
+        return;
+    }
+    if (!_buffer->buffer_storage(in_device, buffer_desc(BIND_UNIFORM_BUFFER, USAGE_STREAM_DRAW, buffer_size),
+                                 0, ACCESS_WRITE_PERSISTENT_COHERENT)) {
+        state().set(_buffer->state().get());
+        return;
+    }
+
+    // mapped once, the mapping stays valid while the buffer is used for drawing
+    _buffer_data = static_cast<uint8*>(_buffer->map_range(*in_device.main_context(), 0, buffer_size,
+                                                          ACCESS_WRITE_PERSISTENT_COHERENT));
+    if (0 == _buffer_data) {
+        state().set(object_state::OS_ERROR_INVALID_OPERATION);
+        return;
+    }
+}
+
+stream_allocator::~stream_allocator()
+{
+    if (_buffer && 0 != _buffer_data) {
+        _buffer->unmap(*parent_device().main_context());
+    }
+    _frame_fences.clear();
+    _buffer.reset();
+}
+
+bool
+stream_allocator::begin_frame(const render_context_ptr& in_context)
+{
+    assert(ok());
+
+    _current_frame  = (_current_frame + 1) % frame_count();
+    _current_offset = 0;
+
+    fence_sync_ptr& region_fence = _frame_fences[_current_frame];
+    if (region_fence) {
+        // only blocks if the gpu is still frame_count frames behind
+        const sync_wait_result wr = in_context->sync_client_wait(region_fence);
+        region_fence.reset();
+
+        if (SYNC_WAIT_FAILED == wr) {
+            glerr() << log::error << "stream_allocator::begin_frame(): "
+                    << "waiting for frame region " << _current_frame << " failed." << log::end;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void
+stream_allocator::end_frame(const render_context_ptr& in_context)
+{
+    assert(ok());
+
+    _frame_fences[_current_frame] = in_context->insert_fence_sync();
+}
+
+stream_allocation
+stream_allocator::allocate(scm::size_t in_size,
+                           scm::size_t in_alignment)
+{
+    stream_allocation   new_alloc;
+
+    if (0 == _buffer_data) {
+        return new_alloc;
+    }
+
+    // the absolute offset in the buffer is aligned, the frame regions are only aligned to the
+    // default alignment (e.g. offset / stride has to be a whole base vertex)
+    const scm::size_t   alignment    = (0 == in_alignment) ? _default_alignment : in_alignment;
+    const scm::size_t   frame_base   = static_cast<scm::size_t>(_current_frame) * _frame_capacity;
+    const scm::size_t   alloc_offset = align_offset(frame_base + _current_offset, alignment) - frame_base;
+
+    if (alloc_offset + in_size > _frame_capacity) {
+        glerr() << log::error << "stream_allocator::allocate(): "
+                << "frame region exhausted (requested: " << in_size << "byte, "
+                << "used: " << _current_offset << "byte, capacity: " << _frame_capacity << "byte)." << log::end;
+        return new_alloc;
+    }
+
+    _current_offset = alloc_offset + in_size;
+
+    new_alloc._buffer = _buffer;
+    new_alloc._offset = frame_base + alloc_offset;
+    new_alloc._size   = in_size;
+    new_alloc._data   = _buffer_data + new_alloc._offset;
+
+    return new_alloc;
+}
+
+const buffer_ptr&
+stream_allocator::stream_buffer() const
+{
+    return _buffer;
+}
+
+scm::size_t
+stream_allocator::frame_capacity() const
+{
+    return _frame_capacity;
+}
+
+int
+stream_allocator::frame_count() const
+{
+    return static_cast<int>(_frame_fences.size());
+}
+
+scm::size_t
+stream_allocator::frame_bytes_used() const
+{
+    return _current_offset;
+}
+
+} // namespace gl
+} // namespace scm
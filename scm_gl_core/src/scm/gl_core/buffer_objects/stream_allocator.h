@@ -0,0 +1,83 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_CORE_STREAM_ALLOCATOR_H_INCLUDED
+#define SCM_GL_CORE_STREAM_ALLOCATOR_H_INCLUDED
+
+#include <vector>
+
+#include <scm/core/numeric_types.h>
+#include <scm/core/memory.h>
+
+#include <scm/gl_core/gl_core_fwd.h>
+#include <scm/gl_core/render_device/device_child.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+struct __scm_export(gl_core) stream_allocation {
+    stream_allocation() : _offset(0), _size(0), _data(0) {}
+
+    bool            valid() const { return 0 != _data; }
+
+    buffer_ptr      _buffer;
+    scm::size_t     _offset;
+    scm::size_t     _size;
+    void*           _data;
+}; // struct stream_allocation
+
+// ring buffer for data written once per frame (uniform blocks, dynamic vertices)
+//  - one immutable buffer, persistently and coherently mapped for its whole lifetime, so no
+//    map or unmap calls are issued once the allocator is created
+//  - the buffer is split into frame_count regions, begin_frame() moves to the next region and
+//    waits for the fence inserted by end_frame() when the region was last used
+//  - allocations are bound using their offset: bind_uniform_buffer(_buffer, point, _offset, _size)
+//    or as vertex data using first/base vertex _offset / stride (allocate with the vertex stride
+//    as alignment)
+class __scm_export(gl_core) stream_allocator : public render_device_child
+{
+public:
+    virtual ~stream_allocator();
+
+    bool                        begin_frame(const render_context_ptr& in_context);
+    void                        end_frame(const render_context_ptr& in_context);
+
+    // in_alignment 0 uses the uniform buffer offset alignment of the device
+    stream_allocation           allocate(scm::size_t in_size,
+                                         scm::size_t in_alignment = 0);
+
+    const buffer_ptr&           stream_buffer() const;
+    scm::size_t                 frame_capacity() const;
+    int                         frame_count() const;
+    scm::size_t                 frame_bytes_used() const;
+
+protected:
+    stream_allocator(render_device& in_device,
+                     scm::size_t    in_frame_capacity,
+                     int            in_frame_count);
+
+protected:
+    buffer_ptr                  _buffer;
+    uint8*                      _buffer_data;
+
+    scm::size_t                 _frame_capacity;
+    scm::size_t                 _default_alignment;
+    std::vector<fence_sync_ptr> _frame_fences;
+    int                         _current_frame;
+    scm::size_t                 _current_offset;
+
+private:
+    friend class render_device;
+
+}; // class stream_allocator
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_CORE_STREAM_ALLOCATOR_H_INCLUDED
@@ -78,6 +78,9 @@ shader_stage_string(shader_stage s)
     case STAGE_TESS_EVALUATION_SHADER: return ("tesselation evaluation shader");break;
     case STAGE_TESS_CONTROL_SHADER:    return ("tesselation control shader");break;
 #endif // SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_400
+#if SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_430
+    case STAGE_COMPUTE_SHADER:         return ("compute shader");break;
+#endif // SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_430
 
     default: break;
     }
@@ -26,7 +26,10 @@ enum buffer_binding
     BIND_UNIFORM_BUFFER              = 0x10,
     BIND_TEXTURE_BUFFER              = 0x20,
     BIND_TRANSFORM_FEEDBACK_BUFFER   = 0x40,
-    BIND_ATOMIC_COUNTER_BUFFER       = 0x80
+    BIND_ATOMIC_COUNTER_BUFFER       = 0x80,
+    BIND_DRAW_INDIRECT_BUFFER        = 0x100,
+    BIND_SHADER_STORAGE_BUFFER       = 0x200,
+    BIND_DISPATCH_INDIRECT_BUFFER    = 0x400
 }; // enum buffer_binding
 
 enum buffer_usage
@@ -55,10 +58,31 @@ enum access_mode
     ACCESS_WRITE_INVALIDATE_RANGE,
     ACCESS_WRITE_INVALIDATE_BUFFER,
     ACCESS_WRITE_UNSYNCHRONIZED,
+    ACCESS_WRITE_PERSISTENT_COHERENT,   // requires immutable buffer storage (ARB_buffer_storage)
 
     ACCESS_COUNT
 }; // enum access_mode
 
+// which accesses have to see the results of preceding incoherent shader writes
+// (image stores, shader storage buffers, atomic counters)
+enum memory_barrier_mask
+{
+    BARRIER_VERTEX_ATTRIB_ARRAY     = 0x0001,
+    BARRIER_ELEMENT_ARRAY           = 0x0002,
+    BARRIER_UNIFORM                 = 0x0004,
+    BARRIER_TEXTURE_FETCH           = 0x0008,
+    BARRIER_SHADER_IMAGE_ACCESS     = 0x0010,
+    BARRIER_COMMAND                 = 0x0020,
+    BARRIER_PIXEL_BUFFER            = 0x0040,
+    BARRIER_TEXTURE_UPDATE          = 0x0080,
+    BARRIER_BUFFER_UPDATE           = 0x0100,
+    BARRIER_FRAMEBUFFER             = 0x0200,
+    BARRIER_TRANSFORM_FEEDBACK      = 0x0400,
+    BARRIER_ATOMIC_COUNTER          = 0x0800,
+    BARRIER_SHADER_STORAGE          = 0x1000,
+    BARRIER_ALL                     = 0x1fff
+}; // enum memory_barrier_mask
+
 enum primitive_type
 {
     PRIMITIVE_POINTS                    = 0x00,
@@ -176,6 +200,9 @@ enum shader_stage
     STAGE_TESS_EVALUATION_SHADER,
     STAGE_TESS_CONTROL_SHADER,
 #endif // SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_400
+#if SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_430
+    STAGE_COMPUTE_SHADER,
+#endif // SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_430
     SHADER_STAGE_COUNT
 }; // enum shader_stage
 
@@ -21,11 +21,11 @@ __scm_export(gl_core) log::out_stream  glerr();
 } // namespace gl
 } // namespace scm
 
-#if SCM_GL_DEBUG
+#if SCM_GL_DEBUG && SCM_LOG_MIN_LEVEL >= SCM_LOG_LEVEL_DEBUG
 #define SCM_GL_DGB(X) scm::gl::glerr() << log::debug << BOOST_PP_EXPAND(X) << log::end
 #else
 #define SCM_GL_DGB(X) static_cast<void>(0)
-#endif // SCM_GL_DEBUG
+#endif // SCM_GL_DEBUG && SCM_LOG_MIN_LEVEL >= SCM_LOG_LEVEL_DEBUG
 
 #define SCM_GL_LOG_ONCE(L, X)                                                       \
     static bool scm_gl_log_once_done = false;                                       \
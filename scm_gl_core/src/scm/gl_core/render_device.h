@@ -6,6 +6,7 @@
 #define SCM_GL_CORE_RENDER_DEVICE_H_INCLUDED
 
 #include <scm/gl_core/render_device/render_device_fwd.h>
+#include <scm/gl_core/render_device/command_list.h>
 #include <scm/gl_core/render_device/context.h>
 #include <scm/gl_core/render_device/context_guards.h>
 #include <scm/gl_core/render_device/device.h>
@@ -0,0 +1,592 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "command_list.h"
+
+#include <cstring>
+
+#include <scm/gl_core/render_device/context.h>
+#include <scm/gl_core/shader_objects/uniform.h>
+
+namespace scm {
+namespace gl {
+
+// command_list ///////////////////////////////////////////////////////////////////////////////////
+command_list::command_list()
+{
+}
+
+command_list::~command_list()
+{
+}
+
+void
+command_list::clear()
+{
+    _commands.clear();
+    _uniform_data.clear();
+}
+
+bool
+command_list::empty() const
+{
+    return _commands.empty();
+}
+
+scm::size_t
+command_list::size() const
+{
+    return _commands.size();
+}
+
+void
+command_list::apply()
+{
+    _commands.push_back(apply_command());
+}
+
+void
+command_list::bind_program(const program_ptr& in_program)
+{
+    bind_program_command c;
+    c._program = in_program;
+    _commands.push_back(c);
+}
+
+void
+command_list::bind_vertex_array(const vertex_array_ptr& in_vertex_array)
+{
+    bind_vertex_array_command c;
+    c._vertex_array = in_vertex_array;
+    _commands.push_back(c);
+}
+
+void
+command_list::bind_index_buffer(const buffer_ptr& in_buffer, const primitive_topology in_topology, const data_type in_index_type, const scm::size_t in_offset)
+{
+    bind_index_buffer_command c;
+    c._binding._index_buffer       = in_buffer;
+    c._binding._primitive_topology = in_topology;
+    c._binding._index_data_type    = in_index_type;
+    c._binding._index_data_offset  = in_offset;
+    _commands.push_back(c);
+}
+
+void
+command_list::bind_draw_indirect_buffer(const buffer_ptr& in_buffer)
+{
+    bind_draw_indirect_buffer_command c;
+    c._buffer = in_buffer;
+    _commands.push_back(c);
+}
+
+void
+command_list::bind_uniform_buffer(const buffer_ptr& in_buffer,
+                                  const unsigned    in_bind_point,
+                                  const scm::size_t in_offset,
+                                  const scm::size_t in_size)
+{
+    bind_buffer_command c;
+    c._target     = bind_buffer_command::UNIFORM_BUFFER;
+    c._buffer     = in_buffer;
+    c._bind_point = in_bind_point;
+    c._offset     = in_offset;
+    c._size       = in_size;
+    _commands.push_back(c);
+}
+
+void
+command_list::bind_atomic_counter_buffer(const buffer_ptr& in_buffer,
+                                         const unsigned    in_bind_point,
+                                         const scm::size_t in_offset,
+                                         const scm::size_t in_size)
+{
+    bind_buffer_command c;
+    c._target     = bind_buffer_command::ATOMIC_COUNTER_BUFFER;
+    c._buffer     = in_buffer;
+    c._bind_point = in_bind_point;
+    c._offset     = in_offset;
+    c._size       = in_size;
+    _commands.push_back(c);
+}
+
+void
+command_list::bind_storage_buffer(const buffer_ptr& in_buffer,
+                                  const unsigned    in_bind_point,
+                                  const scm::size_t in_offset,
+                                  const scm::size_t in_size)
+{
+    bind_buffer_command c;
+    c._target     = bind_buffer_command::STORAGE_BUFFER;
+    c._buffer     = in_buffer;
+    c._bind_point = in_bind_point;
+    c._offset     = in_offset;
+    c._size       = in_size;
+    _commands.push_back(c);
+}
+
+void
+command_list::bind_texture(const texture_ptr&       in_texture_image,
+                           const sampler_state_ptr& in_sampler_state,
+                           const unsigned           in_unit)
+{
+    bind_texture_command c;
+    c._texture       = in_texture_image;
+    c._sampler_state = in_sampler_state;
+    c._unit          = in_unit;
+    _commands.push_back(c);
+}
+
+void
+command_list::bind_image(const texture_ptr&       in_texture_image,
+                               data_format        in_format,
+                               access_mode        in_access,
+                               unsigned           in_unit,
+                               int                in_level,
+                               int                in_layer)
+{
+    bind_image_command c;
+    c._texture = in_texture_image;
+    c._format  = in_format;
+    c._access  = in_access;
+    c._unit    = in_unit;
+    c._level   = in_level;
+    c._layer   = in_layer;
+    _commands.push_back(c);
+}
+
+void
+command_list::set_depth_stencil_state(const depth_stencil_state_ptr& in_ds_state, unsigned in_stencil_ref)
+{
+    depth_stencil_state_command c;
+    c._state       = in_ds_state;
+    c._stencil_ref = in_stencil_ref;
+    _commands.push_back(c);
+}
+
+void
+command_list::set_rasterizer_state(const rasterizer_state_ptr& in_rs_state, float in_line_width, float in_point_size)
+{
+    rasterizer_state_command c;
+    c._state      = in_rs_state;
+    c._line_width = in_line_width;
+    c._point_size = in_point_size;
+    _commands.push_back(c);
+}
+
+void
+command_list::set_blend_state(const blend_state_ptr& in_bl_state, const math::vec4f& in_blend_color)
+{
+    blend_state_command c;
+    c._state       = in_bl_state;
+    c._blend_color = in_blend_color;
+    _commands.push_back(c);
+}
+
+void
+command_list::set_frame_buffer(const frame_buffer_ptr& in_frame_buffer)
+{
+    frame_buffer_command c;
+    c._frame_buffer   = in_frame_buffer;
+    c._default_target = FRAMEBUFFER_BACK;
+    _commands.push_back(c);
+}
+
+void
+command_list::set_default_frame_buffer(const frame_buffer_target in_target)
+{
+    frame_buffer_command c;
+    c._default_target = in_target;
+    _commands.push_back(c);
+}
+
+void
+command_list::set_viewport(const viewport& in_vp)
+{
+    set_viewports(viewport_array(in_vp));
+}
+
+void
+command_list::set_viewports(const viewport_array& in_vp)
+{
+    viewports_command c = { in_vp };
+    _commands.push_back(c);
+}
+
+void
+command_list::draw_arrays(const primitive_topology in_topology, const int in_first_index, const int in_count)
+{
+    draw_arrays_command c;
+    c._topology       = in_topology;
+    c._first_index    = in_first_index;
+    c._count          = in_count;
+    c._instanced      = false;
+    c._instance_count = 1;
+    c._base_instance  = 0;
+    _commands.push_back(c);
+}
+
+void
+command_list::draw_elements(const int in_count, const int in_start_index, const int in_base_vertex)
+{
+    draw_elements_command c;
+    c._count          = in_count;
+    c._start_index    = in_start_index;
+    c._base_vertex    = in_base_vertex;
+    c._instanced      = false;
+    c._instance_count = 1;
+    c._base_instance  = 0;
+    _commands.push_back(c);
+}
+
+void
+command_list::draw_arrays_instanced(const primitive_topology in_topology,
+                                    const int                in_first_index,
+                                    const int                in_count,
+                                    const int                in_instance_count,
+                                    const unsigned           in_base_instance)
+{
+    draw_arrays_command c;
+    c._topology       = in_topology;
+    c._first_index    = in_first_index;
+    c._count          = in_count;
+    c._instanced      = true;
+    c._instance_count = in_instance_count;
+    c._base_instance  = in_base_instance;
+    _commands.push_back(c);
+}
+
+void
+command_list::draw_elements_instanced(const int      in_count,
+                                      const int      in_instance_count,
+                                      const int      in_start_index,
+                                      const int      in_base_vertex,
+                                      const unsigned in_base_instance)
+{
+    draw_elements_command c;
+    c._count          = in_count;
+    c._start_index    = in_start_index;
+    c._base_vertex    = in_base_vertex;
+    c._instanced      = true;
+    c._instance_count = in_instance_count;
+    c._base_instance  = in_base_instance;
+    _commands.push_back(c);
+}
+
+void
+command_list::draw_arrays_indirect(const primitive_topology in_topology,
+                                   const scm::size_t        in_offset)
+{
+    draw_indirect_command c;
+    c._indexed    = false;
+    c._topology   = in_topology;
+    c._multi_draw = false;
+    c._draw_count = 1;
+    c._offset     = in_offset;
+    c._stride     = 0;
+    _commands.push_back(c);
+}
+
+void
+command_list::draw_elements_indirect(const scm::size_t in_offset)
+{
+    draw_indirect_command c;
+    c._indexed    = true;
+    c._topology   = PRIMITIVE_TRIANGLE_LIST; // taken from the index buffer binding
+    c._multi_draw = false;
+    c._draw_count = 1;
+    c._offset     = in_offset;
+    c._stride     = 0;
+    _commands.push_back(c);
+}
+
+void
+command_list::multi_draw_arrays_indirect(const primitive_topology in_topology,
+                                         const int                in_draw_count,
+                                         const scm::size_t        in_offset,
+                                         const int                in_stride)
+{
+    draw_indirect_command c;
+    c._indexed    = false;
+    c._topology   = in_topology;
+    c._multi_draw = true;
+    c._draw_count = in_draw_count;
+    c._offset     = in_offset;
+    c._stride     = in_stride;
+    _commands.push_back(c);
+}
+
+void
+command_list::multi_draw_elements_indirect(const int         in_draw_count,
+                                           const scm::size_t in_offset,
+                                           const int         in_stride)
+{
+    draw_indirect_command c;
+    c._indexed    = true;
+    c._topology   = PRIMITIVE_TRIANGLE_LIST; // taken from the index buffer binding
+    c._multi_draw = true;
+    c._draw_count = in_draw_count;
+    c._offset     = in_offset;
+    c._stride     = in_stride;
+    _commands.push_back(c);
+}
+
+void
+command_list::clear_color_buffer(const frame_buffer_ptr& in_frame_buffer,
+                                 const unsigned          in_buffer,
+                                 const math::vec4f&      in_clear_color)
+{
+    clear_color_command c;
+    c._frame_buffer   = in_frame_buffer;
+    c._default_target = FRAMEBUFFER_BACK;
+    c._buffer         = static_cast<int>(in_buffer);
+    c._clear_color    = in_clear_color;
+    _commands.push_back(c);
+}
+
+void
+command_list::clear_color_buffers(const frame_buffer_ptr& in_frame_buffer,
+                                  const math::vec4f&      in_clear_color)
+{
+    clear_color_command c;
+    c._frame_buffer   = in_frame_buffer;
+    c._default_target = FRAMEBUFFER_BACK;
+    c._buffer         = -1;
+    c._clear_color    = in_clear_color;
+    _commands.push_back(c);
+}
+
+void
+command_list::clear_depth_stencil_buffer(const frame_buffer_ptr& in_frame_buffer,
+                                         const float             in_clear_depth,
+                                         const int               in_clear_stencil)
+{
+    clear_depth_stencil_command c;
+    c._frame_buffer  = in_frame_buffer;
+    c._clear_depth   = in_clear_depth;
+    c._clear_stencil = in_clear_stencil;
+    _commands.push_back(c);
+}
+
+void
+command_list::clear_default_color_buffer(const frame_buffer_target in_target,
+                                         const math::vec4f&        in_clear_color)
+{
+    clear_color_command c;
+    c._default_target = in_target;
+    c._buffer         = -1;
+    c._clear_color    = in_clear_color;
+    _commands.push_back(c);
+}
+
+void
+command_list::clear_default_depth_stencil_buffer(const float in_clear_depth,
+                                                 const int   in_clear_stencil)
+{
+    clear_depth_stencil_command c;
+    c._clear_depth   = in_clear_depth;
+    c._clear_stencil = in_clear_stencil;
+    _commands.push_back(c);
+}
+
+void
+command_list::record_uniform(const uniform_ptr& in_uniform,
+                             int                in_element,
+                             const void*        in_value,
+                             scm::size_t        in_value_size)
+{
+    uniform_command c;
+    c._uniform     = in_uniform;
+    c._element     = in_element;
+    c._data_offset = _uniform_data.size();
+
+    _uniform_data.resize(_uniform_data.size() + in_value_size);
+    std::memcpy(&_uniform_data[c._data_offset], in_value, in_value_size);
+
+    _commands.push_back(c);
+}
+
+void
+command_list::execute(render_context& in_context) const
+{
+    replay_visitor replay(in_context, _uniform_data);
+
+    command_array::const_iterator c = _commands.begin();
+    command_array::const_iterator e = _commands.end();
+    for (; c != e; ++c) {
+        boost::apply_visitor(replay, *c);
+    }
+}
+
+// command_list::replay_visitor //////////////////////////////////////////////////////////////////
+command_list::replay_visitor::replay_visitor(render_context&   in_context,
+                                             const data_array& in_uniform_data)
+  : _context(in_context)
+  , _uniform_data(in_uniform_data)
+{
+}
+
+void
+command_list::replay_visitor::operator()(const apply_command&) const
+{
+    _context.apply();
+}
+
+void
+command_list::replay_visitor::operator()(const bind_program_command& c) const
+{
+    _context.bind_program(c._program);
+}
+
+void
+command_list::replay_visitor::operator()(const bind_vertex_array_command& c) const
+{
+    _context.bind_vertex_array(c._vertex_array);
+}
+
+void
+command_list::replay_visitor::operator()(const bind_index_buffer_command& c) const
+{
+    _context.set_index_buffer_binding(c._binding);
+}
+
+void
+command_list::replay_visitor::operator()(const bind_draw_indirect_buffer_command& c) const
+{
+    _context.bind_draw_indirect_buffer(c._buffer);
+}
+
+void
+command_list::replay_visitor::operator()(const bind_buffer_command& c) const
+{
+    switch (c._target) {
+        case bind_buffer_command::UNIFORM_BUFFER:         _context.bind_uniform_buffer(c._buffer, c._bind_point, c._offset, c._size);break;
+        case bind_buffer_command::ATOMIC_COUNTER_BUFFER:  _context.bind_atomic_counter_buffer(c._buffer, c._bind_point, c._offset, c._size);break;
+        case bind_buffer_command::STORAGE_BUFFER:         _context.bind_storage_buffer(c._buffer, c._bind_point, c._offset, c._size);break;
+    }
+}
+
+void
+command_list::replay_visitor::operator()(const bind_texture_command& c) const
+{
+    _context.bind_texture(c._texture, c._sampler_state, c._unit);
+}
+
+void
+command_list::replay_visitor::operator()(const bind_image_command& c) const
+{
+    _context.bind_image(c._texture, c._format, c._access, c._unit, c._level, c._layer);
+}
+
+void
+command_list::replay_visitor::operator()(const depth_stencil_state_command& c) const
+{
+    _context.set_depth_stencil_state(c._state, c._stencil_ref);
+}
+
+void
+command_list::replay_visitor::operator()(const rasterizer_state_command& c) const
+{
+    _context.set_rasterizer_state(c._state, c._line_width, c._point_size);
+}
+
+void
+command_list::replay_visitor::operator()(const blend_state_command& c) const
+{
+    _context.set_blend_state(c._state, c._blend_color);
+}
+
+void
+command_list::replay_visitor::operator()(const frame_buffer_command& c) const
+{
+    if (c._frame_buffer) {
+        _context.set_frame_buffer(c._frame_buffer);
+    }
+    else {
+        _context.set_default_frame_buffer(c._default_target);
+    }
+}
+
+void
+command_list::replay_visitor::operator()(const viewports_command& c) const
+{
+    _context.set_viewports(c._viewports);
+}
+
+void
+command_list::replay_visitor::operator()(const uniform_command& c) const
+{
+    c._uniform->value_data(c._element, &_uniform_data[c._data_offset]);
+}
+
+void
+command_list::replay_visitor::operator()(const draw_arrays_command& c) const
+{
+    if (c._instanced) {
+        _context.draw_arrays_instanced(c._topology, c._first_index, c._count, c._instance_count, c._base_instance);
+    }
+    else {
+        _context.draw_arrays(c._topology, c._first_index, c._count);
+    }
+}
+
+void
+command_list::replay_visitor::operator()(const draw_elements_command& c) const
+{
+    if (c._instanced) {
+        _context.draw_elements_instanced(c._count, c._instance_count, c._start_index, c._base_vertex, c._base_instance);
+    }
+    else {
+        _context.draw_elements(c._count, c._start_index, c._base_vertex);
+    }
+}
+
+void
+command_list::replay_visitor::operator()(const draw_indirect_command& c) const
+{
+    if (c._indexed) {
+        if (c._multi_draw) {
+            _context.multi_draw_elements_indirect(c._draw_count, c._offset, c._stride);
+        }
+        else {
+            _context.draw_elements_indirect(c._offset);
+        }
+    }
+    else {
+        if (c._multi_draw) {
+            _context.multi_draw_arrays_indirect(c._topology, c._draw_count, c._offset, c._stride);
+        }
+        else {
+            _context.draw_arrays_indirect(c._topology, c._offset);
+        }
+    }
+}
+
+void
+command_list::replay_visitor::operator()(const clear_color_command& c) const
+{
+    if (!c._frame_buffer) {
+        _context.clear_default_color_buffer(c._default_target, c._clear_color);
+    }
+    else if (c._buffer < 0) {
+        _context.clear_color_buffers(c._frame_buffer, c._clear_color);
+    }
+    else {
+        _context.clear_color_buffer(c._frame_buffer, static_cast<unsigned>(c._buffer), c._clear_color);
+    }
+}
+
+void
+command_list::replay_visitor::operator()(const clear_depth_stencil_command& c) const
+{
+    if (c._frame_buffer) {
+        _context.clear_depth_stencil_buffer(c._frame_buffer, c._clear_depth, c._clear_stencil);
+    }
+    else {
+        _context.clear_default_depth_stencil_buffer(c._clear_depth, c._clear_stencil);
+    }
+}
+
+} // namespace gl
+} // namespace scm
@@ -0,0 +1,311 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_CORE_COMMAND_LIST_H_INCLUDED
+#define SCM_GL_CORE_COMMAND_LIST_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/variant.hpp>
+
+#include <scm/core/math.h>
+#include <scm/core/memory.h>
+#include <scm/core/numeric_types.h>
+
+#include <scm/gl_core/constants.h>
+#include <scm/gl_core/data_formats.h>
+#include <scm/gl_core/data_types.h>
+#include <scm/gl_core/gl_core_fwd.h>
+#include <scm/gl_core/frame_buffer_objects/viewport.h>
+#include <scm/gl_core/render_device/context.h>
+#include <scm/gl_core/shader_objects/uniform.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// deferred render_context commands
+//  - records the binding, state object, uniform, draw and clear calls of the render_context
+//    without touching OpenGL, any thread can record into its own command list
+//  - render_context::execute() replays the commands in order on the thread owning the
+//    context through the regular render_context api, redundant bindings and state changes
+//    are filtered by the context as for direct calls
+//  - like with direct calls, indexed and indirect draws need the bindings applied first
+//    (apply() command)
+//  - the recorded objects are kept alive until the list is cleared
+class __scm_export(gl_core) command_list : boost::noncopyable
+{
+protected:
+    struct apply_command {
+    };
+    struct bind_program_command {
+        program_ptr                     _program;
+    };
+    struct bind_vertex_array_command {
+        vertex_array_ptr                _vertex_array;
+    };
+    struct bind_index_buffer_command {
+        render_context::index_buffer_binding _binding;
+    };
+    struct bind_draw_indirect_buffer_command {
+        buffer_ptr                      _buffer;
+    };
+    struct bind_buffer_command {
+        enum buffer_target {
+            UNIFORM_BUFFER = 0x00,
+            ATOMIC_COUNTER_BUFFER,
+            STORAGE_BUFFER
+        };
+        buffer_target                   _target;
+        buffer_ptr                      _buffer;
+        unsigned                        _bind_point;
+        scm::size_t                     _offset;
+        scm::size_t                     _size;
+    };
+    struct bind_texture_command {
+        texture_ptr                     _texture;
+        sampler_state_ptr               _sampler_state;
+        unsigned                        _unit;
+    };
+    struct bind_image_command {
+        texture_ptr                     _texture;
+        data_format                     _format;
+        access_mode                     _access;
+        unsigned                        _unit;
+        int                             _level;
+        int                             _layer;
+    };
+    struct depth_stencil_state_command {
+        depth_stencil_state_ptr         _state;
+        unsigned                        _stencil_ref;
+    };
+    struct rasterizer_state_command {
+        rasterizer_state_ptr            _state;
+        float                           _line_width;
+        float                           _point_size;
+    };
+    struct blend_state_command {
+        blend_state_ptr                 _state;
+        math::vec4f                     _blend_color;
+    };
+    struct frame_buffer_command {
+        frame_buffer_ptr                _frame_buffer;      // default frame buffer if empty
+        frame_buffer_target             _default_target;
+    };
+    struct viewports_command {
+        viewport_array                  _viewports;
+    };
+    struct uniform_command {
+        uniform_ptr                     _uniform;
+        int                             _element;
+        scm::size_t                     _data_offset;       // value in _uniform_data
+    };
+    struct draw_arrays_command {
+        primitive_topology              _topology;
+        int                             _first_index;
+        int                             _count;
+        bool                            _instanced;
+        int                             _instance_count;
+        unsigned                        _base_instance;
+    };
+    struct draw_elements_command {
+        int                             _count;
+        int                             _start_index;
+        int                             _base_vertex;
+        bool                            _instanced;
+        int                             _instance_count;
+        unsigned                        _base_instance;
+    };
+    struct draw_indirect_command {
+        bool                            _indexed;
+        primitive_topology              _topology;
+        bool                            _multi_draw;
+        int                             _draw_count;
+        scm::size_t                     _offset;
+        int                             _stride;
+    };
+    struct clear_color_command {
+        frame_buffer_ptr                _frame_buffer;      // default frame buffer if empty
+        frame_buffer_target             _default_target;
+        int                             _buffer;            // < 0: all color buffers
+        math::vec4f                     _clear_color;
+    };
+    struct clear_depth_stencil_command {
+        frame_buffer_ptr                _frame_buffer;      // default frame buffer if empty
+        float                           _clear_depth;
+        int                             _clear_stencil;
+    };
+
+    typedef boost::variant<apply_command,
+                           bind_program_command,
+                           bind_vertex_array_command,
+                           bind_index_buffer_command,
+                           bind_draw_indirect_buffer_command,
+                           bind_buffer_command,
+                           bind_texture_command,
+                           bind_image_command,
+                           depth_stencil_state_command,
+                           rasterizer_state_command,
+                           blend_state_command,
+                           frame_buffer_command,
+                           viewports_command,
+                           uniform_command,
+                           draw_arrays_command,
+                           draw_elements_command,
+                           draw_indirect_command,
+                           clear_color_command,
+                           clear_depth_stencil_command>    command;
+    typedef std::vector<command>                            command_array;
+    typedef std::vector<char>                               data_array;
+
+    // issues the recorded commands through the render_context api
+    class replay_visitor : public boost::static_visitor<void>
+    {
+    public:
+        replay_visitor(render_context&   in_context,
+                       const data_array& in_uniform_data);
+
+        void operator()(const apply_command& c) const;
+        void operator()(const bind_program_command& c) const;
+        void operator()(const bind_vertex_array_command& c) const;
+        void operator()(const bind_index_buffer_command& c) const;
+        void operator()(const bind_draw_indirect_buffer_command& c) const;
+        void operator()(const bind_buffer_command& c) const;
+        void operator()(const bind_texture_command& c) const;
+        void operator()(const bind_image_command& c) const;
+        void operator()(const depth_stencil_state_command& c) const;
+        void operator()(const rasterizer_state_command& c) const;
+        void operator()(const blend_state_command& c) const;
+        void operator()(const frame_buffer_command& c) const;
+        void operator()(const viewports_command& c) const;
+        void operator()(const uniform_command& c) const;
+        void operator()(const draw_arrays_command& c) const;
+        void operator()(const draw_elements_command& c) const;
+        void operator()(const draw_indirect_command& c) const;
+        void operator()(const clear_color_command& c) const;
+        void operator()(const clear_depth_stencil_command& c) const;
+
+    private:
+        render_context&         _context;
+        const data_array&       _uniform_data;
+    }; // class replay_visitor
+
+public:
+    command_list();
+    /*virtual*/ ~command_list();
+
+    // releases all recorded commands, the storage is kept for the next recording
+    void                        clear();
+    bool                        empty() const;
+    scm::size_t                 size() const;
+
+    // render_context api /////////////////////////////////////////////////////////////////////////
+    void                        apply();
+
+    void                        bind_program(const program_ptr& in_program);
+
+    void                        bind_vertex_array(const vertex_array_ptr& in_vertex_array);
+    void                        bind_index_buffer(const buffer_ptr& in_buffer, const primitive_topology in_topology, const data_type in_index_type, const scm::size_t in_offset = 0);
+    void                        bind_draw_indirect_buffer(const buffer_ptr& in_buffer);
+
+    void                        bind_uniform_buffer(const buffer_ptr& in_buffer,
+                                                    const unsigned    in_bind_point,
+                                                    const scm::size_t in_offset = 0,
+                                                    const scm::size_t in_size   = 0);
+    void                        bind_atomic_counter_buffer(const buffer_ptr& in_buffer,
+                                                           const unsigned    in_bind_point,
+                                                           const scm::size_t in_offset = 0,
+                                                           const scm::size_t in_size   = 0);
+    void                        bind_storage_buffer(const buffer_ptr& in_buffer,
+                                                    const unsigned    in_bind_point,
+                                                    const scm::size_t in_offset = 0,
+                                                    const scm::size_t in_size   = 0);
+
+    void                        bind_texture(const texture_ptr&       in_texture_image,
+                                             const sampler_state_ptr& in_sampler_state,
+                                             const unsigned           in_unit);
+    void                        bind_image(const texture_ptr&       in_texture_image,
+                                                 data_format        in_format,
+                                                 access_mode        in_access,
+                                                 unsigned           in_unit,
+                                                 int                in_level = 0,
+                                                 int                in_layer = -1);
+
+    void                        set_depth_stencil_state(const depth_stencil_state_ptr& in_ds_state, unsigned in_stencil_ref = 0);
+    void                        set_rasterizer_state(const rasterizer_state_ptr& in_rs_state, float in_line_width = 1.0f, float in_point_size = 1.0f);
+    void                        set_blend_state(const blend_state_ptr& in_bl_state, const math::vec4f& in_blend_color = math::vec4f(1.0f, 1.0f, 1.0f, 1.0f));
+
+    void                        set_frame_buffer(const frame_buffer_ptr& in_frame_buffer);
+    void                        set_default_frame_buffer(const frame_buffer_target in_target = FRAMEBUFFER_BACK);
+    void                        set_viewport(const viewport& in_vp);
+    void                        set_viewports(const viewport_array& in_vp);
+
+    // uniform values are copied into the command list and set on replay
+    template<typename T> void   uniform(const program_ptr& in_program, const std::string& in_name, const T& in_value);
+    template<typename T> void   uniform(const program_ptr& in_program, const std::string& in_name, int in_element, const T& in_value);
+    template<typename T> void   uniform(const uniform_handle<T>& in_uniform, const T& in_value);
+    template<typename T> void   uniform(const uniform_handle<T>& in_uniform, int in_element, const T& in_value);
+
+    void                        draw_arrays(const primitive_topology in_topology, const int in_first_index, const int in_count);
+    void                        draw_elements(const int in_count, const int in_start_index = 0, const int in_base_vertex = 0);
+    void                        draw_arrays_instanced(const primitive_topology in_topology,
+                                                      const int                in_first_index,
+                                                      const int                in_count,
+                                                      const int                in_instance_count,
+                                                      const unsigned           in_base_instance = 0);
+    void                        draw_elements_instanced(const int      in_count,
+                                                        const int      in_instance_count,
+                                                        const int      in_start_index   = 0,
+                                                        const int      in_base_vertex   = 0,
+                                                        const unsigned in_base_instance = 0);
+    void                        draw_arrays_indirect(const primitive_topology in_topology,
+                                                     const scm::size_t        in_offset = 0);
+    void                        draw_elements_indirect(const scm::size_t in_offset = 0);
+    void                        multi_draw_arrays_indirect(const primitive_topology in_topology,
+                                                           const int                in_draw_count,
+                                                           const scm::size_t        in_offset = 0,
+                                                           const int                in_stride = 0);
+    void                        multi_draw_elements_indirect(const int         in_draw_count,
+                                                             const scm::size_t in_offset = 0,
+                                                             const int         in_stride = 0);
+
+    void                        clear_color_buffer(const frame_buffer_ptr& in_frame_buffer,
+                                                   const unsigned          in_buffer,
+                                                   const math::vec4f&      in_clear_color = math::vec4f(0.0f));
+    void                        clear_color_buffers(const frame_buffer_ptr& in_frame_buffer,
+                                                    const math::vec4f&      in_clear_color = math::vec4f(0.0f));
+    void                        clear_depth_stencil_buffer(const frame_buffer_ptr& in_frame_buffer,
+                                                           const float             in_clear_depth   = 1.0f,
+                                                           const int               in_clear_stencil = 0);
+    void                        clear_default_color_buffer(const frame_buffer_target in_target      = FRAMEBUFFER_BACK,
+                                                           const math::vec4f&        in_clear_color = math::vec4f(0.0f));
+    void                        clear_default_depth_stencil_buffer(const float in_clear_depth   = 1.0f,
+                                                                   const int   in_clear_stencil = 0);
+
+protected:
+    void                        record_uniform(const uniform_ptr& in_uniform,
+                                               int                in_element,
+                                               const void*        in_value,
+                                               scm::size_t        in_value_size);
+    void                        execute(render_context& in_context) const;
+
+protected:
+    command_array               _commands;
+    data_array                  _uniform_data;
+
+    friend class scm::gl::render_context;
+}; // class command_list
+
+} // namespace gl
+} // namespace scm
+
+#include "command_list.inl"
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_CORE_COMMAND_LIST_H_INCLUDED
@@ -0,0 +1,49 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include <scm/gl_core/shader_objects/program.h>
+
+namespace scm {
+namespace gl {
+
+template<typename T>
+inline
+void
+command_list::uniform(const program_ptr& in_program, const std::string& in_name, const T& in_value)
+{
+    uniform(in_program->resolve_uniform<T>(in_name), 0, in_value);
+}
+
+template<typename T>
+inline
+void
+command_list::uniform(const program_ptr& in_program, const std::string& in_name, int in_element, const T& in_value)
+{
+    uniform(in_program->resolve_uniform<T>(in_name), in_element, in_value);
+}
+
+template<typename T>
+inline
+void
+command_list::uniform(const uniform_handle<T>& in_uniform, const T& in_value)
+{
+    uniform(in_uniform, 0, in_value);
+}
+
+template<typename T>
+inline
+void
+command_list::uniform(const uniform_handle<T>& in_uniform, int in_element, const T& in_value)
+{
+    typedef typename uniform_handle<T>::uniform_value_type::value_type  stored_type;
+
+    if (in_uniform.valid()) {
+        // stored as the value type of the uniform (e.g. bool values of int uniforms)
+        const stored_type v(in_value);
+        record_uniform(in_uniform.get(), in_element, &v, sizeof(stored_type));
+    }
+}
+
+} // namespace gl
+} // namespace scm
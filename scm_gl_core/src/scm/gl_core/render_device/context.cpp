@@ -4,6 +4,7 @@
 
 #include "context.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include <scm/gl_core/config.h>
@@ -15,6 +16,7 @@
 #include <scm/gl_core/state_objects.h>
 #include <scm/gl_core/sync_objects.h>
 #include <scm/gl_core/texture_objects.h>
+#include <scm/gl_core/render_device/command_list.h>
 #include <scm/gl_core/render_device/device.h>
 #include <scm/gl_core/render_device/opengl/gl_core.h>
 #include <scm/gl_core/render_device/opengl/util/assert.h>
@@ -27,6 +29,28 @@
 #include <scm/cl_core/cuda/device.h>
 #include <scm/cl_core/opencl/device.h>
 
+namespace {
+
+scm::size_t
+sub_texture_size(const scm::gl::texture_region& in_region,
+                 const scm::gl::data_format     in_data_format)
+{
+    using namespace scm::gl;
+
+    if (is_compressed_format(in_data_format)) {
+        return   compressed_block_size(in_data_format)
+               * (((std::max)(1u, in_region._dimensions.x) + 3) / 4)
+               * (((std::max)(1u, in_region._dimensions.y) + 3) / 4)
+               * (std::max)(1u, in_region._dimensions.z);
+    }
+    return   static_cast<scm::size_t>(size_of_format(in_data_format))
+           * (std::max)(1u, in_region._dimensions.x)
+           * (std::max)(1u, in_region._dimensions.y)
+           * (std::max)(1u, in_region._dimensions.z);
+}
+
+} // namespace
+
 namespace scm {
 namespace gl {
 namespace detail {
@@ -100,6 +124,21 @@ render_context::image_unit_binding::operator!=(const image_unit_binding& rhs) co
            || (_layer         != rhs._layer);
 }
 
+render_context::call_statistics::call_statistics()
+  : _draw_calls(0)
+  , _compute_dispatches(0)
+  , _program_binds(0)
+  , _texture_binds(0)
+  , _image_binds(0)
+  , _vertex_array_binds(0)
+  , _frame_buffer_binds(0)
+  , _state_object_changes(0)
+  , _uniform_updates(0)
+  , _buffer_bytes_mapped(0)
+  , _texture_bytes_uploaded(0)
+{
+}
+
 render_context::binding_state_type::binding_state_type()
   : _stencil_ref_value(0)
   , _line_width(1.0f)
@@ -145,6 +184,9 @@ render_context::render_context(render_device& in_device)
     _current_state._active_atomic_counter_buffers.resize(in_device.capabilities()._max_atomic_counter_buffer_bindings);
     _applied_state._active_atomic_counter_buffers.resize(in_device.capabilities()._max_atomic_counter_buffer_bindings);
 
+    _current_state._active_storage_buffers.resize(in_device.capabilities()._max_shader_storage_buffer_bindings);
+    _applied_state._active_storage_buffers.resize(in_device.capabilities()._max_shader_storage_buffer_bindings);
+
     glapi.glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     glapi.glPixelStorei(GL_PACK_ALIGNMENT, 1);
 
@@ -152,6 +194,8 @@ render_context::render_context(render_device& in_device)
 
     _active_transform_feedback_topology_mode = PRIMITIVE_POINTS;
 
+    _collect_statistics = false;
+
     gl_assert(glapi, leaving render_context::render_context());
 }
 
@@ -180,11 +224,22 @@ render_context::apply()
     apply_state_objects();
     apply_uniform_buffer_bindings();
     apply_atomic_counter_bindings();
+    apply_storage_buffer_bindings();
     apply_program();
 
     assert(state().ok());
 }
 
+void
+render_context::execute(const command_list& in_commands)
+{
+    gl_assert(opengl_api(), entering render_context::execute());
+
+    in_commands.execute(*this);
+
+    gl_assert(opengl_api(), leaving render_context::execute());
+}
+
 void
 render_context::reset()
 {
@@ -195,6 +250,7 @@ render_context::reset()
     reset_state_objects();
     reset_uniform_buffers();
     reset_atomic_counter_buffers();
+    reset_storage_buffers();
     reset_program();
 }
 
@@ -242,9 +298,6 @@ render_context::flush()
     //apply_program();
 
     apply();
-    if (opengl_api().extension_EXT_shader_image_load_store) {
-        opengl_api().glMemoryBarrierEXT(GL_ALL_BARRIER_BITS_EXT);
-    }
     opengl_api().glFlush();
     //opengl_api().glFinish();
 }
@@ -418,6 +471,38 @@ render_context::gl_debug_dispatch(unsigned src, unsigned type, unsigned severity
     }
 }
 
+// call statistics ////////////////////////////////////////////////////////////////////////////////
+void
+render_context::collect_statistics(bool e)
+{
+    _collect_statistics = e;
+}
+
+bool
+render_context::collect_statistics() const
+{
+    return _collect_statistics;
+}
+
+void
+render_context::end_statistics_frame()
+{
+    _last_frame_statistics = _statistics;
+    _statistics            = call_statistics();
+}
+
+const render_context::call_statistics&
+render_context::current_statistics() const
+{
+    return _statistics;
+}
+
+const render_context::call_statistics&
+render_context::last_frame_statistics() const
+{
+    return _last_frame_statistics;
+}
+
 // buffer api /////////////////////////////////////////////////////////////////////////////////
 void*
 render_context::map_buffer(const buffer_ptr&  in_buffer,
@@ -429,6 +514,9 @@ render_context::map_buffer(const buffer_ptr&  in_buffer,
         || (!in_buffer->ok())) {
         SCM_GL_DGB("render_context::map_buffer(): error mapping buffer ('" << in_buffer->state().state_string() << "')");
     }
+    else if (_collect_statistics && ACCESS_READ_ONLY != in_access) {
+        _statistics._buffer_bytes_mapped += in_buffer->descriptor()._size;
+    }
 
     return return_value;
 }
@@ -446,6 +534,9 @@ render_context::map_buffer_range(const buffer_ptr&   in_buffer,
         || (!in_buffer->ok())) {
         SCM_GL_DGB("render_context::map_buffer_range(): error mapping buffer range ('" << in_buffer->state().state_string() << "')");
     }
+    else if (_collect_statistics && ACCESS_READ_ONLY != in_access) {
+        _statistics._buffer_bytes_mapped += in_size;
+    }
 
     return return_value;
 }
@@ -633,6 +724,47 @@ render_context::reset_atomic_counter_buffers()
               buffer_binding());
 }
 
+void
+render_context::bind_storage_buffer(const buffer_ptr& in_buffer,
+                                    const unsigned    in_bind_point,
+                                    const scm::size_t in_offset,
+                                    const scm::size_t in_size)
+{
+    if (in_bind_point < _current_state._active_storage_buffers.size()) {
+        _current_state._active_storage_buffers[in_bind_point]._buffer = in_buffer;
+        _current_state._active_storage_buffers[in_bind_point]._offset = in_offset;
+        _current_state._active_storage_buffers[in_bind_point]._size   = in_size;
+    }
+    else {
+        glerr() << log::error
+                << "render_context::bind_storage_buffer() "
+                << "storage buffer binding point out of range "
+                << "(binding point: " << in_bind_point
+                << ", max binding point" << _current_state._active_storage_buffers.size()
+                << ")." << log::end;
+    }
+}
+
+void
+render_context::set_storage_buffers(const buffer_binding_array& in_buffers)
+{
+    _current_state._active_storage_buffers = in_buffers;
+}
+
+const render_context::buffer_binding_array&
+render_context::current_storage_buffers() const
+{
+    return _current_state._active_storage_buffers;
+}
+
+void
+render_context::reset_storage_buffers()
+{
+    std::fill(_current_state._active_storage_buffers.begin(),
+              _current_state._active_storage_buffers.end(),
+              buffer_binding());
+}
+
 void
 render_context::bind_unpack_buffer(const buffer_ptr& in_buffer)
 {
@@ -695,11 +827,24 @@ render_context::current_index_buffer_binding() const
     return _current_state._index_buffer_binding;
 }
 
+void
+render_context::bind_draw_indirect_buffer(const buffer_ptr& in_buffer)
+{
+    _current_state._draw_indirect_buffer = in_buffer;
+}
+
+const buffer_ptr&
+render_context::current_draw_indirect_buffer() const
+{
+    return _current_state._draw_indirect_buffer;
+}
+
 void
 render_context::reset_vertex_input()
 {
     _current_state._vertex_array         = vertex_array_ptr();
     _current_state._index_buffer_binding = index_buffer_binding();
+    _current_state._draw_indirect_buffer = buffer_ptr();
 }
 
 void
@@ -841,6 +986,229 @@ render_context::draw_elements(const int in_count, const int in_start_index, cons
     gl_assert(glapi, leaving render_context::draw_elements());
 }
 
+void
+render_context::draw_arrays_instanced(const primitive_topology in_topology,
+                                      const int                in_first_index,
+                                      const int                in_count,
+                                      const int                in_instance_count,
+                                      const unsigned           in_base_instance)
+{
+    const opengl::gl_core& glapi = opengl_api();
+
+    if (   (0 > in_first_index)
+        || (0 > in_count)
+        || (0 > in_instance_count)) {
+        state().set(object_state::OS_ERROR_INVALID_VALUE);
+        SCM_GL_DGB("render_context::draw_arrays_instanced(): error invalid count, instance count or start index (< 0) " << "('" << state().state_string() << "')");
+        return;
+    }
+
+    if (0 != in_base_instance) {
+        if (SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_420) {
+            pre_draw_setup();
+            glapi.glDrawArraysInstancedBaseInstance(util::gl_primitive_topology(in_topology), in_first_index, in_count,
+                                                    in_instance_count, in_base_instance);
+            post_draw_setup();
+        }
+        else {
+            glerr() << log::error
+                    << "render_context::draw_arrays_instanced(): "
+                    << "base instance offsets are only available using scm_gl_core with OpenGL4.2 capabilities enabled on a OpenGL4.2 context."
+                    << log::end;
+        }
+    }
+    else {
+        pre_draw_setup();
+        glapi.glDrawArraysInstanced(util::gl_primitive_topology(in_topology), in_first_index, in_count, in_instance_count);
+        post_draw_setup();
+    }
+
+    gl_assert(glapi, leaving render_context::draw_arrays_instanced());
+}
+
+void
+render_context::draw_elements_instanced(const int      in_count,
+                                        const int      in_instance_count,
+                                        const int      in_start_index,
+                                        const int      in_base_vertex,
+                                        const unsigned in_base_instance)
+{
+    const opengl::gl_core& glapi = opengl_api();
+
+    if (!util::is_vaild_index_type(_applied_state._index_buffer_binding._index_data_type)) {
+        state().set(object_state::OS_ERROR_INVALID_ENUM);
+        return;
+    }
+    if (   (0 > in_count)
+        || (0 > in_start_index)
+        || (0 > in_instance_count)) {
+        state().set(object_state::OS_ERROR_INVALID_VALUE);
+        SCM_GL_DGB("render_context::draw_elements_instanced(): error invalid count, instance count or start index (< 0) " << "('" << state().state_string() << "')");
+        return;
+    }
+
+    const index_buffer_binding& ib = _applied_state._index_buffer_binding;
+    const GLenum                gl_topology = util::gl_primitive_topology(ib._primitive_topology);
+    const GLenum                gl_type     = util::gl_base_type(ib._index_data_type);
+    const void*                 gl_indices  = (char*)0 + ib._index_data_offset + size_of_type(ib._index_data_type) * in_start_index;
+
+    if (0 != in_base_instance) {
+        if (SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_420) {
+            pre_draw_setup();
+            glapi.glDrawElementsInstancedBaseVertexBaseInstance(gl_topology, in_count, gl_type, gl_indices,
+                                                                in_instance_count, in_base_vertex, in_base_instance);
+            post_draw_setup();
+        }
+        else {
+            glerr() << log::error
+                    << "render_context::draw_elements_instanced(): "
+                    << "base instance offsets are only available using scm_gl_core with OpenGL4.2 capabilities enabled on a OpenGL4.2 context."
+                    << log::end;
+        }
+    }
+    else {
+        pre_draw_setup();
+        glapi.glDrawElementsInstancedBaseVertex(gl_topology, in_count, gl_type, gl_indices, in_instance_count, in_base_vertex);
+        post_draw_setup();
+    }
+
+    gl_assert(glapi, leaving render_context::draw_elements_instanced());
+}
+
+void
+render_context::draw_arrays_indirect(const primitive_topology in_topology,
+                                     const scm::size_t        in_offset)
+{
+    if (SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_400) {
+        const opengl::gl_core& glapi = opengl_api();
+
+        if (!_applied_state._draw_indirect_buffer) {
+            state().set(object_state::OS_ERROR_INVALID_OPERATION);
+            SCM_GL_DGB("render_context::draw_arrays_indirect(): error no draw indirect buffer bound " << "('" << state().state_string() << "')");
+            return;
+        }
+
+        pre_draw_setup();
+        glapi.glDrawArraysIndirect(util::gl_primitive_topology(in_topology), (char*)0 + in_offset);
+        post_draw_setup();
+
+        gl_assert(glapi, leaving render_context::draw_arrays_indirect());
+    }
+    else {
+        glerr() << log::error
+                << "render_context::draw_arrays_indirect(): "
+                << "the draw_arrays_indirect functionality is only available using scm_gl_core with OpenGL4.x capabilities enabled on a OpenGL4.x context."
+                << log::end;
+    }
+}
+
+void
+render_context::draw_elements_indirect(const scm::size_t in_offset)
+{
+    if (SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_400) {
+        const opengl::gl_core& glapi = opengl_api();
+
+        if (!util::is_vaild_index_type(_applied_state._index_buffer_binding._index_data_type)) {
+            state().set(object_state::OS_ERROR_INVALID_ENUM);
+            return;
+        }
+        if (!_applied_state._draw_indirect_buffer) {
+            state().set(object_state::OS_ERROR_INVALID_OPERATION);
+            SCM_GL_DGB("render_context::draw_elements_indirect(): error no draw indirect buffer bound " << "('" << state().state_string() << "')");
+            return;
+        }
+
+        pre_draw_setup();
+        glapi.glDrawElementsIndirect(util::gl_primitive_topology(_applied_state._index_buffer_binding._primitive_topology),
+                                     util::gl_base_type(_applied_state._index_buffer_binding._index_data_type),
+                                     (char*)0 + in_offset);
+        post_draw_setup();
+
+        gl_assert(glapi, leaving render_context::draw_elements_indirect());
+    }
+    else {
+        glerr() << log::error
+                << "render_context::draw_elements_indirect(): "
+                << "the draw_elements_indirect functionality is only available using scm_gl_core with OpenGL4.x capabilities enabled on a OpenGL4.x context."
+                << log::end;
+    }
+}
+
+void
+render_context::multi_draw_arrays_indirect(const primitive_topology in_topology,
+                                           const int                in_draw_count,
+                                           const scm::size_t        in_offset,
+                                           const int                in_stride)
+{
+    if (SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_430) {
+        const opengl::gl_core& glapi = opengl_api();
+
+        if (   (0 > in_draw_count)
+            || (0 > in_stride)) {
+            state().set(object_state::OS_ERROR_INVALID_VALUE);
+            SCM_GL_DGB("render_context::multi_draw_arrays_indirect(): error invalid draw count or stride (< 0) " << "('" << state().state_string() << "')");
+            return;
+        }
+        if (!_applied_state._draw_indirect_buffer) {
+            state().set(object_state::OS_ERROR_INVALID_OPERATION);
+            SCM_GL_DGB("render_context::multi_draw_arrays_indirect(): error no draw indirect buffer bound " << "('" << state().state_string() << "')");
+            return;
+        }
+
+        pre_draw_setup();
+        glapi.glMultiDrawArraysIndirect(util::gl_primitive_topology(in_topology), (char*)0 + in_offset, in_draw_count, in_stride);
+        post_draw_setup();
+
+        gl_assert(glapi, leaving render_context::multi_draw_arrays_indirect());
+    }
+    else {
+        glerr() << log::error
+                << "render_context::multi_draw_arrays_indirect(): "
+                << "the multi_draw_arrays_indirect functionality is only available using scm_gl_core with OpenGL4.3 capabilities enabled on a OpenGL4.3 context."
+                << log::end;
+    }
+}
+
+void
+render_context::multi_draw_elements_indirect(const int         in_draw_count,
+                                             const scm::size_t in_offset,
+                                             const int         in_stride)
+{
+    if (SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_430) {
+        const opengl::gl_core& glapi = opengl_api();
+
+        if (!util::is_vaild_index_type(_applied_state._index_buffer_binding._index_data_type)) {
+            state().set(object_state::OS_ERROR_INVALID_ENUM);
+            return;
+        }
+        if (   (0 > in_draw_count)
+            || (0 > in_stride)) {
+            state().set(object_state::OS_ERROR_INVALID_VALUE);
+            SCM_GL_DGB("render_context::multi_draw_elements_indirect(): error invalid draw count or stride (< 0) " << "('" << state().state_string() << "')");
+            return;
+        }
+        if (!_applied_state._draw_indirect_buffer) {
+            state().set(object_state::OS_ERROR_INVALID_OPERATION);
+            SCM_GL_DGB("render_context::multi_draw_elements_indirect(): error no draw indirect buffer bound " << "('" << state().state_string() << "')");
+            return;
+        }
+
+        pre_draw_setup();
+        glapi.glMultiDrawElementsIndirect(util::gl_primitive_topology(_applied_state._index_buffer_binding._primitive_topology),
+                                          util::gl_base_type(_applied_state._index_buffer_binding._index_data_type),
+                                          (char*)0 + in_offset, in_draw_count, in_stride);
+        post_draw_setup();
+
+        gl_assert(glapi, leaving render_context::multi_draw_elements_indirect());
+    }
+    else {
+        glerr() << log::error
+                << "render_context::multi_draw_elements_indirect(): "
+                << "the multi_draw_elements_indirect functionality is only available using scm_gl_core with OpenGL4.3 capabilities enabled on a OpenGL4.3 context."
+                << log::end;
+    }
+}
+
 void
 render_context::pre_draw_setup()
 {
@@ -849,6 +1217,10 @@ render_context::pre_draw_setup()
     gl_assert(glapi, entering render_context::pre_draw());
     assert(state().ok());
 
+    if (_collect_statistics) {
+        ++_statistics._draw_calls;
+    }
+
     start_transform_feedback();
 
     if (_applied_state._program->rasterization_discard()) {
@@ -898,6 +1270,10 @@ render_context::apply_vertex_input()
             _applied_state._vertex_array->unbind(*this);
         }
         _applied_state._vertex_array = _current_state._vertex_array;
+
+        if (_collect_statistics) {
+            ++_statistics._vertex_array_binds;
+        }
     }
 
     if (_current_state._index_buffer_binding != _applied_state._index_buffer_binding) {
@@ -911,6 +1287,16 @@ render_context::apply_vertex_input()
         }
         _applied_state._index_buffer_binding = _current_state._index_buffer_binding;
     }
+
+    if (_current_state._draw_indirect_buffer != _applied_state._draw_indirect_buffer) {
+        if (_current_state._draw_indirect_buffer) {
+            _current_state._draw_indirect_buffer->bind(*this, BIND_DRAW_INDIRECT_BUFFER);
+        }
+        else {
+            _applied_state._draw_indirect_buffer->unbind(*this, BIND_DRAW_INDIRECT_BUFFER);
+        }
+        _applied_state._draw_indirect_buffer = _current_state._draw_indirect_buffer;
+    }
     gl_assert(opengl_api(), leaving render_context::apply_vertex_input());
 }
 
@@ -954,6 +1340,105 @@ render_context::apply_atomic_counter_bindings()
     }
 }
 
+void
+render_context::apply_storage_buffer_bindings()
+{
+    for (int i = 0; i < _current_state._active_storage_buffers.size(); ++i) {
+        const buffer_binding&   cubb = _current_state._active_storage_buffers[i];
+        buffer_binding&         aubb = _applied_state._active_storage_buffers[i];
+
+        if (cubb != aubb) {
+            if (cubb._buffer) {
+                cubb._buffer->bind_range(*this, BIND_SHADER_STORAGE_BUFFER, i, cubb._offset, cubb._size);
+                assert(cubb._buffer->ok());
+            }
+            else {
+                aubb._buffer->unbind_range(*this, BIND_SHADER_STORAGE_BUFFER, i);
+            }
+            aubb = cubb;
+        }
+    }
+}
+
+// compute api ////////////////////////////////////////////////////////////////////////////////
+#if SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_430
+void
+render_context::dispatch_compute(const math::vec3ui& in_num_groups)
+{
+    const opengl::gl_core& glapi = opengl_api();
+    const render_device::device_capabilities& caps = parent_device().capabilities();
+
+    for (int d = 0; d < 3; ++d) {
+        if (in_num_groups[d] > static_cast<unsigned>(caps._max_compute_work_group_count[d])) {
+            state().set(object_state::OS_ERROR_INVALID_VALUE);
+            SCM_GL_DGB("render_context::dispatch_compute(): error work group count exceeds MAX_COMPUTE_WORK_GROUP_COUNT "
+                       << "('" << state().state_string() << "')");
+            return;
+        }
+    }
+    if (!_applied_state._program) {
+        state().set(object_state::OS_ERROR_INVALID_OPERATION);
+        SCM_GL_DGB("render_context::dispatch_compute(): error no program applied " << "('" << state().state_string() << "')");
+        return;
+    }
+
+    glapi.glDispatchCompute(in_num_groups.x, in_num_groups.y, in_num_groups.z);
+
+    if (_collect_statistics) {
+        ++_statistics._compute_dispatches;
+    }
+
+    gl_assert(glapi, leaving render_context::dispatch_compute());
+}
+
+void
+render_context::dispatch_compute_indirect(const buffer_ptr& in_indirect_buffer,
+                                          const scm::size_t in_offset)
+{
+    const opengl::gl_core& glapi = opengl_api();
+
+    if (!in_indirect_buffer) {
+        state().set(object_state::OS_ERROR_INVALID_VALUE);
+        SCM_GL_DGB("render_context::dispatch_compute_indirect(): error invalid indirect buffer " << "('" << state().state_string() << "')");
+        return;
+    }
+    if (!_applied_state._program) {
+        state().set(object_state::OS_ERROR_INVALID_OPERATION);
+        SCM_GL_DGB("render_context::dispatch_compute_indirect(): error no program applied " << "('" << state().state_string() << "')");
+        return;
+    }
+
+    { // the dispatch indirect binding is not part of the context state
+        util::buffer_binding_guard save_guard(glapi, util::gl_buffer_targets(BIND_DISPATCH_INDIRECT_BUFFER),
+                                                     util::gl_buffer_bindings(BIND_DISPATCH_INDIRECT_BUFFER));
+        in_indirect_buffer->bind(*this, BIND_DISPATCH_INDIRECT_BUFFER);
+        glapi.glDispatchComputeIndirect(static_cast<GLintptr>(in_offset));
+    }
+
+    if (_collect_statistics) {
+        ++_statistics._compute_dispatches;
+    }
+
+    gl_assert(glapi, leaving render_context::dispatch_compute_indirect());
+}
+#endif // SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_430
+
+void
+render_context::memory_barrier(const unsigned in_barrier_mask)
+{
+    const opengl::gl_core& glapi = opengl_api();
+
+    if (SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_420) {
+        glapi.glMemoryBarrier(util::gl_memory_barrier_bits(in_barrier_mask));
+    }
+    else if (glapi.extension_EXT_shader_image_load_store) {
+        // the EXT barrier bits match the core bits up to the atomic counter barrier
+        glapi.glMemoryBarrierEXT(util::gl_memory_barrier_bits(in_barrier_mask & ~(BARRIER_ATOMIC_COUNTER | BARRIER_SHADER_STORAGE)));
+    }
+
+    gl_assert(glapi, leaving render_context::memory_barrier());
+}
+
 // shader api /////////////////////////////////////////////////////////////////////////////////
 void
 render_context::bind_program(const program_ptr& in_program)
@@ -990,9 +1475,16 @@ render_context::apply_program()
     if (_current_state._program != _applied_state._program) {
         _current_state._program->bind(*this);
         _applied_state._program = _current_state._program;
+
+        if (_collect_statistics) {
+            ++_statistics._program_binds;
+        }
     }
 
     // bind uniforms
+    if (_collect_statistics) {
+        _statistics._uniform_updates += _applied_state._program->_dirty_uniforms.size();
+    }
     _applied_state._program->bind_uniforms(*this);
 
     gl_assert(opengl_api(), leaving render_context::apply_program());
@@ -1099,6 +1591,9 @@ render_context::update_sub_texture(const texture_image_ptr& in_texture,
                 << log::end;
         return false;
     }
+    if (_collect_statistics) {
+        _statistics._texture_bytes_uploaded += sub_texture_size(in_region, in_data_format);
+    }
     return true;
 }
 
@@ -1117,6 +1612,9 @@ render_context::update_sub_texture(const texture_image_ptr& in_texture,
                 << log::end;
         return false;
     }
+    if (_collect_statistics) {
+        _statistics._texture_bytes_uploaded += sub_texture_size(in_region, in_data_format);
+    }
     return true;
 }
 
@@ -1178,6 +1676,10 @@ render_context::apply_texture_units()
                 ati->unbind(*this, u);
             }
             ati = cti;
+
+            if (_collect_statistics) {
+                ++_statistics._texture_binds;
+            }
         }
         sampler_state_ptr&  css = _current_state._texture_units[u]._sampler_state;
         sampler_state_ptr&  ass = _applied_state._texture_units[u]._sampler_state;
@@ -1189,6 +1691,10 @@ render_context::apply_texture_units()
                 ass->unbind(*this, u);
             }
             ass = css;
+
+            if (_collect_statistics) {
+                ++_statistics._texture_binds;
+            }
         }
     }
     gl_assert(opengl_api(), leaving render_context::apply_texture_units());
@@ -1208,6 +1714,10 @@ render_context::apply_image_units()
             else {
                 aub._texture_image->unbind_image(*this, u);
             }
+
+            if (_collect_statistics) {
+                ++_statistics._image_binds;
+            }
         }
         aub = cub;
     }
@@ -1816,6 +2326,10 @@ render_context::apply_frame_buffer()
             _applied_state._draw_framebuffer->unbind(*this);
         }
         _applied_state._draw_framebuffer = _current_state._draw_framebuffer;
+
+        if (_collect_statistics) {
+            ++_statistics._frame_buffer_binds;
+        }
     }
     if (!_applied_state._draw_framebuffer) { // we are on the default frame buffer
         if (_current_state._default_framebuffer_target != _applied_state._default_framebuffer_target) {
@@ -1959,6 +2473,10 @@ render_context::apply_state_objects()
                                                    *(_applied_state._depth_stencil_state), _applied_state._stencil_ref_value);
         _applied_state._depth_stencil_state = _current_state._depth_stencil_state;
         _applied_state._stencil_ref_value   = _current_state._stencil_ref_value;
+
+        if (_collect_statistics) {
+            ++_statistics._state_object_changes;
+        }
     }
 
     if (   (_current_state._rasterizer_state != _applied_state._rasterizer_state)
@@ -1968,6 +2486,10 @@ render_context::apply_state_objects()
         _applied_state._rasterizer_state = _current_state._rasterizer_state;
         _applied_state._line_width       = _current_state._line_width;
         _applied_state._point_size       = _current_state._point_size;
+
+        if (_collect_statistics) {
+            ++_statistics._state_object_changes;
+        }
     }
 
     if (   (_current_state._blend_state != _applied_state._blend_state)
@@ -1976,6 +2498,10 @@ render_context::apply_state_objects()
                                            *(_applied_state._blend_state), _applied_state._blend_color);
         _applied_state._blend_state = _current_state._blend_state;
         _applied_state._blend_color = _current_state._blend_color;
+
+        if (_collect_statistics) {
+            ++_statistics._state_object_changes;
+        }
     }
     gl_assert(opengl_api(), leaving render_context::apply_state_objects());
 }
@@ -2065,6 +2591,17 @@ render_context::query_time_stamp(const timer_query_ptr& in_timer) const
     gl_assert(opengl_api(), leaving render_context::query_time_stamp());
 }
 
+scm::uint64
+render_context::current_time_stamp() const
+{
+    GLint64 time_stamp = 0;
+    opengl_api().glGetInteger64v(GL_TIMESTAMP, &time_stamp);
+
+    gl_assert(opengl_api(), leaving render_context::current_time_stamp());
+
+    return static_cast<scm::uint64>(time_stamp);
+}
+
 // sync api ///////////////////////////////////////////////////////////////////////////////////////
 fence_sync_ptr
 render_context::insert_fence_sync()
@@ -90,6 +90,36 @@ public:
         scm::size_t         _offset;
         scm::size_t         _size;
     }; // struct uniform_buffer_binding
+    // command layouts of the indirect draw calls in the draw indirect buffer
+    struct draw_arrays_indirect_command {
+        unsigned            _count;
+        unsigned            _instance_count;
+        unsigned            _first;
+        unsigned            _base_instance;
+    }; // struct draw_arrays_indirect_command
+    struct draw_elements_indirect_command {
+        unsigned            _count;
+        unsigned            _instance_count;
+        unsigned            _first_index;
+        int                 _base_vertex;
+        unsigned            _base_instance;
+    }; // struct draw_elements_indirect_command
+    // gl calls issued by the context, redundant bindings filtered by the context are not counted
+    struct call_statistics {
+        call_statistics();
+        scm::size_t         _draw_calls;
+        scm::size_t         _compute_dispatches;
+        scm::size_t         _program_binds;
+        scm::size_t         _texture_binds;             // textures and samplers
+        scm::size_t         _image_binds;
+        scm::size_t         _vertex_array_binds;
+        scm::size_t         _frame_buffer_binds;
+        scm::size_t         _state_object_changes;
+        scm::size_t         _uniform_updates;           // uniform values uploaded on program apply
+        scm::size_t         _buffer_bytes_mapped;       // size of buffer ranges mapped with write access,
+                                                        // an upper bound of the uploaded bytes
+        scm::size_t         _texture_bytes_uploaded;
+    }; // struct call_statistics
     typedef std::vector<texture_unit_binding>   texture_unit_array;
     typedef std::vector<image_unit_binding>     image_unit_array;
     typedef std::vector<buffer_binding>         buffer_binding_array;
@@ -102,8 +132,10 @@ private:
         // vertex specification ///////////////////////////////////////////////////////////////////
         vertex_array_ptr                    _vertex_array;
         index_buffer_binding                _index_buffer_binding;
+        buffer_ptr                          _draw_indirect_buffer;
         buffer_binding_array                _active_uniform_buffers;
         buffer_binding_array                _active_atomic_counter_buffers;
+        buffer_binding_array                _active_storage_buffers;
         // state objects //////////////////////////////////////////////////////////////////////////
         // depth state
         depth_stencil_state_ptr             _depth_stencil_state;
@@ -131,6 +163,8 @@ public:
 
     const opengl::gl_core&      opengl_api() const;
     void                        apply();
+    // replays a command list recorded on any thread, has to be called on the thread of the context
+    void                        execute(const command_list& in_commands);
 
     void                        reset();
 
@@ -155,6 +189,16 @@ protected:
                                                   int msg_length, const char* msg, void* user_param);
     void                        gl_debug_dispatch(unsigned src, unsigned type, unsigned severity, int msg_length, const char* msg);
 
+    // call statistics ////////////////////////////////////////////////////////////////////////////
+public:
+    // counting is disabled by default, a disabled context only tests the flag
+    void                        collect_statistics(bool e);
+    bool                        collect_statistics() const;
+    // call once per frame, stores the counters of the ending frame and resets them
+    void                        end_statistics_frame();
+    const call_statistics&      current_statistics() const;
+    const call_statistics&      last_frame_statistics() const;
+
     // buffer api /////////////////////////////////////////////////////////////////////////////////
 public:
     void*                       map_buffer(const buffer_ptr& in_buffer, const access_mode in_access) const;
@@ -199,11 +243,20 @@ public:
     void                        set_atomic_counter_buffers(const buffer_binding_array& in_buffers);
     const buffer_binding_array& current_atomic_counter_buffers() const;
 
+    void                        bind_storage_buffer(const buffer_ptr& in_buffer,
+                                                    const unsigned    in_bind_point,
+                                                    const scm::size_t in_offset = 0,
+                                                    const scm::size_t in_size   = 0);
+
+    void                        set_storage_buffers(const buffer_binding_array& in_buffers);
+    const buffer_binding_array& current_storage_buffers() const;
+
     void                        bind_unpack_buffer(const buffer_ptr& in_buffer);
     const buffer_ptr&           current_unpack_buffer() const;
 
     void                        reset_uniform_buffers();
     void                        reset_atomic_counter_buffers();
+    void                        reset_storage_buffers();
 
     void                        bind_vertex_array(const vertex_array_ptr& in_vertex_array);
     const vertex_array_ptr&     current_vertex_array() const;
@@ -213,6 +266,10 @@ public:
     void                        set_index_buffer_binding(const index_buffer_binding& in_index_buffer_binding);
     const index_buffer_binding& current_index_buffer_binding() const;
 
+    // source of the indirect draw commands
+    void                        bind_draw_indirect_buffer(const buffer_ptr& in_buffer);
+    const buffer_ptr&           current_draw_indirect_buffer() const;
+
     void                        reset_vertex_input();
 
     void                        begin_transform_feedback(const transform_feedback_ptr& in_transform_feedback, primitive_type in_topology_mode);
@@ -224,6 +281,33 @@ public:
     void                        draw_arrays(const primitive_topology in_topology, const int in_first_index, const int in_count);
     void                        draw_elements(const int in_count, const int in_start_index = 0, const int in_base_vertex = 0);
 
+    // instanced draws, instanced vertex attributes are fetched starting at in_base_instance
+    void                        draw_arrays_instanced(const primitive_topology in_topology,
+                                                      const int                in_first_index,
+                                                      const int                in_count,
+                                                      const int                in_instance_count,
+                                                      const unsigned           in_base_instance = 0);
+    void                        draw_elements_instanced(const int      in_count,
+                                                        const int      in_instance_count,
+                                                        const int      in_start_index   = 0,
+                                                        const int      in_base_vertex   = 0,
+                                                        const unsigned in_base_instance = 0);
+
+    // indirect draws reading their parameters from the bound draw indirect buffer at in_offset
+    //  - draw_arrays_indirect_command/draw_elements_indirect_command layout
+    //  - the multi draw variants issue in_draw_count commands in a single call, in_stride is
+    //    the distance between consecutive commands (0: tightly packed)
+    void                        draw_arrays_indirect(const primitive_topology in_topology,
+                                                     const scm::size_t        in_offset = 0);
+    void                        draw_elements_indirect(const scm::size_t in_offset = 0);
+    void                        multi_draw_arrays_indirect(const primitive_topology in_topology,
+                                                           const int                in_draw_count,
+                                                           const scm::size_t        in_offset = 0,
+                                                           const int                in_stride = 0);
+    void                        multi_draw_elements_indirect(const int         in_draw_count,
+                                                             const scm::size_t in_offset = 0,
+                                                             const int         in_stride = 0);
+
 protected:
     void                        pre_draw_setup();
     void                        post_draw_setup();
@@ -233,6 +317,21 @@ protected:
     void                        apply_vertex_input();
     void                        apply_uniform_buffer_bindings();
     void                        apply_atomic_counter_bindings();
+    void                        apply_storage_buffer_bindings();
+
+    // compute api ////////////////////////////////////////////////////////////////////////////////
+public:
+#if SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_430
+    // launch the compute shader of the current program on in_num_groups work groups, the
+    // indirect variant reads the group counts (three unsigned ints) from in_indirect_buffer
+    void                        dispatch_compute(const math::vec3ui& in_num_groups);
+    void                        dispatch_compute_indirect(const buffer_ptr& in_indirect_buffer,
+                                                          const scm::size_t in_offset = 0);
+#endif // SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_430
+
+    // order incoherent shader writes (image stores, storage buffers, atomic counters) before
+    // the accesses in in_barrier_mask (memory_barrier_mask bits), nothing is issued implicitly
+    void                        memory_barrier(const unsigned in_barrier_mask = BARRIER_ALL);
 
     // shader api /////////////////////////////////////////////////////////////////////////////////
 public:
@@ -372,6 +471,9 @@ public:
     bool                            query_result_available(const query_ptr& in_query) const;
     void                            collect_query_results(const query_ptr& in_query) const;
     void                            query_time_stamp(const timer_query_ptr& in_timer) const;
+    // gpu time in nanoseconds once all previous commands reached the gpu (no wait for completion),
+    // same time base as query_time_stamp() results
+    scm::uint64                     current_time_stamp() const;
 
     // sync api ///////////////////////////////////////////////////////////////////////////////////
 public:
@@ -412,6 +514,10 @@ private:
     transform_feedback_ptr                      _active_transform_feedback;
     primitive_type                              _active_transform_feedback_topology_mode;
 
+    bool                                        _collect_statistics;
+    mutable call_statistics                     _statistics;
+    call_statistics                             _last_frame_statistics;
+
     // defaults
     // TODO
     //program_ptr                 _default_program;
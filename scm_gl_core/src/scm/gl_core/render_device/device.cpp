@@ -28,7 +28,9 @@
 #include <scm/gl_core/render_device/opengl/gl_core.h>
 #include <scm/gl_core/render_device/opengl/util/assert.h>
 #include <scm/gl_core/render_device/opengl/util/error_helper.h>
+#include <scm/gl_core/shader_objects/async_program.h>
 #include <scm/gl_core/shader_objects/program.h>
+#include <scm/gl_core/shader_objects/program_binary_cache.h>
 #include <scm/gl_core/shader_objects/shader.h>
 #include <scm/gl_core/shader_objects/stream_capture.h>
 #include <scm/gl_core/state_objects/depth_stencil_state.h>
@@ -41,6 +43,53 @@
 
 namespace scm {
 namespace gl {
+namespace {
+
+// returns the living state object for the descriptor or an empty pointer
+template<typename state_ptr, typename state_cache>
+state_ptr
+find_cached_state(const state_cache& in_cache, const typename state_cache::key_type& in_desc)
+{
+    typename state_cache::const_iterator s = in_cache.find(in_desc);
+    if (s != in_cache.end()) {
+        return s->second.lock();
+    }
+    return state_ptr();
+}
+
+template<typename state_ptr, typename state_cache>
+void
+insert_cached_state(state_cache& in_cache, const typename state_cache::key_type& in_desc, const state_ptr& in_state)
+{
+    // drop the entries of released state objects before the cache grows
+    typename state_cache::iterator s = in_cache.begin();
+    while (s != in_cache.end()) {
+        if (s->second.expired()) {
+            s = in_cache.erase(s);
+        }
+        else {
+            ++s;
+        }
+    }
+    in_cache[in_desc] = in_state;
+}
+
+template<typename state_cache>
+scm::size_t
+count_cached_states(const state_cache& in_cache)
+{
+    scm::size_t count = 0;
+    typename state_cache::const_iterator s = in_cache.begin();
+    typename state_cache::const_iterator e = in_cache.end();
+    for (; s != e; ++s) {
+        if (!s->second.expired()) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+} // namespace
 
 struct render_device::mutex_impl
 {
@@ -49,6 +98,7 @@ struct render_device::mutex_impl
 
 render_device::render_device()
   : _mutex_impl(new mutex_impl)
+  , _include_strings_key(program_binary_cache::hash_seed())
 {
     _opengl_api_core.reset(new opengl::gl_core());
 
@@ -94,6 +144,11 @@ render_device::render_device()
 
     init_capabilities();
 
+    if (_opengl_api_core->extension_KHR_parallel_shader_compile) {
+        // let the driver decide on the number of compiler threads
+        _opengl_api_core->glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+    }
+
     // setup main rendering context
     try {
         _main_context.reset(new render_context(*this));
@@ -111,6 +166,8 @@ render_device::render_device()
 
 render_device::~render_device()
 {
+    // finish all pending asynchronous programs while the device is still intact
+    _async_program_worker.reset();
     _main_context.reset();
 
     assert(0 == _registered_resources.size());
@@ -249,6 +306,33 @@ render_device::init_capabilities()
         _capabilities._max_atomic_counter_buffer_bindings = 0;
     }
 
+    if (SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_430) {
+        glcore.glGetIntegerv(GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS,     &_capabilities._max_shader_storage_buffer_bindings);
+        glcore.glGetIntegerv(GL_MAX_SHADER_STORAGE_BLOCK_SIZE,          &_capabilities._max_shader_storage_block_size);
+        glcore.glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &_capabilities._shader_storage_buffer_offset_alignment);
+        for (int d = 0; d < 3; ++d) {
+            glcore.glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_COUNT, d,  &_capabilities._max_compute_work_group_count[d]);
+            glcore.glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_SIZE,  d,  &_capabilities._max_compute_work_group_size[d]);
+        }
+        glcore.glGetIntegerv(GL_MAX_COMPUTE_LOCAL_INVOCATIONS,          &_capabilities._max_compute_work_group_invocations);
+        glcore.glGetIntegerv(GL_MAX_COMPUTE_SHARED_MEMORY_SIZE,         &_capabilities._max_compute_shared_memory_size);
+
+        assert(_capabilities._max_shader_storage_buffer_bindings     > 0);
+        assert(_capabilities._shader_storage_buffer_offset_alignment > 0);
+        assert(_capabilities._max_compute_work_group_invocations     > 0);
+    }
+    else {
+        _capabilities._max_shader_storage_buffer_bindings     = 0;
+        _capabilities._max_shader_storage_block_size          = 0;
+        _capabilities._shader_storage_buffer_offset_alignment = 1;
+        for (int d = 0; d < 3; ++d) {
+            _capabilities._max_compute_work_group_count[d] = 0;
+            _capabilities._max_compute_work_group_size[d]  = 0;
+        }
+        _capabilities._max_compute_work_group_invocations     = 0;
+        _capabilities._max_compute_shared_memory_size         = 0;
+    }
+
     if (   SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_420
         || glcore.extension_ARB_map_buffer_alignment) {
         glcore.glGetIntegerv(GL_MIN_MAP_BUFFER_ALIGNMENT, &_capabilities._min_buffer_alignment);
@@ -328,6 +412,25 @@ render_device::init_capabilities()
             << "MAX_ATOMIC_COUNTER_BUFFER_BINDINGS          " << _capabilities._max_atomic_counter_buffer_bindings
             << log::outdent;
 
+    glout() << "shader storage buffers: " << log::nline
+            << log::indent
+            << "MAX_SHADER_STORAGE_BUFFER_BINDINGS          " << _capabilities._max_shader_storage_buffer_bindings << log::nline
+            << "MAX_SHADER_STORAGE_BLOCK_SIZE               " << _capabilities._max_shader_storage_block_size << log::nline
+            << "SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT      " << _capabilities._shader_storage_buffer_offset_alignment
+            << log::outdent;
+
+    glout() << "compute shaders: " << log::nline
+            << log::indent
+            << "MAX_COMPUTE_WORK_GROUP_COUNT                " << "(" << _capabilities._max_compute_work_group_count[0]
+                                                             << ", " << _capabilities._max_compute_work_group_count[1]
+                                                             << ", " << _capabilities._max_compute_work_group_count[2] << ")" << log::nline
+            << "MAX_COMPUTE_WORK_GROUP_SIZE                 " << "(" << _capabilities._max_compute_work_group_size[0]
+                                                             << ", " << _capabilities._max_compute_work_group_size[1]
+                                                             << ", " << _capabilities._max_compute_work_group_size[2] << ")" << log::nline
+            << "MAX_COMPUTE_WORK_GROUP_INVOCATIONS          " << _capabilities._max_compute_work_group_invocations << log::nline
+            << "MAX_COMPUTE_SHARED_MEMORY_SIZE              " << _capabilities._max_compute_shared_memory_size
+            << log::outdent;
+
     glout() << "map buffer alignment: " << log::nline
             << log::indent
             << "MIN_MAP_BUFFER_ALIGNMENT                    " << _capabilities._min_buffer_alignment
@@ -404,6 +507,25 @@ render_device::resize_buffer(const buffer_ptr& in_buffer, scm::size_t in_size)
     }
 }
 
+stream_allocator_ptr
+render_device::create_stream_allocator(scm::size_t in_frame_capacity,
+                                       int         in_frame_count)
+{
+    if (!opengl_api().extension_ARB_buffer_storage) {
+        glerr() << log::error << "render_device::create_stream_allocator(): "
+                << "unable to create stream allocator (missing support for ARB_buffer_storage)." << log::end;
+        return stream_allocator_ptr();
+    }
+
+    stream_allocator_ptr new_allocator(new stream_allocator(*this, in_frame_capacity, in_frame_count));
+    if (new_allocator->fail()) {
+        glerr() << log::error << "render_device::create_stream_allocator(): unable to create stream allocator ("
+                << new_allocator->state().state_string() << ")." << log::end;
+        return stream_allocator_ptr();
+    }
+    return new_allocator;
+}
+
 vertex_array_ptr
 render_device::create_vertex_array(const vertex_format& in_vert_fmt,
                                    const buffer_array&  in_attrib_buffers,
@@ -610,6 +732,13 @@ render_device::add_include_string_internal(const std::string& in_path,
             }
         }
 
+        // programs using the include string have to miss binaries linked with older contents
+        _include_strings_key = program_binary_cache::hash_combine(_include_strings_key, in_path);
+        _include_strings_key = program_binary_cache::hash_combine(_include_strings_key, in_source_string);
+        if (_program_binary_cache) {
+            _program_binary_cache->include_key(_include_strings_key);
+        }
+
         size_t      parent_path_end = in_path.find_last_of('/');
         std::string parent_path     = in_path.substr(0, parent_path_end);
 
@@ -688,6 +817,17 @@ render_device::create_shader(shader_stage                    in_stage,
                              const shader_macro_array&       in_macros,
                              const shader_include_path_list& in_inc_paths,
                              const std::string&              in_source_name)
+{
+    return create_shader_internal(in_stage, in_source, in_macros, in_inc_paths, in_source_name, false);
+}
+
+shader_ptr
+render_device::create_shader_internal(shader_stage                    in_stage,
+                                      const std::string&              in_source,
+                                      const shader_macro_array&       in_macros,
+                                      const shader_include_path_list& in_inc_paths,
+                                      const std::string&              in_source_name,
+                                      bool                            in_defer_compile)
 {
     // combine macro definitions
     shader_macro_array  macro_array(in_macros);
@@ -722,7 +862,8 @@ render_device::create_shader(shader_stage                    in_stage,
                                      in_source,
                                      in_source_name,
                                      macro_array,
-                                     include_paths));
+                                     include_paths,
+                                     in_defer_compile));
     if (new_shader->fail()) {
         if (new_shader->bad()) {
             glerr() << "render_device::create_shader(): unable to create shader object ("
@@ -796,6 +937,62 @@ render_device::create_shader_from_file(shader_stage                    in_stage,
     return create_shader(in_stage, source_string, in_macros, in_inc_paths, file_path.filename().string());
 }
 
+bool
+render_device::enable_program_binary_cache(const std::string& in_cache_directory)
+{
+    namespace bfs = boost::filesystem;
+
+    if (   SCM_GL_CORE_OPENGL_CORE_VERSION < SCM_GL_CORE_OPENGL_CORE_VERSION_410
+        || 0 >= _capabilities._num_program_binary_formats) {
+        glerr() << log::error << "render_device::enable_program_binary_cache(): "
+                << "program binaries not supported (no program binary formats)." << log::end;
+        return false;
+    }
+
+    boost::system::error_code   ec;
+    bfs::path                   cache_path(in_cache_directory);
+
+    if (!bfs::exists(cache_path, ec)) {
+        bfs::create_directories(cache_path, ec);
+    }
+    if (ec || !bfs::is_directory(cache_path, ec)) {
+        glerr() << log::error << "render_device::enable_program_binary_cache(): "
+                << "unable to use cache directory " << in_cache_directory << "." << log::end;
+        return false;
+    }
+
+    std::ostringstream  driver_string;
+    driver_string << device_vendor() << "|" << device_renderer() << "|"
+                  << _opengl_api_core->context_information()._version_info << "|"
+                  << device_shader_compiler();
+
+    {
+        boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+        _program_binary_cache.reset(new program_binary_cache(cache_path.string(), driver_string.str()));
+        _program_binary_cache->include_key(_include_strings_key);
+    }
+
+    glout() << log::info << "render_device::enable_program_binary_cache(): "
+            << "using program binary cache in " << cache_path.string() << log::end;
+
+    return true;
+}
+
+void
+render_device::disable_program_binary_cache()
+{
+    boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+    _program_binary_cache.reset();
+}
+
+const program_binary_cache_ptr&
+render_device::program_cache() const
+{
+    return _program_binary_cache;
+}
+
 program_ptr
 render_device::create_program(const shader_list& in_shaders,
                               const std::string& in_program_name)
@@ -816,6 +1013,13 @@ render_device::create_program(const shader_list&          in_shaders,
                     << "name: " << in_program_name << ", "
                     << new_program->state().state_string() << ")." << log::end;
         }
+        else if (new_program->state().get() == object_state::OS_ERROR_SHADER_COMPILE) {
+            // shader compilation deferred by the program binary cache
+            glerr() << "render_device::create_program(): unable to compile shader ("
+                    << "name: " << in_program_name << ", "
+                    << new_program->state().state_string() << "):" << log::nline
+                    << new_program->info_log() << log::end;
+        }
         else {
             glerr() << "render_device::create_program(): error during link operation ("
                     << "name: " << in_program_name << ", "
@@ -834,6 +1038,110 @@ render_device::create_program(const shader_list&          in_shaders,
     }
 }
 
+bool
+render_device::enable_async_program_worker(const wm::context_ptr& in_shared_context,
+                                           const wm::surface_ptr& in_surface)
+{
+    if (!in_shared_context || !in_surface) {
+        glerr() << log::error << "render_device::enable_async_program_worker(): "
+                << "invalid context or surface." << log::end;
+        return false;
+    }
+
+    async_program_worker_ptr new_worker(new async_program_worker(in_shared_context, in_surface));
+    if (!new_worker->start()) {
+        glerr() << log::error << "render_device::enable_async_program_worker(): "
+                << "unable to start worker thread." << log::end;
+        return false;
+    }
+
+    {
+        boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+        _async_program_worker.swap(new_worker);
+    }
+    // the previous worker (if any) finishes its queue when released here
+
+    return true;
+}
+
+void
+render_device::disable_async_program_worker()
+{
+    async_program_worker_ptr old_worker;
+    {
+        boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+        old_worker.swap(_async_program_worker);
+    }
+    // joins the worker thread outside of the device lock, the worker creates
+    // shaders and programs through this device
+}
+
+async_program_ptr
+render_device::create_program_async(const shader_source_array& in_sources,
+                                    const std::string&         in_program_name)
+{
+    return create_program_async(in_sources, stream_capture_array(), false, in_program_name);
+}
+
+async_program_ptr
+render_device::create_program_async(const shader_source_array&  in_sources,
+                                    const stream_capture_array& in_capture,
+                                    bool                        in_rasterization_discard,
+                                    const std::string&          in_program_name)
+{
+    async_program_ptr new_async_program(new async_program(*this, in_sources, in_capture,
+                                                          in_rasterization_discard, in_program_name));
+
+    if (_opengl_api_core->extension_KHR_parallel_shader_compile) {
+        // compile and link in the driver background threads, polled by the async_program
+        shader_list shaders;
+        foreach(const shader_source& s, in_sources) {
+            shader_ptr new_shader = create_shader_internal(s._stage, s._source, s._macros,
+                                                           s._include_paths, s._source_name, true);
+            if (!new_shader) {
+                // error reported by create_shader_internal
+                new_async_program->finish(program_ptr());
+                return new_async_program;
+            }
+            shaders.push_back(new_shader);
+        }
+
+        program_ptr new_program(new program(*this, shaders, in_capture, in_rasterization_discard,
+                                            program::named_location_list(), program::named_location_list(),
+                                            true));
+        if (new_program->fail()) {
+            glerr() << "render_device::create_program_async(): unable to create program ("
+                    << "name: " << in_program_name << ", "
+                    << new_program->state().state_string() << ")." << log::end;
+            new_async_program->finish(program_ptr());
+        }
+        else if (!new_program->_link_pending) {
+            // linked from the program binary cache
+            new_async_program->finish(new_program);
+        }
+        else {
+            new_async_program->_linking_program = new_program;
+        }
+        return new_async_program;
+    }
+
+    async_program_worker_ptr worker;
+    {
+        boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+        worker = _async_program_worker;
+    }
+
+    if (worker) {
+        worker->submit(new_async_program);
+    }
+    else {
+        // no asynchronous path available
+        new_async_program->finish(new_async_program->build_program());
+    }
+
+    return new_async_program;
+}
+
 // texture api ////////////////////////////////////////////////////////////////////////////////////
 texture_1d_ptr
 render_device::create_texture_1d(const texture_1d_desc&   in_desc)
@@ -1068,9 +1376,31 @@ render_device::create_texture_buffer(const data_format   in_format,
     return create_texture_buffer(in_format, tex_buffer);
 }
 
+texture_upload_queue_ptr
+render_device::create_texture_upload_queue(scm::size_t in_staging_buffer_size,
+                                           int         in_staging_buffer_count)
+{
+    texture_upload_queue_ptr new_queue(new texture_upload_queue(*this, in_staging_buffer_size, in_staging_buffer_count));
+    if (new_queue->fail()) {
+        glerr() << log::error << "render_device::create_texture_upload_queue(): unable to create texture upload queue ("
+                << new_queue->state().state_string() << ")." << log::end;
+        return texture_upload_queue_ptr();
+    }
+    return new_queue;
+}
+
 sampler_state_ptr
 render_device::create_sampler_state(const sampler_state_desc& in_desc)
 {
+    { // protect this function from multiple thread access
+        boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+        sampler_state_ptr cached_sstate = find_cached_state<sampler_state_ptr>(_sampler_state_cache, in_desc);
+        if (cached_sstate) {
+            return cached_sstate;
+        }
+    }
+
     sampler_state_ptr  new_sstate(new sampler_state(*this, in_desc));
     if (new_sstate->fail()) {
         if (new_sstate->bad()) {
@@ -1080,6 +1410,15 @@ render_device::create_sampler_state(const sampler_state_desc& in_desc)
         return sampler_state_ptr();
     }
     else {
+        boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+        // another thread may have created an equal state object in the meantime
+        sampler_state_ptr cached_sstate = find_cached_state<sampler_state_ptr>(_sampler_state_cache, in_desc);
+        if (cached_sstate) {
+            return cached_sstate;
+        }
+        insert_cached_state(_sampler_state_cache, in_desc, new_sstate);
+
         return new_sstate;
     }
 }
@@ -1158,7 +1497,26 @@ render_device::create_frame_buffer()
 depth_stencil_state_ptr
 render_device::create_depth_stencil_state(const depth_stencil_state_desc& in_desc)
 {
+    { // protect this function from multiple thread access
+        boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+        depth_stencil_state_ptr cached_state = find_cached_state<depth_stencil_state_ptr>(_depth_stencil_state_cache, in_desc);
+        if (cached_state) {
+            return cached_state;
+        }
+    }
+
     depth_stencil_state_ptr new_ds_state(new depth_stencil_state(*this, in_desc));
+    if (new_ds_state->ok()) {
+        boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+        // another thread may have created an equal state object in the meantime
+        depth_stencil_state_ptr cached_state = find_cached_state<depth_stencil_state_ptr>(_depth_stencil_state_cache, in_desc);
+        if (cached_state) {
+            return cached_state;
+        }
+        insert_cached_state(_depth_stencil_state_cache, in_desc, new_ds_state);
+    }
     return new_ds_state;
 }
 
@@ -1185,7 +1543,26 @@ render_device::create_depth_stencil_state(bool in_depth_test, bool in_depth_mask
 rasterizer_state_ptr
 render_device::create_rasterizer_state(const rasterizer_state_desc& in_desc)
 {
+    { // protect this function from multiple thread access
+        boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+        rasterizer_state_ptr cached_state = find_cached_state<rasterizer_state_ptr>(_rasterizer_state_cache, in_desc);
+        if (cached_state) {
+            return cached_state;
+        }
+    }
+
     rasterizer_state_ptr new_r_state(new rasterizer_state(*this, in_desc));
+    if (new_r_state->ok()) {
+        boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+        // another thread may have created an equal state object in the meantime
+        rasterizer_state_ptr cached_state = find_cached_state<rasterizer_state_ptr>(_rasterizer_state_cache, in_desc);
+        if (cached_state) {
+            return cached_state;
+        }
+        insert_cached_state(_rasterizer_state_cache, in_desc, new_r_state);
+    }
     return new_r_state;
 }
 
@@ -1200,7 +1577,26 @@ render_device::create_rasterizer_state(fill_mode in_fmode, cull_mode in_cmode, p
 blend_state_ptr
 render_device::create_blend_state(const blend_state_desc& in_desc)
 {
+    { // protect this function from multiple thread access
+        boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+        blend_state_ptr cached_state = find_cached_state<blend_state_ptr>(_blend_state_cache, in_desc);
+        if (cached_state) {
+            return cached_state;
+        }
+    }
+
     blend_state_ptr new_bl_state(new blend_state(*this, in_desc));
+    if (new_bl_state->ok()) {
+        boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+        // another thread may have created an equal state object in the meantime
+        blend_state_ptr cached_state = find_cached_state<blend_state_ptr>(_blend_state_cache, in_desc);
+        if (cached_state) {
+            return cached_state;
+        }
+        insert_cached_state(_blend_state_cache, in_desc, new_bl_state);
+    }
     return new_bl_state;
 }
 
@@ -1224,6 +1620,17 @@ render_device::create_blend_state(const blend_ops_array& in_blend_ops, bool in_a
     return create_blend_state(blend_state_desc(in_blend_ops, in_alpha_to_coverage));
 }
 
+scm::size_t
+render_device::cached_state_object_count() const
+{
+    boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+    return   count_cached_states(_sampler_state_cache)
+           + count_cached_states(_depth_stencil_state_cache)
+           + count_cached_states(_rasterizer_state_cache)
+           + count_cached_states(_blend_state_cache);
+}
+
 // query api //////////////////////////////////////////////////////////////////////////////////////
 timer_query_ptr
 render_device::create_timer_query()
@@ -24,9 +24,11 @@
 #include <scm/gl_core/buffer_objects/buffer.h>
 #include <scm/gl_core/shader_objects/shader_objects_fwd.h>
 #include <scm/gl_core/shader_objects/shader_macro.h>
+#include <scm/gl_core/shader_objects/async_program.h>
 #include <scm/gl_core/state_objects/blend_state.h>
 #include <scm/gl_core/state_objects/depth_stencil_state.h>
 #include <scm/gl_core/state_objects/rasterizer_state.h>
+#include <scm/gl_core/state_objects/sampler_state.h>
 
 #include <scm/core/platform/platform.h>
 #include <scm/core/utilities/platform_warning_disable.h>
@@ -102,6 +104,13 @@ public:
         int             _max_fragment_atomic_counters;
         int             _max_combined_atomic_counters;
         int             _max_atomic_counter_buffer_bindings;
+        int             _max_shader_storage_buffer_bindings;
+        int             _max_shader_storage_block_size;
+        int             _shader_storage_buffer_offset_alignment;
+        int             _max_compute_work_group_count[3];
+        int             _max_compute_work_group_size[3];
+        int             _max_compute_work_group_invocations;
+        int             _max_compute_shared_memory_size;
         int             _min_buffer_alignment;
 
         int             _num_program_binary_formats;
@@ -118,6 +127,12 @@ protected:
 
     typedef std::vector<buffer_ptr>                         buffer_array;
 
+    // state objects are immutable, equal descriptors share one object as long as it is in use
+    typedef boost::unordered_map<sampler_state_desc, sampler_state_wptr>                sampler_state_cache;
+    typedef boost::unordered_map<depth_stencil_state_desc, depth_stencil_state_wptr>    depth_stencil_state_cache;
+    typedef boost::unordered_map<rasterizer_state_desc, rasterizer_state_wptr>          rasterizer_state_cache;
+    typedef boost::unordered_map<blend_state_desc, blend_state_wptr>                    blend_state_cache;
+
 ////// methods ////////////////////////////////////////////////////////////////////////////////////
 public:
     render_device();
@@ -150,6 +165,9 @@ public:
                                                   scm::size_t    in_size,
                                                   const void*    in_initial_data = 0);
     bool                            resize_buffer(const buffer_ptr& in_buffer, scm::size_t in_size);
+    // requires ARB_buffer_storage, in_frame_capacity bytes are usable per frame
+    stream_allocator_ptr            create_stream_allocator(scm::size_t in_frame_capacity,
+                                                            int         in_frame_count = 3);
 
     vertex_array_ptr                create_vertex_array(const vertex_format& in_vert_fmt,
                                                         const buffer_array&  in_attrib_buffers,
@@ -207,7 +225,36 @@ public:
                                                    bool                        in_rasterization_discard = false,
                                                    const std::string&          in_program_name = "");
 
+    // on-disk cache of linked program binaries (requires OpenGL 4.1 and at least one program
+    // binary format), shaders created while the cache is enabled are only compiled when
+    // create_program does not find a usable binary, compiler errors are reported there
+    bool                            enable_program_binary_cache(const std::string& in_cache_directory);
+    void                            disable_program_binary_cache();
+    const program_binary_cache_ptr& program_cache() const;
+
+    // asynchronous program creation, the returned handle reports ready/failed without blocking
+    //  - with KHR_parallel_shader_compile the driver compiles and links in the background,
+    //    the handle is then polled from the thread of the main context
+    //  - otherwise programs are built on a worker thread using a context sharing its objects
+    //    with the main context (enable_async_program_worker)
+    //  - without both the program is created synchronously in create_program_async
+    bool                            enable_async_program_worker(const wm::context_ptr& in_shared_context,
+                                                                const wm::surface_ptr& in_surface);
+    void                            disable_async_program_worker();
+    async_program_ptr               create_program_async(const shader_source_array& in_sources,
+                                                         const std::string&         in_program_name = "");
+    async_program_ptr               create_program_async(const shader_source_array&  in_sources,
+                                                         const stream_capture_array& in_capture,
+                                                         bool                        in_rasterization_discard = false,
+                                                         const std::string&          in_program_name = "");
+
 protected:
+    shader_ptr                      create_shader_internal(shader_stage                    in_stage,
+                                                           const std::string&              in_source,
+                                                           const shader_macro_array&       in_macros,
+                                                           const shader_include_path_list& in_inc_paths,
+                                                           const std::string&              in_source_name,
+                                                           bool                            in_defer_compile);
     bool                            add_include_string_internal(const std::string& in_path,
                                                                 const std::string& in_source_string,
                                                                       bool         lock_thread);
@@ -266,6 +313,9 @@ public:
                                                           buffer_usage        in_buffer_usage,
                                                           scm::size_t         in_buffer_size,
                                                           const void*         in_buffer_initial_data = 0);
+    // streams texture updates through in_staging_buffer_count pixel unpack buffers
+    texture_upload_queue_ptr        create_texture_upload_queue(scm::size_t in_staging_buffer_size,
+                                                                int         in_staging_buffer_count = 3);
 
     sampler_state_ptr               create_sampler_state(const sampler_state_desc& in_desc);
     sampler_state_ptr               create_sampler_state(texture_filter_mode  in_filter1,
@@ -318,6 +368,9 @@ public:
                                                        unsigned in_write_mask = COLOR_ALL, bool in_alpha_to_coverage = false);
     blend_state_ptr                 create_blend_state(const blend_ops_array& in_blend_ops, bool in_alpha_to_coverage = false);
 
+    // number of distinct state objects alive in the state object caches
+    scm::size_t                     cached_state_object_count() const;
+
     // query api //////////////////////////////////////////////////////////////////////////////////
 public:
     timer_query_ptr                 create_timer_query();
@@ -349,10 +402,19 @@ protected:
     // shader api /////////////////////////////////////////////////////////////////////////////////
     shader_macro_map                _default_macro_defines;
     string_set                      _default_include_paths;
+    scm::uint64                     _include_strings_key;
+    program_binary_cache_ptr        _program_binary_cache;
+    async_program_worker_ptr        _async_program_worker;
 
     device_capabilities             _capabilities;
     resource_ptr_set                _registered_resources;
 
+    // state api //////////////////////////////////////////////////////////////////////////////////
+    sampler_state_cache             _sampler_state_cache;
+    depth_stencil_state_cache       _depth_stencil_state_cache;
+    rasterizer_state_cache          _rasterizer_state_cache;
+    blend_state_cache               _blend_state_cache;
+
     // compute interop ////////////////////////////////////////////////////////////////////////////
     cl::opencl_device_ptr           _opencl_device;
     cu::cuda_device_ptr             _cuda_device;
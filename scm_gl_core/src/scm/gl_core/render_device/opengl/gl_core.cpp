@@ -115,6 +115,7 @@ gl_core::gl_core()
     version_4_2_available   = false;
     version_4_3_available   = false;
 
+    extension_ARB_buffer_storage                = false;
     extension_ARB_cl_event                      = false;
     extension_ARB_debug_output                  = false;
     extension_ARB_map_buffer_alignment          = false;
@@ -122,6 +123,8 @@ gl_core::gl_core()
     extension_ARB_shading_language_include      = false;
     extension_ARB_texture_compression_bptc      = false;
 
+    extension_KHR_parallel_shader_compile       = false;
+
     extension_EXT_direct_state_access_available = false;
     extension_EXT_shader_image_load_store       = false;
     extension_EXT_texture_compression_s3tc      = false;
@@ -243,6 +246,9 @@ gl_core::initialize()
     //        _extensions.insert(*i);
     //    }
     //}
+    if (is_supported("GL_ARB_buffer_storage") && !extension_ARB_buffer_storage) {
+        glout() << log::warning << "gl_core::initialize(): GL_ARB_buffer_storage reported but missing entry points detected" << log::end;
+    }
     if (is_supported("GL_ARB_cl_event") && !extension_ARB_cl_event) {
         glout() << log::warning << "gl_core::initialize(): GL_ARB_cl_event reported but missing entry points detected" << log::end;
     }
@@ -254,6 +260,7 @@ gl_core::initialize()
     }
 
     extension_ARB_shading_language_include = extension_ARB_shading_language_include && is_supported("GL_ARB_shading_language_include");
+    extension_ARB_buffer_storage           = extension_ARB_buffer_storage           && is_supported("GL_ARB_buffer_storage");
     extension_ARB_cl_event                 = extension_ARB_cl_event                 && is_supported("GL_ARB_cl_event");
     extension_ARB_debug_output             = extension_ARB_debug_output             && is_supported("GL_ARB_debug_output");
     extension_ARB_robustness               = extension_ARB_robustness               && is_supported("GL_ARB_robustness");
@@ -266,6 +273,10 @@ gl_core::initialize()
 
     extension_NV_bindless_texture          = extension_NV_bindless_texture && is_supported("GL_NV_bindless_texture");
 
+    extension_KHR_parallel_shader_compile  =    extension_KHR_parallel_shader_compile
+                                             && (   is_supported("GL_KHR_parallel_shader_compile")
+                                                 || is_supported("GL_ARB_parallel_shader_compile"));
+
 #ifdef SCM_GL_CORE_USE_DIRECT_STATE_ACCESS
     if (!is_supported("GL_EXT_direct_state_access")) {
         glout() << log::warning
@@ -1035,6 +1046,13 @@ gl_core::init_entry_points()
     SCM_INIT_GL_ENTRY(PFNGLGETNAMEDSTRINGIVARBPROC, glGetNamedStringivARB, "GL_ARB_shading_language_include", init_success);
     extension_ARB_shading_language_include = init_success;
 
+    // ARB_buffer_storage /////////////////////////////////////////////////////////////////////////
+    init_success = true;
+    SCM_INIT_GL_ENTRY(PFNGLBUFFERSTORAGEPROC, glBufferStorage, "ARB_buffer_storage", init_success);
+    extension_ARB_buffer_storage = init_success;
+    // only exposed together with EXT_direct_state_access, the buffer falls back to glBufferStorage
+    glNamedBufferStorageEXT = gl_proc_address<PFNGLNAMEDBUFFERSTORAGEEXTPROC>("glNamedBufferStorageEXT");
+
     // ARB_cl_event ///////////////////////////////////////////////////////////////////////////////
     init_success = true;
     SCM_INIT_GL_ENTRY(PFNGLCREATESYNCFROMCLEVENTARBPROC, glCreateSyncFromCLeventARB, "ARB_cl_event", init_success);
@@ -1185,6 +1203,15 @@ gl_core::init_entry_points()
     extension_EXT_direct_state_access_available = init_success;
 
 
+    // KHR_parallel_shader_compile ////////////////////////////////////////////////////////////////
+    // the ARB variant only differs in the entry point suffix, no missing entry point warnings
+    // are issued as most drivers expose neither
+    glMaxShaderCompilerThreadsKHR = gl_proc_address<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>("glMaxShaderCompilerThreadsKHR");
+    if (0 == glMaxShaderCompilerThreadsKHR) {
+        glMaxShaderCompilerThreadsKHR = gl_proc_address<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>("glMaxShaderCompilerThreadsARB");
+    }
+    extension_KHR_parallel_shader_compile = (0 != glMaxShaderCompilerThreadsKHR);
+
     // GL_NV_bindless_texture
     init_success = true;
     SCM_INIT_GL_ENTRY(PFNGLGETTEXTUREHANDLENVPROC, glGetTextureHandleNV, "GL_NV_bindless_texture", init_success);
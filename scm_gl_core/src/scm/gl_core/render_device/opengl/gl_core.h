@@ -19,6 +19,23 @@
 #define BUFFER_OFFSET(i) ((char *) NULL + (i))
 #endif
 
+// ARB_buffer_storage tokens missing in glcorearb.h
+#ifndef GL_ARB_buffer_storage
+#define GL_MAP_PERSISTENT_BIT               0x0040
+#define GL_MAP_COHERENT_BIT                 0x0080
+#define GL_DYNAMIC_STORAGE_BIT              0x0100
+#define GL_CLIENT_STORAGE_BIT               0x0200
+#define GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT 0x00004000
+#define GL_BUFFER_IMMUTABLE_STORAGE         0x821F
+#define GL_BUFFER_STORAGE_FLAGS             0x8220
+#endif
+
+// KHR_parallel_shader_compile tokens missing in glcorearb.h (same values for the ARB variant)
+#ifndef GL_KHR_parallel_shader_compile
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR  0x91B0
+#define GL_COMPLETION_STATUS_KHR            0x91B1
+#endif
+
 namespace scm {
 namespace gl {
 namespace opengl {
@@ -55,6 +72,9 @@ public:
     typedef void (APIENTRY * PFNGLVERTEXARRAYVERTEXATTRIBOFFSETEXTPROC) (GLuint vaobj, GLuint buffer, GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, GLintptr offset);
     typedef void (APIENTRY * PFNGLENABLEVERTEXARRAYATTRIBEXTPROC) (GLuint vaobj, GLuint index);
     typedef void (APIENTRY * PFNGLDISABLEVERTEXARRAYATTRIBEXTPROC) (GLuint vaobj, GLuint index);
+    typedef void (APIENTRY * PFNGLBUFFERSTORAGEPROC) (GLenum target, GLsizeiptr size, const GLvoid *data, GLbitfield flags);
+    typedef void (APIENTRY * PFNGLNAMEDBUFFERSTORAGEEXTPROC) (GLuint buffer, GLsizeiptr size, const GLvoid *data, GLbitfield flags);
+    typedef void (APIENTRY * PFNGLMAXSHADERCOMPILERTHREADSKHRPROC) (GLuint count);
 private:
     typedef std::set<std::string>   string_set;
 
@@ -96,6 +116,7 @@ public:
     bool version_4_3_available;
 
 
+    bool extension_ARB_buffer_storage;
     bool extension_ARB_cl_event;
     bool extension_ARB_debug_output;
     bool extension_ARB_map_buffer_alignment;
@@ -103,6 +124,8 @@ public:
     bool extension_ARB_shading_language_include;
     bool extension_ARB_texture_compression_bptc;
 
+    bool extension_KHR_parallel_shader_compile;
+
     bool extension_EXT_direct_state_access_available;
     bool extension_EXT_shader_image_load_store;
     bool extension_EXT_texture_compression_s3tc;
@@ -773,6 +796,9 @@ public:
     PFNGLVERTEXARRAYVERTEXATTRIBBINDINGEXTPROC      glVertexArrayVertexAttribBindingEXT;
     PFNGLVERTEXARRAYVERTEXBINDINGDIVISOREXTPROC     glVertexArrayVertexBindingDivisorEXT;
 
+    // KHR_parallel_shader_compile (or ARB_parallel_shader_compile)
+    PFNGLMAXSHADERCOMPILERTHREADSKHRPROC            glMaxShaderCompilerThreadsKHR;
+
     // GL_ARB_shading_language_include
     PFNGLNAMEDSTRINGARBPROC                         glNamedStringARB;
     PFNGLDELETENAMEDSTRINGARBPROC                   glDeleteNamedStringARB;
@@ -781,6 +807,10 @@ public:
     PFNGLGETNAMEDSTRINGARBPROC                      glGetNamedStringARB;
     PFNGLGETNAMEDSTRINGIVARBPROC                    glGetNamedStringivARB;
 
+    // ARB_buffer_storage
+    PFNGLBUFFERSTORAGEPROC                          glBufferStorage;
+    PFNGLNAMEDBUFFERSTORAGEEXTPROC                  glNamedBufferStorageEXT;
+
     // ARB_cl_event
     PFNGLCREATESYNCFROMCLEVENTARBPROC               glCreateSyncFromCLeventARB;
 
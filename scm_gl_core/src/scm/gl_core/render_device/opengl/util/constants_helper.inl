@@ -26,6 +26,9 @@ gl_buffer_targets(const buffer_binding b)
         case BIND_TEXTURE_BUFFER:               return GL_TEXTURE_BUFFER;
         case BIND_TRANSFORM_FEEDBACK_BUFFER:    return GL_TRANSFORM_FEEDBACK_BUFFER;
         case BIND_ATOMIC_COUNTER_BUFFER:        return GL_ATOMIC_COUNTER_BUFFER;
+        case BIND_DRAW_INDIRECT_BUFFER:         return GL_DRAW_INDIRECT_BUFFER;
+        case BIND_SHADER_STORAGE_BUFFER:        return GL_SHADER_STORAGE_BUFFER;
+        case BIND_DISPATCH_INDIRECT_BUFFER:     return GL_DISPATCH_INDIRECT_BUFFER;
         default:                                return 0;
     }
 }
@@ -44,6 +47,9 @@ gl_buffer_bindings(const buffer_binding b)
         case BIND_TEXTURE_BUFFER:               return GL_TEXTURE_BINDING_BUFFER;
         case BIND_TRANSFORM_FEEDBACK_BUFFER:    return GL_TRANSFORM_FEEDBACK_BUFFER_BINDING;
         case BIND_ATOMIC_COUNTER_BUFFER:        return GL_ATOMIC_COUNTER_BUFFER_BINDING;
+        case BIND_DRAW_INDIRECT_BUFFER:         return GL_DRAW_INDIRECT_BUFFER_BINDING;
+        case BIND_SHADER_STORAGE_BUFFER:        return GL_SHADER_STORAGE_BUFFER_BINDING;
+        case BIND_DISPATCH_INDIRECT_BUFFER:     return GL_DISPATCH_INDIRECT_BUFFER_BINDING;
         default:                                return 0;
     }
 }
@@ -88,6 +94,7 @@ gl_buffer_access_mode(const access_mode a)
         case ACCESS_WRITE_INVALIDATE_RANGE:     return GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
         case ACCESS_WRITE_INVALIDATE_BUFFER:    return GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
         case ACCESS_WRITE_UNSYNCHRONIZED:       return GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+        case ACCESS_WRITE_PERSISTENT_COHERENT:  return GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
         default:                                return 0;                       
     }
 }
@@ -106,6 +113,29 @@ gl_image_access_mode(const access_mode a)
     }
 }
 
+inline
+unsigned
+gl_memory_barrier_bits(const unsigned in_barrier_mask)
+{
+    unsigned gl_bits = 0;
+
+    if (in_barrier_mask & BARRIER_VERTEX_ATTRIB_ARRAY)  gl_bits |= GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT;
+    if (in_barrier_mask & BARRIER_ELEMENT_ARRAY)        gl_bits |= GL_ELEMENT_ARRAY_BARRIER_BIT;
+    if (in_barrier_mask & BARRIER_UNIFORM)              gl_bits |= GL_UNIFORM_BARRIER_BIT;
+    if (in_barrier_mask & BARRIER_TEXTURE_FETCH)        gl_bits |= GL_TEXTURE_FETCH_BARRIER_BIT;
+    if (in_barrier_mask & BARRIER_SHADER_IMAGE_ACCESS)  gl_bits |= GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+    if (in_barrier_mask & BARRIER_COMMAND)              gl_bits |= GL_COMMAND_BARRIER_BIT;
+    if (in_barrier_mask & BARRIER_PIXEL_BUFFER)         gl_bits |= GL_PIXEL_BUFFER_BARRIER_BIT;
+    if (in_barrier_mask & BARRIER_TEXTURE_UPDATE)       gl_bits |= GL_TEXTURE_UPDATE_BARRIER_BIT;
+    if (in_barrier_mask & BARRIER_BUFFER_UPDATE)        gl_bits |= GL_BUFFER_UPDATE_BARRIER_BIT;
+    if (in_barrier_mask & BARRIER_FRAMEBUFFER)          gl_bits |= GL_FRAMEBUFFER_BARRIER_BIT;
+    if (in_barrier_mask & BARRIER_TRANSFORM_FEEDBACK)   gl_bits |= GL_TRANSFORM_FEEDBACK_BARRIER_BIT;
+    if (in_barrier_mask & BARRIER_ATOMIC_COUNTER)       gl_bits |= GL_ATOMIC_COUNTER_BARRIER_BIT;
+    if (in_barrier_mask & BARRIER_SHADER_STORAGE)       gl_bits |= GL_SHADER_STORAGE_BARRIER_BIT;
+
+    return gl_bits;
+}
+
 inline
 unsigned
 gl_primitive_type(const primitive_type p)
@@ -197,6 +227,10 @@ gl_shader_types(const shader_stage s)
         GL_TESS_EVALUATION_SHADER,  // STAGE_TESS_EVALUATION_SHADER,
         GL_TESS_CONTROL_SHADER      // STAGE_TESS_CONTROL_SHADER
 #endif // SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_400
+#if SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_430
+        ,
+        GL_COMPUTE_SHADER           // STAGE_COMPUTE_SHADER
+#endif // SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_430
     };
 
     BOOST_STATIC_ASSERT((sizeof(shader_types) / sizeof(int)) == SHADER_STAGE_COUNT);
@@ -14,6 +14,7 @@ class render_device;
 class render_context;
 class render_device_child;
 class render_device_resource;
+class command_list;
 
 typedef shared_ptr<render_device>           render_device_ptr;
 typedef shared_ptr<const render_device>     render_device_cptr;
@@ -21,6 +22,8 @@ typedef weak_ptr<render_device>             render_device_wptr;
 typedef shared_ptr<render_context>          render_context_ptr;
 typedef shared_ptr<const render_context>    render_context_cptr;
 typedef weak_ptr<render_context>            render_context_wptr;
+typedef shared_ptr<command_list>            command_list_ptr;
+typedef shared_ptr<const command_list>      command_list_cptr;
 
 class context_program_guard;
 class context_vertex_input_guard;
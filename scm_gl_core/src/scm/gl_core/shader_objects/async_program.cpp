@@ -0,0 +1,262 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "async_program.h"
+
+#include <list>
+
+#include <boost/bind.hpp>
+
+#include <scm/core/utilities/foreach.h>
+
+#include <scm/gl_core/log.h>
+#include <scm/gl_core/render_device/device.h>
+#include <scm/gl_core/render_device/opengl/gl_core.h>
+#include <scm/gl_core/shader_objects/program.h>
+#include <scm/gl_core/shader_objects/shader.h>
+#include <scm/gl_core/window_management/context.h>
+#include <scm/gl_core/window_management/surface.h>
+
+namespace scm {
+namespace gl {
+
+// shader_source //////////////////////////////////////////////////////////////////////////////////
+shader_source::shader_source(shader_stage                    in_stage,
+                             const std::string&              in_source,
+                             const std::string&              in_source_name,
+                             const shader_macro_array&       in_macros,
+                             const shader_include_path_list& in_inc_paths)
+  : _stage(in_stage)
+  , _source(in_source)
+  , _source_name(in_source_name)
+  , _macros(in_macros)
+  , _include_paths(in_inc_paths)
+{
+}
+
+// async_program //////////////////////////////////////////////////////////////////////////////////
+async_program::async_program(render_device&              in_device,
+                             const shader_source_array&  in_sources,
+                             const stream_capture_array& in_capture,
+                             bool                        in_rasterization_discard,
+                             const std::string&          in_program_name)
+  : _device(in_device)
+  , _sources(in_sources)
+  , _capture(in_capture)
+  , _rasterization_discard(in_rasterization_discard)
+  , _program_name(in_program_name)
+  , _status(STATUS_PENDING)
+{
+}
+
+async_program::~async_program()
+{
+}
+
+bool
+async_program::ready()
+{
+    return STATUS_READY == status();
+}
+
+bool
+async_program::failed()
+{
+    return STATUS_FAILED == status();
+}
+
+async_program::status_type
+async_program::status()
+{
+    poll_deferred_link(false);
+
+    boost::mutex::scoped_lock lock(_mutex);
+    return _status;
+}
+
+program_ptr
+async_program::result() const
+{
+    boost::mutex::scoped_lock lock(_mutex);
+    return _program;
+}
+
+program_ptr
+async_program::wait()
+{
+    poll_deferred_link(true);
+
+    boost::mutex::scoped_lock lock(_mutex);
+    while (STATUS_PENDING == _status) {
+        _finished_condition.wait(lock);
+    }
+    return _program;
+}
+
+const std::string&
+async_program::program_name() const
+{
+    return _program_name;
+}
+
+program_ptr
+async_program::build_program() const
+{
+    std::list<shader_ptr>   shaders;
+
+    foreach(const shader_source& s, _sources) {
+        shader_ptr new_shader = _device.create_shader(s._stage, s._source, s._macros, s._include_paths, s._source_name);
+        if (!new_shader) {
+            // error reported by create_shader
+            return program_ptr();
+        }
+        shaders.push_back(new_shader);
+    }
+
+    return _device.create_program(shaders, _capture, _rasterization_discard, _program_name);
+}
+
+void
+async_program::poll_deferred_link(bool in_wait)
+{
+    if (!_linking_program) {
+        return;
+    }
+    if (!in_wait && !_linking_program->link_completed(_device)) {
+        return;
+    }
+
+    program_ptr linked_program;
+    linked_program.swap(_linking_program);
+
+    if (linked_program->finish_link(_device)) {
+        if (!linked_program->info_log().empty()) {
+            glout() << log::info << "async_program::poll_deferred_link(): linker info ("
+                    << "name: " << _program_name << ")" << log::nline
+                    << linked_program->info_log() << log::end;
+        }
+        finish(linked_program);
+    }
+    else {
+        glerr() << "async_program::poll_deferred_link(): unable to create program ("
+                << "name: " << _program_name << ", "
+                << linked_program->state().state_string() << "):" << log::nline
+                << linked_program->info_log() << log::end;
+        finish(program_ptr());
+    }
+}
+
+void
+async_program::finish(const program_ptr& in_program)
+{
+    {
+        boost::mutex::scoped_lock lock(_mutex);
+        _program = in_program;
+        _status  = in_program ? STATUS_READY : STATUS_FAILED;
+    }
+    _finished_condition.notify_all();
+}
+
+// async_program_worker ///////////////////////////////////////////////////////////////////////////
+async_program_worker::async_program_worker(const wm::context_ptr& in_context,
+                                           const wm::surface_ptr& in_surface)
+  : _context(in_context)
+  , _surface(in_surface)
+  , _stop_requested(false)
+{
+}
+
+async_program_worker::~async_program_worker()
+{
+    stop();
+}
+
+bool
+async_program_worker::start()
+{
+    if (_worker_thread) {
+        return false;
+    }
+
+    _stop_requested = false;
+    try {
+        _worker_thread.reset(new boost::thread(boost::bind(&async_program_worker::worker_main, this)));
+    }
+    catch (const boost::thread_resource_error&) {
+        _worker_thread.reset();
+        return false;
+    }
+
+    return true;
+}
+
+void
+async_program_worker::stop()
+{
+    if (!_worker_thread) {
+        return;
+    }
+
+    {
+        boost::mutex::scoped_lock lock(_queue_mutex);
+        _stop_requested = true;
+    }
+    _queue_condition.notify_one();
+
+    _worker_thread->join();
+    _worker_thread.reset();
+}
+
+void
+async_program_worker::submit(const async_program_ptr& in_program)
+{
+    {
+        boost::mutex::scoped_lock lock(_queue_mutex);
+        _queue.push_back(in_program);
+    }
+    _queue_condition.notify_one();
+}
+
+void
+async_program_worker::worker_main()
+{
+    const bool context_current = _context->make_current(_surface, true);
+
+    if (!context_current) {
+        glerr() << log::error << "async_program_worker::worker_main(): "
+                << "unable to make worker context current, asynchronous programs will fail." << log::end;
+    }
+
+    for (;;) {
+        async_program_ptr next_program;
+        {
+            boost::mutex::scoped_lock lock(_queue_mutex);
+            while (_queue.empty() && !_stop_requested) {
+                _queue_condition.wait(lock);
+            }
+            if (_queue.empty()) {
+                break; // stop requested and all submitted programs finished
+            }
+            next_program = _queue.front();
+            _queue.pop_front();
+        }
+
+        if (context_current) {
+            program_ptr new_program = next_program->build_program();
+            // the program objects have to be complete before the main context uses them
+            next_program->_device.opengl_api().glFinish();
+            next_program->finish(new_program);
+        }
+        else {
+            next_program->finish(program_ptr());
+        }
+    }
+
+    if (context_current) {
+        _context->make_current(_surface, false);
+    }
+}
+
+} // namespace gl
+} // namespace scm
@@ -0,0 +1,141 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_CORE_ASYNC_PROGRAM_H_INCLUDED
+#define SCM_GL_CORE_ASYNC_PROGRAM_H_INCLUDED
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <scm/core/memory.h>
+
+#include <scm/gl_core/constants.h>
+#include <scm/gl_core/gl_core_fwd.h>
+#include <scm/gl_core/shader_objects/shader_macro.h>
+#include <scm/gl_core/shader_objects/shader_objects_fwd.h>
+#include <scm/gl_core/shader_objects/stream_capture.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+struct __scm_export(gl_core) shader_source {
+    shader_source(shader_stage                    in_stage,
+                  const std::string&              in_source,
+                  const std::string&              in_source_name = "",
+                  const shader_macro_array&       in_macros      = shader_macro_array(),
+                  const shader_include_path_list& in_inc_paths   = shader_include_path_list());
+
+    shader_stage                _stage;
+    std::string                 _source;
+    std::string                 _source_name;
+    shader_macro_array          _macros;
+    shader_include_path_list    _include_paths;
+}; // struct shader_source
+
+typedef std::vector<shader_source>  shader_source_array;
+
+// handle to a program created by render_device::create_program_async
+//  - ready() and failed() never block, with KHR_parallel_shader_compile they poll the driver
+//    and have to be called on the thread of the main context
+//  - result() returns the program once it is ready, wait() blocks until it is finished
+class __scm_export(gl_core) async_program : boost::noncopyable
+{
+public:
+    enum status_type {
+        STATUS_PENDING  = 0x00,
+        STATUS_READY,
+        STATUS_FAILED
+    }; // enum status_type
+
+public:
+    /*virtual*/ ~async_program();
+
+    bool                        ready();
+    bool                        failed();
+    status_type                 status();
+
+    program_ptr                 result() const;
+    program_ptr                 wait();
+
+    const std::string&          program_name() const;
+
+protected:
+    async_program(render_device&              in_device,
+                  const shader_source_array&  in_sources,
+                  const stream_capture_array& in_capture,
+                  bool                        in_rasterization_discard,
+                  const std::string&          in_program_name);
+
+    // creates the program synchronously on the calling thread (worker thread or fallback)
+    program_ptr                 build_program() const;
+    // completes a deferred link started on the main context (KHR_parallel_shader_compile)
+    void                        poll_deferred_link(bool in_wait);
+    void                        finish(const program_ptr& in_program);
+
+protected:
+    render_device&              _device;
+
+    shader_source_array         _sources;
+    stream_capture_array        _capture;
+    bool                        _rasterization_discard;
+    std::string                 _program_name;
+
+    // a pending deferred link, only accessed from the main context thread
+    program_ptr                 _linking_program;
+
+    mutable boost::mutex        _mutex;
+    boost::condition_variable   _finished_condition;
+    status_type                 _status;
+    program_ptr                 _program;
+
+    friend class scm::gl::render_device;
+    friend class scm::gl::async_program_worker;
+}; // class async_program
+
+// builds asynchronous programs on a thread owning a context sharing its objects with the
+// context of the render device
+class __scm_export(gl_core) async_program_worker : boost::noncopyable
+{
+public:
+    /*virtual*/ ~async_program_worker();
+
+protected:
+    async_program_worker(const wm::context_ptr& in_context,
+                         const wm::surface_ptr& in_surface);
+
+    bool                        start();
+    void                        stop();
+    void                        submit(const async_program_ptr& in_program);
+
+    void                        worker_main();
+
+protected:
+    wm::context_ptr             _context;
+    wm::surface_ptr             _surface;
+
+    boost::mutex                    _queue_mutex;
+    boost::condition_variable       _queue_condition;
+    std::deque<async_program_ptr>   _queue;
+    bool                            _stop_requested;
+
+    scm::scoped_ptr<boost::thread>  _worker_thread;
+
+    friend class scm::gl::render_device;
+}; // class async_program_worker
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_CORE_ASYNC_PROGRAM_H_INCLUDED
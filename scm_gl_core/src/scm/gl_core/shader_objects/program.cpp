@@ -26,6 +26,7 @@
 #include <scm/gl_core/render_device/opengl/util/constants_helper.h>
 #include <scm/gl_core/render_device/opengl/util/data_type_helper.h>
 #include <scm/gl_core/render_device/opengl/util/error_helper.h>
+#include <scm/gl_core/shader_objects/program_binary_cache.h>
 #include <scm/gl_core/shader_objects/shader.h>
 #include <scm/gl_core/shader_objects/stream_capture.h>
 
@@ -39,9 +40,13 @@ program::program(render_device&              in_device,
                  const stream_capture_array& in_capture,
                  bool                        in_rasterization_discard,
                  const named_location_list&  in_attribute_locations,
-                 const named_location_list&  in_fragment_locations)
+                 const named_location_list&  in_fragment_locations,
+                 bool                        in_deferred_link)
   : render_device_child(in_device)
   , _rasterization_discard(in_rasterization_discard)
+  , _link_pending(false)
+  , _store_binary(false)
+  , _binary_key(0)
 {
     const opengl::gl_core& glapi = in_device.opengl_api();
     util::gl_error          glerror(glapi);
@@ -51,49 +56,91 @@ program::program(render_device&              in_device,
         state().set(object_state::OS_BAD);
     }
     else {
-        // attach all shaders
-        foreach(const shader_ptr& s, in_shaders) {
-            if (s) {
-                glapi.glAttachShader(_gl_program_obj, s->_gl_shader_obj);
-                if (!glerror) {
+        const program_binary_cache_ptr& binary_cache = in_device.program_cache();
+        scm::uint64                     binary_key   = 0;
+        bool                            use_cache    =    binary_cache
+                                                       && binary_cache_key(*binary_cache, in_shaders, in_capture,
+                                                                           in_attribute_locations, in_fragment_locations,
+                                                                           binary_key);
+
+        if (use_cache && load_program_binary(in_device, *binary_cache, binary_key)) {
+            // linked from the cached binary, the shaders are kept for their lifetime only
+            foreach(const shader_ptr& s, in_shaders) {
+                if (s) {
                     _shaders.push_back(s);
                 }
+            }
+        }
+        else {
+            // compile the shaders deferred by the program binary cache, a deferred link
+            // only starts the compilation, errors are reported by finish_link()
+            foreach(const shader_ptr& s, in_shaders) {
+                if (s && in_deferred_link) {
+                    s->submit_compile(in_device);
+                }
+                else if (s && !s->compile(in_device)) {
+                    state().set(object_state::OS_ERROR_SHADER_COMPILE);
+                    _info_log += shader_stage_string(s->type()) + std::string(":\n") + s->info_log();
+                }
+            }
+            if (fail()) {
+                return;
+            }
+            // attach all shaders
+            foreach(const shader_ptr& s, in_shaders) {
+                if (s) {
+                    glapi.glAttachShader(_gl_program_obj, s->_gl_shader_obj);
+                    if (!glerror) {
+                        _shaders.push_back(s);
+                    }
+                    else {
+                        state().set(object_state::OS_ERROR_INVALID_VALUE);
+                    }
+                }
                 else {
                     state().set(object_state::OS_ERROR_INVALID_VALUE);
                 }
             }
-            else {
-                state().set(object_state::OS_ERROR_INVALID_VALUE);
+            gl_assert(glapi, program::program() attaching shader objects);
+            // set the captured transform feedback varyings
+            if (!in_capture.empty()) {
+                if (!apply_transform_feedback_varyings(in_device, in_capture)) {
+                    // error code set in function itself
+                    return;
+                }
             }
-        }
-        gl_assert(glapi, program::program() attaching shader objects);
-        // set the captured transform feedback varyings
-        if (!in_capture.empty()) {
-            if (!apply_transform_feedback_varyings(in_device, in_capture)) {
-                // error code set in function itself
-                return;
+            // set default attribute locations
+            foreach(const named_location& l, in_attribute_locations) {
+                glapi.glBindAttribLocation(_gl_program_obj, l.second, l.first.c_str());
+                gl_assert(glapi, program::program() binding attribute location);
+            }
+            // set default fragdata locations
+            foreach(const named_location& l, in_fragment_locations) {
+                glapi.glBindFragDataLocation(_gl_program_obj, l.second, l.first.c_str());
+                gl_assert(glapi, program::program() binding fragdata location);
+            }
+            if (use_cache) {
+                glapi.glProgramParameteri(_gl_program_obj, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            }
+            // link program
+            if (in_deferred_link) {
+                glapi.glLinkProgram(_gl_program_obj);
+                _link_pending = true;
+                _store_binary = use_cache;
+                _binary_key   = binary_key;
+            }
+            else {
+                link(in_device);
+
+                if (ok() && use_cache) {
+                    store_program_binary(in_device, *binary_cache, binary_key);
+                }
             }
         }
-        // set default attribute locations
-        foreach(const named_location& l, in_attribute_locations) {
-            glapi.glBindAttribLocation(_gl_program_obj, l.second, l.first.c_str());
-            gl_assert(glapi, program::program() binding attribute location);
-        }
-        // set default fragdata locations
-        foreach(const named_location& l, in_fragment_locations) {
-            glapi.glBindFragDataLocation(_gl_program_obj, l.second, l.first.c_str());
-            gl_assert(glapi, program::program() binding fragdata location);
-        }
-        // link program
-        link(in_device);
 
         // retrieve information
-        if (ok()) {
-            util::program_binding_guard save_guard(glapi);
-            glapi.glUseProgram(_gl_program_obj);
-            retrieve_attribute_information(in_device);
-            retrieve_fragdata_information(in_device);
-            retrieve_uniform_information(in_device);
+        if (ok() && !_link_pending) {
+            retrieve_information(in_device);
         }
     }
     
@@ -106,6 +153,13 @@ program::~program()
 
     // TODO detach all shaders and remove them from _shaders;
 
+    // uniforms held outside of the program must not reference the dirty list anymore
+    name_uniform_map::const_iterator u = _uniforms.begin();
+    name_uniform_map::const_iterator e = _uniforms.end();
+    for (; u != e; ++u) {
+        u->second->_dirty_list = 0;
+    }
+
     assert(0 != _gl_program_obj);
     glapi.glDeleteProgram(_gl_program_obj);
 
@@ -123,12 +177,23 @@ program::link(render_device& ren_dev)
 {
     assert(_gl_program_obj != 0);
 
+    const opengl::gl_core& glapi = ren_dev.opengl_api();
+
+    glapi.glLinkProgram(_gl_program_obj);
+
+    return retrieve_link_status(ren_dev);
+}
+
+bool
+program::retrieve_link_status(render_device& ren_dev)
+{
+    assert(_gl_program_obj != 0);
+
     const opengl::gl_core& glapi = ren_dev.opengl_api();
     util::gl_error          glerror(glapi);
 
     int link_state  = 0;
 
-    glapi.glLinkProgram(_gl_program_obj);
     glapi.glGetProgramiv(_gl_program_obj, GL_LINK_STATUS, &link_state);
 
     if (GL_TRUE != link_state) {
@@ -149,6 +214,68 @@ program::link(render_device& ren_dev)
     return (GL_TRUE == link_state);
 }
 
+bool
+program::link_completed(render_device& ren_dev) const
+{
+    assert(_gl_program_obj != 0);
+
+    const opengl::gl_core& glapi = ren_dev.opengl_api();
+
+    if (!_link_pending) {
+        return true;
+    }
+    if (!glapi.extension_KHR_parallel_shader_compile) {
+        // no way to ask without blocking
+        return false;
+    }
+
+    int completion_status = GL_FALSE;
+    glapi.glGetProgramiv(_gl_program_obj, GL_COMPLETION_STATUS_KHR, &completion_status);
+
+    return (GL_FALSE != completion_status);
+}
+
+bool
+program::finish_link(render_device& ren_dev)
+{
+    if (!_link_pending) {
+        return ok();
+    }
+    _link_pending = false;
+
+    if (!retrieve_link_status(ren_dev)) {
+        // the link failed because of a shader, report the compiler errors instead
+        foreach(const shader_ptr& s, _shaders) {
+            if (!s->compile(ren_dev)) {
+                state().set(object_state::OS_ERROR_SHADER_COMPILE);
+                _info_log += shader_stage_string(s->type()) + std::string(":\n") + s->info_log();
+            }
+        }
+        return false;
+    }
+
+    const program_binary_cache_ptr& binary_cache = ren_dev.program_cache();
+    if (_store_binary && binary_cache) {
+        store_program_binary(ren_dev, *binary_cache, _binary_key);
+    }
+
+    retrieve_information(ren_dev);
+
+    return ok();
+}
+
+void
+program::retrieve_information(render_device& in_device)
+{
+    const opengl::gl_core& glapi = in_device.opengl_api();
+
+    util::program_binding_guard save_guard(glapi);
+    glapi.glUseProgram(_gl_program_obj);
+    retrieve_attribute_information(in_device);
+    retrieve_fragdata_information(in_device);
+    retrieve_uniform_information(in_device);
+}
+
 bool
 program::validate(render_context& ren_ctx)
 {
@@ -177,27 +304,14 @@ program::bind_uniforms(render_context& ren_ctx) const
 
     const opengl::gl_core& glapi = ren_ctx.opengl_api();
 
-    { // uniforms
-        name_uniform_map::const_iterator u = _uniforms.begin();
-        name_uniform_map::const_iterator e = _uniforms.end();
+    { // uniforms, only the ones changed since the last apply
+        uniform_base::dirty_list::const_iterator u = _dirty_uniforms.begin();
+        uniform_base::dirty_list::const_iterator e = _dirty_uniforms.end();
         for (; u != e; ++u) {
-            //std::cout << u->first << std::endl;
-            if (u->second->update_required()) {
-                u->second->apply_value(ren_ctx, *this);
-                u->second->_status._update_required = false;
-            }
-            //if (u->second._update_required) {
-                //std::cout << u->second._name << std::endl;
-//#if SCM_GL_CORE_USE_DIRECT_STATE_ACCESS
-//                boost::apply_visitor(detail::uniform_bind_dsa(glapi, _gl_program_obj, u->second), u->second._data);
-//#else
-//                boost::apply_visitor(detail::uniform_bind(glapi, u->second), u->second._data);
-//#endif // SCM_GL_CORE_USE_DIRECT_STATE_ACCESS
-            //    gl_assert(glapi, program::bind_uniforms() after apply uniform);
-
-            //    u->second._update_required = false;
-            //}
+            (*u)->apply_value(ren_ctx, *this);
+            (*u)->_status._update_required = false;
         }
+        _dirty_uniforms.clear(); // keeps the capacity, no allocations in the next frames
     }
     { // uniform buffers
         name_uniform_block_map::const_iterator b = _uniform_blocks.begin();
@@ -211,27 +325,139 @@ program::bind_uniforms(render_context& ren_ctx) const
             }
         }
     }
-#if 1
-    { // subroutines
+    { // subroutines, the selection is lost with every program change and has to be set each time
         for (int s = 0; s < SHADER_STAGE_COUNT; ++s) {
-            name_subroutine_uniform_map::const_iterator b = _subroutine_uniforms[s].begin();
-            name_subroutine_uniform_map::const_iterator e = _subroutine_uniforms[s].end();
-            int indices_size = static_cast<int>(_subroutine_uniforms[s].size());
-            scoped_array<unsigned>  indices;
-            if (0 < indices_size) {
-                indices.reset(new unsigned[indices_size]);
+            if (!_subroutine_indices[s].empty()) {
+                glapi.glUniformSubroutinesuiv(util::gl_shader_types(static_cast<shader_stage>(s)),
+                                              static_cast<int>(_subroutine_indices[s].size()),
+                                              &_subroutine_indices[s].front());
             }
-            for (; b != e; ++b) {
-                int       l  = b->second._location;
-                indices[l] = b->second._selected_routine;
+        }
+    }
+    gl_assert(glapi, leaving program::bind_uniforms());
+}
+
+bool
+program::binary_cache_key(const program_binary_cache&  in_cache,
+                          const shader_list&           in_shaders,
+                          const stream_capture_array&  in_capture,
+                          const named_location_list&   in_attribute_locations,
+                          const named_location_list&   in_fragment_locations,
+                                scm::uint64&           out_key) const
+{
+    typedef program_binary_cache pbc;
+
+    pbc::key_type key = in_cache.base_key();
+
+    foreach(const shader_ptr& s, in_shaders) {
+        if (!s || (s->_compiled && s->_preprocessed_source.empty())) {
+            // shaders created before the cache was enabled keep no source to identify them
+            return false;
+        }
+        key = pbc::hash_combine(key, static_cast<scm::uint64>(s->type()));
+        key = pbc::hash_combine(key, s->_preprocessed_source);
+    }
+
+    key = pbc::hash_combine(key, static_cast<scm::uint64>(in_capture.used_streams()));
+    key = pbc::hash_combine(key, static_cast<scm::uint64>(in_capture.interleaved_streams()));
+    for (int stream = 0; stream < in_capture.used_streams(); ++stream) {
+        const stream_capture::captures_list& captures = in_capture.stream_captures(stream).captures();
+        key = pbc::hash_combine(key, static_cast<scm::uint64>(captures.size()));
+
+        stream_capture::captures_list::const_iterator b = captures.begin();
+        stream_capture::captures_list::const_iterator e = captures.end();
+        for (; b != e; ++b) {
+            if (const std::string* varying_name = boost::get<std::string>(&(*b))) {
+                key = pbc::hash_combine(key, *varying_name);
             }
-            if (0 < indices_size) {
-                glapi.glUniformSubroutinesuiv(util::gl_shader_types(static_cast<shader_stage>(s)), indices_size, indices.get());
+            else if (const stream_capture::skip_components_type* skip = boost::get<stream_capture::skip_components_type>(&(*b))) {
+                key = pbc::hash_combine(key, static_cast<scm::uint64>(*skip));
             }
         }
     }
-#endif
-    gl_assert(glapi, leaving program::bind_uniforms());
+
+    foreach(const named_location& l, in_attribute_locations) {
+        key = pbc::hash_combine(key, l.first);
+        key = pbc::hash_combine(key, static_cast<scm::uint64>(l.second));
+    }
+    key = pbc::hash_combine(key, static_cast<scm::uint64>(in_attribute_locations.size()));
+    foreach(const named_location& l, in_fragment_locations) {
+        key = pbc::hash_combine(key, l.first);
+        key = pbc::hash_combine(key, static_cast<scm::uint64>(l.second));
+    }
+    key = pbc::hash_combine(key, static_cast<scm::uint64>(in_fragment_locations.size()));
+
+    out_key = key;
+
+    return true;
+}
+
+bool
+program::load_program_binary(render_device&              in_device,
+                             const program_binary_cache& in_cache,
+                             scm::uint64                 in_key)
+{
+    assert(_gl_program_obj != 0);
+
+    const opengl::gl_core& glapi = in_device.opengl_api();
+    util::gl_error          glerror(glapi);
+
+    unsigned                            binary_format = 0;
+    program_binary_cache::binary_data   binary;
+
+    if (!in_cache.load(in_key, binary_format, binary)) {
+        return false;
+    }
+
+    int link_state = 0;
+
+    glapi.glProgramBinary(_gl_program_obj, binary_format, &binary.front(), static_cast<int>(binary.size()));
+    glapi.glGetProgramiv(_gl_program_obj, GL_LINK_STATUS, &link_state);
+
+    if (glerror || GL_TRUE != link_state) {
+        // driver update or different hardware, the program is linked from source and stored again
+        glout() << log::info << "program::load_program_binary(): "
+                << "cached program binary rejected, linking from source." << log::end;
+        in_cache.remove(in_key);
+        return false;
+    }
+
+    gl_assert(glapi, leaving program::load_program_binary());
+
+    return true;
+}
+
+bool
+program::store_program_binary(render_device&              in_device,
+                              const program_binary_cache& in_cache,
+                              scm::uint64                 in_key)
+{
+    assert(_gl_program_obj != 0);
+
+    const opengl::gl_core& glapi = in_device.opengl_api();
+    util::gl_error          glerror(glapi);
+
+    int binary_length = 0;
+    glapi.glGetProgramiv(_gl_program_obj, GL_PROGRAM_BINARY_LENGTH, &binary_length);
+
+    if (0 >= binary_length) {
+        return false;
+    }
+
+    unsigned                            binary_format = 0;
+    program_binary_cache::binary_data   binary(binary_length);
+
+    glapi.glGetProgramBinary(_gl_program_obj, binary_length, 0, &binary_format, &binary.front());
+
+    if (glerror) {
+        glout() << log::warning << "program::store_program_binary(): "
+                << "unable to retrieve program binary (" << glerror.error_string() << ")." << log::end;
+        return false;
+    }
+
+    gl_assert(glapi, leaving program::store_program_binary());
+
+    return in_cache.store(in_key, binary_format, binary);
 }
 
 bool
@@ -550,6 +776,7 @@ program::retrieve_uniform_information(render_device& in_device)
                 }
 
                 if (current_uniform) {
+                    current_uniform->_dirty_list = &_dirty_uniforms;
                     _uniforms[actual_uniform_name] = current_uniform;
                 }
             }
@@ -624,6 +851,13 @@ program::retrieve_uniform_information(render_device& in_device)
 
                 }
                 gl_assert(glapi, program::retrieve_uniform_information() after retrieving subroutine uniform info);
+
+                // subroutine uniform arrays occupy multiple locations
+                int act_routine_locations = 0;
+                glapi.glGetProgramStageiv(_gl_program_obj, util::gl_shader_types(static_cast<shader_stage>(stge)),
+                                          GL_ACTIVE_SUBROUTINE_UNIFORM_LOCATIONS, &act_routine_locations);
+                _subroutine_indices[stge].assign(act_routine_locations, 0u);
+                gl_assert(glapi, program::retrieve_uniform_information() after retrieving subroutine uniform locations);
             }
 #if 0
             if (0){ // subroutines
@@ -728,6 +962,8 @@ program::uniform_subroutine(const shader_stage stage, const std::string& name, c
     if (subr != _subroutine_uniforms[stage].end()) {
         if (rout != _subroutines[stage].end()) {
             subr->second._selected_routine = rout->second._index;
+            assert(subr->second._location < static_cast<int>(_subroutine_indices[stage].size()));
+            _subroutine_indices[stage][subr->second._location] = rout->second._index;
         }
         else {
             SCM_GL_DGB("program::uniform_subroutine(): unable to find routine ('" << name << "').");
@@ -83,6 +83,9 @@ public:
 
     template<typename T> void   uniform(const std::string& name, const T& v) const;
     template<typename T> void   uniform(const std::string& name, int i, const T& v) const;
+    // resolves the typed uniform once, values set through the handle skip the name lookup
+    template<typename T>
+    scm::gl::uniform_handle<T>  resolve_uniform(const std::string& name) const;
 
     uniform_ptr                 uniform_raw(const std::string& name) const;
 
@@ -130,9 +133,16 @@ protected:
             const stream_capture_array& in_capture,
             bool                        in_rasterization_discard = false,
             const named_location_list&  in_attribute_locations = named_location_list(),
-            const named_location_list&  in_fragment_locations  = named_location_list());
+            const named_location_list&  in_fragment_locations  = named_location_list(),
+            bool                        in_deferred_link       = false);
 
     bool                        link(render_device& ren_dev);
+    bool                        retrieve_link_status(render_device& ren_dev);
+    // deferred link (asynchronous programs), link_completed() does not block with
+    // KHR_parallel_shader_compile, finish_link() waits for the result
+    bool                        link_completed(render_device& ren_dev) const;
+    bool                        finish_link(render_device& ren_dev);
+    void                        retrieve_information(render_device& in_device);
     bool                        validate(render_context& ren_ctx);
     
     void                        bind(render_context& ren_ctx) const;
@@ -140,6 +150,19 @@ protected:
 
     bool                        apply_transform_feedback_varyings(render_device& in_device, const stream_capture_array& in_capture); 
 
+    bool                        binary_cache_key(const program_binary_cache&  in_cache,
+                                                 const shader_list&           in_shaders,
+                                                 const stream_capture_array&  in_capture,
+                                                 const named_location_list&   in_attribute_locations,
+                                                 const named_location_list&   in_fragment_locations,
+                                                       scm::uint64&           out_key) const;
+    bool                        load_program_binary(render_device&              in_device,
+                                                    const program_binary_cache& in_cache,
+                                                    scm::uint64                 in_key);
+    bool                        store_program_binary(render_device&              in_device,
+                                                     const program_binary_cache& in_cache,
+                                                     scm::uint64                 in_key);
+
     void                        retrieve_attribute_information(render_device& in_device);
     void                        retrieve_fragdata_information(render_device& in_device);
     void                        retrieve_uniform_information(render_device& in_device);
@@ -155,12 +178,22 @@ protected:
     name_location_map           _samplers;
     name_subroutine_uniform_map _subroutine_uniforms[SHADER_STAGE_COUNT];
     name_subroutine_map         _subroutines[SHADER_STAGE_COUNT];
+    // selected routine per subroutine uniform location, uploaded as is in bind_uniforms
+    std::vector<unsigned>       _subroutine_indices[SHADER_STAGE_COUNT];
+
+    // uniforms changed since the last bind_uniforms
+    mutable uniform_base::dirty_list  _dirty_uniforms;
 
     unsigned                    _gl_program_obj;
     std::string                 _info_log;
 
+    bool                        _link_pending;
+    bool                        _store_binary;
+    scm::uint64                 _binary_key;
+
     friend class scm::gl::render_device;
     friend class scm::gl::render_context;
+    friend class scm::gl::async_program;
 }; // class program
 
 } // namespace gl
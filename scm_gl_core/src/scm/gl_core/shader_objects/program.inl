@@ -42,6 +42,28 @@ program::uniform(const std::string& name, int i, const T& v) const {
     }
 }
 
+template<typename T>
+inline
+uniform_handle<T>
+program::resolve_uniform(const std::string& name) const {
+    typedef typename uniform_handle<T>::uniform_value_type cur_uniform_type;
+    const uniform_ptr u = uniform_raw(name);
+    if (u) {
+        const shared_ptr<cur_uniform_type> ut = dynamic_pointer_cast<cur_uniform_type>(u);
+        if (ut) {
+            return uniform_handle<T>(ut);
+        }
+        else {
+            SCM_GL_DGB("program::resolve_uniform(): found non matching uniform type '" << type_string(uniform_data_type<T>::type)
+                                                                                       << "' ('uniform: " << name << ", " << type_string(u->type()) << ").");
+        }
+    }
+    else {
+        SCM_GL_DGB("program::resolve_uniform(): unable to find uniform ('" << name << "').");
+    }
+    return uniform_handle<T>();
+}
+
 inline uniform_sampler_ptr
 program::uniform_sampler(const std::string& name) const {
     return (dynamic_pointer_cast<scm::gl::uniform_sampler>(uniform_raw(name)));
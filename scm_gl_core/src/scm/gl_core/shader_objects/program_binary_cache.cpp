@@ -0,0 +1,228 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "program_binary_cache.h"
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <scm/gl_core/log.h>
+
+namespace scm {
+namespace gl {
+namespace {
+
+const char          cache_file_magic[8]   = { 'S', 'C', 'M', 'P', 'B', 'I', 'N', 0 };
+const scm::uint32   cache_file_version    = 1;
+const char*         cache_file_extension  = ".glpb";
+
+struct cache_file_header
+{
+    char            _magic[8];
+    scm::uint32     _version;
+    scm::uint32     _format;
+    scm::uint64     _key;
+    scm::uint64     _size;
+}; // struct cache_file_header
+
+} // namespace
+
+program_binary_cache::program_binary_cache(const std::string& in_cache_directory,
+                                           const std::string& in_driver_string)
+  : _cache_directory(in_cache_directory)
+  , _driver_key(hash_combine(hash_seed(), in_driver_string))
+  , _include_key(hash_seed())
+{
+}
+
+program_binary_cache::~program_binary_cache()
+{
+}
+
+const std::string&
+program_binary_cache::cache_directory() const
+{
+    return _cache_directory;
+}
+
+program_binary_cache::key_type
+program_binary_cache::driver_key() const
+{
+    return _driver_key;
+}
+
+program_binary_cache::key_type
+program_binary_cache::include_key() const
+{
+    return _include_key;
+}
+
+void
+program_binary_cache::include_key(key_type in_key)
+{
+    _include_key = in_key;
+}
+
+program_binary_cache::key_type
+program_binary_cache::base_key() const
+{
+    return hash_combine(_driver_key, _include_key);
+}
+
+bool
+program_binary_cache::load(key_type       in_key,
+                           unsigned&      out_format,
+                           binary_data&   out_binary) const
+{
+    std::ifstream   cache_file(cache_file_name(in_key).c_str(), std::ios_base::in | std::ios_base::binary);
+
+    if (!cache_file) {
+        return false; // not cached yet
+    }
+
+    cache_file_header   header;
+    cache_file.read(reinterpret_cast<char*>(&header), sizeof(cache_file_header));
+
+    if (   !cache_file
+        || 0 != std::memcmp(header._magic, cache_file_magic, sizeof(cache_file_magic))
+        || header._version != cache_file_version
+        || header._key     != in_key
+        || header._size    == 0)
+    {
+        glout() << log::warning << "program_binary_cache::load(): "
+                << "ignoring invalid cache file " << cache_file_name(in_key) << log::end;
+        return false;
+    }
+
+    out_binary.resize(static_cast<scm::size_t>(header._size));
+    cache_file.read(&out_binary.front(), static_cast<std::streamsize>(header._size));
+
+    if (!cache_file) {
+        glout() << log::warning << "program_binary_cache::load(): "
+                << "ignoring truncated cache file " << cache_file_name(in_key) << log::end;
+        out_binary.clear();
+        return false;
+    }
+
+    out_format = header._format;
+
+    return true;
+}
+
+bool
+program_binary_cache::store(key_type           in_key,
+                            unsigned           in_format,
+                            const binary_data& in_binary) const
+{
+    namespace bfs = boost::filesystem;
+
+    if (in_binary.empty()) {
+        return false;
+    }
+
+    const std::string   file_name = cache_file_name(in_key);
+    // the temporary name is unique per call, processes sharing the cache directory never
+    // write to the same temporary file
+    const std::string   temp_name = bfs::unique_path(file_name + ".%%%%-%%%%-%%%%-%%%%.tmp").string();
+
+    { // the binary is written to a temporary file first, a concurrently starting
+      // application never sees a partially written cache file
+        std::ofstream   cache_file(temp_name.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+
+        if (!cache_file) {
+            glout() << log::warning << "program_binary_cache::store(): "
+                    << "unable to open cache file " << temp_name << " for writing." << log::end;
+            return false;
+        }
+
+        cache_file_header   header;
+        std::memcpy(header._magic, cache_file_magic, sizeof(cache_file_magic));
+        header._version = cache_file_version;
+        header._format  = in_format;
+        header._key     = in_key;
+        header._size    = in_binary.size();
+
+        cache_file.write(reinterpret_cast<const char*>(&header), sizeof(cache_file_header));
+        cache_file.write(&in_binary.front(), static_cast<std::streamsize>(in_binary.size()));
+
+        if (!cache_file) {
+            glout() << log::warning << "program_binary_cache::store(): "
+                    << "error writing cache file " << temp_name << log::end;
+            cache_file.close();
+            boost::system::error_code   ec;
+            bfs::remove(temp_name, ec);
+            return false;
+        }
+    }
+
+    boost::system::error_code   ec;
+    bfs::rename(temp_name, file_name, ec);
+    if (ec) {
+        glout() << log::warning << "program_binary_cache::store(): "
+                << "unable to rename cache file " << temp_name << " (" << ec.message() << ")." << log::end;
+        bfs::remove(temp_name, ec);
+        return false;
+    }
+
+    return true;
+}
+
+void
+program_binary_cache::remove(key_type in_key) const
+{
+    boost::system::error_code   ec;
+    boost::filesystem::remove(cache_file_name(in_key), ec);
+}
+
+program_binary_cache::key_type
+program_binary_cache::hash_combine(key_type in_key, const void* in_data, scm::size_t in_size)
+{
+    const scm::uint64   fnv_prime = 0x100000001b3ull;
+    const scm::uint8*   data      = static_cast<const scm::uint8*>(in_data);
+
+    for (scm::size_t i = 0; i < in_size; ++i) {
+        in_key ^= data[i];
+        in_key *= fnv_prime;
+    }
+
+    return in_key;
+}
+
+program_binary_cache::key_type
+program_binary_cache::hash_combine(key_type in_key, const std::string& in_string)
+{
+    // the length separates consecutive strings ("ab" + "c" != "a" + "bc")
+    in_key = hash_combine(in_key, static_cast<scm::uint64>(in_string.size()));
+    return hash_combine(in_key, in_string.data(), in_string.size());
+}
+
+program_binary_cache::key_type
+program_binary_cache::hash_combine(key_type in_key, scm::uint64 in_value)
+{
+    return hash_combine(in_key, &in_value, sizeof(scm::uint64));
+}
+
+program_binary_cache::key_type
+program_binary_cache::hash_seed()
+{
+    return 0xcbf29ce484222325ull;
+}
+
+std::string
+program_binary_cache::cache_file_name(key_type in_key) const
+{
+    std::ostringstream  file_name;
+
+    file_name << std::hex << std::setfill('0') << std::setw(16) << in_key << cache_file_extension;
+
+    return (boost::filesystem::path(_cache_directory) / file_name.str()).string();
+}
+
+} // namespace gl
+} // namespace scm
@@ -0,0 +1,79 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_CORE_PROGRAM_BINARY_CACHE_H_INCLUDED
+#define SCM_GL_CORE_PROGRAM_BINARY_CACHE_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include <scm/core/numeric_types.h>
+#include <scm/core/memory.h>
+
+#include <scm/gl_core/shader_objects/shader_objects_fwd.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// on-disk store of linked program binaries (glGetProgramBinary/glProgramBinary)
+//  - one file per program, named after the 64bit key of everything that influences
+//    the linked result: preprocessed shader sources (including the macro defines),
+//    shader include strings, transform feedback setup and the driver (vendor,
+//    renderer and version strings)
+//  - binaries rejected by the driver are removed, the program is then linked from
+//    source and stored again
+class __scm_export(gl_core) program_binary_cache : boost::noncopyable
+{
+public:
+    typedef scm::uint64         key_type;
+    typedef std::vector<char>   binary_data;
+
+public:
+    program_binary_cache(const std::string& in_cache_directory,
+                         const std::string& in_driver_string);
+    /*virtual*/ ~program_binary_cache();
+
+    const std::string&          cache_directory() const;
+    key_type                    driver_key() const;
+    // key of all shader include strings known to the device
+    key_type                    include_key() const;
+    void                        include_key(key_type in_key);
+    // combined driver and include key, the seed for the program keys
+    key_type                    base_key() const;
+
+    bool                        load(key_type       in_key,
+                                     unsigned&      out_format,
+                                     binary_data&   out_binary) const;
+    bool                        store(key_type           in_key,
+                                      unsigned           in_format,
+                                      const binary_data& in_binary) const;
+    void                        remove(key_type in_key) const;
+
+    // 64bit FNV-1a, in_key is the running hash value to combine multiple strings
+    static key_type             hash_combine(key_type in_key, const void* in_data, scm::size_t in_size);
+    static key_type             hash_combine(key_type in_key, const std::string& in_string);
+    static key_type             hash_combine(key_type in_key, scm::uint64 in_value);
+    static key_type             hash_seed();
+
+protected:
+    std::string                 cache_file_name(key_type in_key) const;
+
+protected:
+    std::string                 _cache_directory;
+    key_type                    _driver_key;
+    key_type                    _include_key;
+
+}; // class program_binary_cache
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_CORE_PROGRAM_BINARY_CACHE_H_INCLUDED
@@ -67,10 +67,13 @@ shader::shader(render_device&                  ren_dev,
                const std::string&              in_src,
                const std::string&              in_src_name,
                const shader_macro_array&       in_macros,
-               const shader_include_path_list& in_inc_paths)
+               const shader_include_path_list& in_inc_paths,
+               bool                            in_defer_compile)
   : render_device_child(ren_dev),
     _type(in_type),
-    _gl_shader_obj(0)
+    _gl_shader_obj(0),
+    _compiled(false),
+    _compile_status_pending(false)
 {
     const opengl::gl_core& glapi = ren_dev.opengl_api();
     util::gl_error          glerror(glapi);
@@ -82,7 +85,15 @@ shader::shader(render_device&                  ren_dev,
     else {
         std::string preprocessed_source;
         if (preprocess_source_string(ren_dev, in_src, in_src_name, in_macros, preprocessed_source)) {
-            compile_source_string(ren_dev, preprocessed_source, in_inc_paths);
+            if (in_defer_compile || ren_dev.program_cache()) {
+                // compiled by the first program not found in the binary cache
+                _preprocessed_source.swap(preprocessed_source);
+                _include_paths = in_inc_paths;
+            }
+            else {
+                compile_source_string(ren_dev, preprocessed_source, in_inc_paths);
+                _compiled = true;
+            }
         }
         else {
             state().set(object_state::OS_ERROR_SHADER_COMPILE);
@@ -205,6 +216,16 @@ bool
 shader::compile_source_string(      render_device&            ren_dev,
                               const std::string&              in_src,
                               const shader_include_path_list& in_inc_paths)
+{
+    submit_source_string(ren_dev, in_src, in_inc_paths);
+
+    return retrieve_compile_status(ren_dev);
+}
+
+void
+shader::submit_source_string(      render_device&            ren_dev,
+                             const std::string&              in_src,
+                             const shader_include_path_list& in_inc_paths)
 {
     const opengl::gl_core& glapi = ren_dev.opengl_api();
     util::gl_error          glerror(glapi);
@@ -235,6 +256,12 @@ shader::compile_source_string(      render_device&            ren_dev,
     else {
         glapi.glCompileShader(_gl_shader_obj);                                                                          gl_assert(glapi, shader::compile_source_string() after glCompileShader);
     }
+}
+
+bool
+shader::retrieve_compile_status(render_device& ren_dev)
+{
+    const opengl::gl_core& glapi = ren_dev.opengl_api();
 
     int compile_state = 0;
     glapi.glGetShaderiv(_gl_shader_obj, GL_COMPILE_STATUS, &compile_state);
@@ -257,5 +284,28 @@ shader::compile_source_string(      render_device&            ren_dev,
     return (GL_TRUE == compile_state);
 }
 
+bool
+shader::compile(render_device& ren_dev)
+{
+    submit_compile(ren_dev);
+
+    if (_compile_status_pending) {
+        _compile_status_pending = false;
+        retrieve_compile_status(ren_dev);
+    }
+
+    return ok();
+}
+
+void
+shader::submit_compile(render_device& ren_dev)
+{
+    if (!_compiled) {
+        _compiled               = true;
+        _compile_status_pending = true;
+        submit_source_string(ren_dev, _preprocessed_source, _include_paths);
+    }
+}
+
 } // namespace gl
 } // namespace scm
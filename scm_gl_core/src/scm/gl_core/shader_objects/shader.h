@@ -36,7 +36,8 @@ protected:
            const std::string&              in_src,
            const std::string&              in_src_name,
            const shader_macro_array&       in_macros,
-           const shader_include_path_list& in_inc_paths);
+           const shader_include_path_list& in_inc_paths,
+           bool                            in_defer_compile = false);
 
     bool   preprocess_source_string(      render_device&      ren_dev,
                                     const std::string&        in_src,
@@ -46,6 +47,14 @@ protected:
     bool   compile_source_string(      render_device&            ren_dev,
                                  const std::string&              in_src,
                                  const shader_include_path_list& in_inc_paths);
+    void   submit_source_string(      render_device&            ren_dev,
+                                const std::string&              in_src,
+                                const shader_include_path_list& in_inc_paths);
+    bool   retrieve_compile_status(render_device& ren_dev);
+    // compiles a deferred shader (enabled program binary cache, asynchronous programs)
+    bool   compile(render_device& ren_dev);
+    // starts the compilation of a deferred shader without waiting for the result
+    void   submit_compile(render_device& ren_dev);
 
 
 protected:
@@ -53,6 +62,13 @@ protected:
     unsigned        _gl_shader_obj;
     std::string     _info_log;
 
+    // only kept for deferred shaders, the programs compute their binary cache key
+    // from the preprocessed source and compile it on a cache miss
+    bool                        _compiled;
+    bool                        _compile_status_pending;
+    std::string                 _preprocessed_source;
+    shader_include_path_list    _include_paths;
+
     friend class scm::gl::program;
     friend class scm::gl::render_device;
     friend class scm::gl::render_context;
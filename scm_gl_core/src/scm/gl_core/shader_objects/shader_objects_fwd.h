@@ -15,6 +15,9 @@ namespace gl {
 
 class shader;
 class program;
+class program_binary_cache;
+class async_program;
+class async_program_worker;
 class uniform_base;
 
 class shader_macro;
@@ -33,6 +36,11 @@ typedef shared_ptr<program>             program_ptr;
 typedef shared_ptr<const program>       program_cptr;
 typedef weak_ptr<program>               program_wtr;
 typedef weak_ptr<const program>         program_cwtr;
+typedef shared_ptr<program_binary_cache>        program_binary_cache_ptr;
+typedef shared_ptr<const program_binary_cache>  program_binary_cache_cptr;
+typedef shared_ptr<async_program>               async_program_ptr;
+typedef shared_ptr<const async_program>         async_program_cptr;
+typedef shared_ptr<async_program_worker>        async_program_worker_ptr;
 
 typedef shared_ptr<uniform_base>        uniform_ptr;
 typedef shared_ptr<const uniform_base>  uniform_cptr;
@@ -5,6 +5,10 @@
 #include "uniform.h"
 
 #include <cassert>
+#include <cstring>
+
+#include <boost/aligned_storage.hpp>
+#include <boost/type_traits/alignment_of.hpp>
 
 #include <scm/gl_core/render_device/device.h>
 #include <scm/gl_core/render_device/context.h>
@@ -60,11 +64,22 @@ uniform<T, D>::value(int i, value_param_type v)
     assert(i < static_cast<int>(_elements));
     if (!_status._initialized || v != _value[i]) {
         _value[i] = v;
-        _status._update_required = true;
         _status._initialized     = true;
+        mark_update_required();
     }
 }
 
+template<typename T, data_type D>
+void
+uniform<T, D>::value_data(int i, const void* in_data)
+{
+    // the recorded data is not aligned for value_type, the vector and matrix types only
+    // hold their scalar components and are copied from an aligned raw buffer
+    boost::aligned_storage<sizeof(value_type), boost::alignment_of<value_type>::value>  v;
+    std::memcpy(v.address(), in_data, sizeof(value_type));
+    value(i, *static_cast<const value_type*>(v.address()));
+}
+
 } // namespace gl
 } // namespace scm
 
@@ -118,6 +133,7 @@ uniform_base::uniform_base(const std::string& n, const int l, const unsigned e,
   , _location(l)
   , _elements(e)
   , _type(t)
+  , _dirty_list(0)
 {
     _status._initialized     = false;
     _status._update_required = false;
@@ -157,6 +173,17 @@ uniform_base::update_required() const
     return _status._update_required;
 }
 
+void
+uniform_base::mark_update_required()
+{
+    if (!_status._update_required) {
+        _status._update_required = true;
+        if (_dirty_list) {
+            _dirty_list->push_back(this);
+        }
+    }
+}
+
 // float types ////////////////////////////////////////////////////////////////////////////////////
 template<>
 void
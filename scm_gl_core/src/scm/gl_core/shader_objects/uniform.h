@@ -23,6 +23,9 @@ namespace gl {
 
 class __scm_export(gl_core) uniform_base
 {
+public:
+    typedef std::vector<uniform_base*>  dirty_list;
+
 public:
     uniform_base(const std::string& n, const int l, const unsigned e, const data_type t);
     virtual ~uniform_base();
@@ -35,6 +38,14 @@ public:
     bool                    update_required() const;
     virtual void            apply_value(const render_context& context, const program& p) = 0;
 
+    // sets element i from a value of the uniform value type stored as raw bytes, used by deferred
+    // submission (command_list, render_queue) that stores the values untyped
+    virtual void            value_data(int i, const void* in_data) = 0;
+
+protected:
+    // flags the uniform for the next apply and registers it once in the dirty list of the program
+    void                    mark_update_required();
+
 protected:
     std::string             _name;
     int                     _location;
@@ -46,6 +57,9 @@ protected:
         bool                _initialized     : 1;
     }                       _status;
 
+    // owned by the program, reset when the program is destroyed before the uniform
+    dirty_list*             _dirty_list;
+
 private:
     // declared, never defined
     uniform_base(const uniform_base&);
@@ -75,6 +89,7 @@ public:
     void                    value(int i, value_param_type v);
     
     void                    apply_value(const render_context& context, const program& p);
+    void                    value_data(int i, const void* in_data);
 
 protected:
     value_array             _value;
@@ -138,9 +153,37 @@ template<> struct uniform_data_type<bool> { static const data_type  type = TYPE_
 
 #undef SCM_UNIFORM_TYPE_DECLARE
 
+// typed uniform resolved once by program::resolve_uniform, setting values through the
+// handle involves no name lookup or type check
+template<typename T>
+class uniform_handle
+{
+public:
+    typedef T                                       value_type;
+    typedef typename uniform_type<T>::type          uniform_value_type;
+    typedef shared_ptr<uniform_value_type>          uniform_value_ptr;
+
+public:
+    uniform_handle();
+    explicit uniform_handle(const uniform_value_ptr& u);
+
+    bool                        valid() const;
+    int                         location() const;
+    const uniform_value_ptr&    get() const;
+
+    void                        value(const value_type& v) const;
+    void                        value(int i, const value_type& v) const;
+
+private:
+    uniform_value_ptr           _uniform;
+
+}; // class uniform_handle
+
 } // namespace gl
 } // namespace scm
 
+#include "uniform.inl"
+
 #include <scm/core/utilities/platform_warning_enable.h>
 
 #endif // SCM_GL_CORE_UNIFORM_H_INCLUDED
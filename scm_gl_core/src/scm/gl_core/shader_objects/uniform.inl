@@ -0,0 +1,64 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+namespace scm {
+namespace gl {
+
+template<typename T>
+inline
+uniform_handle<T>::uniform_handle()
+{
+}
+
+template<typename T>
+inline
+uniform_handle<T>::uniform_handle(const uniform_value_ptr& u)
+  : _uniform(u)
+{
+}
+
+template<typename T>
+inline
+bool
+uniform_handle<T>::valid() const
+{
+    return 0 != _uniform.get();
+}
+
+template<typename T>
+inline
+int
+uniform_handle<T>::location() const
+{
+    return _uniform ? _uniform->location() : -1;
+}
+
+template<typename T>
+inline
+const typename uniform_handle<T>::uniform_value_ptr&
+uniform_handle<T>::get() const
+{
+    return _uniform;
+}
+
+template<typename T>
+inline
+void
+uniform_handle<T>::value(const value_type& v) const
+{
+    value(0, v);
+}
+
+template<typename T>
+inline
+void
+uniform_handle<T>::value(int i, const value_type& v) const
+{
+    if (_uniform) {
+        _uniform->value(i, v);
+    }
+}
+
+} // namespace gl
+} // namespace scm
@@ -31,6 +31,11 @@ typedef shared_ptr<const rasterizer_state>      rasterizer_state_cptr;
 typedef shared_ptr<sampler_state>               sampler_state_ptr;
 typedef shared_ptr<const sampler_state>         sampler_state_cptr;
 
+typedef weak_ptr<depth_stencil_state>           depth_stencil_state_wptr;
+typedef weak_ptr<blend_state>                   blend_state_wptr;
+typedef weak_ptr<rasterizer_state>              rasterizer_state_wptr;
+typedef weak_ptr<sampler_state>                 sampler_state_wptr;
+
 } // namespace gl
 } // namespace scm
 
@@ -12,5 +12,6 @@
 #include <scm/gl_core/texture_objects/texture_2d.h>
 #include <scm/gl_core/texture_objects/texture_3d.h>
 #include <scm/gl_core/texture_objects/texture_buffer.h>
+#include <scm/gl_core/texture_objects/texture_upload_queue.h>
 
 #endif // SCM_GL_CORE_TEXTURE_OBJECTS_H_INCLUDED
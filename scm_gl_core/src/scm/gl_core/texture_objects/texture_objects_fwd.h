@@ -26,6 +26,8 @@ class  texture_3d;
 struct texture_buffer_desc;
 class  texture_buffer;
 
+class texture_upload_queue;
+
 typedef shared_ptr<texture>                 texture_ptr;
 typedef shared_ptr<texture const>           texture_cptr;
 typedef shared_ptr<texture_image>           texture_image_ptr;
@@ -38,6 +40,8 @@ typedef shared_ptr<texture_3d>              texture_3d_ptr;
 typedef shared_ptr<texture_3d const>        texture_3d_cptr;
 typedef shared_ptr<texture_buffer>          texture_buffer_ptr;
 typedef shared_ptr<texture_buffer const>    texture_buffer_cptr;
+typedef shared_ptr<texture_upload_queue>        texture_upload_queue_ptr;
+typedef shared_ptr<texture_upload_queue const>  texture_upload_queue_cptr;
 
 } // namespace gl
 } // namespace scm
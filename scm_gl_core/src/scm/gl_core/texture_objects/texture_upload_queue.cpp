@@ -0,0 +1,343 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "texture_upload_queue.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <scm/core/time/cpu_timer.h>
+
+#include <scm/gl_core/log.h>
+#include <scm/gl_core/buffer_objects/buffer.h>
+#include <scm/gl_core/render_device/context.h>
+#include <scm/gl_core/render_device/device.h>
+#include <scm/gl_core/sync_objects/fence_sync.h>
+#include <scm/gl_core/texture_objects/texture_image.h>
+
+namespace scm {
+namespace gl {
+namespace {
+
+// keeps the staging offsets valid for every pixel size and the default unpack alignment
+const scm::size_t   staging_alignment = 16;
+
+inline
+scm::size_t
+align_offset(scm::size_t in_offset, scm::size_t in_alignment)
+{
+    return ((in_offset + in_alignment - 1) / in_alignment) * in_alignment;
+}
+
+} // namespace
+
+// texture_upload_queue::upload_budget ////////////////////////////////////////////////////////////
+texture_upload_queue::upload_budget::upload_budget(scm::size_t in_max_bytes,
+                                                   double      in_max_milliseconds)
+  : _max_bytes(in_max_bytes)
+  , _max_milliseconds(in_max_milliseconds)
+{
+}
+
+// texture_upload_queue ///////////////////////////////////////////////////////////////////////////
+texture_upload_queue::texture_upload_queue(render_device& in_device,
+                                           scm::size_t    in_staging_buffer_size,
+                                           int            in_staging_buffer_count)
+  : render_device_child(in_device)
+  , _pending_bytes(0)
+  , _last_processed_bytes(0)
+  , _staging_buffer_size(0)
+  , _current_buffer(-1)
+  , _next_buffer(0)
+{
+    if (   0 >= in_staging_buffer_count
+        || 0 == in_staging_buffer_size) {
+        state().set(object_state::OS_ERROR_INVALID_VALUE);
+        return;
+    }
+
+    _staging_buffer_size = align_offset(in_staging_buffer_size, staging_alignment);
+    _staging_buffers.resize(in_staging_buffer_count);
+
+    for (int b = 0; b < in_staging_buffer_count; ++b) {
+        _staging_buffers[b]._buffer = in_device.create_buffer(BIND_PIXEL_UNPACK_BUFFER, USAGE_STREAM_DRAW, _staging_buffer_size);
+        _staging_buffers[b]._used   = 0;
+        if (!_staging_buffers[b]._buffer) {
+            state().set(object_state::OS_BAD);
+            return;
+        }
+    }
+}
+
+texture_upload_queue::~texture_upload_queue()
+{
+    _requests.clear();
+    _staging_buffers.clear();
+}
+
+bool
+texture_upload_queue::upload(const texture_image_ptr&   in_texture,
+                             const texture_region&      in_region,
+                             const unsigned             in_level,
+                             const data_format          in_data_format,
+                             const shared_array<uint8>& in_data)
+{
+    upload_request  r;
+
+    if (!check_request(in_texture, in_region, in_data_format, r._data_size)) {
+        return false;
+    }
+
+    r._texture      = in_texture;
+    r._region       = in_region;
+    r._level        = in_level;
+    r._data_format  = in_data_format;
+    r._data         = in_data;
+
+    _requests.push_back(r);
+    _pending_bytes += r._data_size;
+
+    return true;
+}
+
+bool
+texture_upload_queue::upload(const texture_image_ptr&   in_texture,
+                             const texture_region&      in_region,
+                             const unsigned             in_level,
+                             const data_format          in_data_format,
+                             const void*const           in_data)
+{
+    scm::size_t     data_size = 0;
+
+    if (!check_request(in_texture, in_region, in_data_format, data_size)) {
+        return false;
+    }
+
+    shared_array<uint8> data_copy(new uint8[data_size]);
+    std::memcpy(data_copy.get(), in_data, data_size);
+
+    return upload(in_texture, in_region, in_level, in_data_format, data_copy);
+}
+
+scm::size_t
+texture_upload_queue::process(const render_context_ptr& in_context,
+                              const upload_budget&      in_budget)
+{
+    return issue_uploads(in_context, in_budget, false);
+}
+
+scm::size_t
+texture_upload_queue::finish(const render_context_ptr& in_context)
+{
+    return issue_uploads(in_context, upload_budget(), true);
+}
+
+scm::size_t
+texture_upload_queue::pending_uploads() const
+{
+    return _requests.size();
+}
+
+scm::size_t
+texture_upload_queue::pending_bytes() const
+{
+    return _pending_bytes;
+}
+
+scm::size_t
+texture_upload_queue::last_processed_bytes() const
+{
+    return _last_processed_bytes;
+}
+
+scm::size_t
+texture_upload_queue::staging_buffer_size() const
+{
+    return _staging_buffer_size;
+}
+
+int
+texture_upload_queue::staging_buffer_count() const
+{
+    return static_cast<int>(_staging_buffers.size());
+}
+
+bool
+texture_upload_queue::check_request(const texture_image_ptr& in_texture,
+                                    const texture_region&    in_region,
+                                    const data_format        in_data_format,
+                                    scm::size_t&             out_data_size) const
+{
+    if (!in_texture) {
+        glerr() << log::error << "texture_upload_queue::upload(): invalid texture." << log::end;
+        return false;
+    }
+    if (is_compressed_format(in_data_format)) {
+        glerr() << log::error << "texture_upload_queue::upload(): "
+                << "compressed formats are not supported (" << format_string(in_data_format) << ")." << log::end;
+        return false;
+    }
+
+    out_data_size =   static_cast<scm::size_t>(size_of_format(in_data_format))
+                    * (std::max)(1u, in_region._dimensions.x)
+                    * (std::max)(1u, in_region._dimensions.y)
+                    * (std::max)(1u, in_region._dimensions.z);
+
+    return true;
+}
+
+scm::size_t
+texture_upload_queue::issue_uploads(const render_context_ptr& in_context,
+                                    const upload_budget&      in_budget,
+                                    bool                      in_wait)
+{
+    assert(ok());
+
+    _last_processed_bytes = 0;
+
+    if (_requests.empty()) {
+        return 0;
+    }
+
+    time::cpu_timer     budget_timer;
+    const buffer_ptr    restore_unpack_buffer = in_context->current_unpack_buffer();
+    scm::size_t         issued_uploads        = 0;
+
+    budget_timer.start();
+
+    while (!_requests.empty()) {
+        const upload_request& r = _requests.front();
+
+        // the first update of a call is always issued, a large update would block the queue otherwise
+        if (0 < issued_uploads) {
+            if (   0 != in_budget._max_bytes
+                && _last_processed_bytes + r._data_size > in_budget._max_bytes) {
+                break;
+            }
+            if (   0.0 < in_budget._max_milliseconds
+                && static_cast<double>(budget_timer.elapsed()) * 1.0e-6 >= in_budget._max_milliseconds) {
+                break;
+            }
+        }
+
+        if (!issue_upload(in_context, r, in_wait)) {
+            break; // no free staging buffer
+        }
+
+        ++issued_uploads;
+        _last_processed_bytes += r._data_size;
+        _pending_bytes        -= r._data_size;
+        _requests.pop_front();
+    }
+
+    budget_timer.stop();
+
+    retire_staging_buffer(in_context);
+    in_context->bind_unpack_buffer(restore_unpack_buffer);
+
+    return issued_uploads;
+}
+
+bool
+texture_upload_queue::issue_upload(const render_context_ptr& in_context,
+                                   const upload_request&     in_request,
+                                   bool                      in_wait)
+{
+    if (in_request._data_size > _staging_buffer_size) {
+        // too large for staging, issued synchronously from client memory
+        in_context->bind_unpack_buffer(buffer_ptr());
+        in_context->update_sub_texture(in_request._texture, in_request._region, in_request._level,
+                                       in_request._data_format, in_request._data.get());
+        return true;
+    }
+
+    if (   0 <= _current_buffer
+        && align_offset(_staging_buffers[_current_buffer]._used, staging_alignment) + in_request._data_size > _staging_buffer_size) {
+        retire_staging_buffer(in_context);
+    }
+    if (0 > _current_buffer) {
+        if (!acquire_staging_buffer(in_context, in_wait)) {
+            return false;
+        }
+    }
+
+    staging_buffer&     sb     = _staging_buffers[_current_buffer];
+    const scm::size_t   offset = align_offset(sb._used, staging_alignment);
+
+    // the staging buffer is not read by the gpu (fence signaled), earlier copies in this buffer
+    // use disjoint ranges
+    void* staging_data = in_context->map_buffer_range(sb._buffer, offset, in_request._data_size, ACCESS_WRITE_UNSYNCHRONIZED);
+    if (0 == staging_data) {
+        glerr() << log::error << "texture_upload_queue::issue_upload(): "
+                << "unable to map staging buffer, update issued from client memory." << log::end;
+        in_context->bind_unpack_buffer(buffer_ptr());
+        in_context->update_sub_texture(in_request._texture, in_request._region, in_request._level,
+                                       in_request._data_format, in_request._data.get());
+        return true;
+    }
+    std::memcpy(staging_data, in_request._data.get(), in_request._data_size);
+    in_context->unmap_buffer(sb._buffer);
+
+    in_context->bind_unpack_buffer(sb._buffer);
+    in_context->update_sub_texture(in_request._texture, in_request._region, in_request._level,
+                                   in_request._data_format, offset);
+
+    sb._used = offset + in_request._data_size;
+
+    return true;
+}
+
+bool
+texture_upload_queue::acquire_staging_buffer(const render_context_ptr& in_context,
+                                             bool                      in_wait)
+{
+    assert(0 > _current_buffer);
+
+    const int   buffer_count = staging_buffer_count();
+
+    // the buffers are retired in order, the oldest one is checked first
+    for (int i = 0; i < buffer_count; ++i) {
+        const int       b  = (_next_buffer + i) % buffer_count;
+        staging_buffer& sb = _staging_buffers[b];
+
+        if (sb._fence) {
+            if (SYNC_SIGNALED != in_context->sync_signal_status(sb._fence)) {
+                if (!in_wait) {
+                    continue;
+                }
+                if (SYNC_WAIT_FAILED == in_context->sync_client_wait(sb._fence)) {
+                    glerr() << log::error << "texture_upload_queue::acquire_staging_buffer(): "
+                            << "waiting for staging buffer " << b << " failed." << log::end;
+                    return false;
+                }
+            }
+            sb._fence.reset();
+        }
+
+        sb._used        = 0;
+        _current_buffer = b;
+        _next_buffer    = (b + 1) % buffer_count;
+        return true;
+    }
+
+    return false;
+}
+
+void
+texture_upload_queue::retire_staging_buffer(const render_context_ptr& in_context)
+{
+    if (0 > _current_buffer) {
+        return;
+    }
+
+    staging_buffer& sb = _staging_buffers[_current_buffer];
+    if (0 < sb._used) {
+        sb._fence = in_context->insert_fence_sync();
+    }
+    _current_buffer = -1;
+}
+
+} // namespace gl
+} // namespace scm
@@ -0,0 +1,131 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_CORE_TEXTURE_UPLOAD_QUEUE_H_INCLUDED
+#define SCM_GL_CORE_TEXTURE_UPLOAD_QUEUE_H_INCLUDED
+
+#include <deque>
+#include <vector>
+
+#include <scm/core/numeric_types.h>
+#include <scm/core/memory.h>
+
+#include <scm/gl_core/constants.h>
+#include <scm/gl_core/data_formats.h>
+#include <scm/gl_core/data_types.h>
+#include <scm/gl_core/gl_core_fwd.h>
+#include <scm/gl_core/render_device/device_child.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// streams texture sub image updates through a pool of pixel unpack buffers
+//  - upload() only queues the update, process() copies queued updates into a staging buffer
+//    and issues the texture updates from it until the frame budget is used up
+//  - every staging buffer is fenced after a process() call that wrote to it and reused once
+//    the fence signaled, process() never waits for the gpu, it stops if no staging buffer is free
+//  - updates larger than a staging buffer are issued directly from client memory
+//  - compressed formats are not supported
+class __scm_export(gl_core) texture_upload_queue : public render_device_child
+{
+public:
+    struct __scm_export(gl_core) upload_budget {
+        // 0 for no limit
+        explicit upload_budget(scm::size_t in_max_bytes        = 0,
+                               double      in_max_milliseconds = 0.0);
+
+        scm::size_t             _max_bytes;
+        double                  _max_milliseconds;
+    }; // struct upload_budget
+
+public:
+    virtual ~texture_upload_queue();
+
+    // the shared data must not change until the update is issued
+    bool                        upload(const texture_image_ptr&   in_texture,
+                                       const texture_region&      in_region,
+                                       const unsigned             in_level,
+                                       const data_format          in_data_format,
+                                       const shared_array<uint8>& in_data);
+    // the data is copied into the queue
+    bool                        upload(const texture_image_ptr&   in_texture,
+                                       const texture_region&      in_region,
+                                       const unsigned             in_level,
+                                       const data_format          in_data_format,
+                                       const void*const           in_data);
+
+    // issues queued updates within the budget, at least one update is issued per call if a
+    // staging buffer is free, returns the number of issued updates
+    scm::size_t                 process(const render_context_ptr& in_context,
+                                        const upload_budget&      in_budget = upload_budget());
+    // issues all queued updates, waits for staging buffers to become free if required
+    scm::size_t                 finish(const render_context_ptr& in_context);
+
+    scm::size_t                 pending_uploads() const;
+    scm::size_t                 pending_bytes() const;
+    scm::size_t                 last_processed_bytes() const;
+
+    scm::size_t                 staging_buffer_size() const;
+    int                         staging_buffer_count() const;
+
+protected:
+    texture_upload_queue(render_device& in_device,
+                         scm::size_t    in_staging_buffer_size,
+                         int            in_staging_buffer_count);
+
+    struct upload_request {
+        texture_image_ptr       _texture;
+        texture_region          _region;
+        unsigned                _level;
+        data_format             _data_format;
+        shared_array<uint8>     _data;
+        scm::size_t             _data_size;
+    }; // struct upload_request
+    struct staging_buffer {
+        buffer_ptr              _buffer;
+        fence_sync_ptr          _fence;
+        scm::size_t             _used;
+    }; // struct staging_buffer
+
+    typedef std::deque<upload_request>  request_queue;
+    typedef std::vector<staging_buffer> staging_buffer_array;
+
+    bool                        check_request(const texture_image_ptr& in_texture,
+                                              const texture_region&    in_region,
+                                              const data_format        in_data_format,
+                                              scm::size_t&             out_data_size) const;
+    scm::size_t                 issue_uploads(const render_context_ptr& in_context,
+                                              const upload_budget&      in_budget,
+                                              bool                      in_wait);
+    bool                        issue_upload(const render_context_ptr& in_context,
+                                             const upload_request&     in_request,
+                                             bool                      in_wait);
+    bool                        acquire_staging_buffer(const render_context_ptr& in_context,
+                                                       bool                      in_wait);
+    void                        retire_staging_buffer(const render_context_ptr& in_context);
+
+protected:
+    request_queue               _requests;
+    scm::size_t                 _pending_bytes;
+    scm::size_t                 _last_processed_bytes;
+
+    scm::size_t                 _staging_buffer_size;
+    staging_buffer_array        _staging_buffers;
+    int                         _current_buffer;        // -1 if no staging buffer is acquired
+    int                         _next_buffer;           // oldest retired staging buffer
+
+private:
+    friend class render_device;
+
+}; // class texture_upload_queue
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_CORE_TEXTURE_UPLOAD_QUEUE_H_INCLUDED
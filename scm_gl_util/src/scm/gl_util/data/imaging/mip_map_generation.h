@@ -5,8 +5,27 @@
 #ifndef SCM_GL_UTIL_MIP_MAP_GENERATION_H_INCLUDED
 #define SCM_GL_UTIL_MIP_MAP_GENERATION_H_INCLUDED
 
+#include <algorithm>
+#include <vector>
+
 #include <boost/numeric/conversion/bounds.hpp>
 
+#include <scm/core/math.h>
+#include <scm/core/memory.h>
+#include <scm/core/numeric_types.h>
+#include <scm/core/utilities/thread_pool.h>
+
+#include <scm/core/platform/platform.h>
+
+// the line filters of the parallel path use sse2, which is part of every x86-64 target
+#if    (SCM_COMPILER == SCM_COMPILER_MSVC && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))) \
+    || (SCM_COMPILER == SCM_COMPILER_GNUC && defined(__SSE2__))
+#   define SCM_MIP_MAP_SSE2_AVAILABLE 1
+#   include <emmintrin.h>
+#else
+#   define SCM_MIP_MAP_SSE2_AVAILABLE 0
+#endif
+
 namespace scm {
 namespace gl {
 namespace util {
@@ -174,6 +193,478 @@ typed_generate_mipmaps(const math::vec3ui&        src_dim,
     }
 }
 
+namespace detail {
+
+// line filters of the parallel mip map generation, all filters apply the operations in the
+// same order as typed_generate_mipmaps() so both paths produce bit identical results
+
+// d = (a + b) * 0.5
+inline
+void
+mip_filter_box(float* d, const float* a, const float* b, scm::size_t n)
+{
+    scm::size_t i = 0;
+#if SCM_MIP_MAP_SSE2_AVAILABLE
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(d + i, _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)), half));
+    }
+#endif
+    for (; i < n; ++i) {
+        d[i] = (a[i] + b[i]) * 0.5f;
+    }
+}
+
+// d = (w0 * a + w1 * b + w2 * c) * scale
+inline
+void
+mip_filter_polyphase(float* d, const float* a, const float* b, const float* c,
+                     float w0, float w1, float w2, float scale, scm::size_t n)
+{
+    scm::size_t i = 0;
+#if SCM_MIP_MAP_SSE2_AVAILABLE
+    const __m128 vw0 = _mm_set1_ps(w0);
+    const __m128 vw1 = _mm_set1_ps(w1);
+    const __m128 vw2 = _mm_set1_ps(w2);
+    const __m128 vsc = _mm_set1_ps(scale);
+    for (; i + 4 <= n; i += 4) {
+        __m128 t = _mm_mul_ps(vw0, _mm_loadu_ps(a + i));
+        t = _mm_add_ps(t, _mm_mul_ps(vw1, _mm_loadu_ps(b + i)));
+        t = _mm_add_ps(t, _mm_mul_ps(vw2, _mm_loadu_ps(c + i)));
+        _mm_storeu_ps(d + i, _mm_mul_ps(t, vsc));
+    }
+#endif
+    for (; i < n; ++i) {
+        float t = w0 * a[i];
+        t += w1 * b[i];
+        t += w2 * c[i];
+        d[i] = t * scale;
+    }
+}
+
+// horizontal filters from a source line of interleaved vdim component texels,
+// the accumulation starts at zero as in the original implementation
+template<const unsigned vdim>
+struct mip_filter_x
+{
+    static void box(float* d, const float* s, scm::size_t dst_count) {
+        for (scm::size_t x = 0; x < dst_count; ++x, s += 2 * vdim, d += vdim) {
+            for (unsigned c = 0; c < vdim; ++c) {
+                d[c] = ((0.0f + s[c]) + s[vdim + c]) * 0.5f;
+            }
+        }
+    }
+    static void polyphase(float* d, const float* s, scm::size_t dst_count) {
+        const float w1    = static_cast<float>(dst_count);
+        const float scale = 1.0f / (2.0f * dst_count + 1.0f);
+        for (scm::size_t x = 0; x < dst_count; ++x, s += 2 * vdim, d += vdim) {
+            const float w0 = static_cast<float>(dst_count - x);
+            const float w2 = static_cast<float>(1 + x);
+            for (unsigned c = 0; c < vdim; ++c) {
+                d[c] = (((0.0f + w0 * s[c]) + w1 * s[vdim + c]) + w2 * s[2 * vdim + c]) * scale;
+            }
+        }
+    }
+}; // struct mip_filter_x
+
+#if SCM_MIP_MAP_SSE2_AVAILABLE
+// single component lines: four output texels from eight (nine) deinterleaved source texels
+template<>
+struct mip_filter_x<1>
+{
+    static void box(float* d, const float* s, scm::size_t dst_count) {
+        const __m128    zero = _mm_setzero_ps();
+        const __m128    half = _mm_set1_ps(0.5f);
+        scm::size_t     x    = 0;
+        for (; x + 4 <= dst_count; x += 4) {
+            const __m128 s0 = _mm_loadu_ps(s + 2 * x);
+            const __m128 s1 = _mm_loadu_ps(s + 2 * x + 4);
+            const __m128 ev = _mm_shuffle_ps(s0, s1, _MM_SHUFFLE(2, 0, 2, 0));
+            const __m128 od = _mm_shuffle_ps(s0, s1, _MM_SHUFFLE(3, 1, 3, 1));
+            _mm_storeu_ps(d + x, _mm_mul_ps(_mm_add_ps(_mm_add_ps(zero, ev), od), half));
+        }
+        for (; x < dst_count; ++x) {
+            d[x] = ((0.0f + s[2 * x]) + s[2 * x + 1]) * 0.5f;
+        }
+    }
+    static void polyphase(float* d, const float* s, scm::size_t dst_count) {
+        const float     w1    = static_cast<float>(dst_count);
+        const float     scale = 1.0f / (2.0f * dst_count + 1.0f);
+        const __m128    zero  = _mm_setzero_ps();
+        const __m128    vw1   = _mm_set1_ps(w1);
+        const __m128    vsc   = _mm_set1_ps(scale);
+        const __m128    four  = _mm_set1_ps(4.0f);
+        __m128          vw0   = _mm_sub_ps(_mm_set1_ps(w1), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f));
+        __m128          vw2   = _mm_set_ps(4.0f, 3.0f, 2.0f, 1.0f);
+        scm::size_t     x     = 0;
+        // the source line holds 2 * dst_count + 1 texels, the loads reach up to s[2 * x + 9]
+        for (; x + 5 <= dst_count; x += 4) {
+            const __m128 s0 = _mm_loadu_ps(s + 2 * x);
+            const __m128 s1 = _mm_loadu_ps(s + 2 * x + 4);
+            const __m128 s2 = _mm_loadu_ps(s + 2 * x + 2);
+            const __m128 s3 = _mm_loadu_ps(s + 2 * x + 6);
+            const __m128 a  = _mm_shuffle_ps(s0, s1, _MM_SHUFFLE(2, 0, 2, 0));
+            const __m128 b  = _mm_shuffle_ps(s0, s1, _MM_SHUFFLE(3, 1, 3, 1));
+            const __m128 c  = _mm_shuffle_ps(s2, s3, _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 t = _mm_add_ps(zero, _mm_mul_ps(vw0, a));
+            t = _mm_add_ps(t, _mm_mul_ps(vw1, b));
+            t = _mm_add_ps(t, _mm_mul_ps(vw2, c));
+            _mm_storeu_ps(d + x, _mm_mul_ps(t, vsc));
+            vw0 = _mm_sub_ps(vw0, four);
+            vw2 = _mm_add_ps(vw2, four);
+        }
+        for (; x < dst_count; ++x) {
+            const float w0 = static_cast<float>(dst_count - x);
+            const float w2 = static_cast<float>(1 + x);
+            d[x] = (((0.0f + w0 * s[2 * x]) + w1 * s[2 * x + 1]) + w2 * s[2 * x + 2]) * scale;
+        }
+    }
+}; // struct mip_filter_x<1>
+
+// four component lines: one texel per register
+template<>
+struct mip_filter_x<4>
+{
+    static void box(float* d, const float* s, scm::size_t dst_count) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 half = _mm_set1_ps(0.5f);
+        for (scm::size_t x = 0; x < dst_count; ++x, s += 8, d += 4) {
+            const __m128 t = _mm_add_ps(_mm_add_ps(zero, _mm_loadu_ps(s)), _mm_loadu_ps(s + 4));
+            _mm_storeu_ps(d, _mm_mul_ps(t, half));
+        }
+    }
+    static void polyphase(float* d, const float* s, scm::size_t dst_count) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 vw1  = _mm_set1_ps(static_cast<float>(dst_count));
+        const __m128 vsc  = _mm_set1_ps(1.0f / (2.0f * dst_count + 1.0f));
+        for (scm::size_t x = 0; x < dst_count; ++x, s += 8, d += 4) {
+            const __m128 vw0 = _mm_set1_ps(static_cast<float>(dst_count - x));
+            const __m128 vw2 = _mm_set1_ps(static_cast<float>(1 + x));
+            __m128 t = _mm_add_ps(zero, _mm_mul_ps(vw0, _mm_loadu_ps(s)));
+            t = _mm_add_ps(t, _mm_mul_ps(vw1, _mm_loadu_ps(s + 4)));
+            t = _mm_add_ps(t, _mm_mul_ps(vw2, _mm_loadu_ps(s + 8)));
+            _mm_storeu_ps(d, _mm_mul_ps(t, vsc));
+        }
+    }
+}; // struct mip_filter_x<4>
+#endif // SCM_MIP_MAP_SSE2_AVAILABLE
+
+// source lines are converted to float once, float source data is used in place
+template<typename vtype>
+inline
+const float*
+mip_load_line(const vtype* s, float* tmp, scm::size_t n)
+{
+    for (scm::size_t i = 0; i < n; ++i) {
+        tmp[i] = static_cast<float>(s[i]);
+    }
+    return tmp;
+}
+
+inline
+const float*
+mip_load_line(const float* s, float* /*tmp*/, scm::size_t /*n*/)
+{
+    return s;
+}
+
+template<typename vtype>
+inline
+void
+mip_store_line(vtype* d, const float* s, scm::size_t n, float vmin, float vmax)
+{
+    for (scm::size_t i = 0; i < n; ++i) {
+        d[i] = static_cast<vtype>(math::clamp(s[i], vmin, vmax));
+    }
+}
+
+#if SCM_MIP_MAP_SSE2_AVAILABLE
+inline
+const float*
+mip_load_line(const scm::uint8* s, float* tmp, scm::size_t n)
+{
+    const __m128i   zero = _mm_setzero_si128();
+    scm::size_t     i    = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i b  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        const __m128i w0 = _mm_unpacklo_epi8(b, zero);
+        const __m128i w1 = _mm_unpackhi_epi8(b, zero);
+        _mm_storeu_ps(tmp + i,      _mm_cvtepi32_ps(_mm_unpacklo_epi16(w0, zero)));
+        _mm_storeu_ps(tmp + i +  4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(w0, zero)));
+        _mm_storeu_ps(tmp + i +  8, _mm_cvtepi32_ps(_mm_unpacklo_epi16(w1, zero)));
+        _mm_storeu_ps(tmp + i + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(w1, zero)));
+    }
+    for (; i < n; ++i) {
+        tmp[i] = static_cast<float>(s[i]);
+    }
+    return tmp;
+}
+
+inline
+const float*
+mip_load_line(const scm::uint16* s, float* tmp, scm::size_t n)
+{
+    const __m128i   zero = _mm_setzero_si128();
+    scm::size_t     i    = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        _mm_storeu_ps(tmp + i,     _mm_cvtepi32_ps(_mm_unpacklo_epi16(w, zero)));
+        _mm_storeu_ps(tmp + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(w, zero)));
+    }
+    for (; i < n; ++i) {
+        tmp[i] = static_cast<float>(s[i]);
+    }
+    return tmp;
+}
+
+// the clamped values are in range of the integer types, so the saturating packs only
+// narrow the truncated values (uint16 is packed as signed values biased by -32768)
+inline
+void
+mip_store_line(scm::uint8* d, const float* s, scm::size_t n, float vmin, float vmax)
+{
+    const __m128    lo = _mm_set1_ps(vmin);
+    const __m128    hi = _mm_set1_ps(vmax);
+    scm::size_t     i  = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i i0 = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(s + i),      lo), hi));
+        const __m128i i1 = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(s + i +  4), lo), hi));
+        const __m128i i2 = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(s + i +  8), lo), hi));
+        const __m128i i3 = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(s + i + 12), lo), hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i),
+                         _mm_packus_epi16(_mm_packs_epi32(i0, i1), _mm_packs_epi32(i2, i3)));
+    }
+    for (; i < n; ++i) {
+        d[i] = static_cast<scm::uint8>(math::clamp(s[i], vmin, vmax));
+    }
+}
+
+inline
+void
+mip_store_line(scm::uint16* d, const float* s, scm::size_t n, float vmin, float vmax)
+{
+    const __m128    lo   = _mm_set1_ps(vmin);
+    const __m128    hi   = _mm_set1_ps(vmax);
+    const __m128i   bias = _mm_set1_epi32(32768);
+    const __m128i   sign = _mm_set1_epi16(static_cast<short>(0x8000));
+    scm::size_t     i    = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i i0 = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(s + i),     lo), hi));
+        const __m128i i1 = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(s + i + 4), lo), hi));
+        const __m128i p  = _mm_packs_epi32(_mm_sub_epi32(i0, bias), _mm_sub_epi32(i1, bias));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), _mm_xor_si128(p, sign));
+    }
+    for (; i < n; ++i) {
+        d[i] = static_cast<scm::uint16>(math::clamp(s[i], vmin, vmax));
+    }
+}
+
+inline
+void
+mip_store_line(float* d, const float* s, scm::size_t n, float vmin, float vmax)
+{
+    const __m128    lo = _mm_set1_ps(vmin);
+    const __m128    hi = _mm_set1_ps(vmax);
+    scm::size_t     i  = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(d + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(s + i), lo), hi));
+    }
+    for (; i < n; ++i) {
+        d[i] = math::clamp(s[i], vmin, vmax);
+    }
+}
+#endif // SCM_MIP_MAP_SSE2_AVAILABLE
+
+// filters the output texels of a single mip level from the previous level
+template<typename vtype,
+         const unsigned vdim>
+struct mip_level_filter
+{
+    const vtype*        _src;
+    vtype*              _dst;
+    math::vec3ui        _src_size;
+    math::vec3ui        _dst_size;
+
+    unsigned z_samples() const {
+        return math::min(_src_size.z, (_src_size.z & 1) ? 3u : 2u);
+    }
+
+    // filter the output rows [begin, end) of the complete levels _src and _dst,
+    // a row index is y + z * size.y
+    void operator()(scm::size_t begin, scm::size_t end) const {
+        const scm::size_t   src_slice = static_cast<scm::size_t>(_src_size.x) * _src_size.y * vdim;
+        const scm::size_t   dst_slice = static_cast<scm::size_t>(_dst_size.x) * _dst_size.y * vdim;
+
+        while (begin < end) {
+            const unsigned      z     = static_cast<unsigned>(begin / _dst_size.y);
+            const scm::size_t   y_beg = begin - static_cast<scm::size_t>(z) * _dst_size.y;
+            const scm::size_t   y_end = math::min<scm::size_t>(_dst_size.y, y_beg + (end - begin));
+            const vtype*        src_slices[3];
+            for (unsigned zs = 0; zs < z_samples(); ++zs) {
+                src_slices[zs] = _src + (2 * z + zs) * src_slice;
+            }
+
+            filter_rows(z, y_beg, y_end, src_slices, _dst + z * dst_slice);
+
+            begin += y_end - y_beg;
+        }
+    }
+
+    // filter the rows [y_begin, y_end) of the output slice z, src_slices are the source
+    // slices 2z to 2z + z_samples() - 1, dst_slice receives the output slice
+    void filter_rows(unsigned                z,
+                     scm::size_t             y_begin,
+                     scm::size_t             y_end,
+                     const vtype*const*      src_slices,
+                           vtype*            dst_slice) const {
+        using namespace scm::math;
+
+        const float         vmin = static_cast<float>(boost::numeric::bounds<vtype>::lowest());
+        const float         vmax = static_cast<float>(boost::numeric::bounds<vtype>::highest());
+
+        const scm::size_t   src_line  = static_cast<scm::size_t>(_src_size.x) * vdim;
+        const scm::size_t   dst_line  = static_cast<scm::size_t>(_dst_size.x) * vdim;
+
+        const unsigned      x_samples = min(_src_size.x, (_src_size.x & 1) ? 3u : 2u);
+        const unsigned      y_samples = min(_src_size.y, (_src_size.y & 1) ? 3u : 2u);
+
+        // scratch lines for the whole range: one converted source line, 3x3 x-filtered
+        // lines, 3 y-filtered lines and the z-filtered output line
+        std::vector<float>  scratch(src_line + (9 + 3 + 1) * dst_line);
+        float*const         src_tmp = &scratch[0];
+        float*              xlines[3][3];
+        float*              ylines[3];
+        float*const         out     = src_tmp + src_line + 12 * dst_line;
+        for (unsigned zs = 0; zs < 3; ++zs) {
+            for (unsigned ys = 0; ys < 3; ++ys) {
+                xlines[zs][ys] = src_tmp + src_line + (zs * 3 + ys) * dst_line;
+            }
+        }
+
+        for (scm::size_t y = y_begin; y < y_end; ++y) {
+            // polyphase rows share the last source row with the first of the next output row
+            unsigned        first_ys = 0;
+            if (y_samples == 3 && y > y_begin) {
+                for (unsigned zs = 0; zs < z_samples(); ++zs) {
+                    std::swap(xlines[zs][0], xlines[zs][2]);
+                }
+                first_ys = 1;
+            }
+
+            // read and sample x-lines
+            for (unsigned zs = 0; zs < z_samples(); ++zs) {
+                for (unsigned ys = first_ys; ys < y_samples; ++ys) {
+                    const vtype*    sl = src_slices[zs] + (2 * y + ys) * src_line;
+                    const float*    fl = mip_load_line(sl, src_tmp, x_samples == 1 ? vdim : src_line);
+                    float*          xl = xlines[zs][ys];
+
+                    if (x_samples == 1) {
+                        std::copy(fl, fl + vdim, xl);
+                    }
+                    else if (x_samples == 2) {
+                        mip_filter_x<vdim>::box(xl, fl, _dst_size.x);
+                    }
+                    else {
+                        mip_filter_x<vdim>::polyphase(xl, fl, _dst_size.x);
+                    }
+                }
+            }
+            // downsample y-lines
+            for (unsigned zs = 0; zs < z_samples(); ++zs) {
+                if (y_samples == 1) {
+                    ylines[zs] = xlines[zs][0];
+                }
+                else {
+                    ylines[zs] = src_tmp + src_line + (9 + zs) * dst_line;
+                    if (y_samples == 2) {
+                        mip_filter_box(ylines[zs], xlines[zs][0], xlines[zs][1], dst_line);
+                    }
+                    else {
+                        mip_filter_polyphase(ylines[zs], xlines[zs][0], xlines[zs][1], xlines[zs][2],
+                                             static_cast<float>(_dst_size.y - y),
+                                             static_cast<float>(_dst_size.y),
+                                             static_cast<float>(1 + y),
+                                             1.0f / (2.0f * _dst_size.y + 1.0f), dst_line);
+                    }
+                }
+            }
+            // downsample z-lines
+            const float* zl = ylines[0];
+            if (z_samples() == 2) {
+                mip_filter_box(out, ylines[0], ylines[1], dst_line);
+                zl = out;
+            }
+            else if (z_samples() == 3) {
+                mip_filter_polyphase(out, ylines[0], ylines[1], ylines[2],
+                                     static_cast<float>(_dst_size.z - z),
+                                     static_cast<float>(_dst_size.z),
+                                     static_cast<float>(1 + z),
+                                     1.0f / (2.0f * _dst_size.z + 1.0f), dst_line);
+                zl = out;
+            }
+            // write out samples
+            mip_store_line(dst_slice + y * dst_line, zl, dst_line, vmin, vmax);
+        }
+    }
+}; // struct mip_level_filter
+
+} // namespace detail
+
+// parallel mip map generation producing the same results as typed_generate_mipmaps()
+//  - all levels below the source level are written to the single buffer dst_pyramid,
+//    dst_data receives the source pointer followed by the level pointers into it
+//  - the output rows of a level are distributed over the thread pool in slabs of
+//    whole z-slices (rows for 2d images), levels are processed one after another
+template<typename vtype,
+         const unsigned vdim>
+void
+typed_generate_mipmaps_parallel(const math::vec3ui&         src_dim,
+                                      uint8*                src_data,
+                                      shared_array<uint8>&  dst_pyramid,
+                                      std::vector<uint8*>&  dst_data,
+                                      thread_pool&          threads)
+{
+    using namespace scm::math;
+
+    typedef math::vec<vtype, vdim> varr;
+
+    // amount of output texels per task, small levels are filtered by the calling thread
+    const scm::size_t   task_texels = 64 * 1024;
+    const scm::size_t   level_align = 64;
+    const unsigned      level_count = util::max_mip_levels(src_dim);
+
+    std::vector<scm::size_t>    level_offsets(1, 0);
+    scm::size_t                 pyramid_size = 0;
+    for (unsigned l = 1; l < level_count; ++l) {
+        const vec3ui        lsize  = util::mip_level_dimensions(src_dim, l);
+        const scm::size_t   ldsize = static_cast<scm::size_t>(lsize.x) * lsize.y * lsize.z * sizeof(varr);
+
+        level_offsets.push_back(pyramid_size);
+        pyramid_size += ((ldsize + level_align - 1) / level_align) * level_align;
+    }
+
+    dst_pyramid.reset(pyramid_size > 0 ? new uint8[pyramid_size] : 0);
+    dst_data.push_back(src_data);
+
+    for (unsigned l = 1; l < level_count; ++l) {
+        detail::mip_level_filter<vtype, vdim> level_filter;
+        level_filter._src      = reinterpret_cast<const vtype*>(dst_data[l - 1]);
+        level_filter._dst      = reinterpret_cast<vtype*>(dst_pyramid.get() + level_offsets[l]);
+        level_filter._src_size = util::mip_level_dimensions(src_dim, l - 1);
+        level_filter._dst_size = util::mip_level_dimensions(src_dim, l);
+
+        const vec3ui&       lsize      = level_filter._dst_size;
+        const scm::size_t   row_count  = static_cast<scm::size_t>(lsize.y) * lsize.z;
+        const scm::size_t   task_rows  = (task_texels + lsize.x - 1) / lsize.x;
+        const scm::size_t   grain      = (lsize.z > 1) ? ((task_rows + lsize.y - 1) / lsize.y) * lsize.y
+                                                       : task_rows;
+
+        threads.parallel_for(row_count, grain, level_filter);
+
+        dst_data.push_back(dst_pyramid.get() + level_offsets[l]);
+    }
+}
+
 } // namespace util
 } // namespace gl
 } // namespace scm
@@ -6,6 +6,8 @@
 
 #include <memory.h>
 
+#include <scm/core/utilities/thread_pool.h>
+
 #include <scm/gl_core/log.h>
 #include <scm/gl_core/texture_objects/texture_image.h>
 #include <scm/gl_util/data/imaging/mip_map_generation.h>
@@ -389,6 +391,76 @@ generate_mipmaps(const math::vec3ui&        src_dim,
     return true;
 }
 
+bool
+generate_mipmaps_parallel(const math::vec3ui&         src_dim,
+                                gl::data_format       src_fmt,
+                                uint8*                src_data,
+                                shared_array<uint8>&  dst_pyramid,
+                                std::vector<uint8*>&  dst_data,
+                                thread_pool&          threads)
+{
+    using namespace scm::gl;
+    using namespace scm::math;
+
+    switch (src_fmt) {
+    case FORMAT_R_32F:
+        typed_generate_mipmaps_parallel<float, 1>(src_dim, src_data, dst_pyramid, dst_data, threads);
+        break;
+    case FORMAT_RG_32F:
+        typed_generate_mipmaps_parallel<float, 2>(src_dim, src_data, dst_pyramid, dst_data, threads);
+        break;
+    case FORMAT_RGB_32F:
+        typed_generate_mipmaps_parallel<float, 3>(src_dim, src_data, dst_pyramid, dst_data, threads);
+        break;
+    case FORMAT_RGBA_32F:
+        typed_generate_mipmaps_parallel<float, 4>(src_dim, src_data, dst_pyramid, dst_data, threads);
+        break;
+    case FORMAT_R_8:
+        typed_generate_mipmaps_parallel<uint8, 1>(src_dim, src_data, dst_pyramid, dst_data, threads);
+        break;
+    case FORMAT_RG_8:
+        typed_generate_mipmaps_parallel<uint8, 2>(src_dim, src_data, dst_pyramid, dst_data, threads);
+        break;
+    case FORMAT_RGB_8:
+        typed_generate_mipmaps_parallel<uint8, 3>(src_dim, src_data, dst_pyramid, dst_data, threads);
+        break;
+    case FORMAT_RGBA_8:
+        typed_generate_mipmaps_parallel<uint8, 4>(src_dim, src_data, dst_pyramid, dst_data, threads);
+        break;
+    case FORMAT_R_16:
+        typed_generate_mipmaps_parallel<uint16, 1>(src_dim, src_data, dst_pyramid, dst_data, threads);
+        break;
+    case FORMAT_RG_16:
+        typed_generate_mipmaps_parallel<uint16, 2>(src_dim, src_data, dst_pyramid, dst_data, threads);
+        break;
+    case FORMAT_RGB_16:
+        typed_generate_mipmaps_parallel<uint16, 3>(src_dim, src_data, dst_pyramid, dst_data, threads);
+        break;
+    case FORMAT_RGBA_16:
+        typed_generate_mipmaps_parallel<uint16, 4>(src_dim, src_data, dst_pyramid, dst_data, threads);
+        break;
+    default:
+        glerr() << log::error
+                << "generate_mipmaps_parallel(): error unsupported source data format (" << format_string(src_fmt) << ")." << log::end;
+        return false;
+    }
+
+    return true;
+}
+
+bool
+generate_mipmaps_parallel(const math::vec3ui&         src_dim,
+                                gl::data_format       src_fmt,
+                                uint8*                src_data,
+                                shared_array<uint8>&  dst_pyramid,
+                                std::vector<uint8*>&  dst_data,
+                                unsigned              thread_count)
+{
+    thread_pool threads(thread_count);
+
+    return generate_mipmaps_parallel(src_dim, src_fmt, src_data, dst_pyramid, dst_data, threads);
+}
+
 } // namespace util
 } // namespace gl
 } // namespace scm
@@ -17,6 +17,9 @@
 #include <scm/core/utilities/platform_warning_disable.h>
 
 namespace scm {
+
+class thread_pool;
+
 namespace gl {
 namespace util {
 
@@ -33,6 +36,28 @@ generate_mipmaps(const math::vec3ui&        src_dim,
                        uint8*               src_data,
                        std::vector<uint8*>& dst_data);
 
+// multi-threaded mip map generation with the same results as generate_mipmaps(), all
+// generated levels are stored in the single buffer dst_pyramid which owns the memory of
+// dst_data[1..n], dst_data[0] is the source data
+bool
+__scm_export(gl_util)
+generate_mipmaps_parallel(const math::vec3ui&         src_dim,
+                                gl::data_format       src_fmt,
+                                uint8*                src_data,
+                                shared_array<uint8>&  dst_pyramid,
+                                std::vector<uint8*>&  dst_data,
+                                thread_pool&          threads);
+
+// thread_count = 0 uses one thread per hardware thread
+bool
+__scm_export(gl_util)
+generate_mipmaps_parallel(const math::vec3ui&         src_dim,
+                                gl::data_format       src_fmt,
+                                uint8*                src_data,
+                                shared_array<uint8>&  dst_pyramid,
+                                std::vector<uint8*>&  dst_data,
+                                unsigned              thread_count = 0);
+
 } // namespace util
 } // namespace gl
 } // namespace scm
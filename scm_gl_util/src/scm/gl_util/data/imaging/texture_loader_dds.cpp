@@ -913,14 +913,63 @@ texture_loader_dds::save_image_data_dx9(const std::string&           in_image_pa
         return false;
     }
 
+    io::file::offset_type dds_data_off = 0;
+    if (!write_header_dx9(*out_file, in_img_data->mip_level(0).size(), in_img_data->format(),
+                          static_cast<unsigned>(in_img_data->mip_level_count()), dds_data_off)) {
+        glerr() << log::error
+                << "texture_loader_dds::save_image_data_dx9(): error writing dds header to output file: " << in_image_path << log::end;
+        return false;
+    }
+
+    { // write image data
+        io::file::offset_type woff = dds_data_off;
+        for (unsigned l = 0; l < static_cast<unsigned>(in_img_data->mip_level_count()); ++l) {
+            const scm::size_t         lmip_img_size = mip_level_size(in_img_data->mip_level(l).size(), in_img_data->format());
+
+            if (out_file->write(in_img_data->mip_level(l).data().get(), woff, lmip_img_size) != lmip_img_size) {
+                glerr() << log::error
+                        << "texture_loader_dds::save_image_data_dx9(): error writing to output file: " << in_image_path 
+                        << " (number of bytes attempted to write: " << lmip_img_size << ", at position : " << woff << ")" << log::end;
+                return false;
+            }
+
+            woff += lmip_img_size;
+        }
+    }
+
+    out_file->close();
+
+    if (in_img_data->origin() == texture_image_data::ORIGIN_UPPER_LEFT) {
+        if (!in_img_data->flip_vertical()) {
+            glerr() << log::error
+                    << "texture_loader_dds::save_image_data_dx9(): error flipping image data after save operation." << log::end;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+bool
+texture_loader_dds::write_header_dx9(io::file&           out_file,
+                                     const math::vec3ui& in_size,
+                                     data_format         in_format,
+                                     unsigned            in_level_count,
+                                     io::offset_type&    out_data_offset) const
+{
+    using namespace scm;
+    using namespace scm::gl;
+    using namespace scm::io;
+    using namespace scm::math;
+
     scm::size_t       dds_header_off = sizeof(unsigned int);
-    scm::size_t       dds_data_off   = dds_header_off + sizeof(DDS_HEADER);
 
     // check  magic number ("DDS ")
     unsigned int magic_number = DDS_MAGIC;
-    if (out_file->write(&magic_number, 0, sizeof(unsigned int)) != sizeof(unsigned int)) {
+    if (out_file.write(&magic_number, 0, sizeof(unsigned int)) != sizeof(unsigned int)) {
         glerr() << log::error
-                << "texture_loader_dds::save_image_data_dx9(): error writing to output file: " << in_image_path 
+                << "texture_loader_dds::write_header_dx9(): error writing to output file"
                 << " (number of bytes attempted to write: " << sizeof(unsigned int) << ", at position : " << 0 << ")" << log::end;
         return false;
     }
@@ -933,29 +982,29 @@ texture_loader_dds::save_image_data_dx9(const std::string&           in_image_pa
     dds9_header->dwHeaderFlags       =   DDSD_CAPS
                                        | DDSD_WIDTH
                                        | DDSD_HEIGHT
-                                       | (in_img_data->mip_level(0).size().z > 1 ? DDSD_DEPTH : 0)
+                                       | (in_size.z > 1 ? DDSD_DEPTH : 0)
                                        | DDSD_PIXELFORMAT
-                                       | (in_img_data->mip_level_count() > 1 ? DDSD_MIPMAPCOUNT : 0)
-                                       | (is_compressed_format(in_img_data->format()) ? DDSD_LINEARSIZE : DDSD_PITCH);
-    dds9_header->dwHeight            = in_img_data->mip_level(0).size().y;
-    dds9_header->dwWidth             = in_img_data->mip_level(0).size().x;
-    dds9_header->dwPitchOrLinearSize = (is_compressed_format(in_img_data->format())
-                                         ? max(1u, (in_img_data->mip_level(0).size().x * 3u) / 4u) * compressed_block_size(in_img_data->format())
-                                         : (in_img_data->mip_level(0).size().x * bit_per_pixel(in_img_data->format()) + 7) / 8
+                                       | (in_level_count > 1 ? DDSD_MIPMAPCOUNT : 0)
+                                       | (is_compressed_format(in_format) ? DDSD_LINEARSIZE : DDSD_PITCH);
+    dds9_header->dwHeight            = in_size.y;
+    dds9_header->dwWidth             = in_size.x;
+    dds9_header->dwPitchOrLinearSize = (is_compressed_format(in_format)
+                                         ? max(1u, (in_size.x * 3u) / 4u) * compressed_block_size(in_format)
+                                         : (in_size.x * bit_per_pixel(in_format) + 7) / 8
                                        );
-    dds9_header->dwDepth             = (in_img_data->mip_level(0).size().z > 1 ? in_img_data->mip_level(0).size().z : 0);
-    dds9_header->dwMipMapCount       = (in_img_data->mip_level_count() > 1 ? in_img_data->mip_level_count() : 0);
+    dds9_header->dwDepth             = (in_size.z > 1 ? in_size.z : 0);
+    dds9_header->dwMipMapCount       = (in_level_count > 1 ? in_level_count : 0);
     dds9_header->ddspf.dwSize        = sizeof(DDS_PIXELFORMAT);
-    dds9_header->ddspf.dwFlags       = dds_flags(in_img_data->format());
-    dds9_header->ddspf.dwFourCC      = dds_fourcc(in_img_data->format());
-    dds9_header->ddspf.dwRGBBitCount = (dds9_header->ddspf.dwFourCC & DDPF_FOURCC ? 0 : bit_per_pixel(in_img_data->format()));
+    dds9_header->ddspf.dwFlags       = dds_flags(in_format);
+    dds9_header->ddspf.dwFourCC      = dds_fourcc(in_format);
+    dds9_header->ddspf.dwRGBBitCount = (dds9_header->ddspf.dwFourCC & DDPF_FOURCC ? 0 : bit_per_pixel(in_format));
     unsigned rm = 0;
     unsigned gm = 0;
     unsigned bm = 0;
     unsigned am = 0;
-    if (!dds_bitmask(in_img_data->format(), rm, gm, bm, am)) {
+    if (!dds_bitmask(in_format, rm, gm, bm, am)) {
         glerr() << log::error
-                << "texture_loader_dds::save_image_data_dx9(): error generating dds header bitmask info." << log::end;
+                << "texture_loader_dds::write_header_dx9(): error generating dds header bitmask info." << log::end;
         return false;
     }
     dds9_header->ddspf.dwRBitMask   = rm;
@@ -963,42 +1012,18 @@ texture_loader_dds::save_image_data_dx9(const std::string&           in_image_pa
     dds9_header->ddspf.dwBBitMask   = bm;
     dds9_header->ddspf.dwABitMask   = am;
     dds9_header->dwSurfaceFlags     =   DDSCAPS_TEXTURE
-                                      | (in_img_data->mip_level_count() > 1 ? DDSCAPS_MIPMAP : 0)
-                                      | (in_img_data->mip_level_count() > 1 ? DDSCAPS_COMPLEX : 0);
-    dds9_header->dwSurfaceFlags2    = (in_img_data->mip_level(0).size().z > 1 ? DDSCAPS2_VOLUME : 0);
+                                      | (in_level_count > 1 ? DDSCAPS_MIPMAP : 0)
+                                      | (in_level_count > 1 ? DDSCAPS_COMPLEX : 0);
+    dds9_header->dwSurfaceFlags2    = (in_size.z > 1 ? DDSCAPS2_VOLUME : 0);
 
-    if (out_file->write(dds9_header.get(), dds_header_off, sizeof(DDS_HEADER)) != sizeof(DDS_HEADER)) {
+    if (out_file.write(dds9_header.get(), dds_header_off, sizeof(DDS_HEADER)) != sizeof(DDS_HEADER)) {
         glerr() << log::error
-                << "texture_loader_dds::save_image_data_dx9(): error writing to output file: " << in_image_path 
+                << "texture_loader_dds::write_header_dx9(): error writing to output file"
                 << " (number of bytes attempted to write: " << sizeof(DDS_HEADER) << ", at position : " << dds_header_off << ")" << log::end;
         return false;
     }
 
-    { // write image data
-        io::file::offset_type woff = dds_data_off;
-        for (unsigned l = 0; l < static_cast<unsigned>(in_img_data->mip_level_count()); ++l) {
-            const scm::size_t         lmip_img_size = mip_level_size(in_img_data->mip_level(l).size(), in_img_data->format());
-
-            if (out_file->write(in_img_data->mip_level(l).data().get(), woff, lmip_img_size) != lmip_img_size) {
-                glerr() << log::error
-                        << "texture_loader_dds::save_image_data_dx9(): error writing to output file: " << in_image_path 
-                        << " (number of bytes attempted to write: " << lmip_img_size << ", at position : " << woff << ")" << log::end;
-                return false;
-            }
-
-            woff += lmip_img_size;
-        }
-    }
-
-    out_file->close();
-
-    if (in_img_data->origin() == texture_image_data::ORIGIN_UPPER_LEFT) {
-        if (!in_img_data->flip_vertical()) {
-            glerr() << log::error
-                    << "texture_loader_dds::save_image_data_dx9(): error flipping image data after save operation." << log::end;
-            return false;
-        }
-    }
+    out_data_offset = dds_header_off + sizeof(DDS_HEADER);
 
     return true;
 }
@@ -8,6 +8,7 @@
 #include <scm/core/math.h>
 #include <scm/core/numeric_types.h>
 #include <scm/core/memory.h>
+#include <scm/core/io/io_fwd.h>
 
 #include <scm/gl_core/data_formats.h>
 #include <scm/gl_core/data_types.h>
@@ -34,6 +35,14 @@ public:
     bool                        save_image_data_dx9(const std::string&           in_image_path,
                                                     const texture_image_data_ptr in_img_data) const;
 
+    // write the magic number and dx9 header of an image with in_level_count mip levels,
+    // the level data is expected to follow at out_data_offset (upper left origin)
+    bool                        write_header_dx9(io::file&           out_file,
+                                                 const math::vec3ui& in_size,
+                                                 data_format         in_format,
+                                                 unsigned            in_level_count,
+                                                 io::offset_type&    out_data_offset) const;
+
 }; // class texture_loader_dds
 
 } // namespace gl
@@ -0,0 +1,28 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_VOLUME_OOC_FWD_H_INCLUDED
+#define SCM_GL_UTIL_VOLUME_OOC_FWD_H_INCLUDED
+
+#include <scm/core/memory.h>
+
+namespace scm {
+namespace gl {
+
+class volume_brick_layout;
+class volume_brick_loader;
+class volume_brick_cache;
+class volume_reader_bricked;
+
+typedef shared_ptr<volume_brick_loader>             volume_brick_loader_ptr;
+typedef shared_ptr<volume_brick_loader const>       volume_brick_loader_cptr;
+typedef shared_ptr<volume_brick_cache>              volume_brick_cache_ptr;
+typedef shared_ptr<volume_brick_cache const>        volume_brick_cache_cptr;
+typedef shared_ptr<volume_reader_bricked>           volume_reader_bricked_ptr;
+typedef shared_ptr<volume_reader_bricked const>     volume_reader_bricked_cptr;
+
+} // namespace gl
+} // namespace scm
+
+#endif // SCM_GL_UTIL_VOLUME_OOC_FWD_H_INCLUDED
@@ -0,0 +1,350 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "volume_brick_builder.h"
+
+#include <cstring>
+#include <vector>
+
+#include <boost/type_traits/is_floating_point.hpp>
+
+#include <scm/core/math.h>
+#include <scm/core/memory.h>
+#include <scm/core/numeric_types.h>
+#include <scm/core/io/file.h>
+
+#include <scm/gl_core/log.h>
+
+#include <scm/gl_util/data/volume/volume_reader.h>
+#include <scm/gl_util/data/volume/ooc/volume_brick_layout.h>
+#include <scm/gl_util/data/volume/ooc/volume_reader_bricked.h>
+
+namespace {
+
+using namespace scm;
+using namespace scm::gl;
+using namespace scm::math;
+
+// inclusive region of voxels inside a level
+struct level_region
+{
+    vec3ui  _begin;
+    vec3ui  _end;
+}; // struct level_region
+
+level_region
+clamp_region(const vec3i& o, const vec3ui& s, const vec3ui& dim)
+{
+    level_region r;
+
+    r._begin = vec3ui(clamp(o,                       vec3i(0), vec3i(dim) - vec3i(1)));
+    r._end   = vec3ui(clamp(o + vec3i(s) - vec3i(1), vec3i(0), vec3i(dim) - vec3i(1)));
+
+    return r;
+}
+
+// copy the in-level source region into the destination region, destination
+// voxels outside the level replicate the level edge voxels
+void
+copy_region_clamped(const uint8*        src,
+                    const level_region& src_region,
+                          uint8*        dst,
+                    const vec3i&        dst_origin,
+                    const vec3ui&       dst_size,
+                    const size_t        value_size)
+{
+    const vec3ui    src_size = src_region._end - src_region._begin + vec3ui(1u);
+
+    for (unsigned z = 0; z < dst_size.z; ++z) {
+        const unsigned sz = clamp<int>(dst_origin.z + z, src_region._begin.z, src_region._end.z) - src_region._begin.z;
+        for (unsigned y = 0; y < dst_size.y; ++y) {
+            const unsigned  sy   = clamp<int>(dst_origin.y + y, src_region._begin.y, src_region._end.y) - src_region._begin.y;
+            const uint8*    sl   = src + value_size * (static_cast<size_t>(src_size.x) * (sy + static_cast<size_t>(src_size.y) * sz));
+                  uint8*    dl   = dst + value_size * (static_cast<size_t>(dst_size.x) * (y + static_cast<size_t>(dst_size.y) * z));
+
+            for (unsigned x = 0; x < dst_size.x; ++x) {
+                const unsigned sx = clamp<int>(dst_origin.x + x, src_region._begin.x, src_region._end.x) - src_region._begin.x;
+                memcpy(dl + value_size * x, sl + value_size * sx, value_size);
+            }
+        }
+    }
+}
+
+// source sample positions of a 2:1 downsampled axis, the last voxel of an
+// odd sized source is folded into the last destination voxel
+void
+downsample_axis_samples(const int                 dst_origin,
+                        const unsigned            dst_size,
+                        const unsigned            dst_dim,
+                        const unsigned            src_dim,
+                        const unsigned            src_begin,
+                              std::vector<int>&   samples,
+                              std::vector<int>&   sample_counts)
+{
+    samples.resize(dst_size * 3);
+    sample_counts.resize(dst_size);
+
+    for (unsigned i = 0; i < dst_size; ++i) {
+        const unsigned c = clamp<int>(dst_origin + i, 0, dst_dim - 1);
+
+        int n = 0;
+        samples[3 * i + n++] = 2 * c - src_begin;
+        samples[3 * i + n++] = min(2 * c + 1, src_dim - 1) - src_begin;
+        if ((src_dim & 1) && src_dim > 1 && c == dst_dim - 1) {
+            samples[3 * i + n++] = 2 * c + 2 - src_begin;
+        }
+        sample_counts[i] = n;
+    }
+}
+
+template<typename vtype>
+void
+typed_downsample_region(const uint8*        src,
+                        const level_region& src_region,
+                        const vec3ui&       src_dim,
+                              uint8*        dst,
+                        const vec3i&        dst_origin,
+                        const vec3ui&       dst_size,
+                        const vec3ui&       dst_dim,
+                        const unsigned      channels)
+{
+    const vec3ui        src_size = src_region._end - src_region._begin + vec3ui(1u);
+    const vtype*        s        = reinterpret_cast<const vtype*>(src);
+          vtype*        d        = reinterpret_cast<vtype*>(dst);
+    const float         rnd      = boost::is_floating_point<vtype>::value ? 0.0f : 0.5f;
+
+    std::vector<int>    xs, xn, ys, yn, zs, zn;
+
+    downsample_axis_samples(dst_origin.x, dst_size.x, dst_dim.x, src_dim.x, src_region._begin.x, xs, xn);
+    downsample_axis_samples(dst_origin.y, dst_size.y, dst_dim.y, src_dim.y, src_region._begin.y, ys, yn);
+    downsample_axis_samples(dst_origin.z, dst_size.z, dst_dim.z, src_dim.z, src_region._begin.z, zs, zn);
+
+    std::vector<float>  acc(channels);
+
+    for (unsigned z = 0; z < dst_size.z; ++z) {
+        for (unsigned y = 0; y < dst_size.y; ++y) {
+            for (unsigned x = 0; x < dst_size.x; ++x) {
+                std::fill(acc.begin(), acc.end(), 0.0f);
+
+                for (int k = 0; k < zn[z]; ++k) {
+                    for (int j = 0; j < yn[y]; ++j) {
+                        const vtype* sl = s + channels * (static_cast<size_t>(src_size.x) * (ys[3 * y + j] + static_cast<size_t>(src_size.y) * zs[3 * z + k]));
+                        for (int i = 0; i < xn[x]; ++i) {
+                            const vtype* sv = sl + channels * xs[3 * x + i];
+                            for (unsigned c = 0; c < channels; ++c) {
+                                acc[c] += static_cast<float>(sv[c]);
+                            }
+                        }
+                    }
+                }
+
+                const float w  = 1.0f / static_cast<float>(xn[x] * yn[y] * zn[z]);
+                vtype*      dv = d + channels * (x + static_cast<size_t>(dst_size.x) * (y + static_cast<size_t>(dst_size.y) * z));
+                for (unsigned c = 0; c < channels; ++c) {
+                    dv[c] = static_cast<vtype>(acc[c] * w + rnd);
+                }
+            }
+        }
+    }
+}
+
+bool
+supported_format(const data_format fmt)
+{
+    switch (fmt) {
+    case FORMAT_R_8:  case FORMAT_RG_8:  case FORMAT_RGB_8:  case FORMAT_RGBA_8:
+    case FORMAT_R_16: case FORMAT_RG_16: case FORMAT_RGB_16: case FORMAT_RGBA_16:
+    case FORMAT_R_32F: case FORMAT_RG_32F: case FORMAT_RGB_32F: case FORMAT_RGBA_32F:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool
+downsample_region(const data_format   fmt,
+                  const uint8*        src,
+                  const level_region& src_region,
+                  const vec3ui&       src_dim,
+                        uint8*        dst,
+                  const vec3i&        dst_origin,
+                  const vec3ui&       dst_size,
+                  const vec3ui&       dst_dim)
+{
+    switch (fmt) {
+    case FORMAT_R_8:
+    case FORMAT_RG_8:
+    case FORMAT_RGB_8:
+    case FORMAT_RGBA_8:
+        typed_downsample_region<uint8>(src, src_region, src_dim, dst, dst_origin, dst_size, dst_dim, channel_count(fmt));
+        break;
+    case FORMAT_R_16:
+    case FORMAT_RG_16:
+    case FORMAT_RGB_16:
+    case FORMAT_RGBA_16:
+        typed_downsample_region<uint16>(src, src_region, src_dim, dst, dst_origin, dst_size, dst_dim, channel_count(fmt));
+        break;
+    case FORMAT_R_32F:
+    case FORMAT_RG_32F:
+    case FORMAT_RGB_32F:
+    case FORMAT_RGBA_32F:
+        typed_downsample_region<float>(src, src_region, src_dim, dst, dst_origin, dst_size, dst_dim, channel_count(fmt));
+        break;
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace
+
+namespace scm {
+namespace gl {
+
+bool
+build_brick_volume(volume_reader&      source,
+                   const std::string&  file_path,
+                   const unsigned      brick_size,
+                   const unsigned      brick_border)
+{
+    using namespace scm::math;
+
+    if (!source) {
+        glerr() << log::error
+                << "build_brick_volume(): invalid source volume." << log::end;
+        return false;
+    }
+
+    volume_brick_layout layout(source.dimensions(), source.format(), brick_size, brick_border);
+
+    if (!layout.valid()) {
+        glerr() << log::error
+                << "build_brick_volume(): invalid brick layout"
+                << " (dimensions: " << source.dimensions()
+                << ", brick size: " << brick_size << ", brick border: " << brick_border
+                << "), the brick size has to be even and larger than the border." << log::end;
+        return false;
+    }
+
+    if (!supported_format(layout.format())) {
+        glerr() << log::error
+                << "build_brick_volume(): unsupported volume format (" << format_string(layout.format()) << ")." << log::end;
+        return false;
+    }
+
+    io::file out_file;
+
+    if (!out_file.open(file_path, std::ios_base::in | std::ios_base::out | std::ios_base::trunc, false)) {
+        glerr() << log::error
+                << "build_brick_volume(): error opening output file (" << file_path << ")." << log::end;
+        return false;
+    }
+
+    if (!layout.write_header(out_file)) {
+        return false;
+    }
+
+    const size_t        value_size = size_of_format(layout.format());
+    const unsigned      bsize      = layout.brick_size();
+    const unsigned      bdim       = layout.brick_data_dimensions();
+    const scm::size_t   bdata_size = layout.brick_data_size();
+
+    shared_array<uint8> brick_data(new uint8[bdata_size]);
+    shared_array<uint8> slab_data;
+    shared_array<uint8> src_data;
+    scm::size_t         slab_data_size = 0;
+    scm::size_t         src_data_size  = 0;
+
+    for (unsigned l = 0; l < layout.level_count(); ++l) {
+        const vec3ui&   ldim  = layout.level_dimensions(l);
+        const vec3ui&   lgrid = layout.level_brick_grid(l);
+
+        glout() << log::info
+                << "build_brick_volume(): building level " << l
+                << " (dimensions: " << ldim << ", bricks: " << lgrid << ")." << log::end;
+
+        // process one row of bricks in x direction at a time
+        const vec3ui    slab_size(lgrid.x * bsize + 2 * brick_border, bdim, bdim);
+        const size_t    slab_size_bytes = value_size * slab_size.x * slab_size.y * slab_size.z;
+
+        if (slab_data_size < slab_size_bytes) {
+            slab_data.reset(new uint8[slab_size_bytes]);
+            slab_data_size = slab_size_bytes;
+        }
+
+        for (unsigned bz = 0; bz < lgrid.z; ++bz) {
+            for (unsigned by = 0; by < lgrid.y; ++by) {
+                const vec3i         slab_origin(-static_cast<int>(brick_border),
+                                                by * bsize - brick_border,
+                                                bz * bsize - brick_border);
+                const level_region  slab_region = clamp_region(slab_origin, slab_size, ldim);
+
+                // source region: the level itself for level 0, the previous level otherwise
+                level_region        src_region  = slab_region;
+                vec3ui              src_dim     = ldim;
+
+                if (l > 0) {
+                    src_dim             = layout.level_dimensions(l - 1);
+                    src_region._begin   = 2u * slab_region._begin;
+                    src_region._end     = min(2u * slab_region._end + vec3ui(2u), src_dim - vec3ui(1u));
+                }
+
+                const vec3ui    src_size       = src_region._end - src_region._begin + vec3ui(1u);
+                const size_t    src_size_bytes = value_size * src_size.x * src_size.y * src_size.z;
+
+                if (src_data_size < src_size_bytes) {
+                    src_data.reset(new uint8[src_size_bytes]);
+                    src_data_size = src_size_bytes;
+                }
+
+                if (l == 0) {
+                    if (!source.read(src_region._begin, src_size, src_data.get())) {
+                        glerr() << log::error
+                                << "build_brick_volume(): error reading source volume region"
+                                << " (origin: " << src_region._begin << ", size: " << src_size << ")." << log::end;
+                        return false;
+                    }
+                    copy_region_clamped(src_data.get(), src_region, slab_data.get(), slab_origin, slab_size, value_size);
+                }
+                else {
+                    if (!volume_reader_bricked::read_level_region(out_file, layout, l - 1, src_region._begin, src_size, src_data.get())) {
+                        glerr() << log::error
+                                << "build_brick_volume(): error reading level " << l - 1 << " region"
+                                << " (origin: " << src_region._begin << ", size: " << src_size << ")." << log::end;
+                        return false;
+                    }
+                    downsample_region(layout.format(), src_data.get(), src_region, src_dim,
+                                      slab_data.get(), slab_origin, slab_size, ldim);
+                }
+
+                // cut the bricks out of the slab
+                for (unsigned bx = 0; bx < lgrid.x; ++bx) {
+                    for (unsigned z = 0; z < bdim; ++z) {
+                        for (unsigned y = 0; y < bdim; ++y) {
+                            const uint8* sl = slab_data.get() + value_size * (bx * bsize + static_cast<size_t>(slab_size.x) * (y + static_cast<size_t>(slab_size.y) * z));
+                                  uint8* dl = brick_data.get() + value_size * (static_cast<size_t>(bdim) * (y + static_cast<size_t>(bdim) * z));
+                            memcpy(dl, sl, value_size * bdim);
+                        }
+                    }
+
+                    const scm::uint32 bindex = layout.brick_index(l, vec3ui(bx, by, bz));
+
+                    if (out_file.write(brick_data.get(), layout.brick_data_offset(bindex), bdata_size) != static_cast<io::size_type>(bdata_size)) {
+                        glerr() << log::error
+                                << "build_brick_volume(): error writing brick " << bindex << " (" << file_path << ")." << log::end;
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+
+    out_file.close();
+
+    return true;
+}
+
+} // namespace gl
+} // namespace scm
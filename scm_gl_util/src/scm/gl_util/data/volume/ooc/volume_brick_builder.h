@@ -0,0 +1,34 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_VOLUME_BRICK_BUILDER_H_INCLUDED
+#define SCM_GL_UTIL_VOLUME_BRICK_BUILDER_H_INCLUDED
+
+#include <string>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+class volume_reader;
+
+// converts the source volume into a bricked volume file containing the complete
+// resolution pyramid of the volume (see volume_brick_layout). the conversion works
+// out-of-core, only a single row of bricks is held in memory at any time.
+// supported are the unsigned normalized 8/16bit and 32bit floating point formats.
+bool
+__scm_export(gl_util)
+build_brick_volume(volume_reader&      source,
+                   const std::string&  file_path,
+                   const unsigned      brick_size   = 64,
+                   const unsigned      brick_border = 1);
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_UTIL_VOLUME_BRICK_BUILDER_H_INCLUDED
@@ -0,0 +1,758 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "volume_brick_cache.h"
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include <scm/gl_core/log.h>
+#include <scm/gl_core/render_device.h>
+#include <scm/gl_core/shader_objects.h>
+#include <scm/gl_core/state_objects.h>
+#include <scm/gl_core/texture_objects.h>
+
+#include <scm/gl_util/data/volume/ooc/volume_brick_loader.h>
+
+namespace {
+
+const scm::uint32   page_table_invalid_level    = 0xffu;
+const scm::uint32   page_table_invalid_entry    = page_table_invalid_level << 24;
+const unsigned      max_loaded_bricks           = 64;
+const unsigned      max_atlas_slots_per_axis    = 255;
+const unsigned      staged_bricks_per_buffer    = 16;
+const int           staging_buffer_count        = 4;
+
+// page table lookup, tc are texture coordinates of level 0, level is the finest level
+// to sample, the page table redirects to the nearest resident ancestor
+const std::string brick_cache_include_path = "/scm/gl_util/volume_brick_cache.glslh";
+const std::string brick_cache_include_src  = "                                                 \
+    #ifndef SCM_GL_UTIL_VOLUME_BRICK_CACHE_INCLUDED                                             \n\
+    #define SCM_GL_UTIL_VOLUME_BRICK_CACHE_INCLUDED                                             \n\
+                                                                                                \n\
+    uniform sampler3D   brick_cache_atlas;                                                      \n\
+    uniform usampler3D  brick_cache_page_table;                                                 \n\
+                                                                                                \n\
+    uniform int         brick_cache_level_count;                                                \n\
+    uniform float       brick_cache_brick_size;                                                 \n\
+    uniform float       brick_cache_brick_border;                                               \n\
+    uniform vec3        brick_cache_atlas_size;                                                 \n\
+    uniform vec3        brick_cache_level_dimensions[16];                                       \n\
+    uniform float       brick_cache_level_offsets[16];                                          \n\
+                                                                                                \n\
+    ivec3 brick_cache_brick(in vec3 tc, in int level, out vec3 vpos)                            \n\
+    {                                                                                           \n\
+        vec3 ldim = brick_cache_level_dimensions[level];                                        \n\
+        vec3 grid = ceil(ldim / brick_cache_brick_size);                                        \n\
+        vpos = clamp(tc, vec3(0.0), vec3(1.0)) * ldim;                                          \n\
+        return ivec3(min(floor(vpos / brick_cache_brick_size), grid - vec3(1.0)));              \n\
+    }                                                                                           \n\
+                                                                                                \n\
+    bool brick_cache_lookup(in vec3 tc, in int level, out vec4 value)                           \n\
+    {                                                                                           \n\
+        int   l = clamp(level, 0, brick_cache_level_count - 1);                                 \n\
+        vec3  vpos;                                                                             \n\
+        ivec3 b = brick_cache_brick(tc, l, vpos);                                               \n\
+        uvec4 e = texelFetch(brick_cache_page_table,                                            \n\
+                             b + ivec3(int(brick_cache_level_offsets[l]), 0, 0), 0);            \n\
+                                                                                                \n\
+        if (e.w >= uint(brick_cache_level_count)) {                                             \n\
+            value = vec4(0.0);                                                                  \n\
+            return false;                                                                       \n\
+        }                                                                                       \n\
+        if (int(e.w) != l) {                                                                    \n\
+            b = brick_cache_brick(tc, int(e.w), vpos);                                          \n\
+        }                                                                                       \n\
+                                                                                                \n\
+        vec3 bdim = vec3(brick_cache_brick_size + 2.0 * brick_cache_brick_border);              \n\
+        vec3 apos =   vec3(e.xyz) * bdim + vec3(brick_cache_brick_border)                       \n\
+                    + (vpos - vec3(b) * brick_cache_brick_size);                                \n\
+                                                                                                \n\
+        value = textureLod(brick_cache_atlas, apos / brick_cache_atlas_size, 0.0);              \n\
+        return true;                                                                            \n\
+    }                                                                                           \n\
+                                                                                                \n\
+    #endif // SCM_GL_UTIL_VOLUME_BRICK_CACHE_INCLUDED                                           \n\
+                                                                                                \n\
+    ";
+
+struct brick_level_less
+{
+    brick_level_less(const scm::gl::volume_brick_layout& l) : _layout(l) {}
+
+    // orders bricks of coarser levels first
+    bool operator()(scm::uint32 lhs, scm::uint32 rhs) const {
+        unsigned        ll, rl;
+        scm::math::vec3ui   lb, rb;
+        _layout.brick_coordinates(lhs, ll, lb);
+        _layout.brick_coordinates(rhs, rl, rb);
+        return ll > rl;
+    }
+
+    const scm::gl::volume_brick_layout& _layout;
+}; // struct brick_level_less
+
+} // namespace
+
+namespace scm {
+namespace gl {
+
+volume_brick_cache::volume_brick_cache(const render_device_ptr& device,
+                                       const std::string&       file_path,
+                                       const math::vec3ui&      atlas_slots,
+                                       const bool               file_unbuffered)
+  : _atlas_slots(atlas_slots)
+  , _frame(1)
+{
+    using namespace scm::math;
+
+    _loader.reset(new volume_brick_loader(file_path, file_unbuffered, max_loaded_bricks));
+
+    if (!(*_loader)) {
+        std::ostringstream s;
+        s << "volume_brick_cache::volume_brick_cache(): error opening brick volume (" << file_path << ").";
+        glerr() << log::error << s.str() << log::end;
+        throw std::runtime_error(s.str());
+    }
+
+    const volume_brick_layout&  bl          = _loader->layout();
+    const vec3ui                atlas_size  = _atlas_slots * bl.brick_data_dimensions();
+    const int                   max_tex_dim = device->capabilities()._max_texture_3d_size;
+
+    if (   _atlas_slots.x == 0 || _atlas_slots.y == 0 || _atlas_slots.z == 0
+        || _atlas_slots.x > max_atlas_slots_per_axis
+        || _atlas_slots.y > max_atlas_slots_per_axis
+        || _atlas_slots.z > max_atlas_slots_per_axis
+        || max(max(atlas_size.x, atlas_size.y), atlas_size.z) > static_cast<unsigned>(max_tex_dim)
+        || _atlas_slots.x * _atlas_slots.y * _atlas_slots.z < bl.level_brick_count(bl.level_count() - 1)) {
+        std::ostringstream s;
+        s << "volume_brick_cache::volume_brick_cache(): invalid atlas configuration"
+          << " (atlas slots: " << _atlas_slots << ", atlas size: " << atlas_size
+          << ", max texture size: " << max_tex_dim << ").";
+        glerr() << log::error << s.str() << log::end;
+        throw std::runtime_error(s.str());
+    }
+
+    _atlas_texture = device->create_texture_3d(atlas_size, bl.format(), 1);
+
+    if (!_atlas_texture) {
+        std::ostringstream s;
+        s << "volume_brick_cache::volume_brick_cache(): error creating brick atlas texture"
+          << " (size: " << atlas_size << ", format: " << format_string(bl.format()) << ").";
+        glerr() << log::error << s.str() << log::end;
+        throw std::runtime_error(s.str());
+    }
+
+    // page table levels are placed next to each other in x direction
+    vec3ui  page_table_size(0u, 1u, 1u);
+
+    _page_table.resize(bl.level_count());
+    _page_table_level_offsets.resize(bl.level_count());
+
+    for (unsigned l = 0; l < bl.level_count(); ++l) {
+        const vec3ui& lgrid = bl.level_brick_grid(l);
+
+        _page_table_level_offsets[l] = page_table_size.x;
+        _page_table[l]._entries.resize(bl.level_brick_count(l), page_table_invalid_entry);
+        mark_page_table_dirty(l, vec3ui(0u), lgrid);
+
+        page_table_size.x += lgrid.x;
+        page_table_size.y  = max(page_table_size.y, lgrid.y);
+        page_table_size.z  = max(page_table_size.z, lgrid.z);
+    }
+
+    _page_table_texture = device->create_texture_3d(page_table_size, FORMAT_RGBA_8UI, 1);
+
+    if (!_page_table_texture) {
+        std::ostringstream s;
+        s << "volume_brick_cache::volume_brick_cache(): error creating page table texture"
+          << " (size: " << page_table_size << ").";
+        glerr() << log::error << s.str() << log::end;
+        throw std::runtime_error(s.str());
+    }
+
+    _atlas_sampler      = device->create_sampler_state(FILTER_MIN_MAG_LINEAR,  WRAP_CLAMP_TO_EDGE);
+    _page_table_sampler = device->create_sampler_state(FILTER_MIN_MAG_NEAREST, WRAP_CLAMP_TO_EDGE);
+
+    if (!_atlas_sampler || !_page_table_sampler) {
+        std::ostringstream s;
+        s << "volume_brick_cache::volume_brick_cache(): error creating lookup sampler states.";
+        glerr() << log::error << s.str() << log::end;
+        throw std::runtime_error(s.str());
+    }
+
+    if (bl.level_count() > max_lookup_levels) {
+        glout() << log::warning
+                << "volume_brick_cache::volume_brick_cache(): "
+                << "levels beyond " << max_lookup_levels << " are not reachable by shader lookups "
+                << "(level count: " << bl.level_count() << ")." << log::end;
+    }
+
+    const scm::size_t brick_bytes =   static_cast<scm::size_t>(size_of_format(bl.format()))
+                                    * bl.brick_data_dimensions() * bl.brick_data_dimensions() * bl.brick_data_dimensions();
+
+    _upload_queue = device->create_texture_upload_queue(brick_bytes * staged_bricks_per_buffer, staging_buffer_count);
+    if (!_upload_queue) {
+        glout() << log::warning
+                << "volume_brick_cache::volume_brick_cache(): unable to create texture upload queue, "
+                << "uploading bricks directly." << log::end;
+    }
+
+    _slots.resize(_atlas_slots.x * _atlas_slots.y * _atlas_slots.z);
+    for (unsigned s = 0; s < _slots.size(); ++s) {
+        _slots[s]._lru_position = _lru.insert(_lru.end(), s);
+    }
+
+    _missing_flags.resize(bl.brick_count(), false);
+}
+
+volume_brick_cache::~volume_brick_cache()
+{
+    _loader.reset();
+
+    _atlas_texture.reset();
+    _page_table_texture.reset();
+    _atlas_sampler.reset();
+    _page_table_sampler.reset();
+}
+
+const volume_brick_layout&
+volume_brick_cache::layout() const
+{
+    return _loader->layout();
+}
+
+const texture_3d_ptr&
+volume_brick_cache::atlas_texture() const
+{
+    return _atlas_texture;
+}
+
+const texture_3d_ptr&
+volume_brick_cache::page_table_texture() const
+{
+    return _page_table_texture;
+}
+
+const math::vec3ui&
+volume_brick_cache::atlas_slots() const
+{
+    return _atlas_slots;
+}
+
+unsigned
+volume_brick_cache::page_table_level_offset(const unsigned level) const
+{
+    assert(level < _page_table_level_offsets.size());
+    return _page_table_level_offsets[level];
+}
+
+void
+volume_brick_cache::request_brick(const unsigned      level,
+                                  const math::vec3ui& brick)
+{
+    request_brick(layout().brick_index(level, brick));
+}
+
+void
+volume_brick_cache::request_brick(const scm::uint32 index)
+{
+    const volume_brick_layout&  bl = layout();
+
+    assert(index < bl.brick_count());
+
+    brick_slot_map::const_iterator  r = _resident.find(index);
+
+    if (r != _resident.end()) {
+        touch_slot(r->second);
+        return;
+    }
+
+    brick_slot_map::const_iterator  p = _pending.find(index);
+
+    if (p != _pending.end()) {
+        touch_slot(p->second);
+    }
+    else if (!_missing_flags[index]) {
+        _missing_flags[index] = true;
+        _missing.push_back(index);
+    }
+
+    // keep the data currently used in place of the missing brick
+    unsigned        l;
+    math::vec3ui    b;
+    bl.brick_coordinates(index, l, b);
+
+    while (l + 1 < bl.level_count()) {
+        b = bl.parent_brick(l, b);
+        ++l;
+
+        r = _resident.find(bl.brick_index(l, b));
+        if (r != _resident.end()) {
+            touch_slot(r->second);
+            break;
+        }
+    }
+}
+
+void
+volume_brick_cache::request_view_dependent(const math::vec3f& view_position,
+                                           const float        lod_scale,
+                                           const unsigned     max_requests)
+{
+    using namespace scm::math;
+
+    typedef std::pair<unsigned, vec3ui>  level_brick;
+
+    const volume_brick_layout&  bl      = layout();
+    const unsigned              top     = bl.level_count() - 1;
+    const vec3f                 l0_dim  = vec3f(bl.volume_dimensions());
+
+    std::deque<level_brick>     traversal;
+
+    const vec3ui& tgrid = bl.level_brick_grid(top);
+    for (unsigned z = 0; z < tgrid.z; ++z) {
+        for (unsigned y = 0; y < tgrid.y; ++y) {
+            for (unsigned x = 0; x < tgrid.x; ++x) {
+                traversal.push_back(level_brick(top, vec3ui(x, y, z)));
+            }
+        }
+    }
+
+    unsigned request_count = 0;
+
+    // breadth first refinement, coarse bricks are refined first
+    while (!traversal.empty()) {
+        const level_brick   lb = traversal.front();
+        traversal.pop_front();
+
+        const unsigned      l       = lb.first;
+        const vec3ui&       b       = lb.second;
+        const vec3ui&       ldim    = bl.level_dimensions(l);
+        const vec3f         lscale  = l0_dim / vec3f(ldim);
+        const vec3f         bmin    = vec3f(b * bl.brick_size()) * lscale;
+        const vec3f         bmax    = vec3f(min((b + vec3ui(1u)) * bl.brick_size(), ldim)) * lscale;
+        const vec3f         nearest = clamp(view_position, bmin, bmax);
+        const float         extent  = static_cast<float>(bl.brick_size()) * max(max(lscale.x, lscale.y), lscale.z);
+
+        bool refine = (l > 0) && (length(view_position - nearest) < lod_scale * extent);
+
+        if (refine) {
+            // children of the brick, the last brick in each direction also owns the
+            // remaining children of an odd sized finer level
+            const vec3ui&   cgrid   = bl.level_brick_grid(l - 1);
+            const vec3ui&   pgrid   = bl.level_brick_grid(l);
+            const vec3ui    cbegin  = min(2u * b, cgrid - vec3ui(1u));
+            vec3ui          cend    = min(2u * b + vec3ui(2u), cgrid);
+
+            for (unsigned d = 0; d < 3; ++d) {
+                if (b[d] == pgrid[d] - 1) {
+                    cend[d] = cgrid[d];
+                }
+            }
+
+            const vec3ui    ccount      = cend - cbegin;
+            const unsigned  child_count = ccount.x * ccount.y * ccount.z;
+
+            if (request_count + traversal.size() + child_count <= max_requests) {
+                for (unsigned z = cbegin.z; z < cend.z; ++z) {
+                    for (unsigned y = cbegin.y; y < cend.y; ++y) {
+                        for (unsigned x = cbegin.x; x < cend.x; ++x) {
+                            traversal.push_back(level_brick(l - 1, vec3ui(x, y, z)));
+                        }
+                    }
+                }
+                continue;
+            }
+        }
+
+        request_brick(l, b);
+        ++request_count;
+    }
+}
+
+void
+volume_brick_cache::update(const render_context_ptr& context,
+                           const unsigned            max_uploads,
+                           const scm::size_t         max_upload_bytes)
+{
+    using namespace scm::math;
+
+    const volume_brick_layout&  bl  = layout();
+    const unsigned              top = bl.level_count() - 1;
+
+    // the coarsest level is always required
+    for (scm::uint32 i = bl.level_brick_index_offset(top); i < bl.brick_count(); ++i) {
+        if (!brick_resident(i) && _pending.find(i) == _pending.end() && !_missing_flags[i]) {
+            _missing_flags[i] = true;
+            _missing.push_back(i);
+        }
+    }
+
+    // coarse bricks first, they serve as fallback for all finer bricks
+    std::stable_sort(_missing.begin(), _missing.end(), brick_level_less(bl));
+
+    _loader->update_requests(_missing);
+
+    volume_brick_loader::loaded_brick_vector    loaded_bricks;
+    _loader->fetch_loaded_bricks(loaded_bricks, max_uploads - (std::min)(_pending.size(), static_cast<scm::size_t>(max_uploads)));
+
+    for (volume_brick_loader::loaded_brick_vector::const_iterator b = loaded_bricks.begin();
+         b != loaded_bricks.end(); ++b) {
+        if (brick_resident(b->_index) || _pending.find(b->_index) != _pending.end()) {
+            continue;
+        }
+
+        unsigned        l;
+        math::vec3ui    bc;
+        bl.brick_coordinates(b->_index, l, bc);
+
+        if (!upload_brick(context, b->_index, b->_data, l == top)) {
+            // no free slot available this frame, the dropped bricks are requested again
+            break;
+        }
+    }
+
+    // the queue issues the uploads in order, the bricks issued this frame are published in the
+    // page table, which is updated after the brick uploads
+    if (_upload_queue) {
+        const scm::size_t issued = _upload_queue->process(context, texture_upload_queue::upload_budget(max_upload_bytes));
+
+        for (scm::size_t i = 0; i < issued && !_pending_order.empty(); ++i) {
+            const scm::uint32           index = _pending_order.front();
+            brick_slot_map::iterator    p     = _pending.find(index);
+
+            assert(p != _pending.end());
+
+            const unsigned slot = p->second;
+
+            _pending_order.pop_front();
+            _pending.erase(p);
+            publish_brick(index, slot);
+        }
+    }
+
+    upload_page_table(context);
+
+    for (brick_index_vector::const_iterator m = _missing.begin(); m != _missing.end(); ++m) {
+        _missing_flags[*m] = false;
+    }
+    _missing.clear();
+
+    ++_frame;
+}
+
+void
+volume_brick_cache::add_lookup_include_string(const render_device_ptr& device)
+{
+    if (!device->add_include_string(brick_cache_include_path, brick_cache_include_src)) {
+        glerr() << log::error
+                << "volume_brick_cache::add_lookup_include_string(): "
+                << "error adding brick cache lookup include string." << log::end;
+    }
+}
+
+void
+volume_brick_cache::bind_lookup(const render_context_ptr& context,
+                                const program_ptr&        program,
+                                const unsigned            atlas_unit,
+                                const unsigned            page_table_unit) const
+{
+    using namespace scm::math;
+
+    const volume_brick_layout&  bl          = layout();
+    const unsigned              level_count = min(bl.level_count(), max_lookup_levels);
+
+    program->uniform("brick_cache_atlas",        static_cast<int>(atlas_unit));
+    program->uniform("brick_cache_page_table",   static_cast<int>(page_table_unit));
+    program->uniform("brick_cache_level_count",  static_cast<int>(level_count));
+    program->uniform("brick_cache_brick_size",   static_cast<float>(bl.brick_size()));
+    program->uniform("brick_cache_brick_border", static_cast<float>(bl.brick_border()));
+    program->uniform("brick_cache_atlas_size",   vec3f(_atlas_texture->descriptor()._size));
+
+    for (unsigned l = 0; l < level_count; ++l) {
+        program->uniform("brick_cache_level_dimensions", static_cast<int>(l), vec3f(bl.level_dimensions(l)));
+        program->uniform("brick_cache_level_offsets",    static_cast<int>(l), static_cast<float>(_page_table_level_offsets[l]));
+    }
+
+    context->bind_texture(_atlas_texture,      _atlas_sampler,      atlas_unit);
+    context->bind_texture(_page_table_texture, _page_table_sampler, page_table_unit);
+}
+
+bool
+volume_brick_cache::brick_resident(const scm::uint32 index) const
+{
+    return _resident.find(index) != _resident.end();
+}
+
+scm::size_t
+volume_brick_cache::resident_bricks() const
+{
+    return _resident.size();
+}
+
+scm::size_t
+volume_brick_cache::missing_bricks() const
+{
+    return _missing.size();
+}
+
+scm::size_t
+volume_brick_cache::pending_bricks() const
+{
+    return _pending.size();
+}
+
+scm::uint64
+volume_brick_cache::frame() const
+{
+    return _frame;
+}
+
+void
+volume_brick_cache::touch_slot(const unsigned slot)
+{
+    atlas_slot& s = _slots[slot];
+
+    s._last_used = _frame;
+    _lru.splice(_lru.begin(), _lru, s._lru_position);
+}
+
+bool
+volume_brick_cache::allocate_slot(unsigned& slot)
+{
+    // least recently used slots are at the back of the list, slots used in
+    // the current frame are never evicted
+    for (std::list<unsigned>::reverse_iterator s = _lru.rbegin(); s != _lru.rend(); ++s) {
+        const atlas_slot& as = _slots[*s];
+
+        if (as._pinned || as._pending) {
+            continue;
+        }
+        if (as._brick != invalid_brick && as._last_used >= _frame) {
+            return false;
+        }
+
+        slot = *s;
+        return true;
+    }
+
+    return false;
+}
+
+bool
+volume_brick_cache::upload_brick(const render_context_ptr&  context,
+                                 const scm::uint32          index,
+                                 const shared_array<uint8>& data,
+                                 const bool                 pinned)
+{
+    using namespace scm::math;
+
+    const volume_brick_layout&  bl = layout();
+
+    unsigned slot = 0;
+    if (!allocate_slot(slot)) {
+        return false;
+    }
+
+    if (_slots[slot]._brick != invalid_brick) {
+        evict_slot(slot);
+    }
+
+    const vec3ui    bdim(bl.brick_data_dimensions());
+    const vec3ui    origin = slot_position(slot) * bdim;
+
+    const bool      uploaded = _upload_queue ? _upload_queue->upload(_atlas_texture, texture_region(origin, bdim), 0, bl.format(), data)
+                                             : context->update_sub_texture(_atlas_texture, texture_region(origin, bdim), 0, bl.format(), data.get());
+    if (!uploaded) {
+        glerr() << log::error
+                << "volume_brick_cache::upload_brick(): "
+                << "error uploading brick " << index << " to atlas slot " << slot_position(slot) << "." << log::end;
+        return false;
+    }
+
+    _slots[slot]._brick  = index;
+    _slots[slot]._pinned = pinned;
+    touch_slot(slot);
+
+    if (_upload_queue) {
+        _slots[slot]._pending = true;
+        _pending[index]       = slot;
+        _pending_order.push_back(index);
+    }
+    else {
+        publish_brick(index, slot);
+    }
+
+    return true;
+}
+
+void
+volume_brick_cache::publish_brick(const scm::uint32 index,
+                                  const unsigned    slot)
+{
+    _slots[slot]._pending = false;
+
+    _resident[index] = slot;
+    update_page_table_entries(index);
+}
+
+void
+volume_brick_cache::evict_slot(const unsigned slot)
+{
+    const scm::uint32 index = _slots[slot]._brick;
+
+    _slots[slot]._brick  = invalid_brick;
+    _slots[slot]._pinned = false;
+
+    _resident.erase(index);
+    update_page_table_entries(index);
+}
+
+void
+volume_brick_cache::update_page_table_entries(const scm::uint32 index)
+{
+    using namespace scm::math;
+
+    const volume_brick_layout&  bl = layout();
+
+    unsigned        level;
+    vec3ui          brick;
+    bl.brick_coordinates(index, level, brick);
+
+    { // the entry of the brick itself
+        brick_slot_map::const_iterator  r    = _resident.find(index);
+        const vec3ui&                   grid = bl.level_brick_grid(level);
+        scm::uint32&                    e    = _page_table[level]._entries[brick.x + grid.x * (brick.y + grid.y * brick.z)];
+
+        if (r != _resident.end()) {
+            e = page_table_entry(r->second, level);
+        }
+        else if (level + 1 < bl.level_count()) {
+            const vec3ui    p     = bl.parent_brick(level, brick);
+            const vec3ui&   pgrid = bl.level_brick_grid(level + 1);
+            e = _page_table[level + 1]._entries[p.x + pgrid.x * (p.y + pgrid.y * p.z)];
+        }
+        else {
+            e = page_table_invalid_entry;
+        }
+        mark_page_table_dirty(level, brick, brick + vec3ui(1u));
+    }
+
+    // propagate to all non-resident descendants
+    vec3ui  rbegin = brick;
+    vec3ui  rend   = brick + vec3ui(1u);
+
+    for (int l = static_cast<int>(level) - 1; l >= 0; --l) {
+        const vec3ui&   grid  = bl.level_brick_grid(l);
+        const vec3ui&   pgrid = bl.level_brick_grid(l + 1);
+
+        vec3ui  cbegin = min(2u * rbegin, grid - vec3ui(1u));
+        vec3ui  cend   = min(2u * rend, grid);
+        for (unsigned d = 0; d < 3; ++d) {
+            if (rend[d] == pgrid[d]) {
+                cend[d] = grid[d];
+            }
+        }
+
+        const scm::uint32   loffset = bl.level_brick_index_offset(l);
+
+        for (unsigned z = cbegin.z; z < cend.z; ++z) {
+            for (unsigned y = cbegin.y; y < cend.y; ++y) {
+                for (unsigned x = cbegin.x; x < cend.x; ++x) {
+                    const scm::uint32 li = x + grid.x * (y + grid.y * z);
+
+                    if (!brick_resident(loffset + li)) {
+                        const vec3ui p = bl.parent_brick(l, vec3ui(x, y, z));
+                        _page_table[l]._entries[li] = _page_table[l + 1]._entries[p.x + pgrid.x * (p.y + pgrid.y * p.z)];
+                    }
+                }
+            }
+        }
+        mark_page_table_dirty(l, cbegin, cend);
+
+        rbegin = cbegin;
+        rend   = cend;
+    }
+}
+
+void
+volume_brick_cache::mark_page_table_dirty(const unsigned      level,
+                                          const math::vec3ui& begin,
+                                          const math::vec3ui& end)
+{
+    page_table_level& ptl = _page_table[level];
+
+    if (ptl._dirty) {
+        ptl._dirty_begin = math::min(ptl._dirty_begin, begin);
+        ptl._dirty_end   = math::max(ptl._dirty_end,   end);
+    }
+    else {
+        ptl._dirty_begin = begin;
+        ptl._dirty_end   = end;
+        ptl._dirty       = true;
+    }
+}
+
+void
+volume_brick_cache::upload_page_table(const render_context_ptr& context)
+{
+    using namespace scm::math;
+
+    const volume_brick_layout&  bl = layout();
+    std::vector<scm::uint32>    region_entries;
+
+    for (unsigned l = 0; l < bl.level_count(); ++l) {
+        page_table_level& ptl = _page_table[l];
+
+        if (!ptl._dirty) {
+            continue;
+        }
+
+        const vec3ui&   grid = bl.level_brick_grid(l);
+        const vec3ui    rdim = ptl._dirty_end - ptl._dirty_begin;
+
+        region_entries.resize(rdim.x * rdim.y * rdim.z);
+        for (unsigned z = 0; z < rdim.z; ++z) {
+            for (unsigned y = 0; y < rdim.y; ++y) {
+                const scm::uint32* src = &ptl._entries[ptl._dirty_begin.x + grid.x * ((ptl._dirty_begin.y + y) + grid.y * (ptl._dirty_begin.z + z))];
+                std::copy(src, src + rdim.x, region_entries.begin() + rdim.x * (y + rdim.y * z));
+            }
+        }
+
+        const vec3ui    origin = ptl._dirty_begin + vec3ui(_page_table_level_offsets[l], 0u, 0u);
+
+        if (!context->update_sub_texture(_page_table_texture, texture_region(origin, rdim), 0, FORMAT_RGBA_8UI, &region_entries.front())) {
+            glerr() << log::error
+                    << "volume_brick_cache::upload_page_table(): "
+                    << "error updating page table level " << l << "." << log::end;
+            continue;
+        }
+
+        ptl._dirty = false;
+    }
+}
+
+scm::uint32
+volume_brick_cache::page_table_entry(const unsigned slot, const unsigned level) const
+{
+    const math::vec3ui p = slot_position(slot);
+
+    return p.x | (p.y << 8) | (p.z << 16) | (level << 24);
+}
+
+math::vec3ui
+volume_brick_cache::slot_position(const unsigned slot) const
+{
+    return math::vec3ui(  slot % _atlas_slots.x,
+                         (slot / _atlas_slots.x) % _atlas_slots.y,
+                          slot / (_atlas_slots.x * _atlas_slots.y));
+}
+
+} // namespace gl
+} // namespace scm
@@ -0,0 +1,179 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_VOLUME_BRICK_CACHE_H_INCLUDED
+#define SCM_GL_UTIL_VOLUME_BRICK_CACHE_H_INCLUDED
+
+#include <deque>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <scm/core/math.h>
+#include <scm/core/memory.h>
+#include <scm/core/numeric_types.h>
+
+#include <scm/gl_core/gl_core_fwd.h>
+
+#include <scm/gl_util/data/volume/ooc/ooc_fwd.h>
+#include <scm/gl_util/data/volume/ooc/volume_brick_layout.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// GPU cache of the bricks of a bricked volume file
+//  - bricks are stored in the slots of a 3D texture atlas (including their borders),
+//    slots are recycled in least recently used order
+//  - the page table is a FORMAT_RGBA_8UI 3D texture holding one entry per brick of each
+//    level, level l occupies the region starting at page_table_level_offset(l) in x
+//  - a page table entry (x, y, z, w) refers to atlas slot (x, y, z) holding the data
+//    of the brick at level w, which is the brick itself if resident or its nearest
+//    resident ancestor otherwise (w = 255 marks entries without resident data)
+//  - the coarsest level is always resident, so every lookup yields valid data
+//
+// shaders sample the cache through brick_cache_lookup() of the include registered by
+// add_lookup_include_string() (/scm/gl_util/volume_brick_cache.glslh), bind_lookup() binds
+// the atlas and page table and sets the lookup uniforms of the program.
+//
+// usage per frame: request the bricks required for rendering, then call update()
+// to hand the missing bricks to the background loader and upload finished bricks.
+// bricks staged through the upload queue are pending until their upload is issued,
+// their page table entries are published in the frame the upload is issued.
+class __scm_export(gl_util) volume_brick_cache : boost::noncopyable
+{
+public:
+    typedef std::vector<scm::uint32>    brick_index_vector;
+
+    // levels beyond are not reachable by shader lookups
+    static const unsigned               max_lookup_levels = 16;
+
+public:
+    volume_brick_cache(const render_device_ptr& device,
+                       const std::string&       file_path,
+                       const math::vec3ui&      atlas_slots,
+                       const bool               file_unbuffered = false);
+    virtual ~volume_brick_cache();
+
+    const volume_brick_layout&  layout() const;
+
+    const texture_3d_ptr&       atlas_texture() const;
+    const texture_3d_ptr&       page_table_texture() const;
+    const math::vec3ui&         atlas_slots() const;
+    unsigned                    page_table_level_offset(const unsigned level) const;
+
+    // mark a brick as required for the current frame
+    void                        request_brick(const unsigned      level,
+                                              const math::vec3ui& brick);
+    void                        request_brick(const scm::uint32   index);
+
+    // request the bricks for a view position given in level 0 voxel coordinates,
+    // a brick is refined while its distance to the view is smaller than
+    // lod_scale times its extent in level 0 voxels
+    void                        request_view_dependent(const math::vec3f& view_position,
+                                                       const float        lod_scale,
+                                                       const unsigned     max_requests);
+
+    // finish the current frame: submit missing bricks to the loader, queue loaded bricks
+    // for upload while less than max_uploads bricks are pending, issue queued uploads of
+    // up to max_upload_bytes (0 for no limit) and update the page table
+    void                        update(const render_context_ptr& context,
+                                       const unsigned            max_uploads      = 32,
+                                       const scm::size_t         max_upload_bytes = 0);
+
+    static void                 add_lookup_include_string(const render_device_ptr& device);
+    // bind the atlas and page table to the texture units and set the lookup uniforms
+    void                        bind_lookup(const render_context_ptr& context,
+                                            const program_ptr&        program,
+                                            const unsigned            atlas_unit,
+                                            const unsigned            page_table_unit) const;
+
+    bool                        brick_resident(const scm::uint32 index) const;
+    scm::size_t                 resident_bricks() const;
+    scm::size_t                 missing_bricks() const;
+    scm::size_t                 pending_bricks() const;
+    scm::uint64                 frame() const;
+
+protected:
+    struct atlas_slot
+    {
+        atlas_slot() : _brick(invalid_brick), _last_used(0), _pinned(false), _pending(false) {}
+
+        scm::uint32             _brick;
+        scm::uint64             _last_used;
+        bool                    _pinned;
+        bool                    _pending;           // upload of _brick not yet issued
+        std::list<unsigned>::iterator   _lru_position;
+    }; // struct atlas_slot
+
+    struct page_table_level
+    {
+        page_table_level() : _dirty(false) {}
+
+        std::vector<scm::uint32>    _entries;
+        math::vec3ui                _dirty_begin;
+        math::vec3ui                _dirty_end;
+        bool                        _dirty;
+    }; // struct page_table_level
+
+    typedef boost::unordered_map<scm::uint32, unsigned>     brick_slot_map;
+
+    static const scm::uint32    invalid_brick = 0xffffffffu;
+
+protected:
+    void                        touch_slot(const unsigned slot);
+    bool                        allocate_slot(unsigned& slot);
+    bool                        upload_brick(const render_context_ptr&  context,
+                                             const scm::uint32          index,
+                                             const shared_array<uint8>& data,
+                                             const bool                 pinned);
+    void                        publish_brick(const scm::uint32 index,
+                                              const unsigned    slot);
+    void                        evict_slot(const unsigned slot);
+    void                        update_page_table_entries(const scm::uint32 index);
+    void                        mark_page_table_dirty(const unsigned      level,
+                                                      const math::vec3ui& begin,
+                                                      const math::vec3ui& end);
+    void                        upload_page_table(const render_context_ptr& context);
+
+    scm::uint32                 page_table_entry(const unsigned slot, const unsigned level) const;
+    math::vec3ui                slot_position(const unsigned slot) const;
+
+protected:
+    volume_brick_loader_ptr     _loader;
+
+    math::vec3ui                _atlas_slots;
+    texture_3d_ptr              _atlas_texture;
+    texture_3d_ptr              _page_table_texture;
+    sampler_state_ptr           _atlas_sampler;
+    sampler_state_ptr           _page_table_sampler;
+    // brick uploads are staged through pixel unpack buffers, direct uploads if not available
+    texture_upload_queue_ptr    _upload_queue;
+    std::vector<unsigned>       _page_table_level_offsets;
+
+    std::vector<atlas_slot>     _slots;
+    std::list<unsigned>         _lru;               // front: most recently used
+    brick_slot_map              _resident;
+    brick_slot_map              _pending;
+    std::deque<scm::uint32>     _pending_order;     // queue order of the pending uploads
+
+    std::vector<page_table_level>   _page_table;
+
+    brick_index_vector          _missing;
+    std::vector<bool>           _missing_flags;
+    scm::uint64                 _frame;
+
+}; // class volume_brick_cache
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_UTIL_VOLUME_BRICK_CACHE_H_INCLUDED
@@ -0,0 +1,319 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "volume_brick_layout.h"
+
+#include <cassert>
+#include <cstring>
+
+#include <scm/core/io/file.h>
+
+#include <scm/gl_core/log.h>
+
+namespace {
+
+const char          brick_volume_magic[8]   = {'S', 'C', 'M', 'B', 'V', 'O', 'L', '\0'};
+const scm::uint32   brick_volume_version    = 1u;
+
+// the brick data starts at a sector aligned position to allow unbuffered access
+const scm::int64    brick_volume_data_start = 4096;
+
+struct brick_volume_header
+{
+    char            _magic[8];
+    scm::uint32     _version;
+    scm::uint32     _format;
+    scm::uint32     _volume_dimensions[3];
+    scm::uint32     _brick_size;
+    scm::uint32     _brick_border;
+    scm::uint32     _level_count;
+    scm::uint64     _data_start;
+}; // struct brick_volume_header
+
+} // namespace
+
+namespace scm {
+namespace gl {
+
+volume_brick_layout::volume_brick_layout()
+  : _volume_dimensions(0u)
+  , _format(FORMAT_NULL)
+  , _brick_size(0)
+  , _brick_border(0)
+  , _brick_count(0)
+{
+}
+
+volume_brick_layout::volume_brick_layout(const math::vec3ui& volume_dimensions,
+                                         const data_format   volume_format,
+                                         const unsigned      brick_size,
+                                         const unsigned      brick_border)
+  : _volume_dimensions(volume_dimensions)
+  , _format(volume_format)
+  , _brick_size(brick_size)
+  , _brick_border(brick_border)
+  , _brick_count(0)
+{
+    generate_levels();
+}
+
+bool
+volume_brick_layout::valid() const
+{
+    return _brick_count > 0;
+}
+
+const math::vec3ui&
+volume_brick_layout::volume_dimensions() const
+{
+    return _volume_dimensions;
+}
+
+data_format
+volume_brick_layout::format() const
+{
+    return _format;
+}
+
+unsigned
+volume_brick_layout::brick_size() const
+{
+    return _brick_size;
+}
+
+unsigned
+volume_brick_layout::brick_border() const
+{
+    return _brick_border;
+}
+
+unsigned
+volume_brick_layout::brick_data_dimensions() const
+{
+    return _brick_size + 2 * _brick_border;
+}
+
+scm::size_t
+volume_brick_layout::brick_data_size() const
+{
+    const scm::size_t bdim = brick_data_dimensions();
+    return bdim * bdim * bdim * size_of_format(_format);
+}
+
+unsigned
+volume_brick_layout::level_count() const
+{
+    return static_cast<unsigned>(_level_dimensions.size());
+}
+
+const math::vec3ui&
+volume_brick_layout::level_dimensions(const unsigned level) const
+{
+    assert(level < level_count());
+    return _level_dimensions[level];
+}
+
+const math::vec3ui&
+volume_brick_layout::level_brick_grid(const unsigned level) const
+{
+    assert(level < level_count());
+    return _level_brick_grid[level];
+}
+
+scm::uint32
+volume_brick_layout::level_brick_count(const unsigned level) const
+{
+    const math::vec3ui& g = level_brick_grid(level);
+    return g.x * g.y * g.z;
+}
+
+scm::uint32
+volume_brick_layout::level_brick_index_offset(const unsigned level) const
+{
+    assert(level < level_count());
+    return _level_brick_index_offset[level];
+}
+
+scm::uint32
+volume_brick_layout::brick_count() const
+{
+    return _brick_count;
+}
+
+scm::uint32
+volume_brick_layout::brick_index(const unsigned      level,
+                                 const math::vec3ui& brick) const
+{
+    const math::vec3ui& g = level_brick_grid(level);
+
+    assert(brick.x < g.x && brick.y < g.y && brick.z < g.z);
+
+    return _level_brick_index_offset[level] + brick.x + g.x * (brick.y + g.y * brick.z);
+}
+
+void
+volume_brick_layout::brick_coordinates(const scm::uint32 index,
+                                       unsigned&         level,
+                                       math::vec3ui&     brick) const
+{
+    assert(index < _brick_count);
+
+    level = 0;
+    while (level + 1 < level_count() && index >= _level_brick_index_offset[level + 1]) {
+        ++level;
+    }
+
+    const math::vec3ui& g = _level_brick_grid[level];
+    const scm::uint32   i = index - _level_brick_index_offset[level];
+
+    brick.x = i % g.x;
+    brick.y = (i / g.x) % g.y;
+    brick.z = i / (g.x * g.y);
+}
+
+math::vec3ui
+volume_brick_layout::parent_brick(const unsigned      level,
+                                  const math::vec3ui& brick) const
+{
+    assert(level + 1 < level_count());
+
+    // the last voxel of an odd sized level is folded into the last voxel
+    // of the next level, so the brick coordinates need to be clamped
+    return math::min(brick / 2u, _level_brick_grid[level + 1] - math::vec3ui(1u));
+}
+
+io::offset_type
+volume_brick_layout::brick_data_offset(const scm::uint32 index) const
+{
+    assert(index < _brick_count);
+
+    return   brick_volume_data_start
+           + static_cast<io::offset_type>(index) * static_cast<io::offset_type>(brick_data_size());
+}
+
+io::size_type
+volume_brick_layout::file_size() const
+{
+    return   brick_volume_data_start
+           + static_cast<io::size_type>(_brick_count) * static_cast<io::size_type>(brick_data_size());
+}
+
+bool
+volume_brick_layout::read_header(io::file& in_file)
+{
+    brick_volume_header hdr;
+
+    if (in_file.read(&hdr, 0, sizeof(brick_volume_header)) != sizeof(brick_volume_header)) {
+        glerr() << log::error
+                << "volume_brick_layout::read_header(): "
+                << "unable to read brick volume header (" << in_file.file_path() << ")." << log::end;
+        return false;
+    }
+
+    if (   0 != memcmp(hdr._magic, brick_volume_magic, sizeof(brick_volume_magic))
+        || hdr._version != brick_volume_version
+        || hdr._data_start != static_cast<scm::uint64>(brick_volume_data_start)) {
+        glerr() << log::error
+                << "volume_brick_layout::read_header(): "
+                << "unsupported brick volume file (" << in_file.file_path() << ")." << log::end;
+        return false;
+    }
+
+    *this = volume_brick_layout(math::vec3ui(hdr._volume_dimensions[0],
+                                             hdr._volume_dimensions[1],
+                                             hdr._volume_dimensions[2]),
+                                static_cast<data_format>(hdr._format),
+                                hdr._brick_size,
+                                hdr._brick_border);
+
+    if (!valid() || hdr._level_count != level_count()) {
+        glerr() << log::error
+                << "volume_brick_layout::read_header(): "
+                << "invalid brick volume layout (" << in_file.file_path() << ")." << log::end;
+        *this = volume_brick_layout();
+        return false;
+    }
+
+    if (in_file.size() < file_size()) {
+        glerr() << log::error
+                << "volume_brick_layout::read_header(): "
+                << "file size does not match brick volume layout"
+                << " (file_size: " << in_file.size()
+                << ", expected size: " << file_size() << ")." << log::end;
+        *this = volume_brick_layout();
+        return false;
+    }
+
+    return true;
+}
+
+bool
+volume_brick_layout::write_header(io::file& out_file) const
+{
+    if (!valid()) {
+        return false;
+    }
+
+    brick_volume_header hdr;
+
+    memset(&hdr, 0, sizeof(brick_volume_header));
+    memcpy(hdr._magic, brick_volume_magic, sizeof(brick_volume_magic));
+    hdr._version                = brick_volume_version;
+    hdr._format                 = _format;
+    hdr._volume_dimensions[0]   = _volume_dimensions.x;
+    hdr._volume_dimensions[1]   = _volume_dimensions.y;
+    hdr._volume_dimensions[2]   = _volume_dimensions.z;
+    hdr._brick_size             = _brick_size;
+    hdr._brick_border           = _brick_border;
+    hdr._level_count            = level_count();
+    hdr._data_start             = brick_volume_data_start;
+
+    if (out_file.write(&hdr, 0, sizeof(brick_volume_header)) != sizeof(brick_volume_header)) {
+        glerr() << log::error
+                << "volume_brick_layout::write_header(): "
+                << "unable to write brick volume header (" << out_file.file_path() << ")." << log::end;
+        return false;
+    }
+
+    return true;
+}
+
+void
+volume_brick_layout::generate_levels()
+{
+    using namespace scm::math;
+
+    _level_dimensions.clear();
+    _level_brick_grid.clear();
+    _level_brick_index_offset.clear();
+    _brick_count = 0;
+
+    // the brick size has to be even for the parent brick computation to work out
+    if (   _volume_dimensions.x == 0 || _volume_dimensions.y == 0 || _volume_dimensions.z == 0
+        || _format == FORMAT_NULL
+        || _brick_size < 2 || (_brick_size & 1)
+        || _brick_border >= _brick_size) {
+        return;
+    }
+
+    vec3ui ldim = _volume_dimensions;
+
+    for (;;) {
+        const vec3ui lgrid = (ldim + vec3ui(_brick_size - 1)) / _brick_size;
+
+        _level_dimensions.push_back(ldim);
+        _level_brick_grid.push_back(lgrid);
+        _level_brick_index_offset.push_back(_brick_count);
+        _brick_count += lgrid.x * lgrid.y * lgrid.z;
+
+        if (lgrid == vec3ui(1u)) {
+            break;
+        }
+
+        ldim = max(vec3ui(1u), ldim / 2u);
+    }
+}
+
+} // namespace gl
+} // namespace scm
@@ -0,0 +1,90 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_VOLUME_BRICK_LAYOUT_H_INCLUDED
+#define SCM_GL_UTIL_VOLUME_BRICK_LAYOUT_H_INCLUDED
+
+#include <vector>
+
+#include <scm/core/math.h>
+#include <scm/core/numeric_types.h>
+#include <scm/core/io/io_fwd.h>
+
+#include <scm/gl_core/data_formats.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// layout of a bricked multi-resolution volume file
+//  - level 0 is the source volume, each following level halves the dimensions
+//    of the previous level (floor, at least 1) until a single brick covers the level
+//  - every level is split into bricks of brick_size^3 voxels, each brick is stored with
+//    brick_border voxels of its neighbors on every side (edge voxels are replicated at
+//    the volume boundary) to allow seamless filtering across brick boundaries
+//  - bricks are stored level by level, inside a level in x, y, z order
+//  - the voxels of a brick are stored x fastest, z slowest
+class __scm_export(gl_util) volume_brick_layout
+{
+public:
+    volume_brick_layout();
+    volume_brick_layout(const math::vec3ui& volume_dimensions,
+                        const data_format   volume_format,
+                        const unsigned      brick_size,
+                        const unsigned      brick_border);
+
+    bool                    valid() const;
+
+    const math::vec3ui&     volume_dimensions() const;
+    data_format             format() const;
+    unsigned                brick_size() const;
+    unsigned                brick_border() const;
+    unsigned                brick_data_dimensions() const;
+    scm::size_t             brick_data_size() const;
+
+    unsigned                level_count() const;
+    const math::vec3ui&     level_dimensions(const unsigned level) const;
+    const math::vec3ui&     level_brick_grid(const unsigned level) const;
+    scm::uint32             level_brick_count(const unsigned level) const;
+    scm::uint32             level_brick_index_offset(const unsigned level) const;
+    scm::uint32             brick_count() const;
+
+    scm::uint32             brick_index(const unsigned      level,
+                                        const math::vec3ui& brick) const;
+    void                    brick_coordinates(const scm::uint32 index,
+                                              unsigned&         level,
+                                              math::vec3ui&     brick) const;
+    math::vec3ui            parent_brick(const unsigned      level,
+                                         const math::vec3ui& brick) const;
+
+    io::offset_type         brick_data_offset(const scm::uint32 index) const;
+    io::size_type           file_size() const;
+
+    bool                    read_header(io::file& in_file);
+    bool                    write_header(io::file& out_file) const;
+
+protected:
+    void                    generate_levels();
+
+protected:
+    math::vec3ui                _volume_dimensions;
+    data_format                 _format;
+    unsigned                    _brick_size;
+    unsigned                    _brick_border;
+
+    std::vector<math::vec3ui>   _level_dimensions;
+    std::vector<math::vec3ui>   _level_brick_grid;
+    std::vector<scm::uint32>    _level_brick_index_offset;
+    scm::uint32                 _brick_count;
+
+}; // class volume_brick_layout
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_UTIL_VOLUME_BRICK_LAYOUT_H_INCLUDED
@@ -0,0 +1,208 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "volume_brick_loader.h"
+
+#include <algorithm>
+
+#include <boost/bind.hpp>
+
+#include <scm/core/io/file.h>
+
+#include <scm/gl_core/log.h>
+
+namespace scm {
+namespace gl {
+
+volume_brick_loader::volume_brick_loader(const std::string& file_path,
+                                               bool         file_unbuffered,
+                                               unsigned     max_loaded_bricks,
+                                               unsigned     bricks_per_read)
+  : _max_loaded_bricks(math::max(1u, max_loaded_bricks))
+  , _bricks_per_read(math::max(1u, bricks_per_read))
+  , _running(true)
+{
+    _file = make_shared<io::file>();
+
+    if (!_file->open(file_path, std::ios_base::in, file_unbuffered)) {
+        _file.reset();
+        glerr() << log::error
+                << "volume_brick_loader::volume_brick_loader(): "
+                << "error opening brick volume file (" << file_path << ")." << log::end;
+        return;
+    }
+
+    if (!_layout.read_header(*_file)) {
+        _file.reset();
+        glerr() << log::error
+                << "volume_brick_loader::volume_brick_loader(): "
+                << "error reading brick volume header (" << file_path << ")." << log::end;
+        return;
+    }
+
+    _thread = boost::thread(boost::bind(&volume_brick_loader::run, this));
+}
+
+volume_brick_loader::~volume_brick_loader()
+{
+    {
+        boost::mutex::scoped_lock   lock(_mutex);
+        _running = false;
+    }
+    _request_condition.notify_all();
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+
+    if (_file) {
+        _file->close();
+        _file.reset();
+    }
+}
+
+volume_brick_loader::operator bool() const
+{
+    return _file.get() != 0;
+}
+
+bool
+volume_brick_loader::operator! () const
+{
+    return _file.get() == 0;
+}
+
+const volume_brick_layout&
+volume_brick_loader::layout() const
+{
+    return _layout;
+}
+
+void
+volume_brick_loader::update_requests(const brick_index_vector& requests)
+{
+    {
+        boost::mutex::scoped_lock   lock(_mutex);
+
+        _requests.clear();
+        for (brick_index_vector::const_iterator r = requests.begin(); r != requests.end(); ++r) {
+            if (   *r < _layout.brick_count()
+                && _in_flight.find(*r) == _in_flight.end()) {
+                _requests.push_back(*r);
+            }
+        }
+    }
+    _request_condition.notify_one();
+}
+
+void
+volume_brick_loader::cancel_requests()
+{
+    boost::mutex::scoped_lock   lock(_mutex);
+    _requests.clear();
+}
+
+scm::size_t
+volume_brick_loader::fetch_loaded_bricks(loaded_brick_vector& out_bricks,
+                                         scm::size_t          max_bricks)
+{
+    scm::size_t fetch_count = 0;
+    {
+        boost::mutex::scoped_lock   lock(_mutex);
+
+        fetch_count = math::min(max_bricks, _loaded.size());
+
+        for (scm::size_t i = 0; i < fetch_count; ++i) {
+            _in_flight.erase(_loaded[i]._index);
+            out_bricks.push_back(_loaded[i]);
+        }
+        _loaded.erase(_loaded.begin(), _loaded.begin() + fetch_count);
+    }
+
+    if (fetch_count > 0) {
+        _request_condition.notify_one();
+    }
+
+    return fetch_count;
+}
+
+scm::size_t
+volume_brick_loader::pending_requests() const
+{
+    boost::mutex::scoped_lock   lock(_mutex);
+    return _requests.size();
+}
+
+void
+volume_brick_loader::run()
+{
+    const scm::size_t       bdata_size = _layout.brick_data_size();
+    io::file_span_vector    read_spans;
+    loaded_brick_vector     read_bricks;
+
+    read_spans.reserve(_bricks_per_read);
+    read_bricks.reserve(_bricks_per_read);
+
+    for (;;) {
+        { // wait for requests while the number of loaded but not yet fetched bricks allows it
+            boost::mutex::scoped_lock   lock(_mutex);
+
+            while (   _running
+                   && (_requests.empty() || _in_flight.size() >= _max_loaded_bricks)) {
+                _request_condition.wait(lock);
+            }
+
+            if (!_running) {
+                return;
+            }
+
+            while (   !_requests.empty()
+                   && read_bricks.size() < _bricks_per_read
+                   && _in_flight.size() < _max_loaded_bricks) {
+                loaded_brick    b;
+                b._index = _requests.front();
+                _requests.pop_front();
+
+                _in_flight.insert(b._index);
+                read_bricks.push_back(b);
+            }
+        }
+
+        // read all bricks of the batch in one vectored request, bricks adjacent in the
+        // file are coalesced into a single read operation
+        io::file::size_type read_size = 0;
+        for (loaded_brick_vector::iterator b = read_bricks.begin(); b != read_bricks.end(); ++b) {
+            b->_data.reset(new uint8[bdata_size]);
+            read_spans.push_back(io::file_span(_layout.brick_data_offset(b->_index), bdata_size, b->_data.get()));
+            read_size += bdata_size;
+        }
+
+        const bool read_success = (_file->read(read_spans, 0) == read_size);
+
+        {
+            boost::mutex::scoped_lock   lock(_mutex);
+
+            if (read_success) {
+                _loaded.insert(_loaded.end(), read_bricks.begin(), read_bricks.end());
+            }
+            else {
+                for (loaded_brick_vector::const_iterator b = read_bricks.begin(); b != read_bricks.end(); ++b) {
+                    _in_flight.erase(b->_index);
+                }
+            }
+        }
+
+        if (!read_success) {
+            glerr() << log::error
+                    << "volume_brick_loader::run(): "
+                    << "error reading bricks from file (" << _file->file_path() << ")." << log::end;
+        }
+
+        read_spans.clear();
+        read_bricks.clear();
+    }
+}
+
+} // namespace gl
+} // namespace scm
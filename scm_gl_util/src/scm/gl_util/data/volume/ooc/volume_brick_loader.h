@@ -0,0 +1,95 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_VOLUME_BRICK_LOADER_H_INCLUDED
+#define SCM_GL_UTIL_VOLUME_BRICK_LOADER_H_INCLUDED
+
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <scm/core/memory.h>
+#include <scm/core/numeric_types.h>
+#include <scm/core/io/io_fwd.h>
+
+#include <scm/gl_util/data/volume/ooc/volume_brick_layout.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// background thread reading bricks of a bricked volume file
+//  - the renderer hands over the list of missing bricks each frame, replacing the
+//    still pending requests of previous frames (requests are served in list order)
+//  - loaded bricks are collected by the renderer thread for upload
+class __scm_export(gl_util) volume_brick_loader : boost::noncopyable
+{
+public:
+    struct loaded_brick
+    {
+        scm::uint32             _index;
+        shared_array<uint8>     _data;
+    }; // struct loaded_brick
+
+    typedef std::vector<scm::uint32>    brick_index_vector;
+    typedef std::vector<loaded_brick>   loaded_brick_vector;
+
+public:
+    volume_brick_loader(const std::string& file_path,
+                              bool         file_unbuffered   = false,
+                              unsigned     max_loaded_bricks = 64,
+                              unsigned     bricks_per_read   = 8);
+    virtual ~volume_brick_loader();
+
+                                operator bool() const;
+    bool                        operator! () const;
+
+    const volume_brick_layout&  layout() const;
+
+    // replace the pending requests, bricks already loading or loaded are skipped
+    void                        update_requests(const brick_index_vector& requests);
+    void                        cancel_requests();
+
+    // move up to max_bricks loaded bricks into out_bricks, never blocks
+    scm::size_t                 fetch_loaded_bricks(loaded_brick_vector& out_bricks,
+                                                    scm::size_t          max_bricks);
+
+    scm::size_t                 pending_requests() const;
+
+protected:
+    void                        run();
+
+protected:
+    volume_brick_layout         _layout;
+    io::file_ptr                _file;
+
+    unsigned                    _max_loaded_bricks;
+    unsigned                    _bricks_per_read;
+
+    mutable boost::mutex        _mutex;
+    boost::condition_variable   _request_condition;
+    bool                        _running;
+
+    std::deque<scm::uint32>     _requests;
+    std::set<scm::uint32>       _in_flight;
+    loaded_brick_vector         _loaded;
+
+    boost::thread               _thread;
+
+}; // class volume_brick_loader
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_UTIL_VOLUME_BRICK_LOADER_H_INCLUDED
@@ -0,0 +1,172 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "volume_reader_bricked.h"
+
+#include <scm/core/io/file.h>
+
+#include <scm/gl_core/log.h>
+
+namespace {
+
+// upper bound for the number of brick lines submitted by a single vectored read
+const scm::size_t max_read_spans_per_batch = 65536;
+
+} // namespace
+
+namespace scm {
+namespace gl {
+
+bool
+volume_reader_bricked::read_level_region(io::file&                  in_file,
+                                         const volume_brick_layout& layout,
+                                         const unsigned             level,
+                                         const scm::math::vec3ui&   o,
+                                         const scm::math::vec3ui&   s,
+                                               void*                d)
+{
+    using namespace scm::math;
+
+    if (!layout.valid() || level >= layout.level_count()) {
+        return false;
+    }
+
+    const vec3ui&       ldim = layout.level_dimensions(level);
+
+    if (   o.x >= ldim.x
+        || o.y >= ldim.y
+        || o.z >= ldim.z) {
+        return true;
+    }
+
+    const int64         data_value_size = static_cast<int64>(size_of_format(layout.format()));
+    const int64         bborder         = layout.brick_border();
+    const int64         bdim            = layout.brick_data_dimensions();
+    const vec3ui        read_end        = min(o + s, ldim);
+    const vec3ui        brick_begin     = o / layout.brick_size();
+    const vec3ui        brick_end       = (read_end - vec3ui(1u)) / layout.brick_size() + vec3ui(1u);
+
+    io::file_span_vector    read_spans;
+    io::file::size_type     read_spans_size = 0;
+
+    // read the lines of all bricks intersecting the region, the lines of neighboring
+    // bricks are coalesced into larger requests by the file
+    for (unsigned bz = brick_begin.z; bz < brick_end.z; ++bz) {
+        for (unsigned by = brick_begin.y; by < brick_end.y; ++by) {
+            for (unsigned bx = brick_begin.x; bx < brick_end.x; ++bx) {
+                const vec3ui            b(bx, by, bz);
+                const vec3ui            bo = b * layout.brick_size();
+                const vec3ui            rb = max(o, bo);
+                const vec3ui            re = min(read_end, bo + vec3ui(layout.brick_size()));
+                const io::offset_type   bstart = layout.brick_data_offset(layout.brick_index(level, b));
+                const int64             line_size = data_value_size * (re.x - rb.x);
+
+                for (unsigned z = rb.z; z < re.z; ++z) {
+                    for (unsigned y = rb.y; y < re.y; ++y) {
+                        int64 offset_src =  (bborder + rb.x - bo.x)
+                                          + bdim * (bborder + y - bo.y)
+                                          + bdim * bdim * (bborder + z - bo.z);
+                        offset_src *= data_value_size;
+
+                        int64 offset_dst =  static_cast<int64>(rb.x - o.x)
+                                          + static_cast<int64>(s.x) * (y - o.y)
+                                          + static_cast<int64>(s.x) * s.y * (z - o.z);
+                        offset_dst *= data_value_size;
+
+                        read_spans.push_back(io::file_span(bstart + offset_src, line_size, reinterpret_cast<char*>(d) + offset_dst));
+                        read_spans_size += line_size;
+
+                        if (read_spans.size() >= max_read_spans_per_batch) {
+                            if (in_file.read(read_spans) != read_spans_size) {
+                                return false;
+                            }
+                            read_spans.clear();
+                            read_spans_size = 0;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (!read_spans.empty()) {
+        if (in_file.read(read_spans) != read_spans_size) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+volume_reader_bricked::volume_reader_bricked(const std::string& file_path,
+                                                   unsigned     level,
+                                                   bool         file_unbuffered)
+  : volume_reader(file_path, file_unbuffered)
+  , _level(level)
+{
+    _file = make_shared<io::file>();
+
+    if (!_file->open(file_path, std::ios_base::in, file_unbuffered)) {
+        _file.reset();
+        glerr() << scm::log::error
+                << "volume_reader_bricked::volume_reader_bricked(): "
+                << "error opening volume file (" << file_path << ")." << scm::log::end;
+        return;
+    }
+
+    if (!_layout.read_header(*_file)) {
+        _file.reset();
+        glerr() << scm::log::error
+                << "volume_reader_bricked::volume_reader_bricked(): "
+                << "error reading brick volume header (" << file_path << ")." << scm::log::end;
+        return;
+    }
+
+    if (_level >= _layout.level_count()) {
+        _file.reset();
+        glerr() << scm::log::error
+                << "volume_reader_bricked::volume_reader_bricked(): "
+                << "requested level not available in brick volume"
+                << " (level: " << _level << ", level count: " << _layout.level_count() << ")." << scm::log::end;
+        return;
+    }
+
+    _dimensions = _layout.level_dimensions(_level);
+    _format     = _layout.format();
+}
+
+volume_reader_bricked::~volume_reader_bricked()
+{
+    if (_file) {
+        _file->close();
+        _file.reset();
+    }
+}
+
+bool
+volume_reader_bricked::read(const scm::math::vec3ui& o,
+                            const scm::math::vec3ui& s,
+                                  void*              d)
+{
+    if (!(*this)) {
+        return false;
+    }
+
+    return read_level_region(*_file, _layout, _level, o, s, d);
+}
+
+const volume_brick_layout&
+volume_reader_bricked::layout() const
+{
+    return _layout;
+}
+
+unsigned
+volume_reader_bricked::level() const
+{
+    return _level;
+}
+
+} // namespace gl
+} // namespace scm
@@ -0,0 +1,52 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_VOLUME_READER_BRICKED_H_INCLUDED
+#define SCM_GL_UTIL_VOLUME_READER_BRICKED_H_INCLUDED
+
+#include <scm/gl_util/data/volume/volume_reader.h>
+#include <scm/gl_util/data/volume/ooc/volume_brick_layout.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// reads sub-volumes of a single resolution level of a bricked volume file
+class __scm_export(gl_util) volume_reader_bricked : public volume_reader
+{
+public:
+    static bool                 read_level_region(io::file&                  in_file,
+                                                  const volume_brick_layout& layout,
+                                                  const unsigned             level,
+                                                  const scm::math::vec3ui&   o,
+                                                  const scm::math::vec3ui&   s,
+                                                        void*                d);
+
+public:
+    volume_reader_bricked(const std::string& file_path,
+                                unsigned     level           = 0,
+                                bool         file_unbuffered = false);
+    virtual ~volume_reader_bricked();
+
+    bool                        read(const scm::math::vec3ui& o,
+                                     const scm::math::vec3ui& s,
+                                           void*              d);
+
+    const volume_brick_layout&  layout() const;
+    unsigned                    level() const;
+
+protected:
+    volume_brick_layout         _layout;
+    unsigned                    _level;
+
+}; // struct volume_reader_bricked
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_UTIL_VOLUME_READER_BRICKED_H_INCLUDED
@@ -99,102 +99,6 @@ swap_segy_binary_header(scm::gl::data::segy_binary_header& h)
     swap_bytes(&h._num_ext_headers);
 }
 
-void
-swap_segy_trace_header(scm::gl::data::segy_trace_header& h)
-{
-    using scm::swap_bytes;
-
-    swap_bytes(&h._line_sequence_num);
-    swap_bytes(&h._file_sequence_num);
-    swap_bytes(&h._field_rec_num);
-    swap_bytes(&h._trace_num_orig);
-    swap_bytes(&h._src_point_num);
-    swap_bytes(&h._ensemble_num);
-    swap_bytes(&h._traces_per_ensemble);
-    swap_bytes(&h._trace_id);
-    swap_bytes(&h._num_ver_summed_traces);
-    swap_bytes(&h._num_hor_stacked_traces);
-    swap_bytes(&h._data_use);
-    swap_bytes(&h._dist_src_grp);
-    swap_bytes(&h._grp_elev);
-    swap_bytes(&h._src_elev);
-    swap_bytes(&h._src_depth);
-    swap_bytes(&h._grp_datum);
-    swap_bytes(&h._src_datum);
-    swap_bytes(&h._src_water_depth);
-    swap_bytes(&h._grp_water_depth);
-    swap_bytes(&h._elev_scalar);
-    swap_bytes(&h._coord_scalar);
-    swap_bytes(&h._src_coord_x);
-    swap_bytes(&h._src_coord_y);
-    swap_bytes(&h._grp_coord_x);
-    swap_bytes(&h._grp_coord_y);
-    swap_bytes(&h._coord_units);
-    swap_bytes(&h._weathering_vel);
-    swap_bytes(&h._subweathering_vel);
-    swap_bytes(&h._src_uphole_time);
-    swap_bytes(&h._grp_uphole_time);
-    swap_bytes(&h._src_static_cor);
-    swap_bytes(&h._grp_static_cor);
-    swap_bytes(&h._total_static);
-    swap_bytes(&h._lag_time_a);
-    swap_bytes(&h._lag_time_b);
-    swap_bytes(&h._delay_rec_time);
-    swap_bytes(&h._mute_time_beg);
-    swap_bytes(&h._mute_time_end);
-    swap_bytes(&h._num_samples);
-    swap_bytes(&h._sample_interval);
-    swap_bytes(&h._gain_type);
-    swap_bytes(&h._instrument_gain_const);
-    swap_bytes(&h._instrument_gain_initial);
-    swap_bytes(&h._correlated);
-    swap_bytes(&h._sweep_freq_beg);
-    swap_bytes(&h._sweep_freq_end);
-    swap_bytes(&h._sweep_length);
-    swap_bytes(&h._sweep_type);
-    swap_bytes(&h._sweep_taper_beg);
-    swap_bytes(&h._sweep_taper_end);
-    swap_bytes(&h._taper_type);
-    swap_bytes(&h._alias_filter_freq);
-    swap_bytes(&h._alias_filter_slope);
-    swap_bytes(&h._notch_filter_freq);
-    swap_bytes(&h._notch_filter_slope);
-    swap_bytes(&h._lo_cut_freq);
-    swap_bytes(&h._hi_cut_freq);
-    swap_bytes(&h._lo_cut_slope);
-    swap_bytes(&h._hi_cut_slope);
-    swap_bytes(&h._year);
-    swap_bytes(&h._day);
-    swap_bytes(&h._hour);
-    swap_bytes(&h._min);
-    swap_bytes(&h._sec);
-    swap_bytes(&h._time_basis_code);
-    swap_bytes(&h._weight_factor);
-    swap_bytes(&h._geophone_grp_num_switch_1);
-    swap_bytes(&h._geophone_grp_num_trace_1);
-    swap_bytes(&h._geophone_grp_num_trace_n);
-    swap_bytes(&h._gap_size);
-    swap_bytes(&h._over_travel);
-    swap_bytes(&h._ensemble_cdp_x);
-    swap_bytes(&h._ensemble_cdp_y);
-    swap_bytes(&h._poststack_inline_num);
-    swap_bytes(&h._poststack_crline_num);
-    swap_bytes(&h._shotpnt_num);
-    swap_bytes(&h._shotpnt_scalar);
-    swap_bytes(&h._trace_measurement_unit);
-    swap_bytes(&h._transduction_const_mant);
-    swap_bytes(&h._transduction_const_exp);
-    swap_bytes(&h._transduction_units);
-    swap_bytes(&h._device_id);
-    swap_bytes(&h._time_scalar);
-    swap_bytes(&h._src_type_orient);
-    swap_bytes(&h._src_energy_dir0);
-    swap_bytes(&h._src_energy_dir);
-    swap_bytes(&h._src_measurement_mant);
-    swap_bytes(&h._src_measurement_exp);
-    swap_bytes(&h._src_measurement_units);
-}
-
 }
 
 namespace scm {
@@ -212,7 +116,9 @@ segy_trace::~segy_trace()
     _header.reset();
 }
 
-segy_data::segy_data(const io::file_ptr& segy_file)
+segy_data::segy_data(const io::file_ptr&                   segy_file,
+                           segy_trace_index::gap_fill_mode  gap_fill,
+                           bool                             use_index_sidecar)
   : _swap_bytes_required(false)
   , _is_ebcdic(false)
   , _volume_size(math::vec3ui(0u))
@@ -224,7 +130,7 @@ segy_data::segy_data(const io::file_ptr& segy_file)
     using namespace scm::math;
 
     if (   !segy_file
-        && !segy_file->is_open()) {
+        || !segy_file->is_open()) {
         throw std::runtime_error("segy_data::segy_data(): invalid file pointer passed.");
     }
 
@@ -299,89 +205,32 @@ segy_data::segy_data(const io::file_ptr& segy_file)
     }
 
     segy_format     trace_fmt  = to_segy_format(_binary_header->_data_format);
-    scm::size_t     trace_size = static_cast<scm::size_t>(_binary_header->_samples_per_trace) * size_of_format(trace_fmt) + sizeof(segy_trace_header);
-    scm::size_t     num_traces = (segy_file->size() - traces_start_offset) / trace_size;
-    vec3ui          vdim       = vec3ui(0u);
-
-    { // read/parse traces
-        io::offset_type next_trace_offset = traces_start_offset;
-
-        segy_format     trace_fmt  = to_segy_format(_binary_header->_data_format);
-        scm::size_t     trace_size = static_cast<scm::size_t>(_binary_header->_samples_per_trace) * size_of_format(trace_fmt) + sizeof(segy_trace_header);
-        scm::size_t     num_traces = (segy_file->size() - traces_start_offset) / trace_size;
-
-        vdim.x = _binary_header->_samples_per_trace;
-        vdim.y = max<int16>(1, _binary_header->_traces_per_ensemble);
-        vdim.z = static_cast<uint32>(num_traces / vdim.y);
-
-        scm::size_t     exp_fsize = trace_size * static_cast<scm::size_t>(vdim.y) * vdim.z + traces_start_offset;
-
-        if (vdim.y <= 1 || exp_fsize != segy_file->size()) {
-            segy_trace trace_00;
-            segy_trace trace_01;
-            if (   segy_file->read(trace_00._header.get(), next_trace_offset,              sizeof(segy_trace_header)) != sizeof(segy_trace_header)
-                || segy_file->read(trace_01._header.get(), next_trace_offset + trace_size, sizeof(segy_trace_header)) != sizeof(segy_trace_header)) {
-                throw std::runtime_error("segy_data::segy_data(): error reading segy first trace headers.");
-            }
-            if (_swap_bytes_required) {
-                swap_segy_trace_header(*trace_00._header);
-                swap_segy_trace_header(*trace_01._header);
-            }
-
-            bool use_crline_num      = trace_00._header->_poststack_crline_num != trace_01._header->_poststack_crline_num;
-            bool use_censemble_cdp_x = trace_00._header->_ensemble_cdp_x != trace_01._header->_ensemble_cdp_x;
-
-            vdim               = vec3ui(0u);
-            vdim.x             = trace_00._header->_num_samples;
-            int32 trace_00_ens;
-            int32 trace_n_ens;
-
-            if (use_crline_num) {
-                trace_00_ens = trace_00._header->_poststack_crline_num;
-                trace_n_ens  = 0;
-            }
-            else if (use_censemble_cdp_x) {
-                trace_00_ens = trace_00._header->_ensemble_cdp_x;
-            }
-            else {
-                throw std::runtime_error("segy_data::segy_data(): no way to know the volume dimensions here... stupid f***ing SEGY.");
-            }
-
-            next_trace_offset += trace_size;
+    scm::size_t     trace_size = static_cast<scm::size_t>(static_cast<uint16>(_binary_header->_samples_per_trace)) * size_of_format(trace_fmt) + sizeof(segy_trace_header);
 
-            bool still_match = true;
-
-            do {
-                segy_trace trace_n;
-                if (segy_file->read(trace_n._header.get(), next_trace_offset, sizeof(segy_trace_header)) != sizeof(segy_trace_header)) {
-                    throw std::runtime_error("segy_data::segy_data(): error reading segy trace header.");
-                }
-                if (_swap_bytes_required) {
-                    swap_segy_trace_header(*trace_n._header);
-                }
-                vdim.y            += 1;
-                next_trace_offset += trace_size;
-
-                if (use_crline_num) {
-                    trace_n_ens = trace_n._header->_poststack_crline_num;
-                }
-                else if (use_censemble_cdp_x) {
-                    trace_n_ens = trace_n._header->_ensemble_cdp_x;
-                }
-                exp_fsize   = trace_size * static_cast<scm::size_t>(vdim.y + 1) + traces_start_offset;
-
-                still_match = trace_00_ens != trace_n_ens;
-            } while (still_match && static_cast<io::size_type>(exp_fsize) <= segy_file->size());
-
-            vdim.z = static_cast<uint32>(num_traces / vdim.y);
-            exp_fsize = trace_size * static_cast<scm::size_t>(vdim.y) * vdim.z + traces_start_offset;
+    if (trace_fmt == SEGY_FORMAT_NULL) {
+        throw std::runtime_error("segy_data::segy_data(): unsupported segy sample format.");
+    }
 
-            if (exp_fsize != segy_file->size()) {
-                throw std::runtime_error("segy_data::segy_data(): something fishy here, the file size does not check out with the determined volume dimensions.");
-            }
+    { // build or load the (inline, crossline) trace index
+        segy_trace_index::scan_desc desc;
+        desc._traces_start          = traces_start_offset;
+        desc._samples_per_trace     = static_cast<uint16>(_binary_header->_samples_per_trace);
+        desc._sample_size           = size_of_format(trace_fmt);
+        desc._traces_per_ensemble   = static_cast<unsigned>(max<int16>(0, _binary_header->_traces_per_ensemble));
+        desc._fixed_length_traces   =    _binary_header->_revision >= 0x0100  // field undefined before rev. 1
+                                      && _binary_header->_fixed_length_flag == 1;
+        desc._swap_bytes            = _swap_bytes_required;
+
+        _trace_index.reset(new segy_trace_index());
+        if (!_trace_index->open(segy_file, desc, gap_fill, use_index_sidecar)) {
+            throw std::runtime_error("segy_data::segy_data(): error building segy trace index.");
         }
     }
 
+    vec3ui          vdim       = vec3ui(_trace_index->max_samples(),
+                                        _trace_index->crossline_count(),
+                                        _trace_index->inline_count());
+
     _traces_start  = traces_start_offset;
     _trace_format  = trace_fmt;
     _trace_size    = trace_size;
@@ -392,6 +241,7 @@ segy_data::segy_data(const io::file_ptr& segy_file)
 
 segy_data::~segy_data()
 {
+    _trace_index.reset();
     _extended_text_headers.clear();
     _binary_header.reset();
     _text_header.reset();
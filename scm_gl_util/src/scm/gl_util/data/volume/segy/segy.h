@@ -14,6 +14,9 @@
 
 #include <scm/gl_core/data_formats.h>
 
+#include <scm/gl_util/data/volume/segy/segy_fwd.h>
+#include <scm/gl_util/data/volume/segy/segy_trace_index.h>
+
 namespace scm {
 namespace gl {
 namespace data {
@@ -198,12 +201,18 @@ struct segy_data
 
     io::offset_type             _traces_start;
     segy_format                 _trace_format;
-    scm::size_t                 _trace_size;
+    scm::size_t                 _trace_size;        // nominal size of a trace including its header
+
+    // (inline, crossline) -> trace location, the volume y and z dimensions are the
+    // crossline and inline bins, x is the maximum trace length
+    segy_trace_index_ptr        _trace_index;
 
     bool                        _swap_bytes_required;
     bool                        _is_ebcdic;
 
-    segy_data(const io::file_ptr& segy_file);
+    segy_data(const io::file_ptr&              segy_file,
+              segy_trace_index::gap_fill_mode  gap_fill          = segy_trace_index::GAP_FILL_NEAREST,
+              bool                             use_index_sidecar = true);
     ~segy_data();
 
     int                         size_of_format(segy_format d) const;
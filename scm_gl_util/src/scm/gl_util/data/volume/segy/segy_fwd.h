@@ -5,11 +5,17 @@
 #ifndef SCM_GL_UTIL_SEGY_FWD_H_INCLUDED
 #define SCM_GL_UTIL_SEGY_FWD_H_INCLUDED
 
+#include <scm/core/memory.h>
+
 namespace scm {
 namespace gl {
 namespace data {
 
 struct segy_data;
+class  segy_trace_index;
+
+typedef shared_ptr<segy_trace_index>        segy_trace_index_ptr;
+typedef shared_ptr<segy_trace_index const>  segy_trace_index_cptr;
 
 } // namespace data
 } // namespace gl
@@ -0,0 +1,191 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "segy_ibm_float.h"
+
+#include <cstring>
+
+#if SCM_COMPILER == SCM_COMPILER_MSVC
+#   include <intrin.h>
+#elif SCM_COMPILER == SCM_COMPILER_GNUC
+#   if defined(__i386__) || defined(__x86_64__)
+#       include <cpuid.h>
+#   endif
+#endif
+
+namespace {
+
+struct cpu_features
+{
+    cpu_features() : _sse41(false), _avx2(false) {
+        detect();
+    }
+
+    void detect() {
+        unsigned r1[4] = { 0, 0, 0, 0 }; // eax, ebx, ecx, edx
+        unsigned r7[4] = { 0, 0, 0, 0 };
+
+        if (cpuid(0, r1) < 1) {
+            return;
+        }
+        const unsigned max_leaf = r1[0];
+
+        cpuid(1, r1);
+        const bool ssse3   = (r1[2] & (1u <<  9)) != 0;
+        const bool sse41   = (r1[2] & (1u << 19)) != 0;
+        const bool osxsave = (r1[2] & (1u << 27)) != 0;
+        const bool avx     = (r1[2] & (1u << 28)) != 0;
+
+        _sse41 = ssse3 && sse41;
+
+        if (max_leaf >= 7 && osxsave && avx) {
+            cpuid(7, r7);
+            const bool avx2  = (r7[1] & (1u << 5)) != 0;
+            const bool ymm_os = (xgetbv0() & 0x06) == 0x06; // os saves xmm and ymm state
+
+            _avx2 = _sse41 && avx2 && ymm_os;
+        }
+    }
+
+    static unsigned cpuid(unsigned leaf, unsigned* r) {
+#if SCM_COMPILER == SCM_COMPILER_MSVC
+        int regs[4];
+        __cpuidex(regs, static_cast<int>(leaf), 0);
+        for (int i = 0; i < 4; ++i) {
+            r[i] = static_cast<unsigned>(regs[i]);
+        }
+        return 1;
+#elif SCM_COMPILER == SCM_COMPILER_GNUC && (defined(__i386__) || defined(__x86_64__))
+        if (leaf > __get_cpuid_max(0, 0)) {
+            return 0;
+        }
+        __cpuid_count(leaf, 0, r[0], r[1], r[2], r[3]);
+        return 1;
+#else
+        return 0;
+#endif
+    }
+
+    static unsigned xgetbv0() {
+#if SCM_COMPILER == SCM_COMPILER_MSVC && SCM_COMPILER_VER >= 1600
+        return static_cast<unsigned>(_xgetbv(0));
+#elif SCM_COMPILER == SCM_COMPILER_GNUC && (defined(__i386__) || defined(__x86_64__))
+        unsigned eax = 0;
+        unsigned edx = 0;
+        __asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0" : "=a" (eax), "=d" (edx) : "c" (0)); // xgetbv
+        return eax;
+#else
+        return 0;
+#endif
+    }
+
+    bool    _sse41;
+    bool    _avx2;
+}; // struct cpu_features
+
+const cpu_features&
+host_cpu_features()
+{
+    static cpu_features features;
+    return features;
+}
+
+scm::gl::data::ibm_float_kernel
+select_kernel()
+{
+    using namespace scm::gl::data;
+
+    if (ibm_float_kernel_supported(IBM_FLOAT_KERNEL_AVX2)) {
+        return IBM_FLOAT_KERNEL_AVX2;
+    }
+    else if (ibm_float_kernel_supported(IBM_FLOAT_KERNEL_SSE4)) {
+        return IBM_FLOAT_KERNEL_SSE4;
+    }
+    else {
+        return IBM_FLOAT_KERNEL_SCALAR;
+    }
+}
+
+} // namespace
+
+namespace scm {
+namespace gl {
+namespace data {
+
+void
+convert_ibm_to_ieee(float*       d,
+                    const void*  s,
+                    scm::size_t  count,
+                    bool         swap_bytes)
+{
+    convert_ibm_to_ieee(ibm_float_kernel_selected(), d, s, count, swap_bytes);
+}
+
+void
+convert_ibm_to_ieee(ibm_float_kernel kernel,
+                    float*           d,
+                    const void*      s,
+                    scm::size_t      count,
+                    bool             swap_bytes)
+{
+    switch (kernel) {
+        case IBM_FLOAT_KERNEL_AVX2: detail::convert_ibm_to_ieee_avx2(d, s, count, swap_bytes);   break;
+        case IBM_FLOAT_KERNEL_SSE4: detail::convert_ibm_to_ieee_sse4(d, s, count, swap_bytes);   break;
+        default:                    detail::convert_ibm_to_ieee_scalar(d, s, count, swap_bytes); break;
+    }
+}
+
+bool
+ibm_float_kernel_supported(ibm_float_kernel kernel)
+{
+    switch (kernel) {
+        case IBM_FLOAT_KERNEL_SCALAR:   return true;
+#if SCM_IBM_FLOAT_SSE4_AVAILABLE
+        case IBM_FLOAT_KERNEL_SSE4:     return host_cpu_features()._sse41;
+#endif
+#if SCM_IBM_FLOAT_AVX2_AVAILABLE
+        case IBM_FLOAT_KERNEL_AVX2:     return host_cpu_features()._avx2;
+#endif
+        default:                        return false;
+    }
+}
+
+ibm_float_kernel
+ibm_float_kernel_selected()
+{
+    static const ibm_float_kernel kernel = select_kernel();
+    return kernel;
+}
+
+const char*
+ibm_float_kernel_name(ibm_float_kernel kernel)
+{
+    switch (kernel) {
+        case IBM_FLOAT_KERNEL_SCALAR:   return "scalar";
+        case IBM_FLOAT_KERNEL_SSE4:     return "sse4";
+        case IBM_FLOAT_KERNEL_AVX2:     return "avx2";
+        default:                        return "unknown";
+    }
+}
+
+namespace detail {
+
+void
+convert_ibm_to_ieee_scalar(float* d, const void* s, scm::size_t count, bool swap_bytes)
+{
+    const scm::uint8*const  src = reinterpret_cast<const scm::uint8*>(s);
+
+    for (scm::size_t i = 0; i < count; ++i) {
+        scm::uint32 v;
+        std::memcpy(&v, src + i * sizeof(scm::uint32), sizeof(scm::uint32));
+        v = ibm_to_ieee_bits(swap_bytes ? byte_swap_32(v) : v);
+        std::memcpy(d + i, &v, sizeof(scm::uint32));
+    }
+}
+
+} // namespace detail
+
+} // namespace data
+} // namespace gl
+} // namespace scm
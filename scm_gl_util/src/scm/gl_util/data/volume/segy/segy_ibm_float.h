@@ -0,0 +1,104 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_SEGY_IBM_FLOAT_H_INCLUDED
+#define SCM_GL_UTIL_SEGY_IBM_FLOAT_H_INCLUDED
+
+#include <scm/core/numeric_types.h>
+
+#include <scm/core/platform/platform.h>
+
+// the vector kernels are built for x86 targets with compilers providing the intrinsics,
+// their translation units are compiled with the matching instruction set flags
+#if    (SCM_COMPILER == SCM_COMPILER_MSVC && (defined(_M_IX86) || defined(_M_X64))) \
+    || (SCM_COMPILER == SCM_COMPILER_GNUC && (defined(__i386__) || defined(__x86_64__)))
+#   define SCM_IBM_FLOAT_SSE4_AVAILABLE 1
+#   if    (SCM_COMPILER == SCM_COMPILER_MSVC && SCM_COMPILER_VER >= 1700) \
+       || (SCM_COMPILER == SCM_COMPILER_GNUC && SCM_COMPILER_VER >= 470)
+#       define SCM_IBM_FLOAT_AVX2_AVAILABLE 1
+#   else
+#       define SCM_IBM_FLOAT_AVX2_AVAILABLE 0
+#   endif
+#else
+#   define SCM_IBM_FLOAT_SSE4_AVAILABLE 0
+#   define SCM_IBM_FLOAT_AVX2_AVAILABLE 0
+#endif
+
+namespace scm {
+namespace gl {
+namespace data {
+
+enum ibm_float_kernel {
+    IBM_FLOAT_KERNEL_SCALAR     = 0x00,
+    IBM_FLOAT_KERNEL_SSE4,
+    IBM_FLOAT_KERNEL_AVX2
+}; // enum ibm_float_kernel
+
+// convert count IBM System/360 single precision floats to IEEE 754 floats,
+// source values are big endian when swap_bytes is set (d == s is allowed)
+//  - values too large for IEEE floats are clamped to +-FLT_MAX, values too small
+//    are flushed to zero (matching the classic normalization loop conversion)
+//  - the fastest kernel supported by the host cpu is selected on first use
+__scm_export(gl_util)
+void
+convert_ibm_to_ieee(float*       d,
+                    const void*  s,
+                    scm::size_t  count,
+                    bool         swap_bytes);
+
+__scm_export(gl_util)
+void
+convert_ibm_to_ieee(ibm_float_kernel kernel,
+                    float*           d,
+                    const void*      s,
+                    scm::size_t      count,
+                    bool             swap_bytes);
+
+__scm_export(gl_util) bool              ibm_float_kernel_supported(ibm_float_kernel kernel);
+__scm_export(gl_util) ibm_float_kernel  ibm_float_kernel_selected();
+__scm_export(gl_util) const char*       ibm_float_kernel_name(ibm_float_kernel kernel);
+
+namespace detail {
+
+// branch free conversion of a single value, the position of the leading one of the
+// 24bit mantissa is taken from the exponent of its exact integer to float conversion
+inline
+scm::uint32
+ibm_to_ieee_bits(scm::uint32 fc)
+{
+    union {
+        float       f;
+        scm::uint32 u;
+    } fm;
+    fm.f = static_cast<float>(fc & 0x00ffffffu);
+
+    // IEEE exponent after normalization: 4 * (ibm_exp - 64) + 127 - 1 - leading zeros,
+    // the biased exponent of the integer to float conversion is 150 - leading zeros
+    const scm::int32    e    = static_cast<scm::int32>((fc & 0x7f000000u) >> 22)
+                             + static_cast<scm::int32>(fm.u >> 23) - 280;
+    const scm::uint32   sign = fc & 0x80000000u;
+
+    const scm::uint32   r = (e > 254) ? (sign | 0x7f7fffffu)
+                                      : (sign | (static_cast<scm::uint32>(e) << 23) | (fm.u & 0x007fffffu));
+    return (e > 0 && fm.u != 0) ? r : 0u;
+}
+
+inline
+scm::uint32
+byte_swap_32(scm::uint32 v)
+{
+    return (v >> 24) | ((v >> 8) & 0x0000ff00u) | ((v << 8) & 0x00ff0000u) | (v << 24);
+}
+
+void convert_ibm_to_ieee_scalar(float* d, const void* s, scm::size_t count, bool swap_bytes);
+void convert_ibm_to_ieee_sse4(float* d, const void* s, scm::size_t count, bool swap_bytes);
+void convert_ibm_to_ieee_avx2(float* d, const void* s, scm::size_t count, bool swap_bytes);
+
+} // namespace detail
+
+} // namespace data
+} // namespace gl
+} // namespace scm
+
+#endif // SCM_GL_UTIL_SEGY_IBM_FLOAT_H_INCLUDED
@@ -0,0 +1,76 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+// compiled with AVX2 code generation enabled (-mavx2 on gcc), the kernel is only
+// called after the host cpu support was verified
+
+#include "segy_ibm_float.h"
+
+#if SCM_IBM_FLOAT_AVX2_AVAILABLE
+#   include <immintrin.h>
+#endif
+
+namespace scm {
+namespace gl {
+namespace data {
+namespace detail {
+
+#if SCM_IBM_FLOAT_AVX2_AVAILABLE
+
+void
+convert_ibm_to_ieee_avx2(float* d, const void* s, scm::size_t count, bool swap_bytes)
+{
+    const __m256i   swap_mask  = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                                 12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    const __m256i   sign_mask  = _mm256_set1_epi32(0x80000000);
+    const __m256i   mant_mask  = _mm256_set1_epi32(0x00ffffff);
+    const __m256i   iexp_mask  = _mm256_set1_epi32(0x7f000000);
+    const __m256i   fmnt_mask  = _mm256_set1_epi32(0x007fffff);
+    const __m256i   max_float  = _mm256_set1_epi32(0x7f7fffff);
+    const __m256i   exp_bias   = _mm256_set1_epi32(280);
+    const __m256i   exp_max    = _mm256_set1_epi32(254);
+    const __m256i   zero       = _mm256_setzero_si256();
+
+    const char*const    src = reinterpret_cast<const char*>(s);
+    scm::size_t         i   = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i fc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * sizeof(float)));
+        if (swap_bytes) {
+            fc = _mm256_shuffle_epi8(fc, swap_mask);
+        }
+
+        // see ibm_to_ieee_bits() for the derivation
+        const __m256i   fm   = _mm256_castps_si256(_mm256_cvtepi32_ps(_mm256_and_si256(fc, mant_mask)));
+        const __m256i   e    = _mm256_sub_epi32(_mm256_add_epi32(_mm256_srli_epi32(_mm256_and_si256(fc, iexp_mask), 22),
+                                                                 _mm256_srli_epi32(fm, 23)),
+                                                exp_bias);
+        const __m256i   sign = _mm256_and_si256(fc, sign_mask);
+
+        __m256i         r    = _mm256_or_si256(_mm256_or_si256(sign, _mm256_slli_epi32(e, 23)),
+                                               _mm256_and_si256(fm, fmnt_mask));
+        r = _mm256_blendv_epi8(r, _mm256_or_si256(sign, max_float), _mm256_cmpgt_epi32(e, exp_max));
+        r = _mm256_and_si256(r, _mm256_cmpgt_epi32(e, zero));
+        r = _mm256_andnot_si256(_mm256_cmpeq_epi32(fm, zero), r);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i), r);
+    }
+
+    convert_ibm_to_ieee_scalar(d + i, src + i * sizeof(float), count - i, swap_bytes);
+}
+
+#else // SCM_IBM_FLOAT_AVX2_AVAILABLE
+
+void
+convert_ibm_to_ieee_avx2(float* d, const void* s, scm::size_t count, bool swap_bytes)
+{
+    convert_ibm_to_ieee_scalar(d, s, count, swap_bytes);
+}
+
+#endif // SCM_IBM_FLOAT_AVX2_AVAILABLE
+
+} // namespace detail
+} // namespace data
+} // namespace gl
+} // namespace scm
@@ -0,0 +1,75 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+// compiled with SSE4.1 code generation enabled (-msse4.1 on gcc), the kernel is
+// only called after the host cpu support was verified
+
+#include "segy_ibm_float.h"
+
+#if SCM_IBM_FLOAT_SSE4_AVAILABLE
+#   include <smmintrin.h>
+#endif
+
+namespace scm {
+namespace gl {
+namespace data {
+namespace detail {
+
+#if SCM_IBM_FLOAT_SSE4_AVAILABLE
+
+void
+convert_ibm_to_ieee_sse4(float* d, const void* s, scm::size_t count, bool swap_bytes)
+{
+    const __m128i   swap_mask  = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    const __m128i   sign_mask  = _mm_set1_epi32(0x80000000);
+    const __m128i   mant_mask  = _mm_set1_epi32(0x00ffffff);
+    const __m128i   iexp_mask  = _mm_set1_epi32(0x7f000000);
+    const __m128i   fmnt_mask  = _mm_set1_epi32(0x007fffff);
+    const __m128i   max_float  = _mm_set1_epi32(0x7f7fffff);
+    const __m128i   exp_bias   = _mm_set1_epi32(280);
+    const __m128i   exp_max    = _mm_set1_epi32(254);
+    const __m128i   zero       = _mm_setzero_si128();
+
+    const char*const    src = reinterpret_cast<const char*>(s);
+    scm::size_t         i   = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i fc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * sizeof(float)));
+        if (swap_bytes) {
+            fc = _mm_shuffle_epi8(fc, swap_mask);
+        }
+
+        // see ibm_to_ieee_bits() for the derivation
+        const __m128i   fm   = _mm_castps_si128(_mm_cvtepi32_ps(_mm_and_si128(fc, mant_mask)));
+        const __m128i   e    = _mm_sub_epi32(_mm_add_epi32(_mm_srli_epi32(_mm_and_si128(fc, iexp_mask), 22),
+                                                           _mm_srli_epi32(fm, 23)),
+                                             exp_bias);
+        const __m128i   sign = _mm_and_si128(fc, sign_mask);
+
+        __m128i         r    = _mm_or_si128(_mm_or_si128(sign, _mm_slli_epi32(e, 23)),
+                                            _mm_and_si128(fm, fmnt_mask));
+        r = _mm_blendv_epi8(r, _mm_or_si128(sign, max_float), _mm_cmpgt_epi32(e, exp_max));
+        r = _mm_and_si128(r, _mm_cmpgt_epi32(e, zero));
+        r = _mm_andnot_si128(_mm_cmpeq_epi32(fm, zero), r);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), r);
+    }
+
+    convert_ibm_to_ieee_scalar(d + i, src + i * sizeof(float), count - i, swap_bytes);
+}
+
+#else // SCM_IBM_FLOAT_SSE4_AVAILABLE
+
+void
+convert_ibm_to_ieee_sse4(float* d, const void* s, scm::size_t count, bool swap_bytes)
+{
+    convert_ibm_to_ieee_scalar(d, s, count, swap_bytes);
+}
+
+#endif // SCM_IBM_FLOAT_SSE4_AVAILABLE
+
+} // namespace detail
+} // namespace data
+} // namespace gl
+} // namespace scm
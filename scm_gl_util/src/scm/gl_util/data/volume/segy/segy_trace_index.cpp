@@ -0,0 +1,750 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "segy_trace_index.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <limits>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <scm/core/memory.h>
+#include <scm/core/io/file.h>
+#include <scm/core/io/file_mapping.h>
+#include <scm/core/platform/byte_swap.h>
+
+#include <scm/gl_core/log.h>
+
+#include <scm/gl_util/data/volume/segy/segy.h>
+
+namespace {
+
+const char          sidecar_magic[8]        = { 'S', 'C', 'M', 'S', 'G', 'Y', 'I', 'X' };
+const scm::uint32   sidecar_version         = 1;
+const scm::uint32   sidecar_header_size     = 512;  // entry table offset
+const std::string   sidecar_extension       = ".scmidx";
+
+const scm::uint32   sidecar_flag_fixed_length   = 0x01;
+const scm::uint32   sidecar_flag_swap_bytes     = 0x02;
+
+// number of trace headers read by a single vectored read during the scan
+const scm::size_t   trace_headers_per_read  = 4096;
+
+const scm::uint64   entry_offset_mask       = (scm::uint64(1) << 48) - 1;
+
+struct sidecar_header
+{
+    char            _magic[8];
+    scm::uint32     _version;
+    scm::uint32     _header_size;
+
+    // source file and scan parameters the index is valid for
+    scm::int64      _source_size;
+    scm::int64      _source_time;
+    scm::int64      _traces_start;
+    scm::uint32     _samples_per_trace;
+    scm::uint32     _sample_size;
+    scm::uint32     _traces_per_ensemble;
+    scm::uint32     _flags;
+    scm::uint32     _gap_fill;
+
+    // index geometry
+    scm::uint32     _inline_count;
+    scm::uint32     _crossline_count;
+    scm::int32      _first_inline;
+    scm::int32      _inline_step;
+    scm::int32      _first_crossline;
+    scm::int32      _crossline_step;
+    scm::uint32     _max_samples;
+    scm::uint64     _present_traces;
+}; // struct sidecar_header
+
+scm::uint32
+sidecar_flags(const scm::gl::data::segy_trace_index::scan_desc& desc)
+{
+    return   (desc._fixed_length_traces ? sidecar_flag_fixed_length : 0u)
+           | (desc._swap_bytes          ? sidecar_flag_swap_bytes   : 0u);
+}
+
+bool
+source_file_stamp(const std::string& file_path,
+                  scm::int64&        out_size,
+                  scm::int64&        out_time)
+{
+    using namespace boost::filesystem;
+
+    boost::system::error_code   ec;
+    const path                  fpath(file_path);
+
+    const boost::uintmax_t  fsize = file_size(fpath, ec);
+    if (ec) {
+        return false;
+    }
+    const std::time_t       ftime = last_write_time(fpath, ec);
+    if (ec) {
+        return false;
+    }
+
+    out_size = static_cast<scm::int64>(fsize);
+    out_time = static_cast<scm::int64>(ftime);
+
+    return true;
+}
+
+scm::int64
+gcd(scm::int64 a, scm::int64 b)
+{
+    while (b != 0) {
+        const scm::int64 t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+} // namespace
+
+namespace scm {
+namespace gl {
+namespace data {
+
+segy_trace_index::scan_desc::scan_desc()
+  : _traces_start(0)
+  , _samples_per_trace(0)
+  , _sample_size(0)
+  , _traces_per_ensemble(0)
+  , _fixed_length_traces(false)
+  , _swap_bytes(false)
+{
+}
+
+segy_trace_index::segy_trace_index()
+  : _inline_count(0)
+  , _crossline_count(0)
+  , _first_inline(0)
+  , _inline_step(1)
+  , _first_crossline(0)
+  , _crossline_step(1)
+  , _max_samples(0)
+  , _present_traces(0)
+  , _gap_fill(GAP_FILL_ZERO)
+  , _entries(0)
+  , _source_size(0)
+  , _source_time(0)
+{
+}
+
+segy_trace_index::~segy_trace_index()
+{
+    clear();
+}
+
+bool
+segy_trace_index::open(const io::file_ptr& segy_file,
+                       const scan_desc&    desc,
+                       gap_fill_mode       gap_fill,
+                       bool                use_sidecar)
+{
+    clear();
+
+    if (!segy_file || !segy_file->is_open()) {
+        glerr() << log::error
+                << "segy_trace_index::open(): "
+                << "invalid segy file." << log::end;
+        return false;
+    }
+
+    const std::string   scidx_path = sidecar_path(segy_file->file_path());
+
+    if (use_sidecar && load_sidecar(scidx_path, segy_file, desc, gap_fill)) {
+        return true;
+    }
+
+    if (!scan(segy_file, desc, gap_fill)) {
+        return false;
+    }
+
+    if (use_sidecar && !write_sidecar(scidx_path)) {
+        glout() << log::warning
+                << "segy_trace_index::open(): "
+                << "unable to write trace index sidecar file (" << scidx_path << "), "
+                << "the trace headers will be scanned again on the next open." << log::end;
+    }
+
+    return true;
+}
+
+bool
+segy_trace_index::scan(const io::file_ptr& segy_file,
+                       const scan_desc&    desc,
+                       gap_fill_mode       gap_fill)
+{
+    clear();
+
+    if (   desc._sample_size == 0
+        || !source_file_stamp(segy_file->file_path(), _source_size, _source_time)) {
+        glerr() << log::error
+                << "segy_trace_index::scan(): "
+                << "invalid scan parameters or segy file (" << segy_file->file_path() << ")." << log::end;
+        return false;
+    }
+
+    trace_record_vector records;
+
+    if (!read_trace_records(segy_file, desc, records)) {
+        glerr() << log::error
+                << "segy_trace_index::scan(): "
+                << "error reading trace headers (" << segy_file->file_path() << ")." << log::end;
+        clear();
+        return false;
+    }
+
+    if (!assign_bins(desc, records)) {
+        glerr() << log::error
+                << "segy_trace_index::scan(): "
+                << "unable to determine trace geometry (" << segy_file->file_path() << ")." << log::end;
+        clear();
+        return false;
+    }
+
+    _scan_desc = desc;
+    _gap_fill  = gap_fill;
+    if (_gap_fill == GAP_FILL_NEAREST) {
+        fill_gaps();
+    }
+    _entries = _entry_table.empty() ? 0 : &_entry_table.front();
+
+    return true;
+}
+
+void
+segy_trace_index::clear()
+{
+    _inline_count       = 0;
+    _crossline_count    = 0;
+    _first_inline       = 0;
+    _inline_step        = 1;
+    _first_crossline    = 0;
+    _crossline_step     = 1;
+    _max_samples        = 0;
+    _present_traces     = 0;
+    _gap_fill           = GAP_FILL_ZERO;
+    _scan_desc          = scan_desc();
+    _entries            = 0;
+    _source_size        = 0;
+    _source_time        = 0;
+
+    std::vector<entry_type>().swap(_entry_table);
+    _sidecar_mapping.reset();
+}
+
+bool
+segy_trace_index::load_sidecar(const std::string&  scidx_path,
+                               const io::file_ptr& segy_file,
+                               const scan_desc&    desc,
+                               gap_fill_mode       gap_fill)
+{
+    using namespace boost::filesystem;
+
+    clear();
+
+    boost::system::error_code   ec;
+    if (!exists(path(scidx_path), ec)) {
+        return false;
+    }
+
+    scm::int64 src_size = 0;
+    scm::int64 src_time = 0;
+    if (!source_file_stamp(segy_file->file_path(), src_size, src_time)) {
+        return false;
+    }
+
+    io::file_mapping_ptr    mapping(new io::file_mapping());
+    if (   !mapping->open(scidx_path, io::MAPPING_ACCESS_RANDOM)
+        || mapping->size() < static_cast<io::size_type>(sidecar_header_size)) {
+        return false;
+    }
+
+    sidecar_header  hdr;
+    std::memcpy(&hdr, mapping->data(), sizeof(sidecar_header));
+
+    const bool header_valid =    std::memcmp(hdr._magic, sidecar_magic, sizeof(sidecar_magic)) == 0
+                              && hdr._version             == sidecar_version
+                              && hdr._header_size         == sidecar_header_size
+                              && hdr._source_size         == src_size
+                              && hdr._source_time         == src_time
+                              && hdr._traces_start        == desc._traces_start
+                              && hdr._samples_per_trace   == desc._samples_per_trace
+                              && hdr._sample_size         == desc._sample_size
+                              && hdr._traces_per_ensemble == desc._traces_per_ensemble
+                              && hdr._flags               == sidecar_flags(desc)
+                              && hdr._gap_fill            == static_cast<scm::uint32>(gap_fill);
+    if (!header_valid) {
+        glout() << log::info
+                << "segy_trace_index::load_sidecar(): "
+                << "outdated trace index sidecar file (" << scidx_path << ")." << log::end;
+        return false;
+    }
+
+    const io::size_type entry_count = static_cast<io::size_type>(hdr._inline_count) * hdr._crossline_count;
+    if (mapping->size() != sidecar_header_size + entry_count * static_cast<io::size_type>(sizeof(entry_type))) {
+        glerr() << log::error
+                << "segy_trace_index::load_sidecar(): "
+                << "corrupt trace index sidecar file (" << scidx_path << ")." << log::end;
+        return false;
+    }
+
+    _inline_count       = hdr._inline_count;
+    _crossline_count    = hdr._crossline_count;
+    _first_inline       = hdr._first_inline;
+    _inline_step        = hdr._inline_step;
+    _first_crossline    = hdr._first_crossline;
+    _crossline_step     = hdr._crossline_step;
+    _max_samples        = hdr._max_samples;
+    _present_traces     = static_cast<scm::size_t>(hdr._present_traces);
+    _gap_fill           = gap_fill;
+    _scan_desc          = desc;
+    _source_size        = src_size;
+    _source_time        = src_time;
+
+    _sidecar_mapping    = mapping;
+    _entries            = reinterpret_cast<const entry_type*>(_sidecar_mapping->data() + sidecar_header_size);
+
+    return true;
+}
+
+bool
+segy_trace_index::write_sidecar(const std::string& scidx_path) const
+{
+    if (empty()) {
+        return false;
+    }
+
+    std::vector<char>   hdr_data(sidecar_header_size, 0);
+    sidecar_header      hdr;
+
+    std::memset(&hdr, 0, sizeof(sidecar_header));
+    std::memcpy(hdr._magic, sidecar_magic, sizeof(sidecar_magic));
+    hdr._version                = sidecar_version;
+    hdr._header_size            = sidecar_header_size;
+    hdr._source_size            = _source_size;
+    hdr._source_time            = _source_time;
+    hdr._traces_start           = _scan_desc._traces_start;
+    hdr._samples_per_trace      = _scan_desc._samples_per_trace;
+    hdr._sample_size            = _scan_desc._sample_size;
+    hdr._traces_per_ensemble    = _scan_desc._traces_per_ensemble;
+    hdr._flags                  = sidecar_flags(_scan_desc);
+    hdr._gap_fill               = static_cast<scm::uint32>(_gap_fill);
+    hdr._inline_count           = _inline_count;
+    hdr._crossline_count        = _crossline_count;
+    hdr._first_inline           = _first_inline;
+    hdr._inline_step            = _inline_step;
+    hdr._first_crossline        = _first_crossline;
+    hdr._crossline_step         = _crossline_step;
+    hdr._max_samples            = _max_samples;
+    hdr._present_traces         = _present_traces;
+    std::memcpy(&hdr_data.front(), &hdr, sizeof(sidecar_header));
+
+    const io::size_type table_size =   static_cast<io::size_type>(_inline_count) * _crossline_count
+                                     * static_cast<io::size_type>(sizeof(entry_type));
+
+    io::file    scidx_file;
+    if (!scidx_file.open(scidx_path, std::ios_base::out | std::ios_base::trunc, false)) {
+        return false;
+    }
+
+    const bool write_success =    scidx_file.write(&hdr_data.front(), 0, sidecar_header_size) == sidecar_header_size
+                               && scidx_file.write(_entries, sidecar_header_size, table_size) == table_size;
+    scidx_file.close();
+
+    if (!write_success) {
+        boost::system::error_code ec;
+        boost::filesystem::remove(boost::filesystem::path(scidx_path), ec);
+    }
+
+    return write_success;
+}
+
+std::string
+segy_trace_index::sidecar_path(const std::string& segy_file_path)
+{
+    return segy_file_path + sidecar_extension;
+}
+
+bool
+segy_trace_index::empty() const
+{
+    return _entries == 0;
+}
+
+bool
+segy_trace_index::mapped() const
+{
+    return _sidecar_mapping && _entries != 0;
+}
+
+unsigned
+segy_trace_index::inline_count() const
+{
+    return _inline_count;
+}
+
+unsigned
+segy_trace_index::crossline_count() const
+{
+    return _crossline_count;
+}
+
+scm::int32
+segy_trace_index::first_inline() const
+{
+    return _first_inline;
+}
+
+scm::int32
+segy_trace_index::inline_step() const
+{
+    return _inline_step;
+}
+
+scm::int32
+segy_trace_index::first_crossline() const
+{
+    return _first_crossline;
+}
+
+scm::int32
+segy_trace_index::crossline_step() const
+{
+    return _crossline_step;
+}
+
+unsigned
+segy_trace_index::max_samples() const
+{
+    return _max_samples;
+}
+
+scm::size_t
+segy_trace_index::present_traces() const
+{
+    return _present_traces;
+}
+
+scm::size_t
+segy_trace_index::missing_traces() const
+{
+    return static_cast<scm::size_t>(_inline_count) * _crossline_count - _present_traces;
+}
+
+segy_trace_index::gap_fill_mode
+segy_trace_index::gap_fill() const
+{
+    return _gap_fill;
+}
+
+segy_trace_index::entry_type
+segy_trace_index::entry(unsigned crossline_index,
+                        unsigned inline_index) const
+{
+    assert(_entries != 0);
+    assert(crossline_index < _crossline_count && inline_index < _inline_count);
+
+    return _entries[static_cast<scm::size_t>(inline_index) * _crossline_count + crossline_index];
+}
+
+io::offset_type
+segy_trace_index::entry_data_offset(entry_type e)
+{
+    return static_cast<io::offset_type>(e & entry_offset_mask);
+}
+
+unsigned
+segy_trace_index::entry_samples(entry_type e)
+{
+    return static_cast<unsigned>(e >> 48);
+}
+
+segy_trace_index::entry_type
+segy_trace_index::make_entry(io::offset_type data_offset,
+                             unsigned        samples)
+{
+    return   (static_cast<entry_type>(data_offset) & entry_offset_mask)
+           | (static_cast<entry_type>(samples & 0xffffu) << 48);
+}
+
+bool
+segy_trace_index::read_trace_records(const io::file_ptr&  segy_file,
+                                     const scan_desc&     desc,
+                                     trace_record_vector& records) const
+{
+    const io::size_type     thsize      = sizeof(segy_trace_header);
+    const io::size_type     fsize       = segy_file->size();
+    const io::size_type     nominal_ts  = thsize + static_cast<io::size_type>(desc._samples_per_trace) * desc._sample_size;
+
+    std::vector<segy_trace_header>  headers(trace_headers_per_read);
+    io::file_span_vector            spans;
+    io::offset_type                 next_trace = desc._traces_start;
+
+    spans.reserve(trace_headers_per_read);
+    records.reserve(static_cast<scm::size_t>((fsize - desc._traces_start) / nominal_ts));
+
+    bool variable_length = false;
+
+    while (next_trace + thsize <= fsize) {
+        // as long as all traces have the nominal length the header positions are known
+        // in advance and a batch of headers is read by one vectored read, once a trace
+        // of different length is found the headers are read one after the other
+        spans.clear();
+        io::size_type read_size = 0;
+        for (io::offset_type t = next_trace;
+             spans.size() < (variable_length ? 1 : trace_headers_per_read) && t + thsize <= fsize;
+             t += nominal_ts) {
+            spans.push_back(io::file_span(t, thsize, &headers[spans.size()]));
+            read_size += thsize;
+        }
+
+        if (segy_file->read(spans, 0) != read_size) {
+            return false;
+        }
+
+        for (scm::size_t i = 0; i < spans.size(); ++i) {
+            segy_trace_header&  h = headers[i];
+            if (desc._swap_bytes) {
+                swap_bytes(&h._num_samples);
+                swap_bytes(&h._ensemble_cdp_x);
+                swap_bytes(&h._poststack_inline_num);
+                swap_bytes(&h._poststack_crline_num);
+            }
+
+            const unsigned      hsamples = static_cast<scm::uint16>(h._num_samples);
+            const unsigned      tsamples = (desc._fixed_length_traces || hsamples == 0) ? desc._samples_per_trace : hsamples;
+            const io::size_type tsize    = thsize + static_cast<io::size_type>(tsamples) * desc._sample_size;
+
+            if (spans[i]._position + tsize > fsize) {
+                // truncated last trace
+                next_trace = fsize;
+                break;
+            }
+
+            trace_record    r;
+            r._inline    = h._poststack_inline_num;
+            r._crossline = h._poststack_crline_num;
+            r._cdp_x     = h._ensemble_cdp_x;
+            r._entry     = make_entry(spans[i]._position + thsize, tsamples);
+            records.push_back(r);
+
+            next_trace = spans[i]._position + tsize;
+
+            if (tsize != nominal_ts) {
+                // following header positions of this batch are invalid
+                variable_length = true;
+                break;
+            }
+        }
+    }
+
+    return !records.empty();
+}
+
+bool
+segy_trace_index::assign_bins(const scan_desc&     desc,
+                              trace_record_vector& records)
+{
+    const scm::size_t   trace_count = records.size();
+
+    bool bins_assigned = false;
+
+    { // try the inline/crossline numbers of the trace headers
+        scm::int32  il_first, il_step, xl_first, xl_step;
+        unsigned    il_count, xl_count;
+
+        bin_range(records, &trace_record::_inline,    il_first, il_step, il_count);
+        bin_range(records, &trace_record::_crossline, xl_first, xl_step, xl_count);
+
+        // reject geometries mostly consisting of empty bins (garbage header values)
+        const scm::uint64 bin_count = static_cast<scm::uint64>(il_count) * xl_count;
+        if (bin_count <= 4 * static_cast<scm::uint64>(trace_count) + 16) {
+            std::vector<entry_type> table(static_cast<scm::size_t>(bin_count), entry_type(invalid_entry));
+            scm::size_t             duplicates = 0;
+
+            for (trace_record_vector::const_iterator t = records.begin(); t != records.end(); ++t) {
+                const scm::size_t b =   static_cast<scm::size_t>((static_cast<scm::int64>(t->_inline)    - il_first) / il_step) * xl_count
+                                      + static_cast<scm::size_t>((static_cast<scm::int64>(t->_crossline) - xl_first) / xl_step);
+                if (table[b] == invalid_entry) {
+                    table[b] = t->_entry;
+                }
+                else {
+                    ++duplicates;
+                }
+            }
+
+            // mostly duplicate bins mean the header fields do not hold the bin numbers
+            if (duplicates * 2 <= trace_count) {
+                _first_inline       = il_first;
+                _inline_step        = il_step;
+                _inline_count       = il_count;
+                _first_crossline    = xl_first;
+                _crossline_step     = xl_step;
+                _crossline_count    = xl_count;
+                _present_traces     = trace_count - duplicates;
+                _entry_table.swap(table);
+
+                bins_assigned = true;
+
+                if (duplicates > 0) {
+                    glout() << log::warning
+                            << "segy_trace_index::assign_bins(): "
+                            << "ignoring " << duplicates << " traces with duplicate inline/crossline numbers." << log::end;
+                }
+            }
+        }
+    }
+
+    if (!bins_assigned) {
+        // regular layout in file order, the ensemble size is given by the binary
+        // header or ends with the first repeated crossline/cdp number
+        scm::size_t ensemble_size = desc._traces_per_ensemble > 1 ? desc._traces_per_ensemble : 0;
+
+        for (scm::size_t t = 1; t < trace_count && ensemble_size == 0; ++t) {
+            if (   (   records[0]._crossline != records[1]._crossline
+                    && records[t]._crossline == records[0]._crossline)
+                || (   records[0]._cdp_x != records[1]._cdp_x
+                    && records[t]._cdp_x == records[0]._cdp_x)) {
+                ensemble_size = t;
+            }
+        }
+        if (ensemble_size == 0) {
+            ensemble_size = trace_count;
+        }
+
+        _first_inline       = 0;
+        _inline_step        = 1;
+        _inline_count       = static_cast<unsigned>((trace_count + ensemble_size - 1) / ensemble_size);
+        _first_crossline    = 0;
+        _crossline_step     = 1;
+        _crossline_count    = static_cast<unsigned>(ensemble_size);
+        _present_traces     = trace_count;
+
+        _entry_table.assign(static_cast<scm::size_t>(_inline_count) * _crossline_count, entry_type(invalid_entry));
+        for (scm::size_t t = 0; t < trace_count; ++t) {
+            _entry_table[t] = records[t]._entry;
+        }
+    }
+
+    _max_samples = 0;
+    for (trace_record_vector::const_iterator t = records.begin(); t != records.end(); ++t) {
+        _max_samples = std::max(_max_samples, entry_samples(t->_entry));
+    }
+
+    return _inline_count > 0 && _crossline_count > 0;
+}
+
+void
+segy_trace_index::bin_range(const trace_record_vector&    records,
+                            scm::int32 trace_record::*    value,
+                            scm::int32&                   first,
+                            scm::int32&                   step,
+                            unsigned&                     count)
+{
+    const scm::int32    v0   = records.front().*value;
+    scm::int32          vmin = v0;
+    scm::int32          vmax = v0;
+    scm::int64          g    = 0;
+
+    // the bin spacing is the greatest common divisor of all distances to the first value
+    for (trace_record_vector::const_iterator t = records.begin(); t != records.end(); ++t) {
+        const scm::int32 v = (*t).*value;
+        vmin = std::min(vmin, v);
+        vmax = std::max(vmax, v);
+        g    = gcd(g, std::abs(static_cast<scm::int64>(v) - v0));
+    }
+
+    first = vmin;
+    step  = static_cast<scm::int32>(std::max<scm::int64>(1, g));
+    count = static_cast<unsigned>((static_cast<scm::int64>(vmax) - vmin) / step + 1);
+}
+
+void
+segy_trace_index::fill_gaps()
+{
+    const unsigned  nx = _crossline_count;
+    const unsigned  ny = _inline_count;
+
+    if (_present_traces == 0 || _present_traces == static_cast<scm::size_t>(nx) * ny) {
+        return;
+    }
+
+    std::vector<unsigned>   dist(nx);
+    std::vector<bool>       row_present(ny, false);
+    const unsigned          no_trace = (std::numeric_limits<unsigned>::max)();
+
+    // fill within the inlines from the nearest trace of the same inline
+    for (unsigned y = 0; y < ny; ++y) {
+        entry_type*const row = &_entry_table[static_cast<scm::size_t>(y) * nx];
+
+        unsigned last = no_trace;
+        for (unsigned x = 0; x < nx; ++x) {
+            if (row[x] != invalid_entry) {
+                last = x;
+            }
+            dist[x] = (last == no_trace) ? no_trace : x - last;
+        }
+        if (last == no_trace) {
+            continue;
+        }
+        row_present[y] = true;
+
+        entry_type  left = invalid_entry;
+        for (unsigned x = 0; x < nx; ++x) {
+            if (dist[x] == 0) {
+                left = row[x];
+            }
+            else if (dist[x] != no_trace) {
+                row[x] = left;  // preliminary, replaced if a closer trace follows
+            }
+        }
+        unsigned next = no_trace;
+        for (unsigned x = nx; x-- > 0; ) {
+            if (dist[x] == 0) {
+                next = x;
+            }
+            else if (next != no_trace && (dist[x] == no_trace || next - x < dist[x])) {
+                row[x] = row[next];
+            }
+        }
+    }
+
+    // inlines without any trace are copies of the nearest filled inline
+    unsigned last = no_trace;
+    for (unsigned y = 0; y < ny; ++y) {
+        unsigned src = no_trace;
+        if (row_present[y]) {
+            last = y;
+            continue;
+        }
+        for (unsigned n = y + 1; n < ny; ++n) {
+            if (row_present[n]) {
+                src = (last == no_trace || n - y < y - last) ? n : last;
+                break;
+            }
+        }
+        if (src == no_trace) {
+            src = last;
+        }
+        std::copy(_entry_table.begin() + static_cast<scm::size_t>(src) * nx,
+                  _entry_table.begin() + static_cast<scm::size_t>(src + 1) * nx,
+                  _entry_table.begin() + static_cast<scm::size_t>(y) * nx);
+    }
+}
+
+} // namespace data
+} // namespace gl
+} // namespace scm
@@ -0,0 +1,158 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_SEGY_TRACE_INDEX_H_INCLUDED
+#define SCM_GL_UTIL_SEGY_TRACE_INDEX_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include <scm/core/numeric_types.h>
+#include <scm/core/io/io_fwd.h>
+
+#include <scm/gl_util/data/volume/segy/segy_fwd.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+namespace data {
+
+// (inline, crossline) -> trace location index of a post stack SEG-Y file
+//  - built once by scanning all trace headers, the bin of a trace is taken from the
+//    inline/crossline numbers (bytes 189/193) or, if these are not usable, from the
+//    trace position using the ensemble size
+//  - traces may be missing, stored out of order or vary in length, missing bins are
+//    either left empty (read as zeros) or filled with the nearest present trace
+//  - the index is stored in a sidecar file next to the SEG-Y file (<file>.scmidx),
+//    on the next open the sidecar is memory mapped instead of scanning again as long
+//    as it matches the SEG-Y file size, modification time and scan parameters
+class __scm_export(gl_util) segy_trace_index : boost::noncopyable
+{
+public:
+    enum gap_fill_mode {
+        GAP_FILL_ZERO       = 0x00,
+        GAP_FILL_NEAREST
+    }; // enum gap_fill_mode
+
+    // parameters of the trace scan, taken from the SEG-Y binary header
+    struct scan_desc
+    {
+        scan_desc();
+
+        io::offset_type     _traces_start;          // file offset of the first trace header
+        unsigned            _samples_per_trace;     // nominal samples per trace
+        unsigned            _sample_size;           // bytes per sample
+        unsigned            _traces_per_ensemble;   // nominal ensemble size (0 if unknown)
+        bool                _fixed_length_traces;   // all traces have _samples_per_trace samples
+        bool                _swap_bytes;            // trace headers are big endian
+    }; // struct scan_desc
+
+    // packed index entry: data offset of the trace samples in the lower 48bit,
+    // number of samples in the upper 16bit, 0 marks bins without trace
+    typedef scm::uint64         entry_type;
+
+    static const entry_type     invalid_entry = 0;
+
+public:
+    segy_trace_index();
+    virtual ~segy_trace_index();
+
+    // load the sidecar of the segy file if it is up to date, otherwise scan the trace
+    // headers and try to write a new sidecar (failing to write it is not an error)
+    bool                        open(const io::file_ptr& segy_file,
+                                     const scan_desc&    desc,
+                                     gap_fill_mode       gap_fill,
+                                     bool                use_sidecar = true);
+    bool                        scan(const io::file_ptr& segy_file,
+                                     const scan_desc&    desc,
+                                     gap_fill_mode       gap_fill);
+    void                        clear();
+
+    bool                        load_sidecar(const std::string& sidecar_path,
+                                             const io::file_ptr& segy_file,
+                                             const scan_desc&    desc,
+                                             gap_fill_mode       gap_fill);
+    bool                        write_sidecar(const std::string& sidecar_path) const;
+
+    static std::string          sidecar_path(const std::string& segy_file_path);
+
+    bool                        empty() const;
+    bool                        mapped() const;
+
+    unsigned                    inline_count() const;
+    unsigned                    crossline_count() const;
+    scm::int32                  first_inline() const;
+    scm::int32                  inline_step() const;
+    scm::int32                  first_crossline() const;
+    scm::int32                  crossline_step() const;
+    unsigned                    max_samples() const;
+
+    scm::size_t                 present_traces() const;
+    scm::size_t                 missing_traces() const;
+    gap_fill_mode               gap_fill() const;
+
+    // crossline_index, inline_index are bin indices in [0, count)
+    entry_type                  entry(unsigned crossline_index,
+                                      unsigned inline_index) const;
+
+    static io::offset_type      entry_data_offset(entry_type e);
+    static unsigned             entry_samples(entry_type e);
+    static entry_type           make_entry(io::offset_type data_offset,
+                                           unsigned        samples);
+
+protected:
+    struct trace_record
+    {
+        scm::int32          _inline;
+        scm::int32          _crossline;
+        scm::int32          _cdp_x;
+        entry_type          _entry;
+    }; // struct trace_record
+    typedef std::vector<trace_record>   trace_record_vector;
+
+    bool                        read_trace_records(const io::file_ptr&  segy_file,
+                                                   const scan_desc&     desc,
+                                                   trace_record_vector& records) const;
+    bool                        assign_bins(const scan_desc&     desc,
+                                            trace_record_vector& records);
+    static void                 bin_range(const trace_record_vector&    records,
+                                          scm::int32 trace_record::*    value,
+                                          scm::int32&                   first,
+                                          scm::int32&                   step,
+                                          unsigned&                     count);
+    void                        fill_gaps();
+
+protected:
+    unsigned                    _inline_count;
+    unsigned                    _crossline_count;
+    scm::int32                  _first_inline;
+    scm::int32                  _inline_step;
+    scm::int32                  _first_crossline;
+    scm::int32                  _crossline_step;
+    unsigned                    _max_samples;
+    scm::size_t                 _present_traces;
+    gap_fill_mode               _gap_fill;
+    scan_desc                   _scan_desc;
+
+    // the entries point either into the own table or into the sidecar mapping
+    std::vector<entry_type>     _entry_table;
+    io::file_mapping_ptr        _sidecar_mapping;
+    const entry_type*           _entries;
+
+    scm::int64                  _source_size;
+    scm::int64                  _source_time;
+
+}; // class segy_trace_index
+
+} // namespace data
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_UTIL_SEGY_TRACE_INDEX_H_INCLUDED
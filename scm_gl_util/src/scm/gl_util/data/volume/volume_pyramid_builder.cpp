@@ -0,0 +1,312 @@
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "volume_pyramid_builder.h"
+
+#include <cstring>
+#include <vector>
+
+#include <scm/core/math.h>
+#include <scm/core/memory.h>
+#include <scm/core/numeric_types.h>
+#include <scm/core/io/file.h>
+#include <scm/core/utilities/thread_pool.h>
+
+#include <scm/gl_core/log.h>
+#include <scm/gl_core/texture_objects/texture_image.h>
+
+#include <scm/gl_util/data/imaging/mip_map_generation.h>
+#include <scm/gl_util/data/imaging/texture_loader_dds.h>
+#include <scm/gl_util/data/volume/volume_reader.h>
+
+namespace {
+
+using namespace scm;
+using namespace scm::gl;
+using namespace scm::math;
+
+// filters the rows [begin, end) of one output slice from the source slices held by the
+// previous level
+template<typename vtype,
+         const unsigned vdim>
+struct slice_filter
+{
+    const util::detail::mip_level_filter<vtype, vdim>*  _filter;
+    unsigned                                            _z;
+    const vtype*                                        _src_slices[3];
+    vtype*                                              _dst_slice;
+
+    void operator()(scm::size_t begin, scm::size_t end) const {
+        _filter->filter_rows(_z, begin, end, _src_slices, _dst_slice);
+    }
+}; // struct slice_filter
+
+// streaming state of a single pyramid level
+struct pyramid_level
+{
+    vec3ui              _dimensions;
+    io::offset_type     _file_offset;
+    scm::size_t         _slice_size;    // bytes
+    unsigned            _ring_size;     // slices kept for the filter of the next level
+    shared_array<uint8> _ring;          // slice z is kept at (z % _ring_size)
+    unsigned            _next_slice;    // next slice to be produced
+}; // struct pyramid_level
+
+template<typename vtype,
+         const unsigned vdim>
+class pyramid_stream
+{
+public:
+    typedef util::detail::mip_level_filter<vtype, vdim>     level_filter;
+
+    pyramid_stream(io::file&               out_file,
+                   const std::string&      file_path,
+                   const vec3ui&           dimensions,
+                   const io::offset_type   data_offset,
+                   thread_pool&            threads)
+      : _out_file(out_file)
+      , _file_path(file_path)
+      , _threads(threads)
+    {
+        const unsigned      level_count = util::max_mip_levels(dimensions);
+        io::offset_type     level_off   = data_offset;
+
+        for (unsigned l = 0; l < level_count; ++l) {
+            pyramid_level   lvl;
+            lvl._dimensions  = util::mip_level_dimensions(dimensions, l);
+            lvl._file_offset = level_off;
+            lvl._slice_size  = static_cast<scm::size_t>(lvl._dimensions.x) * lvl._dimensions.y * sizeof(vtype) * vdim;
+            lvl._ring_size   = (l + 1 < level_count) ? min(3u, lvl._dimensions.z) : 1u;
+            lvl._ring.reset(new uint8[lvl._ring_size * lvl._slice_size]);
+            lvl._next_slice  = 0;
+
+            level_off += static_cast<io::offset_type>(lvl._slice_size) * lvl._dimensions.z;
+            _levels.push_back(lvl);
+        }
+
+        _write_buffer.reset(new uint8[_levels[0]._slice_size]);
+    }
+
+    scm::size_t buffer_size() const {
+        scm::size_t s = _levels[0]._slice_size;
+        for (size_t l = 0; l < _levels.size(); ++l) {
+            s += _levels[l]._ring_size * _levels[l]._slice_size;
+        }
+        return s;
+    }
+
+    // hand the next level 0 slice to the stream
+    bool push_source_slice(const uint8* data) {
+        pyramid_level&  lvl = _levels[0];
+        uint8*          dst = ring_slice(lvl, lvl._next_slice);
+
+        std::memcpy(dst, data, lvl._slice_size);
+
+        return push_slice(0);
+    }
+
+protected:
+    uint8* ring_slice(const pyramid_level& lvl, unsigned z) const {
+        return lvl._ring.get() + (z % lvl._ring_size) * lvl._slice_size;
+    }
+
+    // the slice _next_slice of level l is complete in its ring slot: write it and produce
+    // all slices of the following levels depending on it
+    bool push_slice(unsigned l) {
+        pyramid_level&      lvl = _levels[l];
+        const unsigned      z   = lvl._next_slice++;
+        const uint8*        src = ring_slice(lvl, z);
+
+        if (!write_slice(lvl, z, src)) {
+            return false;
+        }
+
+        if (l + 1 >= _levels.size()) {
+            return true;
+        }
+
+        pyramid_level&      nlvl = _levels[l + 1];
+        level_filter        filter;
+        filter._src      = 0;
+        filter._dst      = 0;
+        filter._src_size = lvl._dimensions;
+        filter._dst_size = nlvl._dimensions;
+
+        const unsigned      zo = nlvl._next_slice;
+        if (zo >= nlvl._dimensions.z || z != 2 * zo + filter.z_samples() - 1) {
+            return true;
+        }
+
+        slice_filter<vtype, vdim>   sf;
+        sf._filter    = &filter;
+        sf._z         = zo;
+        sf._dst_slice = reinterpret_cast<vtype*>(ring_slice(nlvl, zo));
+        for (unsigned zs = 0; zs < filter.z_samples(); ++zs) {
+            sf._src_slices[zs] = reinterpret_cast<const vtype*>(ring_slice(lvl, 2 * zo + zs));
+        }
+
+        const scm::size_t   task_texels = 64 * 1024;
+        const scm::size_t   grain       = (task_texels + nlvl._dimensions.x - 1) / nlvl._dimensions.x;
+
+        _threads.parallel_for(nlvl._dimensions.y, grain, sf);
+
+        return push_slice(l + 1);
+    }
+
+    // dds files store the rows top to bottom
+    bool write_slice(const pyramid_level& lvl, unsigned z, const uint8* src) {
+        const scm::size_t   row_size  = lvl._slice_size / lvl._dimensions.y;
+        const unsigned      row_count = lvl._dimensions.y;
+
+        for (unsigned y = 0; y < row_count; ++y) {
+            std::memcpy(_write_buffer.get() + (row_count - 1 - y) * row_size, src + y * row_size, row_size);
+        }
+
+        const io::offset_type   woff = lvl._file_offset + static_cast<io::offset_type>(z) * lvl._slice_size;
+
+        if (_out_file.write(_write_buffer.get(), woff, lvl._slice_size) != static_cast<io::size_type>(lvl._slice_size)) {
+            glerr() << log::error
+                    << "build_mip_pyramid_dds(): error writing to output file: " << _file_path
+                    << " (number of bytes attempted to write: " << lvl._slice_size << ", at position : " << woff << ")" << log::end;
+            return false;
+        }
+
+        return true;
+    }
+
+protected:
+    io::file&                   _out_file;
+    const std::string&          _file_path;
+    thread_pool&                _threads;
+
+    std::vector<pyramid_level>  _levels;
+    shared_array<uint8>         _write_buffer;
+
+}; // class pyramid_stream
+
+template<typename vtype,
+         const unsigned vdim>
+bool
+typed_build_mip_pyramid(volume_reader&          source,
+                        io::file&               out_file,
+                        const std::string&      file_path,
+                        const io::offset_type   data_offset,
+                        const unsigned          slab_depth,
+                        thread_pool&            threads)
+{
+    const vec3ui&       dim        = source.dimensions();
+    const scm::size_t   slice_size = static_cast<scm::size_t>(dim.x) * dim.y * sizeof(vtype) * vdim;
+    const unsigned      slab_slices = max(1u, min(slab_depth, dim.z));
+
+    pyramid_stream<vtype, vdim> stream(out_file, file_path, dim, data_offset, threads);
+    shared_array<uint8>         slab_data(new uint8[slab_slices * slice_size]);
+
+    glout() << log::info
+            << "build_mip_pyramid_dds(): streaming " << dim << " volume in slabs of " << slab_slices << " slices"
+            << " (buffer size: " << (stream.buffer_size() + slab_slices * slice_size) / (1024 * 1024) << "MiB)." << log::end;
+
+    for (unsigned z = 0; z < dim.z; z += slab_slices) {
+        const unsigned  slab_size = min(slab_slices, dim.z - z);
+
+        if (!source.read(vec3ui(0u, 0u, z), vec3ui(dim.x, dim.y, slab_size), slab_data.get())) {
+            glerr() << log::error
+                    << "build_mip_pyramid_dds(): error reading source volume slab"
+                    << " (origin: " << vec3ui(0u, 0u, z) << ", size: " << vec3ui(dim.x, dim.y, slab_size) << ")." << log::end;
+            return false;
+        }
+
+        for (unsigned s = 0; s < slab_size; ++s) {
+            if (!stream.push_source_slice(slab_data.get() + s * slice_size)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// formats with a mip map filter and an uncompressed dds representation
+bool
+pyramid_format_supported(const data_format fmt)
+{
+    switch (fmt) {
+    case FORMAT_R_32F:
+    case FORMAT_RG_32F:
+    case FORMAT_RGBA_32F:
+    case FORMAT_R_8:
+    case FORMAT_RGB_8:
+    case FORMAT_RGBA_8:
+    case FORMAT_R_16:
+    case FORMAT_RG_16:      return true;
+    default:                return false;
+    }
+}
+
+} // namespace
+
+namespace scm {
+namespace gl {
+
+bool
+build_mip_pyramid_dds(volume_reader&      source,
+                      const std::string&  file_path,
+                      const unsigned      slab_depth,
+                      const unsigned      thread_count)
+{
+    if (!source) {
+        glerr() << log::error
+                << "build_mip_pyramid_dds(): invalid source volume." << log::end;
+        return false;
+    }
+
+    const vec3ui&       dim = source.dimensions();
+    const data_format   fmt = source.format();
+
+    if (!pyramid_format_supported(fmt)) {
+        glerr() << log::error
+                << "build_mip_pyramid_dds(): unsupported volume format (" << format_string(fmt) << ")." << log::end;
+        return false;
+    }
+
+    io::file out_file;
+
+    if (!out_file.open(file_path, std::ios_base::in | std::ios_base::out | std::ios_base::trunc, false)) {
+        glerr() << log::error
+                << "build_mip_pyramid_dds(): error opening output file (" << file_path << ")." << log::end;
+        return false;
+    }
+
+    io::offset_type     data_offset = 0;
+    texture_loader_dds  dds_writer;
+
+    if (!dds_writer.write_header_dx9(out_file, dim, fmt, util::max_mip_levels(dim), data_offset)) {
+        glerr() << log::error
+                << "build_mip_pyramid_dds(): error writing dds header to output file (" << file_path << ")." << log::end;
+        return false;
+    }
+
+    thread_pool threads(thread_count);
+    bool        result = false;
+
+    switch (fmt) {
+    case FORMAT_R_32F:      result = typed_build_mip_pyramid<float, 1>(source, out_file, file_path, data_offset, slab_depth, threads);   break;
+    case FORMAT_RG_32F:     result = typed_build_mip_pyramid<float, 2>(source, out_file, file_path, data_offset, slab_depth, threads);   break;
+    case FORMAT_RGBA_32F:   result = typed_build_mip_pyramid<float, 4>(source, out_file, file_path, data_offset, slab_depth, threads);   break;
+    case FORMAT_R_8:        result = typed_build_mip_pyramid<uint8, 1>(source, out_file, file_path, data_offset, slab_depth, threads);   break;
+    case FORMAT_RGB_8:      result = typed_build_mip_pyramid<uint8, 3>(source, out_file, file_path, data_offset, slab_depth, threads);   break;
+    case FORMAT_RGBA_8:     result = typed_build_mip_pyramid<uint8, 4>(source, out_file, file_path, data_offset, slab_depth, threads);   break;
+    case FORMAT_R_16:       result = typed_build_mip_pyramid<uint16, 1>(source, out_file, file_path, data_offset, slab_depth, threads);  break;
+    case FORMAT_RG_16:      result = typed_build_mip_pyramid<uint16, 2>(source, out_file, file_path, data_offset, slab_depth, threads);  break;
+    default:
+        glerr() << log::error
+                << "build_mip_pyramid_dds(): unsupported volume format (" << format_string(fmt) << ")." << log::end;
+        break;
+    }
+
+    out_file.close();
+
+    return result;
+}
+
+} // namespace gl
+} // namespace scm
@@ -0,0 +1,41 @@
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_VOLUME_PYRAMID_BUILDER_H_INCLUDED
+#define SCM_GL_UTIL_VOLUME_PYRAMID_BUILDER_H_INCLUDED
+
+#include <string>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+class volume_reader;
+
+// streams the source volume through the mip map filters of util::generate_mipmaps() and
+// writes the complete resolution pyramid to an uncompressed dds volume texture file
+//  - the source is read in slabs of slab_depth z-slices, every level keeps only the
+//    (up to three) slices the filter of the next level needs, so the peak memory is
+//    about slab_depth + 5 source slices regardless of the depth of the volume
+//  - the slices of every level are written as soon as they are complete
+//  - the file loads with texture_loader_dds to the same data as generate_mipmaps()
+//    produces from the complete source volume
+//  - thread_count = 0 uses one filter thread per hardware thread
+//  - supported source formats are R_8, RGB_8, RGBA_8, R_16, RG_16, R_32F, RG_32F and RGBA_32F,
+//    other formats (e.g. RG_8, RGB_16, RGBA_16, RGB_32F) have no dx9 dds header
+//    representation and are rejected before the output file is created
+bool
+__scm_export(gl_util)
+build_mip_pyramid_dds(volume_reader&      source,
+                      const std::string&  file_path,
+                      const unsigned      slab_depth   = 16,
+                      const unsigned      thread_count = 0);
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_UTIL_VOLUME_PYRAMID_BUILDER_H_INCLUDED
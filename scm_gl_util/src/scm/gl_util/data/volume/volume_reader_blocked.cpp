@@ -7,9 +7,15 @@
 #include <memory.h>
 
 #include <scm/core/io/file.h>
+#include <scm/core/io/file_mapping.h>
+
+#include <scm/gl_core/log.h>
 
 namespace {
 
+// upper bound for the number of lines submitted by a single vectored read
+const scm::size_t max_read_spans_per_batch = 65536;
+
 } // namespace
 
 
@@ -25,6 +31,82 @@ volume_reader_blocked::volume_reader_blocked(const std::string& file_path,
 
 volume_reader_blocked::~volume_reader_blocked()
 {
+    unmap_volume_data();
+}
+
+bool
+volume_reader_blocked::map_volume_data(io::mapping_access_hint h)
+{
+    if (!(*this)) {
+        return false;
+    }
+
+    if (volume_data_mapped()) {
+        return advise_volume_data(h);
+    }
+
+    io::file_mapping_ptr    new_mapping = make_shared<io::file_mapping>();
+
+    if (!new_mapping->open(_file->file_path(), io::MAPPING_ACCESS_NORMAL)) {
+        glerr() << log::error
+                << "volume_reader_blocked::map_volume_data(): "
+                << "unable to map volume file (" << _file->file_path() << ")." << log::end;
+        return false;
+    }
+
+    scm::int64 volume_size =   static_cast<scm::int64>(_dimensions.x)
+                             * static_cast<scm::int64>(_dimensions.y)
+                             * static_cast<scm::int64>(_dimensions.z)
+                             * static_cast<scm::int64>(size_of_format(_format));
+
+    if (new_mapping->size() < _data_start_offset + volume_size) {
+        glerr() << log::error
+                << "volume_reader_blocked::map_volume_data(): "
+                << "mapped file too small for volume data"
+                << " (file size: " << new_mapping->size()
+                << ", expected size: " << _data_start_offset + volume_size << ")." << log::end;
+        return false;
+    }
+
+    _file_mapping = new_mapping;
+
+    if (h != io::MAPPING_ACCESS_NORMAL) {
+        advise_volume_data(h);
+    }
+
+    return true;
+}
+
+void
+volume_reader_blocked::unmap_volume_data()
+{
+    _file_mapping.reset();
+}
+
+bool
+volume_reader_blocked::volume_data_mapped() const
+{
+    return _file_mapping && _file_mapping->is_open();
+}
+
+bool
+volume_reader_blocked::advise_volume_data(io::mapping_access_hint h) const
+{
+    if (!volume_data_mapped()) {
+        return false;
+    }
+
+    return _file_mapping->advise(h, _data_start_offset);
+}
+
+const void*
+volume_reader_blocked::mapped_volume_data() const
+{
+    if (!volume_data_mapped()) {
+        return 0;
+    }
+
+    return _file_mapping->data() + _data_start_offset;
 }
 
 bool
@@ -54,126 +136,71 @@ volume_reader_blocked::read(const scm::math::vec3ui& o,
                                 * static_cast<scm::int64>(_dimensions.z)
                                 * static_cast<scm::int64>(size_of_format(_format));
 
-        if (_file->read(d, _data_start_offset, read_size) != read_size) {
+        if (volume_data_mapped()) {
+            memcpy(d, mapped_volume_data(), static_cast<size_t>(read_size));
+        }
+        else if (_file->read(d, _data_start_offset, read_size) != read_size) {
             return false;
         }
     }
-#if 1
-    else if (o.x == 0 && s.x == _dimensions.x) {
-        // we can read complete sets of lines/traces
-        scm::int64 offset_src;
-        scm::int64 offset_dst;
-
+    else {
+        // read sets of lines using vectored reads, lines close to each other
+        // in the file are coalesced into large read requests by the file core.
+        // if the volume is mapped the lines are copied straight from the mapping
         const int64             data_value_size = static_cast<int64>(size_of_format(_format));
         const vec<int64, 3>     o64(o);
         const vec<int64, 3>     d64(_dimensions);
         const vec<int64, 3>     s64(s);
         const vec3ui            read_dim = clamp(s + o, vec3ui(0u), _dimensions) - o;
-        const int64             dstart = _data_start_offset;
-
-        for (unsigned int s = 0; s < read_dim.z; ++s) {
-            offset_src  =   o64.x
-                         +  o64.y      * d64.x
-                         + (o64.z + s) * d64.x * d64.y;
-            offset_src *= data_value_size;
-
-            offset_dst  = s64.x * s64.y * s;
-            offset_dst *= data_value_size;
+        const int64             line_size_raw = data_value_size * read_dim.x;
 
-            char* dst_data = reinterpret_cast<char*>(d) + offset_dst;
+        // complete slices are contiguous in source and destination
+        const bool              read_slices = (o.x == 0 && s.x == _dimensions.x);
+        const char*             mapped_data = reinterpret_cast<const char*>(mapped_volume_data());
 
-            scm::int64 read_off      = dstart + offset_src;
-            scm::int64 line_size_raw = data_value_size * read_dim.x;
-            scm::int64 read_size     = line_size_raw   * read_dim.y;
-
-            if (_file->read(dst_data, read_off, read_size) != read_size) {
-                return false;
-            }
-        }
-    }
-    else if (o.x == 0 && s.x > _dimensions.x) {
+        io::file_span_vector    read_spans;
+        io::file::size_type     read_spans_size = 0;
 
-#else
-    else if (o.x == 0 && s.x >= _dimensions.x) {
-#endif
-        // we can read complete sets of lines/traces
-        scm::int64 offset_src;
-        scm::int64 offset_dst;
-
-        const int64             data_value_size = static_cast<int64>(size_of_format(_format));
-        const vec<int64, 3>     o64(o);
-        const vec<int64, 3>     d64(_dimensions);
-        const vec<int64, 3>     s64(s);
-        const vec3ui            read_dim = clamp(s + o, vec3ui(0u), _dimensions) - o;
-        const int64             dstart = _data_start_offset;
+        read_spans.reserve(math::min<size_t>(max_read_spans_per_batch,
+                                             read_slices ? read_dim.z : read_dim.y * read_dim.z));
 
         for (unsigned int s = 0; s < read_dim.z; ++s) {
-            offset_src =   o64.x
-                        +  o64.y      * d64.x
-                        + (o64.z + s) * d64.x * d64.y;
-            offset_src *= data_value_size;
-
-            scm::int64 read_off      = dstart + offset_src;
-            scm::int64 line_size_raw = data_value_size * read_dim.x;
-            scm::int64 read_size     = line_size_raw   * read_dim.y;
-
-            if (_file->read(_slice_buffer.get(), read_off, read_size) != read_size) {
-                return false;
-            }
-            else {
-                for (unsigned i = 0; i < read_dim.y; ++i) {
-                    offset_dst =  s64.x * i
-                                + s64.x * s64.y * s;
-                    offset_dst *= data_value_size;
-
-                    char* dst_data = reinterpret_cast<char*>(d) + offset_dst;
-                    char* src_data = reinterpret_cast<char*>(_slice_buffer.get());
-
-                    memcpy(dst_data, src_data + line_size_raw * i, line_size_raw);
-                }
-            }
-        }
-    }
-    else {
-        // we have to read indivudual lines, should be the slowest
-
-        // read subvolume
-        //if (   (o.x + s.x > _dimensions.x)
-        //    || (o.y + s.y > _dimensions.y)
-        //    || (o.z + s.z > _dimensions.z)) {
-        //    return false;
-        //}
-
-        scm::int64 offset_src;
-        scm::int64 offset_dst;
-
-        const int64             data_value_size = static_cast<int64>(size_of_format(_format));
-        const vec<int64, 3>     offset64(o);
-        const vec<int64, 3>     dimensions64(_dimensions);
-        const vec<int64, 3>     buf_dimensions64(s);
-        const vec3ui            read_dim = clamp(s + o, vec3ui(0u), _dimensions) - o;
-
-        for (unsigned int s = 0; s < read_dim.z; ++s) {
-            for (unsigned int l = 0; l < read_dim.y; ++l) {
-                offset_src =  offset64.x
-                            + dimensions64.x * (offset64.y + l)
-                            + dimensions64.x * dimensions64.y * (offset64.z + s);
+            for (unsigned int l = 0; l < (read_slices ? 1u : read_dim.y); ++l) {
+                scm::int64 offset_src =  o64.x
+                                       + d64.x * (o64.y + l)
+                                       + d64.x * d64.y * (o64.z + s);
                 offset_src *= data_value_size;
 
-                offset_dst =  buf_dimensions64.x * l
-                            + buf_dimensions64.x * buf_dimensions64.y * s;
+                scm::int64 offset_dst =  s64.x * l
+                                       + s64.x * s64.y * s;
                 offset_dst *= data_value_size;
 
                 scm::int64 read_off  = _data_start_offset + offset_src;
-                scm::int64 read_size = data_value_size * read_dim.x;
+                scm::int64 read_size = read_slices ? line_size_raw * read_dim.y : line_size_raw;
+
+                if (mapped_data) {
+                    memcpy(reinterpret_cast<char*>(d) + offset_dst, mapped_data + offset_src, static_cast<size_t>(read_size));
+                    continue;
+                }
 
-                char* dst_data = reinterpret_cast<char*>(d) + offset_dst;
+                read_spans.push_back(io::file_span(read_off, read_size, reinterpret_cast<char*>(d) + offset_dst));
+                read_spans_size += read_size;
 
-                if (_file->read(dst_data, read_off, read_size) != read_size) {
-                    return false;
+                if (read_spans.size() >= max_read_spans_per_batch) {
+                    if (_file->read(read_spans) != read_spans_size) {
+                        return false;
+                    }
+                    read_spans.clear();
+                    read_spans_size = 0;
                 }
             }
         }
+
+        if (!read_spans.empty()) {
+            if (_file->read(read_spans) != read_spans_size) {
+                return false;
+            }
+        }
     }
 
     return true;
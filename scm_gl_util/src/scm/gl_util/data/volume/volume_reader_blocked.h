@@ -7,6 +7,7 @@
 
 #include <scm/core/memory.h>
 #include <scm/core/numeric_types.h>
+#include <scm/core/io/file_mapping.h>
 
 #include <scm/gl_util/data/volume/volume_reader.h>
 
@@ -29,9 +30,20 @@ public:
                              const scm::math::vec3ui& s,
                                    void*              d);
 
+    // memory mapped access to the voxel payload, while mapped all reads are
+    // served directly from the mapping bypassing the file I/O
+    bool                map_volume_data(io::mapping_access_hint h = io::MAPPING_ACCESS_NORMAL);
+    void                unmap_volume_data();
+    bool                volume_data_mapped() const;
+    bool                advise_volume_data(io::mapping_access_hint h) const;
+
+    // const view of the complete voxel payload in the mapping (x fastest, z slowest),
+    // 0 if the volume is not mapped. the pointer is valid until unmap_volume_data() is called
+    const void*         mapped_volume_data() const;
+
 protected:
-    int64               _data_start_offset;
-    shared_array<uint8> _slice_buffer;
+    int64                   _data_start_offset;
+    io::file_mapping_ptr    _file_mapping;
 
 }; // struct volume_reader_blocked
 
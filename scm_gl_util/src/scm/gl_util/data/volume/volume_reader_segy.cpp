@@ -4,62 +4,50 @@
 
 #include "volume_reader_segy.h"
 
+#include <cstring>
 #include <exception>
 #include <stdexcept>
 
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/convenience.hpp>
 
 #include <scm/core/io/file.h>
 #include <scm/core/platform/byte_swap.h>
+#include <scm/core/utilities/thread_pool.h>
 
 #include <scm/gl_core/log.h>
 
 #include <scm/gl_util/data/volume/segy/segy.h>
+#include <scm/gl_util/data/volume/segy/segy_ibm_float.h>
 
 namespace {
 
-inline void
-ibm_to_ieee(float* f)
-{
-    register int fc;
-    register int fmant;
-    register int t;
-
-    fc = *reinterpret_cast<int*>(f);
-    if (fc) {
-        fmant = 0x00ffffff & fc;
-        t = ((0x7f000000 & fc) >> 22) - 130;
-        if (t <= 0) {
-            fc = 0;
-        } else {
-            while (!(fmant & 0x00800000) && t != -1) {
-                --t;
-                fmant <<= 1;
-            }
-            if (t > 254) {
-                fc = (0x80000000 & fc) | 0x7f7fffff;
-            }
-            else if (t <= 0) {
-                fc = 0;
-            }
-            else {
-                fc = (0x80000000 & fc) | (t << 23) | (0x007fffff & fmant);
-            }
-        }
-        *f = *reinterpret_cast<float*>(&fc);
-    }
-}
+// upper bound for the number of traces submitted by a single vectored read
+const scm::size_t max_read_spans_per_batch = 65536;
 
-inline
-void
-swap_bytes_array_ibm_to_ieee(float* d, float* s, scm::size_t c)
+// minimum number of traces decoded by a single conversion task
+const scm::size_t min_traces_per_conversion_task = 256;
+
+// conversion threads shared by all readers created without a thread pool, the pool is
+// released together with the last reader using it
+scm::shared_ptr<scm::thread_pool>
+shared_conversion_threads()
 {
-    for (scm::size_t i = 0; i < c; ++i) {
-        scm::do_swap_bytes<float, sizeof(float)>()(d + i, s + i);
-        ibm_to_ieee(d + i);
+    static boost::mutex                         pool_mutex;
+    static scm::weak_ptr<scm::thread_pool>      pool;
+
+    boost::mutex::scoped_lock           lock(pool_mutex);
+    scm::shared_ptr<scm::thread_pool>   threads = pool.lock();
+
+    if (!threads) {
+        threads.reset(new scm::thread_pool());
+        pool = threads;
     }
+
+    return threads;
 }
 
 } // namespace
@@ -68,8 +56,9 @@ swap_bytes_array_ibm_to_ieee(float* d, float* s, scm::size_t c)
 namespace scm {
 namespace gl {
 
-volume_reader_segy::volume_reader_segy(const std::string& file_path,
-                                             bool         file_unbuffered)
+volume_reader_segy::volume_reader_segy(const std::string&              file_path,
+                                             bool                      file_unbuffered,
+                                       const shared_ptr<thread_pool>&  conversion_threads)
   : volume_reader(file_path, file_unbuffered)
 {
     using namespace boost::filesystem;
@@ -90,7 +79,6 @@ volume_reader_segy::volume_reader_segy(const std::string& file_path,
 
     try {
         _segy_data = make_shared<data::segy_data>(_file);
-        _segy_slice_buffer.reset(new uint8[_segy_data->_trace_size * _segy_data->_volume_size.y]);
     }
     catch (std::exception& e) {
         _file.reset();
@@ -104,11 +92,13 @@ volume_reader_segy::volume_reader_segy(const std::string& file_path,
 
     _dimensions = _segy_data->_volume_size;
     _format     = _segy_data->_volume_format;
+
+    _conversion_threads = conversion_threads ? conversion_threads : shared_conversion_threads();
 }
 
 volume_reader_segy::~volume_reader_segy()
 {
-    _segy_slice_buffer.reset();
+    _conversion_threads.reset();
     _segy_data.reset();
 }
 
@@ -125,207 +115,128 @@ volume_reader_segy::read(const scm::math::vec3ui& o,
         return false;
     }
 
-    {
-        // read subvolume
-        //if (   (o.x + s.x > _dimensions.x)
-        //    || (o.y + s.y > _dimensions.y)
-        //    || (o.z + s.z > _dimensions.z)) {
-        //    return false;
-        //}
-#if 1
-        if (o.x == 0 && sz.x >= _dimensions.x) {
-            // we can read complete sets of lines/traces
-            scm::int64 offset_src;
-            scm::int64 offset_dst;
-
-            const int64             data_value_size = static_cast<int64>(size_of_format(_format));
-            const vec<int64, 3>     o64(o);
-            const vec<int64, 3>     d64(_dimensions);
-            const vec<int64, 3>     s64(sz);
-            const vec3ui            read_dim = clamp(sz + o, vec3ui(0u), _dimensions) - o;
-            const int64             dstart = _segy_data->_traces_start;
-            const int64             thsize = sizeof(data::segy_trace_header);
-
-            for (unsigned int s = 0; s < read_dim.z; ++s) {
-                offset_src =   o64.x
-                            +  o64.y      * d64.x
-                            + (o64.z + s) * d64.x * d64.y;
-                offset_src *= data_value_size;
-                offset_src += thsize * (o64.y + d64.y * (o64.z + s)); // consider the trace headers
-
-                scm::int64 read_off      = dstart + offset_src;
-                scm::int64 line_size_raw = data_value_size * read_dim.x;
-                scm::int64 line_size_sgy = line_size_raw + thsize;
-                scm::int64 read_size     = line_size_sgy * read_dim.y;
-
-                if (_file->read(_segy_slice_buffer.get(), read_off, read_size) != read_size) {
-                    return false;
-                }
-                else {
+    // read the sample data of the individual traces directly into the destination
+    // using vectored reads, the trace locations are taken from the trace index.
+    // neighboring traces only separated by their trace headers are coalesced into
+    // large read requests by the file core. samples of missing bins or beyond the
+    // end of short traces are set to zero
+    const data::segy_trace_index&   tindex = *_segy_data->_trace_index;
 
-                    if (_segy_data->_swap_bytes_required) {
-                        switch (size_of_channel(_format)) {
-                            case 1: for (unsigned i = 0; i < read_dim.y; ++i) {
-                                        offset_dst =  s64.x * i
-                                                    + s64.x * s64.y * s;
-                                        offset_dst *= data_value_size;
-
-                                        char* dst_data = reinterpret_cast<char*>(d) + offset_dst;
-                                        char* src_data = reinterpret_cast<char*>(_segy_slice_buffer.get());
-
-                                        swap_bytes_array(reinterpret_cast<uint8*> (dst_data),
-                                                            reinterpret_cast<uint8*> (src_data + line_size_sgy * i + thsize),
-                                                            line_size_raw / sizeof(uint8));
-                                    }
-                                    break;
-                            case 2: for (unsigned i = 0; i < read_dim.y; ++i) {
-                                        offset_dst =  s64.x * i
-                                                    + s64.x * s64.y * s;
-                                        offset_dst *= data_value_size;
-
-                                        char* dst_data = reinterpret_cast<char*>(d) + offset_dst;
-                                        char* src_data = reinterpret_cast<char*>(_segy_slice_buffer.get());
-
-                                        swap_bytes_array(reinterpret_cast<uint16*> (dst_data),
-                                                            reinterpret_cast<uint16*> (src_data + line_size_sgy * i + thsize),
-                                                            line_size_raw / sizeof(uint16));
-                                    }
-                                    break;
-                            case 4: for (unsigned i = 0; i < read_dim.y; ++i) {
-                                        offset_dst =  s64.x * i
-                                                    + s64.x * s64.y * s;
-                                        offset_dst *= data_value_size;
-
-                                        char* dst_data = reinterpret_cast<char*>(d) + offset_dst;
-                                        char* src_data = reinterpret_cast<char*>(_segy_slice_buffer.get());
-
-                                        if (_segy_data->_trace_format == data::segy_data::SEGY_FORMAT_IBM) {
-                                            swap_bytes_array_ibm_to_ieee(reinterpret_cast<float*>(dst_data),
-                                                                            reinterpret_cast<float*>(src_data + line_size_sgy * i + thsize),
-                                                                            line_size_raw / sizeof(float));
-                                        }
-                                        else {
-                                            swap_bytes_array(reinterpret_cast<uint32*> (dst_data),
-                                                                reinterpret_cast<uint32*> (src_data + line_size_sgy * i + thsize),
-                                                                line_size_raw / sizeof(uint32));
-                                        }
-                                    }
-                                    break;
-                            case 8: for (unsigned i = 0; i < read_dim.y; ++i) {
-                                        offset_dst =  s64.x * i
-                                                    + s64.x * s64.y * s;
-                                        offset_dst *= data_value_size;
-
-                                        char* dst_data = reinterpret_cast<char*>(d) + offset_dst;
-                                        char* src_data = reinterpret_cast<char*>(_segy_slice_buffer.get());
-
-                                        swap_bytes_array(reinterpret_cast<uint64*> (dst_data),
-                                                            reinterpret_cast<uint64*> (src_data + line_size_sgy * i + thsize),
-                                                            line_size_raw / sizeof(uint64));
-                                    }
-                                    break;
-                        default:
-                            return false;
-                        }
-                    }
-                    else {
-                        for (unsigned i = 0; i < read_dim.y; ++i) {
-                            offset_dst =  s64.x * i
-                                        + s64.x * s64.y * s;
-                            offset_dst *= data_value_size;
-
-                            char* dst_data = reinterpret_cast<char*>(d) + offset_dst;
-                            char* src_data = reinterpret_cast<char*>(_segy_slice_buffer.get());
-
-                            memcpy(dst_data, src_data + line_size_sgy * i + thsize, line_size_raw);
-                        }
-                    }
-                }
+    const int64             data_value_size = static_cast<int64>(size_of_format(_format));
+    const vec<int64, 3>     s64(sz);
+    const vec3ui            read_dim = clamp(sz + o, vec3ui(0u), _dimensions) - o;
+    const size_t            conversion_grain = math::max<size_t>(min_traces_per_conversion_task, read_dim.y);
+
+    io::file_span_vector    read_spans;
+    io::file::size_type     read_spans_size = 0;
+
+    read_spans.reserve(math::min<size_t>(max_read_spans_per_batch, read_dim.y * read_dim.z));
+
+    for (unsigned int s = 0; s < read_dim.z; ++s) {
+        for (unsigned int l = 0; l < read_dim.y; ++l) {
+            const data::segy_trace_index::entry_type  e = tindex.entry(o.y + l, o.z + s);
+
+            scm::int64 offset_dst =  s64.x * l
+                                   + s64.x * s64.y * s;
+            offset_dst *= data_value_size;
+
+            char*const      line_dst     = reinterpret_cast<char*>(d) + offset_dst;
+            const unsigned  line_samples = data::segy_trace_index::entry_samples(e);
+            const unsigned  read_samples = (e == data::segy_trace_index::invalid_entry || line_samples <= o.x)
+                                         ? 0u : math::min(read_dim.x, line_samples - o.x);
+            const int64     read_size    = data_value_size * read_samples;
+
+            if (read_samples < read_dim.x) {
+                std::memset(line_dst + read_size, 0, static_cast<size_t>(data_value_size * (read_dim.x - read_samples)));
             }
-        }
-        else
-#endif
-        {
-            // we have to read indivudual lines, should be the slowest
-            scm::int64 offset_src;
-            scm::int64 offset_dst;
-
-            const int64             data_value_size = static_cast<int64>(size_of_format(_format));
-            const vec<int64, 3>     o64(o);
-            const vec<int64, 3>     d64(_dimensions);
-            const vec<int64, 3>     s64(sz);
-            const vec3ui            read_dim = clamp(sz + o, vec3ui(0u), _dimensions) - o;
-            const int64             dstart = _segy_data->_traces_start;
-            const int64             thsize = sizeof(data::segy_trace_header);
-
-            for (unsigned int s = 0; s < read_dim.z; ++s) {
-                for (unsigned int l = 0; l < read_dim.y; ++l) {
-                    offset_src =  o64.x
-                                + d64.x * (o64.y + l)
-                                + d64.x * d64.y * (o64.z + s);
-                    offset_src *= data_value_size;
-                    offset_src += thsize * ((o64.y + l) + d64.y * (o64.z + s)); // consider the trace headers
-
-                    offset_dst =  s64.x * l
-                                + s64.x * s64.y * s;
-                    offset_dst *= data_value_size;
-
-                    scm::int64 read_off  = dstart + offset_src;
-                    scm::int64 read_size = data_value_size * read_dim.x + thsize;
-
-
-                    if (_file->read(_segy_slice_buffer.get(), read_off, read_size) != read_size) {
-                        return false;
-                    }
-                    else {
-                        char* dst_data = reinterpret_cast<char*>(d) + offset_dst;
-                        char* src_data = reinterpret_cast<char*>(_segy_slice_buffer.get()) + thsize;
-
-                        if (_segy_data->_swap_bytes_required) {
-                            switch (size_of_channel(_format)) {
-                                case 1: 
-                                    swap_bytes_array(reinterpret_cast<uint8*>(dst_data),
-                                                     reinterpret_cast<uint8*>(src_data),
-                                                     (read_size - thsize) / sizeof(uint8));
-                                    break;
-                                case 2:
-                                    swap_bytes_array(reinterpret_cast<uint16*>(dst_data),
-                                                     reinterpret_cast<uint16*>(src_data),
-                                                     (read_size - thsize) / sizeof(uint16));
-                                    break;
-                                case 4:
-                                    if (_segy_data->_trace_format == data::segy_data::SEGY_FORMAT_IBM) {
-                                        swap_bytes_array_ibm_to_ieee(reinterpret_cast<float*>(dst_data),
-                                                                     reinterpret_cast<float*>(src_data),
-                                                                     (read_size - thsize) / sizeof(float));
-                                    }
-                                    else {
-                                        swap_bytes_array(reinterpret_cast<uint32*>(dst_data),
-                                                         reinterpret_cast<uint32*>(src_data),
-                                                         (read_size - thsize) / sizeof(uint32));
-                                    }
-                                    break;
-                                case 8:
-                                    swap_bytes_array(reinterpret_cast<uint64*>(dst_data),
-                                                     reinterpret_cast<uint64*>(src_data),
-                                                     (read_size - thsize) / sizeof(uint64));
-                                    break;
-                            default:
-                                return false;
-                            }
-                        }
-                        else {
-                            memcpy(dst_data, src_data, read_size - thsize);
-                        }
-                    }
+            if (read_samples == 0) {
+                continue;
+            }
+
+            const int64     offset_src   =  data::segy_trace_index::entry_data_offset(e)
+                                          + data_value_size * o.x;
+
+            read_spans.push_back(io::file_span(offset_src, read_size, line_dst));
+            read_spans_size += read_size;
+
+            if (read_spans.size() >= max_read_spans_per_batch) {
+                if (   _file->read(read_spans) != read_spans_size
+                    || !convert_trace_samples(read_spans, conversion_grain)) {
+                    return false;
                 }
+                read_spans.clear();
+                read_spans_size = 0;
             }
         }
     }
 
+    if (!read_spans.empty()) {
+        if (   _file->read(read_spans) != read_spans_size
+            || !convert_trace_samples(read_spans, conversion_grain)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+volume_reader_segy::convert_trace_samples(const io::file_span_vector& spans,
+                                                size_t                grain) const
+{
+    const bool ibm_samples =    size_of_channel(_format) == 4
+                             && _segy_data->_trace_format == data::segy_data::SEGY_FORMAT_IBM;
+
+    if (!ibm_samples && !_segy_data->_swap_bytes_required) {
+        return true;
+    }
+
+    switch (size_of_channel(_format)) {
+        case 1: return true;
+        case 2:
+        case 4:
+        case 8: break;
+        default: return false;
+    }
+
+    // the traces of whole slices are decoded by the individual threads
+    _conversion_threads->parallel_for(spans.size(), grain,
+                                      boost::bind(&volume_reader_segy::convert_trace_range, this,
+                                                  boost::cref(spans), _1, _2));
 
     return true;
 }
 
+void
+volume_reader_segy::convert_trace_range(const io::file_span_vector& spans,
+                                              size_t                begin,
+                                              size_t                end) const
+{
+    const bool  swap_bytes = _segy_data->_swap_bytes_required;
+
+    for (size_t i = begin; i < end; ++i) {
+        void*const      dst_data = spans[i]._buffer;
+        const int64     dst_size = spans[i]._size;
+
+        switch (size_of_channel(_format)) {
+            case 2:
+                swap_bytes_array(reinterpret_cast<uint16*>(dst_data), dst_size / sizeof(uint16));
+                break;
+            case 4:
+                if (_segy_data->_trace_format == data::segy_data::SEGY_FORMAT_IBM) {
+                    data::convert_ibm_to_ieee(reinterpret_cast<float*>(dst_data), dst_data,
+                                              dst_size / sizeof(float), swap_bytes);
+                }
+                else {
+                    swap_bytes_array(reinterpret_cast<uint32*>(dst_data), dst_size / sizeof(uint32));
+                }
+                break;
+            case 8:
+                swap_bytes_array(reinterpret_cast<uint64*>(dst_data), dst_size / sizeof(uint64));
+                break;
+        }
+    }
+}
+
 } // namespace gl
 } // namespace scm
@@ -6,6 +6,11 @@
 #define SCM_GL_UTIL_VOLUME_READER_SEGY_H_INCLUDED
 
 #include <scm/core/memory.h>
+#include <scm/core/io/io_fwd.h>
+
+namespace scm {
+class thread_pool;
+} // namespace scm
 
 #include <scm/gl_util/data/volume/segy/segy_fwd.h>
 #include <scm/gl_util/data/volume/volume_reader.h>
@@ -21,16 +26,27 @@ class __scm_export(gl_util) volume_reader_segy : public volume_reader
 public:
 
 public:
-    volume_reader_segy(const std::string& file_path,
-                             bool         file_unbuffered = false);
+    // the sample conversion runs on conversion_threads, readers created without a
+    // thread pool share one pool
+    volume_reader_segy(const std::string&              file_path,
+                             bool                      file_unbuffered    = false,
+                       const shared_ptr<thread_pool>&  conversion_threads = shared_ptr<thread_pool>());
     virtual ~volume_reader_segy();
 
     bool                read(const scm::math::vec3ui& o,
                              const scm::math::vec3ui& s,
                                    void*              d);
+
+protected:
+    bool                convert_trace_samples(const io::file_span_vector& spans,
+                                                    size_t                grain) const;
+    void                convert_trace_range(const io::file_span_vector& spans,
+                                                  size_t                begin,
+                                                  size_t                end) const;
+
 protected:
     shared_ptr<data::segy_data> _segy_data;
-    shared_array<uint8>         _segy_slice_buffer;
+    shared_ptr<thread_pool>     _conversion_threads;
 
 }; // struct volume_reader_segy
 
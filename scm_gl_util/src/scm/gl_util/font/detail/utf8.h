@@ -0,0 +1,63 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_DETAIL_UTF8_H_INCLUDED
+#define SCM_GL_UTIL_DETAIL_UTF8_H_INCLUDED
+
+#include <string>
+
+#include <scm/core/numeric_types.h>
+
+namespace scm {
+namespace gl {
+namespace detail {
+
+const scm::uint32   utf8_replacement_char = 0xfffdu;
+
+// decodes the code point starting at io_cur and advances io_cur behind it, invalid or truncated
+// sequences, overlong encodings and surrogates decode to the replacement character
+inline
+scm::uint32
+utf8_next_code_point(std::string::const_iterator&       io_cur,
+                     const std::string::const_iterator& in_end)
+{
+    const unsigned char lead = static_cast<unsigned char>(*io_cur++);
+
+    if (lead < 0x80u) {
+        return lead;
+    }
+
+    int         trail_count = 0;
+    scm::uint32 code_point  = 0;
+    scm::uint32 min_value   = 0;
+
+    if      ((lead & 0xe0u) == 0xc0u) { trail_count = 1; code_point = lead & 0x1fu; min_value = 0x80u;    }
+    else if ((lead & 0xf0u) == 0xe0u) { trail_count = 2; code_point = lead & 0x0fu; min_value = 0x800u;   }
+    else if ((lead & 0xf8u) == 0xf0u) { trail_count = 3; code_point = lead & 0x07u; min_value = 0x10000u; }
+    else {
+        return utf8_replacement_char;
+    }
+
+    for (int t = 0; t < trail_count; ++t) {
+        if (   io_cur == in_end
+            || (static_cast<unsigned char>(*io_cur) & 0xc0u) != 0x80u) {
+            return utf8_replacement_char; // the following byte starts the next sequence
+        }
+        code_point = (code_point << 6) | (static_cast<unsigned char>(*io_cur++) & 0x3fu);
+    }
+
+    if (   code_point < min_value
+        || code_point > 0x10ffffu
+        || (code_point >= 0xd800u && code_point <= 0xdfffu)) {
+        return utf8_replacement_char;
+    }
+
+    return code_point;
+}
+
+} // namespace detail
+} // namespace gl
+} // namespace scm
+
+#endif // SCM_GL_UTIL_DETAIL_UTF8_H_INCLUDED
@@ -4,6 +4,10 @@
 
 #include "font_face.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
 #include <exception>
 #include <stdexcept>
@@ -11,6 +15,7 @@
 #include <sstream>
 #include <string>
 
+#include <boost/bind.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/assign/list_of.hpp>
 #include <boost/assign/std/vector.hpp>
@@ -21,6 +26,7 @@
 #include <scm/gl_core/texture_objects.h>
 
 #include <scm/gl_util/font/detail/freetype_types.h>
+#include <scm/gl_util/font/detail/utf8.h>
 
 namespace scm {
 namespace gl {
@@ -171,15 +177,122 @@ available_72dpi_size(const std::string& file_name,
 
 } // namesapce detail
 
+namespace {
+
+// the atlas layers hold a grid of glyphs with the maximal glyph box at least
+const unsigned      atlas_glyph_grid         = 16;
+const unsigned      shelf_height_granularity = 4;
+const std::size_t   max_kerning_pairs        = 1 << 16;
+
+struct ft_glyph_holder {
+    ft_glyph_holder() : _glyph(0) {}
+    ~ft_glyph_holder() { if (_glyph) FT_Done_Glyph(_glyph); }
+
+    FT_Glyph    _glyph;
+}; // struct ft_glyph_holder
+
+// copies a freetype bitmap into a glyph box image (rows bottom to top) at the given offset
+void
+copy_glyph_bitmap(const FT_Bitmap&          bitmap,
+                  int                       bitmap_ycomp,
+                  int                       components,
+                  const scm::math::vec2i&   offset,
+                  const scm::math::vec2i&   box,
+                  std::vector<scm::uint8>&  image)
+{
+    const int rows  = static_cast<int>(bitmap.rows);
+    const int width = static_cast<int>(bitmap.width) / (bitmap.pixel_mode == FT_PIXEL_MODE_LCD ? bitmap_ycomp : 1);
+
+    for (int dy = 0; dy < rows; ++dy) {
+        const int y = offset.y + rows - 1 - dy;
+        if (y < 0 || y >= box.y) {
+            continue;
+        }
+        const unsigned char*const   src_row = bitmap.buffer + dy * bitmap.pitch;
+        scm::uint8*const            dst_row = &image[static_cast<std::size_t>(y) * box.x * components];
+
+        for (int dx = 0; dx < width && offset.x + dx < box.x; ++dx) {
+            scm::uint8*const dst = dst_row + (offset.x + dx) * components;
+
+            switch (bitmap.pixel_mode) {
+                case FT_PIXEL_MODE_GRAY:
+                    dst[0] = src_row[dx];
+                    break;
+                case FT_PIXEL_MODE_LCD:
+                    for (int l = 0; l < components && l < bitmap_ycomp; ++l) {
+                        dst[l] = src_row[dx * bitmap_ycomp + l];
+                    }
+                    break;
+                case FT_PIXEL_MODE_MONO:
+                    for (int l = 0; l < components; ++l) {
+                        dst[l] = (src_row[dx >> 3] & (0x80 >> (dx & 7))) ? 255u : 0u;
+                    }
+                    break;
+                default:
+                    return;
+            }
+        }
+    }
+}
+
+// copies a glyph box image into the lower left corner of a cleared slot image
+void
+copy_glyph_image(const std::vector<scm::uint8>& glyph_image,
+                 const scm::math::vec2ui&       box,
+                 const scm::math::vec2ui&       slot,
+                 std::size_t                    components,
+                 std::vector<scm::uint8>&       slot_image)
+{
+    std::fill(slot_image.begin(), slot_image.end(), 0u);
+
+    if (glyph_image.empty()) {
+        return;
+    }
+    for (unsigned y = 0; y < box.y; ++y) {
+        std::memcpy(&slot_image[y * slot.x * components], &glyph_image[y * box.x * components], box.x * components);
+    }
+}
+
+// first free span fitting in_width, out_span is the span count for the space behind the glyphs
+bool
+find_shelf_span(const std::vector<scm::math::vec2ui>&   free_spans,
+                unsigned                                shelf_end,
+                unsigned                                in_width,
+                unsigned                                atlas_width,
+                std::size_t&                            out_span)
+{
+    for (std::size_t f = 0; f < free_spans.size(); ++f) {
+        if (in_width <= free_spans[f].y) {
+            out_span = f;
+            return (true);
+        }
+    }
+    if (shelf_end + in_width <= atlas_width) {
+        out_span = free_spans.size();
+        return (true);
+    }
+    return (false);
+}
+
+} // namespace
+
 font_face::font_face(const render_device_ptr& device,
                      const std::string&       font_file,
                      unsigned                 point_size,
                      float                    border_size,
                      smooth_type              smooth_type,
                      unsigned                 display_dpi)
-  : _font_styles(style_count)
+  : _ft_load_flags(FT_LOAD_DEFAULT)
+  , _ft_render_mode(FT_RENDER_MODE_NORMAL)
+  , _ft_bitmap_ycomp(1)
+  , _font_styles(style_count)
   , _font_styles_available(style_count)
   , _font_smooth_style(smooth_type)
+  , _glyph_format(FORMAT_NULL)
+  , _atlas_size(0u, 0u)
+  , _atlas_generation(0)
+  , _render_device(device)
+  , _running(false)
   , _point_size(point_size)
   , _border_size(static_cast<unsigned>(math::floor(border_size * 64.0f)))
   , _dpi(display_dpi)
@@ -188,9 +301,6 @@ font_face::font_face(const render_device_ptr& device,
     using namespace scm::math;
 
     try {
-
-        detail::ft_library  ft_lib;
-
         if (!detail::check_file(font_file)) {
             std::ostringstream s;
             s << "font_face::font_face(): "
@@ -213,25 +323,39 @@ font_face::font_face(const render_device_ptr& device,
         std::vector<std::string>    font_style_files;
         detail::find_font_style_files(font_file, font_style_files);
 
+        // the library and faces are kept for rasterizing glyphs on demand
+        _ft_library.reset(new detail::ft_library());
+
+        switch (smooth_type) {
+            case smooth_normal: _ft_render_mode  = FT_RENDER_MODE_NORMAL; //FT_RENDER_MODE_LIGHT; //
+                                _ft_load_flags   = FT_LOAD_DEFAULT; //FT_LOAD_FORCE_AUTOHINT | FT_LOAD_TARGET_LIGHT; //
+                                _glyph_format    = FORMAT_RG_8;
+                                break;
+            case smooth_lcd:    _ft_bitmap_ycomp = 3;
+                                _ft_render_mode  = FT_RENDER_MODE_LCD;
+                                _ft_load_flags   = FT_LOAD_TARGET_LCD;//FT_LOAD_FORCE_AUTOHINT | FT_LOAD_TARGET_LIGHT;
+                                _glyph_format    = FORMAT_RGB_8;
+                                FT_Library_SetLcdFilter(_ft_library->get_lib(), FT_LCD_FILTER_LIGHT);
+                                break;
+            default:
+                std::ostringstream s;
+                s << "font_face::font_face(): unsupported smoothing style.";
+                throw(std::runtime_error(s.str()));
+        }
+
         // fill font styles
         math::vec2ui max_glyph_size(0u, 0u); // to store the maximal glyph size over all styles
+        _ft_faces.resize(style_count);
         for (int i = 0; i < style_count; ++i) {
             _font_styles_available[i] = !font_style_files[i].empty();
 
             std::string         cur_font_file = _font_styles_available[i] ? font_style_files[i] : font_style_files[0];
-            detail::ft_face     ft_font(ft_lib, cur_font_file);
+            _ft_faces[i].reset(new detail::ft_face(*_ft_library, cur_font_file));
 
+            detail::ft_face&    ft_font = *_ft_faces[i];
             ft_font.set_size(font_size, display_dpi);
 
-            // calculate kerning information
-            _font_styles[i]._kerning_table.resize(boost::extents[max_char][max_char]);
-            for (unsigned l = min_char; l < max_char; ++l) {
-                for (unsigned r = min_char; r < max_char; ++r) {
-                    //if (l == 'T' && r == 'e')
-                    //    std::cout << "kerning: " << int(ft_font.get_kerning(l, r)) << std::endl;
-                    _font_styles[i]._kerning_table[l][r] = ft_font.get_kerning(l, r);
-                }
-            }
+            _font_styles[i]._shelves_end = 0;
 
             // retrieve the maximal bounding box of all glyphs in the face
             vec2f  font_bbox_x;
@@ -250,8 +374,6 @@ font_face::font_face(const render_device_ptr& device,
                 _font_styles[i]._line_spacing        = static_cast<unsigned>(ceil(ft_font.get_face()->height * y_scale));
                 _font_styles[i]._underline_position  = static_cast<int>(round(ft_font.get_face()->underline_position * y_scale));
                 _font_styles[i]._underline_thickness = static_cast<unsigned>(round(ft_font.get_face()->underline_thickness * y_scale));
-
-
             }
             else if (ft_font.get_face()->face_flags & FT_FACE_FLAG_FIXED_SIZES) {
                 font_bbox_x = vec2f(0.0f, static_cast<float>(ft_font.get_face()->size->metrics.max_advance >> 6));
@@ -272,324 +394,54 @@ font_face::font_face(const render_device_ptr& device,
                                       static_cast<unsigned>(ceil(font_bbox_y.y) - floor(font_bbox_y.x)));
             max_glyph_size.x = max<unsigned>(max_glyph_size.x, font_size.x);
             max_glyph_size.y = max<unsigned>(max_glyph_size.y, font_size.y);
-
         }
         // end fill font styles
 
-        // generate texture image
-        int             glyph_components     = 0;
-        int             glyph_bitmap_ycomp   = 1;
-        FT_Render_Mode  glyph_render_mode    = FT_RENDER_MODE_NORMAL;
-        unsigned        glyph_load_flags     = FT_LOAD_DEFAULT;
-        data_format     glyph_texture_format = FORMAT_NULL;
-
-        switch (smooth_type) {
-            case smooth_normal: glyph_components     = 2;
-                                glyph_render_mode    = FT_RENDER_MODE_NORMAL; //FT_RENDER_MODE_LIGHT; //
-                                glyph_load_flags     = FT_LOAD_DEFAULT; //FT_LOAD_FORCE_AUTOHINT | FT_LOAD_TARGET_LIGHT; //
-                                glyph_texture_format = FORMAT_RG_8;
-                                break;
-            case smooth_lcd:    glyph_components     = 3;
-                                glyph_bitmap_ycomp   = 3;
-                                glyph_render_mode    = FT_RENDER_MODE_LCD;
-                                glyph_load_flags     = FT_LOAD_TARGET_LCD;//FT_LOAD_FORCE_AUTOHINT | FT_LOAD_TARGET_LIGHT;
-                                glyph_texture_format = FORMAT_RGB_8;
-                                FT_Library_SetLcdFilter(ft_lib.get_lib(), FT_LCD_FILTER_LIGHT);
-                                break;
-            default:
-                std::ostringstream s;
-                s << "font_face::font_face(): unsupported smoothing style.";
-                throw(std::runtime_error(s.str()));
-        }
-
-
-        for (int i = 0; i < style_count; ++i) {
-            _font_styles[i]._glyphs.resize(max_char);
-        }
-
-        //typedef vec<unsigned char, 2> glyph_texel; // 2 components (core, border... TO BE DONE!, currently only first used)
+        // generate the atlas textures, one layer per style, glyphs are added on first use
         max_glyph_size += math::vec2ui(1u) + 2 * (_border_size >> 6); // space of at least one texel around all glyphs
 
-        int                           grid_size = static_cast<int>(ceil(math::sqrt(static_cast<double>(max_char - min_char))));
-        vec3ui                        glyph_texture_dim  = vec3ui(max_glyph_size * grid_size, style_count); // a 16x16 grid of 256 glyphs in 4 layers
-        size_t                        glyph_texture_size = static_cast<size_t>(glyph_texture_dim.x) * glyph_texture_dim.y * glyph_texture_dim.z;
-        scoped_array<unsigned char>   glyph_texture(new unsigned char[glyph_texture_size * glyph_components]);
-
-        if (_border_size > 0) { // border
-            memset(glyph_texture.get(), 0u, glyph_texture_size * glyph_components); // clear to black
-
-            for (int i = 0; i < style_count; ++i) {
-                std::string cur_font_file = _font_styles_available[i] ? font_style_files[i] : font_style_files[0];
-
-                detail::ft_face     ft_font(ft_lib, cur_font_file);
-                ft_font.set_size(font_size, display_dpi);
-                FT_Bitmap           bitmap;
-
-                for (unsigned c = min_char; c < max_char; ++c) {
-                    glyph_info& cur_glyph = _font_styles[i]._glyphs[c];
-                    FT_Glyph    ft_glyph;
-
-                    ft_font.load_glyph(c, glyph_load_flags);
-                    {
-                        detail::ft_stroker stroker(ft_lib, _border_size);
-                        FT_Error ft_err;
-
-                        ft_err = FT_Get_Glyph(ft_font.get_glyph(), &ft_glyph);
-                        if (ft_err) {
-                            throw std::runtime_error("font_face::font_face(): error during FT_Get_Glyph");
-                        }
-                        ft_err = FT_Glyph_Stroke(&ft_glyph, stroker.get_stroker(), true);
-                        if (ft_err) {
-                            throw std::runtime_error("font_face::font_face(): error during FT_Glyph_Stroke");
-                        }
-                        ft_err = FT_Glyph_To_Bitmap(&ft_glyph, glyph_render_mode, 0, true);
-                        if (ft_err) {
-                            throw std::runtime_error("font_face::font_face(): error during FT_Glyph_To_Bitmap");
-                        }
-                        FT_BitmapGlyph ft_bitmap_glyph = (FT_BitmapGlyph)ft_glyph;
-                        bitmap = ft_bitmap_glyph->bitmap;
-                    }
-
-                    // calculate the glyphs grid position in the font texture array
-                    vec3ui tex_array_dst;
-                    tex_array_dst.x = ((c - min_char) % grid_size) * max_glyph_size.x;
-                    tex_array_dst.y = glyph_texture_dim.y - (((c - min_char) / grid_size) + 1) * max_glyph_size.y;
-                    //tex_array_dst.x = (c & 0x0F) * max_glyph_size.x;
-                    //tex_array_dst.y = glyph_texture_dim.y - ((c >> 4) + 1) * max_glyph_size.y;
-                    tex_array_dst.z = i;
-
-                    FT_BitmapGlyph ft_bitmap_glyph = (FT_BitmapGlyph)ft_glyph;
-                    cur_glyph._box_size         = vec2i(bitmap.width / glyph_bitmap_ycomp, bitmap.rows);
-                    cur_glyph._border_bearing   = vec2i(ft_bitmap_glyph->left, ft_bitmap_glyph->top - ft_bitmap_glyph->bitmap.rows);
-                    cur_glyph._texture_origin   = vec2f(static_cast<float>(tex_array_dst.x) / glyph_texture_dim.x,
-                                                        static_cast<float>(tex_array_dst.y) / glyph_texture_dim.y);
-                    cur_glyph._texture_box_size = vec2f(static_cast<float>(cur_glyph._box_size.x) / glyph_texture_dim.x,
-                                                        static_cast<float>(cur_glyph._box_size.y) / glyph_texture_dim.y);
-
-                    if (ft_font.get_face()->face_flags & FT_FACE_FLAG_SCALABLE) {
-                        // linearHoriAdvance contains the 16.16 representation of the horizontal advance
-                        // horiAdvance contains only the rounded advance which can be off by 1 and
-                        // lead to sub styles beeing rendered to narrow
-                        cur_glyph._advance          =  FT_CeilFix(ft_font.get_face()->glyph->linearHoriAdvance) >> 16;
-                    }
-                    else if (ft_font.get_face()->face_flags & FT_FACE_FLAG_FIXED_SIZES) {
-                        cur_glyph._advance          = ft_font.get_face()->glyph->metrics.horiAdvance >> 6;
-                    }
-                    cur_glyph._bearing          = vec2i(   ft_font.get_face()->glyph->metrics.horiBearingX >> 6,
-                                                          (ft_font.get_face()->glyph->metrics.horiBearingY >> 6)
-                                                        - (ft_font.get_face()->glyph->metrics.height >> 6));
-                    FT_Face ff = ft_font.get_face();
-                    int ksks = ft_font.get_face()->glyph->lsb_delta;
-                    int ksds = ft_font.get_face()->glyph->rsb_delta;
-
-                    // fill texture
-                    switch (bitmap.pixel_mode) {
-                        case FT_PIXEL_MODE_GRAY:
-                            for (int dy = 0; dy < bitmap.rows; ++dy) {
-                                unsigned src_off = dy * bitmap.pitch;
-                                unsigned dst_off =    tex_array_dst.x
-                                                   + (tex_array_dst.y + bitmap.rows - 1 - dy) * glyph_texture_dim.x
-                                                   + i * (glyph_texture_dim.x * glyph_texture_dim.y);
-                                for (int dx = 0; dx < bitmap.width; ++dx) {
-                                    glyph_texture[(dst_off + dx) * glyph_components] = bitmap.buffer[src_off + dx];
-                                }
-                            }
-                            break;
-                        case FT_PIXEL_MODE_LCD:
-                            for (int dy = 0; dy < bitmap.rows; ++dy) {
-                                unsigned src_off = dy * bitmap.pitch;
-                                unsigned dst_off =    tex_array_dst.x
-                                                   + (tex_array_dst.y + bitmap.rows - 1 - dy) * glyph_texture_dim.x
-                                                   + i * (glyph_texture_dim.x * glyph_texture_dim.y);
-                                for (int dx = 0; dx < bitmap.width / glyph_bitmap_ycomp; ++dx) {
-                                    glyph_texture[(dst_off + dx) * glyph_components    ] = bitmap.buffer[src_off + dx * glyph_bitmap_ycomp];
-                                    glyph_texture[(dst_off + dx) * glyph_components + 1] = bitmap.buffer[src_off + dx * glyph_bitmap_ycomp + 1];
-                                    glyph_texture[(dst_off + dx) * glyph_components + 2] = bitmap.buffer[src_off + dx * glyph_bitmap_ycomp + 2];
-                                }
-                            }
-                            break;
-                        case FT_PIXEL_MODE_MONO:
-                            for (int dy = 0; dy < bitmap.rows; ++dy) {
-                                for (int dx = 0; dx < bitmap.pitch; ++dx) {
-                                    unsigned        src_off     = dx + dy * bitmap.pitch;
-                                    unsigned char   src_byte    = bitmap.buffer[src_off];
-                                    for (int bx = 0; bx < 8; ++bx) {
-                                        unsigned        dst_off =   (tex_array_dst.x + dx * 8 + bx)
-                                                                  + (tex_array_dst.y + bitmap.rows - 1 - dy) * glyph_texture_dim.x
-                                                                  + i * (glyph_texture_dim.x * glyph_texture_dim.y);
-                                        unsigned char   src_set = src_byte & (0x80 >> bx);
-                                        unsigned char*  plah    = &src_byte;
-                                        for (int l = 0; l < glyph_components; ++l) {
-                                            glyph_texture[dst_off * glyph_components + l] = src_set ? 255u : 0u;
-                                        }
-                                    }
-                                }
-                            }
-                            break;
-                        default:
-                            continue;
-                    }
-                    FT_Done_Glyph(ft_glyph);
-                }
-            }
-            // end generate texture image
-            std::vector<void*> image_array_data_raw;
-            image_array_data_raw.push_back(glyph_texture.get());
+        const unsigned max_atlas_size = static_cast<unsigned>(device->capabilities()._max_texture_size);
+        _atlas_size = vec2ui(min(max_glyph_size.x * atlas_glyph_grid, max_atlas_size),
+                             min(max_glyph_size.y * atlas_glyph_grid, max_atlas_size));
 
-            _font_styles_border_texture_array = device->create_texture_2d(vec2ui(glyph_texture_dim.x, glyph_texture_dim.y),
-                                                                   glyph_texture_format, 1, glyph_texture_dim.z, 1,
-                                                                   glyph_texture_format, image_array_data_raw);
+        vec3ui                  atlas_dim    = vec3ui(_atlas_size, style_count);
+        const size_t            atlas_bytes  =   static_cast<size_t>(atlas_dim.x) * atlas_dim.y * atlas_dim.z
+                                               * size_of_format(_glyph_format);
+        std::vector<uint8>      atlas_data(atlas_bytes, 0u); // clear to black
+        std::vector<void*>      image_array_data_raw;
+        image_array_data_raw.push_back(&atlas_data.front());
 
+        _font_styles_texture_array = device->create_texture_2d(_atlas_size, _glyph_format, 1, atlas_dim.z, 1,
+                                                               _glyph_format, image_array_data_raw);
+        if (!_font_styles_texture_array) {
+            std::ostringstream s;
+            s << "font_face::font_face(): unable to create texture object.";
+            throw(std::runtime_error(s.str()));
+        }
+        if (_border_size > 0) {
+            _font_styles_border_texture_array = device->create_texture_2d(_atlas_size, _glyph_format, 1, atlas_dim.z, 1,
+                                                                          _glyph_format, image_array_data_raw);
             if (!_font_styles_border_texture_array) {
                 std::ostringstream s;
                 s << "font_face::font_face(): unable to create texture object (border).";
                 throw(std::runtime_error(s.str()));
             }
-
-            image_array_data_raw.clear();
-        }
-        // TODO the bearing and box is not wrong!!! FIXME
-        { // core
-            memset(glyph_texture.get(), 0u, glyph_texture_size * glyph_components); // clear to black
-
-            for (int i = 0; i < style_count; ++i) {
-                std::string cur_font_file = _font_styles_available[i] ? font_style_files[i] : font_style_files[0];
-
-                detail::ft_face     ft_font(ft_lib, cur_font_file);
-                ft_font.set_size(font_size, display_dpi);
-                FT_Bitmap           bitmap;
-
-                for (unsigned c = min_char; c < max_char; ++c) {
-                    glyph_info&      cur_glyph = _font_styles[i]._glyphs[c];
-
-                    ft_font.load_glyph(c, glyph_load_flags);
-                    if (FT_Render_Glyph(ft_font.get_glyph(), glyph_render_mode)) {
-                        //glout() << static_cast<char>(c) << " afafaf";
-                        continue;
-                    }
-                    bitmap = ft_font.get_face()->glyph->bitmap;
-
-                    // calculate the glyphs grid position in the font texture array
-                    vec3ui tex_array_dst;
-                    tex_array_dst.x = ((c - min_char) % grid_size) * max_glyph_size.x;
-                    tex_array_dst.y = glyph_texture_dim.y - (((c - min_char) / grid_size) + 1) * max_glyph_size.y;
-                    //tex_array_dst.x = (c & 0x0F) * max_glyph_size.x;
-                    //tex_array_dst.y = glyph_texture_dim.y - ((c >> 4) + 1) * max_glyph_size.y;
-                    tex_array_dst.z = i;
-
-                    vec2i cur_core_box = vec2i(bitmap.width / glyph_bitmap_ycomp, bitmap.rows);
-                    vec2i cur_bm_bearing = vec2i(ft_font.get_face()->glyph->bitmap_left, ft_font.get_face()->glyph->bitmap_top - ft_font.get_face()->glyph->bitmap.rows);
-                    vec2i box_diff = vec2i::zero();
-                    if (_border_size > 0) {
-                        box_diff.x = max(0, cur_bm_bearing.x - cur_glyph._border_bearing.x);
-                        box_diff.y = max(0, cur_bm_bearing.y - cur_glyph._border_bearing.y);
-                    }
-                    cur_glyph._box_size.x = max(cur_glyph._box_size.x, cur_core_box.x);
-                    cur_glyph._box_size.y = max(cur_glyph._box_size.y, cur_core_box.y);
-
-                    cur_glyph._texture_origin   = vec2f(static_cast<float>(tex_array_dst.x) / glyph_texture_dim.x,
-                                                        static_cast<float>(tex_array_dst.y) / glyph_texture_dim.y);
-                    cur_glyph._texture_box_size = vec2f(static_cast<float>(cur_glyph._box_size.x) / glyph_texture_dim.x,
-                                                        static_cast<float>(cur_glyph._box_size.y) / glyph_texture_dim.y);
-
-                    if (ft_font.get_face()->face_flags & FT_FACE_FLAG_SCALABLE) {
-                        // linearHoriAdvance contains the 16.16 representation of the horizontal advance
-                        // horiAdvance contains only the rounded advance which can be off by 1 and
-                        // lead to sub styles beeing rendered to narrow
-                        cur_glyph._advance          =  FT_CeilFix(ft_font.get_face()->glyph->linearHoriAdvance) >> 16;
-                    }
-                    else if (ft_font.get_face()->face_flags & FT_FACE_FLAG_FIXED_SIZES) {
-                        cur_glyph._advance          = ft_font.get_face()->glyph->metrics.horiAdvance >> 6;
-                    }
-                    cur_glyph._bearing          = //vec2i(   ft_font.get_face()->glyph->metrics.horiBearingX >> 6,
-                                                  //        (ft_font.get_face()->glyph->metrics.horiBearingY >> 6)
-                                                  //      - (ft_font.get_face()->glyph->metrics.height >> 6))
-                                                    cur_bm_bearing
-                                                  - box_diff;
-                                                  //+ cur_glyph._border_bearing;
-                    // fill texture
-                    switch (bitmap.pixel_mode) {
-                        case FT_PIXEL_MODE_GRAY:
-                            for (int dy = 0; dy < bitmap.rows; ++dy) {
-                                unsigned src_off = dy * bitmap.pitch;
-                                unsigned dst_off =    tex_array_dst.x + box_diff.x
-                                                   + (tex_array_dst.y + box_diff.y + bitmap.rows - 1 - dy) * glyph_texture_dim.x
-                                                   + i * (glyph_texture_dim.x * glyph_texture_dim.y);
-                                for (int dx = 0; dx < bitmap.width; ++dx) {
-                                    glyph_texture[(dst_off + dx) * glyph_components] = bitmap.buffer[src_off + dx];
-                                }
-                            }
-                            break;
-                        case FT_PIXEL_MODE_LCD:
-                            for (int dy = 0; dy < bitmap.rows; ++dy) {
-                                unsigned src_off = dy * bitmap.pitch;
-                                unsigned dst_off =    tex_array_dst.x + box_diff.x
-                                                   + (tex_array_dst.y + box_diff.y + bitmap.rows - 1 - dy) * glyph_texture_dim.x
-                                                   + i * (glyph_texture_dim.x * glyph_texture_dim.y);
-                                for (int dx = 0; dx < bitmap.width / glyph_bitmap_ycomp; ++dx) {
-                                    glyph_texture[(dst_off + dx) * glyph_components    ] = bitmap.buffer[src_off + dx * glyph_bitmap_ycomp];
-                                    glyph_texture[(dst_off + dx) * glyph_components + 1] = bitmap.buffer[src_off + dx * glyph_bitmap_ycomp + 1];
-                                    glyph_texture[(dst_off + dx) * glyph_components + 2] = bitmap.buffer[src_off + dx * glyph_bitmap_ycomp + 2];
-                                }
-                            }
-                            break;
-                        case FT_PIXEL_MODE_MONO:
-                            for (int dy = 0; dy < bitmap.rows; ++dy) {
-                                for (int dx = 0; dx < bitmap.pitch; ++dx) {
-                                    unsigned        src_off     = dx + dy * bitmap.pitch;
-                                    unsigned char   src_byte    = bitmap.buffer[src_off];
-                                    for (int bx = 0; bx < 8; ++bx) {
-                                        unsigned        dst_off =   (tex_array_dst.x + box_diff.x + dx * 8 + bx)
-                                                                  + (tex_array_dst.y + box_diff.y + bitmap.rows - 1 - dy) * glyph_texture_dim.x
-                                                                  + i * (glyph_texture_dim.x * glyph_texture_dim.y);
-                                        unsigned char   src_set = src_byte & (0x80 >> bx);
-                                        unsigned char*  plah    = &src_byte;
-                                        for (int l = 0; l < glyph_components; ++l) {
-                                            glyph_texture[dst_off * glyph_components + l] = src_set ? 255u : 0u;
-                                        }
-                                    }
-                                }
-                            }
-                            break;
-                        default:
-                            continue;
-                    }
-                }
-            }
-            // end generate texture image
-            std::vector<void*> image_array_data_raw;
-            image_array_data_raw.push_back(glyph_texture.get());
-
-            _font_styles_texture_array = device->create_texture_2d(vec2ui(glyph_texture_dim.x, glyph_texture_dim.y),
-                                                                   glyph_texture_format, 1, glyph_texture_dim.z, 1,
-                                                                   glyph_texture_format, image_array_data_raw);
-
-            if (!_font_styles_texture_array) {
-                std::ostringstream s;
-                s << "font_face::font_face(): unable to create texture object.";
-                throw(std::runtime_error(s.str()));
-            }
-
-            image_array_data_raw.clear();
         }
 
-        glyph_texture.reset();
-
         std::stringstream os;
         os << std::fixed << std::setprecision(2)
            << "font_face::font_face(): " << std::endl
-           << " - created font textures for font '" << font_file << "' "
+           << " - created glyph atlas for font '" << font_file << "' "
            << "(point size: " << point_size << ", border size: " << border_size << ")" << std::endl
-           << "   - style texture:  format " << gl::format_string(glyph_texture_format)
-                << ", size " <<      glyph_texture_dim
-                << ", glyph box " << max_glyph_size
-                << ", memory " <<      static_cast<double>(glyph_texture_dim.x * glyph_texture_dim.y * glyph_texture_dim.z * size_of_format(glyph_texture_format)) / 1024.0 << "KiB";
+           << "   - style atlas:  format " << gl::format_string(_glyph_format)
+                << ", size " <<      atlas_dim
+                << ", max. glyph box " << max_glyph_size
+                << ", memory " <<      static_cast<double>(atlas_bytes) / 1024.0 << "KiB";
         if (_border_size > 0) {
             os << std::endl
-               << "   - border texture: format " << gl::format_string(glyph_texture_format)
-               << ", size " <<      glyph_texture_dim
-               << ", glyph box " << max_glyph_size
-               << ", memory " <<      static_cast<double>(glyph_texture_dim.x * glyph_texture_dim.y * glyph_texture_dim.z * size_of_format(glyph_texture_format)) / 1024.0 << "KiB";
+               << "   - border atlas: format " << gl::format_string(_glyph_format)
+               << ", size " <<      atlas_dim
+               << ", memory " <<      static_cast<double>(atlas_bytes) / 1024.0 << "KiB";
         }
         glout() << log::info << os.str();
 
@@ -607,6 +459,7 @@ font_face::font_face(const render_device_ptr& device,
 
 font_face::~font_face()
 {
+    stop_worker();
     cleanup();
 }
 
@@ -646,10 +499,26 @@ font_face::has_style(style_type s) const
     return (_font_styles_available[s]);
 }
 
-const font_face::glyph_info&
-font_face::glyph(char c, style_type s) const
+font_face::glyph_info
+font_face::glyph(scm::uint32 c, style_type s) const
 {
-    return (_font_styles[s]._glyphs[c]);
+    if (const cached_glyph* g = find_glyph(c, s)) {
+        return (g->_info);
+    }
+
+    if (_running) {
+        request_glyph(c, s);
+        return (glyph_info());
+    }
+
+    // glyphs failing to rasterize are cached as empty glyphs
+    rasterized_glyph    r;
+    rasterize_glyph(c, s, r);
+
+    if (const cached_glyph* g = insert_glyph(r)) {
+        return (g->_info);
+    }
+    return (glyph_info());
 }
 
 unsigned
@@ -659,9 +528,106 @@ font_face::line_advance(style_type s) const
 }
 
 int
-font_face::kerning(char l, char r, style_type s) const
+font_face::kerning(scm::uint32 l, scm::uint32 r, style_type s) const
+{
+    font_style&         fs  = _font_styles[s];
+    const scm::uint64   key = (static_cast<scm::uint64>(l) << 32) | r;
+
+    kerning_map::const_iterator k = fs._kerning.find(key);
+    if (k != fs._kerning.end()) {
+        return (k->second);
+    }
+
+    int kern = 0;
+    {
+        boost::mutex::scoped_lock   lock(_ft_mutex);
+        kern = _ft_faces[s]->get_kerning(l, r);
+    }
+
+    if (fs._kerning.size() >= max_kerning_pairs) {
+        fs._kerning.clear();
+    }
+    fs._kerning.insert(std::make_pair(key, kern));
+
+    return (kern);
+}
+
+void
+font_face::prefetch_glyphs(const std::string& utf8_str, style_type s) const
+{
+    std::string::const_iterator c = utf8_str.begin();
+    while (c != utf8_str.end()) {
+        const scm::uint32 cp = detail::utf8_next_code_point(c, utf8_str.end());
+        if (cp != '\n') {
+            glyph(cp, s);
+        }
+    }
+}
+
+scm::size_t
+font_face::process_pending_glyphs() const
+{
+    rasterized_glyph_vector finished;
+    {
+        boost::mutex::scoped_lock   lock(_request_mutex);
+
+        if (_rasterized.empty()) {
+            return (0);
+        }
+        finished.swap(_rasterized);
+        for (rasterized_glyph_vector::const_iterator r = finished.begin(); r != finished.end(); ++r) {
+            _pending.erase((static_cast<scm::uint64>(r->_style) << 32) | r->_code_point);
+        }
+    }
+
+    scm::size_t uploaded = 0;
+    for (rasterized_glyph_vector::const_iterator r = finished.begin(); r != finished.end(); ++r) {
+        const glyph_map& glyphs = _font_styles[r->_style]._glyphs;
+        if (glyphs.find(r->_code_point) != glyphs.end()) {
+            continue; // rasterized synchronously in the meantime
+        }
+        if (insert_glyph(*r)) {
+            ++uploaded;
+        }
+    }
+
+    if (uploaded > 0) {
+        ++_atlas_generation;
+    }
+
+    return (uploaded);
+}
+
+bool
+font_face::async_rasterization() const
 {
-    return (_font_styles[s]._kerning_table[l][r]);
+    return (_running);
+}
+
+void
+font_face::async_rasterization(bool a)
+{
+    if (a == _running) {
+        return;
+    }
+    if (a) {
+        start_worker();
+    }
+    else {
+        stop_worker();
+    }
+}
+
+scm::uint64
+font_face::atlas_generation() const
+{
+    return (_atlas_generation);
+}
+
+const math::vec2ui&
+font_face::atlas_size() const
+{
+    return (_atlas_size);
 }
 
 int
@@ -676,14 +642,6 @@ font_face::underline_thickness(style_type s) const
     return (_font_styles[s]._underline_thickness);
 }
 
-void
-font_face::cleanup()
-{
-    _font_styles.clear();
-    _font_styles_available.clear();
-    _font_styles_texture_array.reset();
-}
-
 const texture_2d_ptr&
 font_face::styles_texture_array() const
 {
@@ -696,5 +654,454 @@ font_face::styles_border_texture_array() const
     return (_font_styles_border_texture_array);
 }
 
+const font_face::cached_glyph*
+font_face::find_glyph(scm::uint32 c, style_type s) const
+{
+    font_style&         fs = _font_styles[s];
+    glyph_map::iterator g  = fs._glyphs.find(c);
+
+    if (g == fs._glyphs.end()) {
+        return (0);
+    }
+
+    fs._lru.splice(fs._lru.begin(), fs._lru, g->second._lru_entry);
+
+    return (&g->second);
+}
+
+bool
+font_face::rasterize_glyph(scm::uint32 c, style_type s, rasterized_glyph& out_glyph) const
+{
+    using namespace scm::math;
+
+    out_glyph._style      = s;
+    out_glyph._code_point = c;
+    out_glyph._valid      = false;
+    out_glyph._info       = glyph_info();
+    out_glyph._core_image.clear();
+    out_glyph._border_image.clear();
+
+    const int               glyph_components = size_of_format(_glyph_format);
+    const int               bitmap_ycomp     = static_cast<int>(_ft_bitmap_ycomp);
+    const FT_Render_Mode    render_mode      = static_cast<FT_Render_Mode>(_ft_render_mode);
+
+    try {
+        boost::mutex::scoped_lock   lock(_ft_mutex);
+
+        detail::ft_face&    ft_font = *_ft_faces[s];
+        ft_glyph_holder     border_glyph;
+        vec2i               border_box     = vec2i::zero();
+        vec2i               border_bearing = vec2i::zero();
+
+        if (_border_size > 0) {
+            ft_font.load_glyph(c, _ft_load_flags);
+
+            detail::ft_stroker stroker(*_ft_library, _border_size);
+
+            if (FT_Get_Glyph(ft_font.get_glyph(), &border_glyph._glyph)) {
+                throw std::runtime_error("error during FT_Get_Glyph");
+            }
+            if (FT_Glyph_Stroke(&border_glyph._glyph, stroker.get_stroker(), true)) {
+                throw std::runtime_error("error during FT_Glyph_Stroke");
+            }
+            if (FT_Glyph_To_Bitmap(&border_glyph._glyph, render_mode, 0, true)) {
+                throw std::runtime_error("error during FT_Glyph_To_Bitmap");
+            }
+            FT_BitmapGlyph ft_bitmap_glyph = (FT_BitmapGlyph)border_glyph._glyph;
+            border_box     = vec2i(ft_bitmap_glyph->bitmap.width / bitmap_ycomp, ft_bitmap_glyph->bitmap.rows);
+            border_bearing = vec2i(ft_bitmap_glyph->left, ft_bitmap_glyph->top - static_cast<int>(ft_bitmap_glyph->bitmap.rows));
+        }
+
+        ft_font.load_glyph(c, _ft_load_flags);
+        if (FT_Render_Glyph(ft_font.get_glyph(), render_mode)) {
+            throw std::runtime_error("error during FT_Render_Glyph");
+        }
+
+        const FT_GlyphSlot  ft_glyph     = ft_font.get_glyph();
+        const FT_Bitmap&    core_bitmap  = ft_glyph->bitmap;
+        const vec2i         core_box     = vec2i(core_bitmap.width / bitmap_ycomp, core_bitmap.rows);
+        const vec2i         core_bearing = vec2i(ft_glyph->bitmap_left, ft_glyph->bitmap_top - static_cast<int>(core_bitmap.rows));
+        vec2i               box_diff     = vec2i::zero();
+
+        if (_border_size > 0) {
+            box_diff.x = max(0, core_bearing.x - border_bearing.x);
+            box_diff.y = max(0, core_bearing.y - border_bearing.y);
+        }
+
+        glyph_info& cur_glyph = out_glyph._info;
+
+        cur_glyph._box_size       = vec2i(max(border_box.x, core_box.x + box_diff.x),
+                                          max(border_box.y, core_box.y + box_diff.y));
+        cur_glyph._border_bearing = border_bearing;
+        cur_glyph._bearing        = core_bearing - box_diff;
+
+        if (ft_font.get_face()->face_flags & FT_FACE_FLAG_SCALABLE) {
+            // linearHoriAdvance contains the 16.16 representation of the horizontal advance
+            // horiAdvance contains only the rounded advance which can be off by 1 and
+            // lead to sub styles beeing rendered to narrow
+            cur_glyph._advance = FT_CeilFix(ft_glyph->linearHoriAdvance) >> 16;
+        }
+        else if (ft_font.get_face()->face_flags & FT_FACE_FLAG_FIXED_SIZES) {
+            cur_glyph._advance = ft_glyph->metrics.horiAdvance >> 6;
+        }
+
+        const size_t image_size = static_cast<size_t>(cur_glyph._box_size.x) * cur_glyph._box_size.y * glyph_components;
+
+        out_glyph._core_image.resize(image_size, 0u);
+        copy_glyph_bitmap(core_bitmap, bitmap_ycomp, glyph_components, box_diff, cur_glyph._box_size, out_glyph._core_image);
+
+        if (border_glyph._glyph) {
+            out_glyph._border_image.resize(image_size, 0u);
+            copy_glyph_bitmap(((FT_BitmapGlyph)border_glyph._glyph)->bitmap, bitmap_ycomp, glyph_components,
+                              vec2i::zero(), cur_glyph._box_size, out_glyph._border_image);
+        }
+
+        out_glyph._valid = true;
+    }
+    catch (const std::exception& e) {
+        glerr() << log::error
+                << "font_face::rasterize_glyph(): unable to rasterize glyph "
+                << "(font: " << _name << ", code point: " << c << "): " << e.what() << log::end;
+        out_glyph._info = glyph_info();
+        out_glyph._core_image.clear();
+        out_glyph._border_image.clear();
+    }
+
+    return (out_glyph._valid);
+}
+
+const font_face::cached_glyph*
+font_face::insert_glyph(const rasterized_glyph& in_glyph) const
+{
+    using namespace scm::math;
+
+    font_style&     fs = _font_styles[in_glyph._style];
+    cached_glyph    cg;
+
+    cg._info         = in_glyph._info;
+    cg._slot._shelf  = 0;
+    cg._slot._x      = 0;
+    cg._slot._width  = 0;
+
+    if (   in_glyph._valid
+        && 0 < cg._info._box_size.x
+        && 0 < cg._info._box_size.y) {
+        const vec2ui    slot_size = vec2ui(cg._info._box_size) + vec2ui(1u); // one texel space to the neighbors
+
+        bool allocated = allocate_slot(in_glyph._style, slot_size, cg._slot);
+        while (!allocated && evict_glyph(in_glyph._style)) {
+            allocated = allocate_slot(in_glyph._style, slot_size, cg._slot);
+        }
+
+        if (!allocated) {
+            glerr() << log::error
+                    << "font_face::insert_glyph(): glyph does not fit into the atlas "
+                    << "(font: " << _name << ", code point: " << in_glyph._code_point << ", box: " << cg._info._box_size << ")." << log::end;
+            cg._slot._width = 0;
+        }
+        else if (!upload_slot(in_glyph._style, cg._slot, in_glyph)) {
+            release_slot(in_glyph._style, cg._slot);
+            cg._slot._width = 0;
+        }
+
+        if (0 < cg._slot._width) {
+            const atlas_shelf& sh = fs._shelves[cg._slot._shelf];
+            cg._info._texture_origin   = vec2f(static_cast<float>(cg._slot._x) / _atlas_size.x,
+                                               static_cast<float>(sh._y)       / _atlas_size.y);
+            cg._info._texture_box_size = vec2f(static_cast<float>(cg._info._box_size.x) / _atlas_size.x,
+                                               static_cast<float>(cg._info._box_size.y) / _atlas_size.y);
+        }
+        else {
+            // keep the advance for the layout, nothing is drawn
+            cg._info._box_size = vec2i::zero();
+        }
+    }
+
+    fs._lru.push_front(in_glyph._code_point);
+    cg._lru_entry = fs._lru.begin();
+
+    std::pair<glyph_map::iterator, bool> g = fs._glyphs.insert(std::make_pair(in_glyph._code_point, cg));
+    assert(g.second);
+
+    return (&g.first->second);
+}
+
+bool
+font_face::allocate_slot(style_type s, const math::vec2ui& in_size, atlas_slot& out_slot) const
+{
+    font_style& fs = _font_styles[s];
+
+    if (   in_size.x > _atlas_size.x
+        || in_size.y > _atlas_size.y) {
+        return (false);
+    }
+
+    // the first pass only considers shelves not wasting too much height, before falling back
+    // to any high enough shelf a new shelf is opened
+    const unsigned  max_fitting_height = in_size.y + in_size.y / 2;
+
+    for (int pass = 0; pass < 2; ++pass) {
+        int     best_shelf = -1;
+        size_t  best_span  = 0;
+
+        for (size_t i = 0; i < fs._shelves.size(); ++i) {
+            const atlas_shelf& sh = fs._shelves[i];
+
+            if (   sh._height < in_size.y
+                || (0 == pass && sh._height > max_fitting_height)
+                || (0 <= best_shelf && fs._shelves[best_shelf]._height <= sh._height)) {
+                continue;
+            }
+            size_t span = 0;
+            if (find_shelf_span(sh._free_spans, sh._end, in_size.x, _atlas_size.x, span)) {
+                best_shelf = static_cast<int>(i);
+                best_span  = span;
+            }
+        }
+
+        if (0 <= best_shelf) {
+            atlas_shelf& sh = fs._shelves[best_shelf];
+
+            out_slot._shelf = static_cast<unsigned>(best_shelf);
+            out_slot._width = in_size.x;
+            if (best_span < sh._free_spans.size()) {
+                math::vec2ui& f = sh._free_spans[best_span];
+                out_slot._x = f.x;
+                if (f.y == in_size.x) {
+                    sh._free_spans.erase(sh._free_spans.begin() + best_span);
+                }
+                else {
+                    f.x += in_size.x;
+                    f.y -= in_size.x;
+                }
+            }
+            else {
+                out_slot._x = sh._end;
+                sh._end    += in_size.x;
+            }
+            ++sh._glyph_count;
+
+            return (true);
+        }
+
+        if (0 == pass) {
+            const unsigned free_height  = _atlas_size.y - fs._shelves_end;
+            const unsigned shelf_height = math::min(free_height,
+                                                    ((in_size.y + shelf_height_granularity - 1) / shelf_height_granularity) * shelf_height_granularity);
+
+            if (in_size.y <= shelf_height) {
+                atlas_shelf sh;
+                sh._y           = fs._shelves_end;
+                sh._height      = shelf_height;
+                sh._end         = in_size.x;
+                sh._glyph_count = 1;
+
+                fs._shelves.push_back(sh);
+                fs._shelves_end += shelf_height;
+
+                out_slot._shelf = static_cast<unsigned>(fs._shelves.size() - 1);
+                out_slot._x     = 0;
+                out_slot._width = in_size.x;
+
+                return (true);
+            }
+        }
+    }
+
+    return (false);
+}
+
+void
+font_face::release_slot(style_type s, const atlas_slot& in_slot) const
+{
+    font_style&     fs = _font_styles[s];
+    atlas_shelf&    sh = fs._shelves[in_slot._shelf];
+
+    assert(0 < sh._glyph_count);
+
+    if (0 == --sh._glyph_count) {
+        sh._end = 0;
+        sh._free_spans.clear();
+    }
+    else {
+        sh._free_spans.push_back(math::vec2ui(in_slot._x, in_slot._width));
+
+        // give free spans at the end of the shelf back to the shelf
+        bool folded = true;
+        while (folded) {
+            folded = false;
+            for (std::vector<math::vec2ui>::iterator f = sh._free_spans.begin(); f != sh._free_spans.end(); ++f) {
+                if (f->x + f->y == sh._end) {
+                    sh._end = f->x;
+                    sh._free_spans.erase(f);
+                    folded = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    // empty shelves at the top of the atlas release their height
+    while (   !fs._shelves.empty()
+           && 0 == fs._shelves.back()._glyph_count) {
+        fs._shelves_end = fs._shelves.back()._y;
+        fs._shelves.pop_back();
+    }
+}
+
+bool
+font_face::evict_glyph(style_type s) const
+{
+    font_style& fs = _font_styles[s];
+
+    if (fs._lru.empty()) {
+        return (false);
+    }
+
+    glyph_map::iterator g = fs._glyphs.find(fs._lru.back());
+    assert(g != fs._glyphs.end());
+
+    if (0 < g->second._slot._width) {
+        release_slot(s, g->second._slot);
+    }
+    fs._glyphs.erase(g);
+    fs._lru.pop_back();
+
+    ++_atlas_generation;
+
+    return (true);
+}
+
+bool
+font_face::upload_slot(style_type s, const atlas_slot& in_slot, const rasterized_glyph& in_glyph) const
+{
+    using namespace scm::math;
+
+    render_device_ptr device = _render_device.lock();
+    if (!device) {
+        glerr() << log::error
+                << "font_face::upload_slot(): unable to optain render device from weak pointer." << log::end;
+        return (false);
+    }
+
+    const render_context_ptr&   context    = device->main_context();
+    const atlas_shelf&          sh         = _font_styles[s]._shelves[in_slot._shelf];
+    const size_t                components = size_of_format(_glyph_format);
+    const vec2ui                slot_dim   = vec2ui(in_slot._width, sh._height);
+    const vec2ui                box        = vec2ui(in_glyph._info._box_size);
+    const texture_region        region(vec3ui(in_slot._x, sh._y, s), vec3ui(slot_dim, 1u));
+
+    // the whole slot is written to clear the remains of evicted glyphs
+    std::vector<uint8>          slot_image(static_cast<size_t>(slot_dim.x) * slot_dim.y * components);
+
+    const buffer_ptr            restore_unpack_buffer = context->current_unpack_buffer();
+    bool                        upload_success        = true;
+
+    context->bind_unpack_buffer(buffer_ptr());
+
+    copy_glyph_image(in_glyph._core_image, box, slot_dim, components, slot_image);
+    upload_success = context->update_sub_texture(_font_styles_texture_array, region, 0, _glyph_format, &slot_image.front());
+
+    if (_font_styles_border_texture_array) {
+        copy_glyph_image(in_glyph._border_image, box, slot_dim, components, slot_image);
+        upload_success =    context->update_sub_texture(_font_styles_border_texture_array, region, 0, _glyph_format, &slot_image.front())
+                         && upload_success;
+    }
+
+    context->bind_unpack_buffer(restore_unpack_buffer);
+
+    if (!upload_success) {
+        glerr() << log::error
+                << "font_face::upload_slot(): unable to update glyph atlas "
+                << "(font: " << _name << ", code point: " << in_glyph._code_point << ")." << log::end;
+    }
+
+    return (upload_success);
+}
+
+void
+font_face::request_glyph(scm::uint32 c, style_type s) const
+{
+    const scm::uint64   key = (static_cast<scm::uint64>(s) << 32) | c;
+    {
+        boost::mutex::scoped_lock   lock(_request_mutex);
+
+        if (!_pending.insert(key).second) {
+            return;
+        }
+        _requests.push_back(key);
+    }
+    _request_condition.notify_one();
+}
+
+void
+font_face::start_worker()
+{
+    {
+        boost::mutex::scoped_lock   lock(_request_mutex);
+        _running = true;
+    }
+    _thread = boost::thread(boost::bind(&font_face::run_worker, this));
+}
+
+void
+font_face::stop_worker()
+{
+    {
+        boost::mutex::scoped_lock   lock(_request_mutex);
+        _running = false;
+
+        // dropped requests are requested again on their next use
+        for (std::deque<scm::uint64>::const_iterator r = _requests.begin(); r != _requests.end(); ++r) {
+            _pending.erase(*r);
+        }
+        _requests.clear();
+    }
+    _request_condition.notify_all();
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void
+font_face::run_worker()
+{
+    for (;;) {
+        scm::uint64 key = 0;
+        {
+            boost::mutex::scoped_lock   lock(_request_mutex);
+
+            while (_running && _requests.empty()) {
+                _request_condition.wait(lock);
+            }
+            if (!_running) {
+                return;
+            }
+            key = _requests.front();
+            _requests.pop_front();
+        }
+
+        rasterized_glyph    r;
+        rasterize_glyph(static_cast<scm::uint32>(key & 0xffffffffu), static_cast<style_type>(key >> 32), r);
+
+        {
+            boost::mutex::scoped_lock   lock(_request_mutex);
+            _rasterized.push_back(r);
+        }
+    }
+}
+
+void
+font_face::cleanup()
+{
+    _font_styles.clear();
+    _font_styles_available.clear();
+    _font_styles_texture_array.reset();
+    _font_styles_border_texture_array.reset();
+    _ft_faces.clear();
+    _ft_library.reset();
+}
+
 } // namespace gl
 } // namespace scm
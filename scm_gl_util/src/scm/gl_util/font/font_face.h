@@ -6,14 +6,23 @@
 #define SCM_GL_UTIL_FONT_FACE_H_INCLUDED
 
 #include <cstddef>
-#include <map>
+#include <deque>
+#include <list>
 #include <string>
 #include <vector>
 
-#include <boost/multi_array.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 
 #include <scm/core/math.h>
+#include <scm/core/memory.h>
+#include <scm/core/numeric_types.h>
 
+#include <scm/gl_core/data_formats.h>
 #include <scm/gl_core/gl_core_fwd.h>
 
 #include <scm/gl_util/font/font_fwd.h>
@@ -24,7 +33,21 @@
 namespace scm {
 namespace gl {
 
-class __scm_export(gl_util) font_face
+namespace detail {
+class ft_library;
+class ft_face;
+} // namespace detail
+
+// font with a glyph cache per style
+//  - glyphs are addressed by unicode code points, they are rasterized on first use and packed
+//    into one atlas layer per style using shelves (rows of glyphs with similar heights)
+//  - if an atlas layer is full the least recently used glyphs of the style are evicted, every
+//    eviction advances atlas_generation(), glyph information queried before is invalid then
+//  - with asynchronous rasterization missing glyphs are rasterized on a worker thread, glyph()
+//    returns an empty glyph until process_pending_glyphs() uploaded the finished glyph
+//  - glyph(), kerning() and process_pending_glyphs() upload to the atlas textures and have to be
+//    called on the thread of the main context of the device
+class __scm_export(gl_util) font_face : boost::noncopyable
 {
 public:
     typedef enum {
@@ -61,26 +84,61 @@ public:
         }
     }; // struct glyph_info
 
-    static const unsigned       min_char = 32u;
-    static const unsigned       max_char = 128u;
-
     static const unsigned       default_point_size   = 12;
     //static const float          default_border_size  = 0.0f;
     static const unsigned       default_display_dpi  = 72;
     static const smooth_type    default_smooth_style = smooth_normal;
 
 protected:
-    typedef std::vector<glyph_info>     glyph_container;
-    typedef boost::multi_array<char, 2> kerning_table;
+    typedef shared_ptr<detail::ft_library>  ft_library_ptr;
+    typedef shared_ptr<detail::ft_face>     ft_face_ptr;
+
+    // atlas space of a glyph, slots span the full shelf height
+    struct atlas_slot {
+        unsigned        _shelf;
+        unsigned        _x;
+        unsigned        _width;
+    }; // struct atlas_slot
+    struct atlas_shelf {
+        unsigned        _y;
+        unsigned        _height;
+        unsigned        _end;       // first unused texel behind the glyphs of the shelf
+        unsigned        _glyph_count;
+        std::vector<math::vec2ui>   _free_spans;    // (x, width) of evicted slots
+    }; // struct atlas_shelf
+
+    typedef std::list<scm::uint32>      lru_list;   // most recently used first
+    struct cached_glyph {
+        glyph_info          _info;
+        atlas_slot          _slot;
+        lru_list::iterator  _lru_entry;
+    }; // struct cached_glyph
+    typedef boost::unordered_map<scm::uint32, cached_glyph> glyph_map;
+    typedef boost::unordered_map<scm::uint64, int>          kerning_map;
+
     struct font_style {
-        glyph_container _glyphs;
-        kerning_table   _kerning_table;
-        int             _underline_position;
-        unsigned        _underline_thickness;
-        unsigned        _line_spacing;
+        glyph_map                   _glyphs;
+        lru_list                    _lru;
+        kerning_map                 _kerning;
+        std::vector<atlas_shelf>    _shelves;
+        unsigned                    _shelves_end;
+        int                         _underline_position;
+        unsigned                    _underline_thickness;
+        unsigned                    _line_spacing;
     }; // struct style_info
     typedef std::vector<font_style>     style_container;
 
+    // glyph metrics and images of the glyph box, rows bottom to top
+    struct rasterized_glyph {
+        style_type                  _style;
+        scm::uint32                 _code_point;
+        bool                        _valid;
+        glyph_info                  _info;
+        std::vector<scm::uint8>     _core_image;
+        std::vector<scm::uint8>     _border_image;
+    }; // struct rasterized_glyph
+    typedef std::vector<rasterized_glyph>   rasterized_glyph_vector;
+
 public:
     font_face(const render_device_ptr& device,                  
               const std::string&       font_file,
@@ -97,9 +155,22 @@ public:
     smooth_type                     smooth_style() const;
     bool                            has_style(style_type s) const;
 
-    const glyph_info&               glyph(char c, style_type s = style_regular) const;
+    // c is a unicode code point, missing glyphs are rasterized (or requested asynchronously)
+    glyph_info                      glyph(scm::uint32 c, style_type s = style_regular) const;
     unsigned                        line_advance(style_type s = style_regular) const;
-    int                             kerning(char l, char r, style_type s = style_regular) const;
+    int                             kerning(scm::uint32 l, scm::uint32 r, style_type s = style_regular) const;
+
+    // makes the glyphs of a utf-8 string resident (or requests them asynchronously)
+    void                            prefetch_glyphs(const std::string& utf8_str, style_type s = style_regular) const;
+    // uploads the glyphs finished by the worker thread, returns the number of uploaded glyphs
+    scm::size_t                     process_pending_glyphs() const;
+
+    bool                            async_rasterization() const;
+    void                            async_rasterization(bool a);
+
+    // advances whenever cached glyph information became invalid or pending glyphs were uploaded
+    scm::uint64                     atlas_generation() const;
+    const math::vec2ui&             atlas_size() const;
 
     int                             underline_position(style_type s = style_regular) const;
     int                             underline_thickness(style_type s = style_regular) const;
@@ -108,16 +179,49 @@ public:
     const texture_2d_ptr&           styles_border_texture_array() const;
 
 protected:
-    void                            render_glyphs();
+    const cached_glyph*             find_glyph(scm::uint32 c, style_type s) const;
+    bool                            rasterize_glyph(scm::uint32 c, style_type s, rasterized_glyph& out_glyph) const;
+    const cached_glyph*             insert_glyph(const rasterized_glyph& in_glyph) const;
+    bool                            allocate_slot(style_type s, const math::vec2ui& in_size, atlas_slot& out_slot) const;
+    void                            release_slot(style_type s, const atlas_slot& in_slot) const;
+    bool                            evict_glyph(style_type s) const;
+    bool                            upload_slot(style_type s, const atlas_slot& in_slot, const rasterized_glyph& in_glyph) const;
+    void                            request_glyph(scm::uint32 c, style_type s) const;
+
+    void                            start_worker();
+    void                            stop_worker();
+    void                            run_worker();
 
     void                            cleanup();
 
 protected:
-    style_container                 _font_styles;
+    // freetype objects are used by the calling and the worker thread
+    mutable boost::mutex            _ft_mutex;
+    ft_library_ptr                  _ft_library;
+    unsigned                        _ft_load_flags;
+    int                             _ft_render_mode;
+    unsigned                        _ft_bitmap_ycomp;
+    std::vector<ft_face_ptr>        _ft_faces;
+
+    mutable style_container         _font_styles;
     std::vector<bool>               _font_styles_available;
     texture_2d_ptr                  _font_styles_texture_array;
     texture_2d_ptr                  _font_styles_border_texture_array;
     smooth_type                     _font_smooth_style;
+    data_format                     _glyph_format;
+    math::vec2ui                    _atlas_size;
+    mutable scm::uint64             _atlas_generation;
+
+    render_device_wptr              _render_device;
+
+    // asynchronous rasterization, requests are keyed (style << 32) | code point
+    mutable boost::mutex                        _request_mutex;
+    mutable boost::condition_variable           _request_condition;
+    bool                                        _running;
+    mutable std::deque<scm::uint64>             _requests;
+    mutable boost::unordered_set<scm::uint64>   _pending;       // requested or rasterized
+    mutable rasterized_glyph_vector             _rasterized;
+    boost::thread                               _thread;
 
     std::string                     _name;
     unsigned                        _point_size;
@@ -11,6 +11,7 @@
 #include <stdexcept>
 #include <string>
 #include <sstream>
+#include <vector>
 
 #include <boost/assign/list_of.hpp>
 
@@ -22,6 +23,7 @@
 #include <scm/gl_core/buffer_objects/scoped_buffer_map.h>
 
 #include <scm/gl_util/font/font_face.h>
+#include <scm/gl_util/font/detail/utf8.h>
 
 #define GEOM_SHADER_FONT 1
 
@@ -53,6 +55,7 @@ text::text(const render_device_ptr&     device,
   , _text_shadow_color(math::vec4f(0.0f, 0.0f, 0.0f, 1.0f))
   , _text_shadow_offset(math::vec2i(1, -1))
   , _text_bounding_box(math::vec2i(0, 0))
+  , _atlas_generation(0)
   , _indices_count(0)
   , _topology(PRIMITIVE_TRIANGLE_LIST)
   , _glyph_capacity(20)
@@ -202,14 +205,35 @@ text::text_bounding_box() const
     return _text_bounding_box;
 }
 
+void
+text::refresh()
+{
+    _font->process_pending_glyphs();
+
+    if (_atlas_generation != _font->atlas_generation()) {
+        update();
+    }
+}
+
 void
 text::update()
 {
-    if (_glyph_capacity < _text_string.size()) {
+    // glyphs added to the atlas during the update may evict glyphs placed before, the text is
+    // updated again on the next refresh() then
+    _atlas_generation = _font->atlas_generation();
+    _glyph_quads.clear();
+
+    std::vector<scm::uint32>    code_points;
+    code_points.reserve(_text_string.size());
+    for (std::string::const_iterator c = _text_string.begin(); c != _text_string.end();) {
+        code_points.push_back(detail::utf8_next_code_point(c, _text_string.end()));
+    }
+
+    if (_glyph_capacity < code_points.size()) {
         // resize the buffers
         if (render_device_ptr device = _render_device.lock()) {
 #if GEOM_SHADER_FONT == 1
-            _glyph_capacity  = static_cast<int>(_text_string.size() + _text_string.size() / 2); // make it 50% bigger as required currently
+            _glyph_capacity  = static_cast<int>(code_points.size() + code_points.size() / 2); // make it 50% bigger as required currently
 
             int num_vertices = _glyph_capacity; 
             if (!device->resize_buffer(_vertex_buffer, num_vertices * sizeof(vertex))) {
@@ -219,7 +243,7 @@ text::update()
             }
 #else
             _indices_count   = 0;
-            _glyph_capacity  = static_cast<int>(_text_string.size() + _text_string.size() / 2); // make it 50% bigger as required currently
+            _glyph_capacity  = static_cast<int>(code_points.size() + code_points.size() / 2); // make it 50% bigger as required currently
 
             int num_vertices = _glyph_capacity * 4; 
             int num_indices  = _glyph_capacity * 6;
@@ -266,7 +290,7 @@ text::update()
 #if GEOM_SHADER_FONT == 1
         //if (0 < _text_string.size())
         {
-            scoped_buffer_map vb_map(context, _vertex_buffer, 0, _text_string.size() * sizeof(vertex), ACCESS_WRITE_INVALIDATE_BUFFER);
+            scoped_buffer_map vb_map(context, _vertex_buffer, 0, code_points.size() * sizeof(vertex), ACCESS_WRITE_INVALIDATE_BUFFER);
 
             if (!vb_map) {
                 err() << log::error
@@ -276,13 +300,13 @@ text::update()
             vertex*const    vertex_data = reinterpret_cast<vertex*const>(vb_map.data_ptr());
             vec2i           current_pos = vec2i(0, 0);
             int             current_lw  = 0;
-            char            prev_char   = 0;
+            scm::uint32     prev_char   = 0;
 
             _indices_count     = 0;
             _text_bounding_box = vec2i(0, _font->line_advance(_text_style));
-            assert(_text_string.size() < (6 * (std::numeric_limits<unsigned short>::max)()));
+            assert(code_points.size() < (6 * (std::numeric_limits<unsigned short>::max)()));
 
-            std::for_each(_text_string.begin(), _text_string.end(), [&](char cur_char) -> void {
+            std::for_each(code_points.begin(), code_points.end(), [&](scm::uint32 cur_char) -> void {
                 using namespace scm::gl;
                 using namespace scm::math;
 
@@ -294,17 +318,22 @@ text::update()
                     _text_bounding_box.x  = max(current_lw, _text_bounding_box.x);
                     current_lw            = 0;
                 }
-                else if (font_face::min_char <= cur_char && cur_char < font_face::max_char) {
+                else if (0x20u <= cur_char) { // skip control characters
                     const font_face::glyph_info& cur_glyph = _font->glyph(cur_char, _text_style);
                     // kerning
                     if (_text_kerning && prev_char) {
                         current_pos.x += _font->kerning(prev_char, cur_char, _text_style);
                     }
 
-                    vec2f pos  = vec2f(current_pos + cur_glyph._bearing);   
-                    vec2f bbox = vec2f(cur_glyph._box_size);   
-                    vertex_data[_indices_count].pos_bbox = vec4f(pos, bbox.x, bbox.y);
-                    vertex_data[_indices_count].tex_bbox = vec4f(cur_glyph._texture_origin, cur_glyph._texture_box_size.x, cur_glyph._texture_box_size.y);
+                    vec2f       pos  = vec2f(current_pos + cur_glyph._bearing);   
+                    vec2f       bbox = vec2f(cur_glyph._box_size);   
+                    glyph_quad  quad;
+                    quad._position_bbox = vec4f(pos, bbox.x, bbox.y);
+                    quad._texcoord_bbox = vec4f(cur_glyph._texture_origin, cur_glyph._texture_box_size.x, cur_glyph._texture_box_size.y);
+                    _glyph_quads.push_back(quad);
+
+                    vertex_data[_indices_count].pos_bbox = quad._position_bbox;
+                    vertex_data[_indices_count].tex_bbox = quad._texcoord_bbox;
 
                     _indices_count += 1;
                     // advance the position
@@ -324,7 +353,7 @@ text::update()
 #else
         vec2i           current_pos = vec2i(0, 0);
         int             current_lw  = 0;
-        char            prev_char   = 0;
+        scm::uint32     prev_char   = 0;
         //vertex*         vertex_data = static_cast<vertex*>(context->map_buffer_range(_vertex_buffer, 0, 4 * _text_string.size() * sizeof(vertex), ACCESS_WRITE_INVALIDATE_BUFFER));
         vertex*         vertex_data = static_cast<vertex*>(context->map_buffer(_vertex_buffer, ACCESS_WRITE_INVALIDATE_BUFFER));
 
@@ -336,10 +365,10 @@ text::update()
 
         _indices_count     = 0;
         _text_bounding_box = vec2i(0, _font->line_advance(_text_style));
-        assert(_text_string.size() < (6 * (std::numeric_limits<unsigned short>::max)()));
+        assert(code_points.size() < (6 * (std::numeric_limits<unsigned short>::max)()));
         //unsigned short str_size = static_cast<unsigned short>( _text_string.size());
         size_t i = 0;
-        std::for_each(_text_string.begin(), _text_string.end(), [&](char cur_char) -> void {
+        std::for_each(code_points.begin(), code_points.end(), [&](scm::uint32 cur_char) -> void {
         //for (size_t i = 0; i < _text_string.size(); ++i) {
         //    char  cur_char = _text_string[i];
 
@@ -369,6 +398,11 @@ text::update()
                 vertex_data[i * 4 + 2].pos = vec2f(current_pos + cur_glyph._bearing + cur_glyph._box_size);             // 11
                 vertex_data[i * 4 + 3].pos = vec2f(current_pos + cur_glyph._bearing + vec2i(0, cur_glyph._box_size.y)); // 01
 
+                glyph_quad  quad;
+                quad._position_bbox = vec4f(vec2f(current_pos + cur_glyph._bearing), static_cast<float>(cur_glyph._box_size.x), static_cast<float>(cur_glyph._box_size.y));
+                quad._texcoord_bbox = vec4f(cur_glyph._texture_origin, cur_glyph._texture_box_size.x, cur_glyph._texture_box_size.y);
+                _glyph_quads.push_back(quad);
+
                 vertex_data[i * 4    ].tex = cur_glyph._texture_origin;                                              // 00
                 vertex_data[i * 4 + 1].tex = cur_glyph._texture_origin + vec2f(cur_glyph._texture_box_size.x, 0.0f); // 10
                 vertex_data[i * 4 + 2].tex = cur_glyph._texture_origin + cur_glyph._texture_box_size;                // 11
@@ -5,7 +5,10 @@
 #ifndef SCM_GL_UTIL_TEXT_H_INCLUDED
 #define SCM_GL_UTIL_TEXT_H_INCLUDED
 
+#include <vector>
+
 #include <scm/core/math.h>
+#include <scm/core/numeric_types.h>
 
 #include <scm/gl_core/gl_core_fwd.h>
 #include <scm/gl_core/constants.h>
@@ -31,6 +34,7 @@ public:
 
     const font_face_cptr&       font() const;
     const font_face::style_type text_style() const;
+    // utf-8 encoded
     const std::string&          text_string() const;
     void                        text_string(const std::string& str);
     void                        text_string(const std::string& str,
@@ -49,8 +53,18 @@ public:
 
     const math::vec2i&          text_bounding_box() const;
 
+protected:
+    // glyph position and texture coordinate boxes in text space
+    struct glyph_quad {
+        math::vec4f             _position_bbox;
+        math::vec4f             _texcoord_bbox;
+    }; // struct glyph_quad
+    typedef std::vector<glyph_quad> glyph_quad_array;
+
 protected:
     void                        update();
+    // updates the glyphs if the glyph information of the font changed
+    void                        refresh();
 
 protected:
     font_face_cptr              _font;
@@ -64,6 +78,8 @@ protected:
     math::vec2i                 _text_shadow_offset;
 
     math::vec2i                 _text_bounding_box;
+    glyph_quad_array            _glyph_quads;       // copy of the vertex data read by text_batch
+    scm::uint64                 _atlas_generation;  // atlas generation of the font at the last update
 
     int                         _glyph_capacity;
     buffer_ptr                  _vertex_buffer;
@@ -76,6 +92,7 @@ protected:
     render_device_wptr          _render_device;
     render_context_wptr         _render_context;
 
+    friend class text_batch;
     friend class text_renderer;
 }; // class text
 
@@ -0,0 +1,216 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "text_batch.h"
+
+#include <boost/assign/list_of.hpp>
+
+#include <scm/log.h>
+
+#include <scm/gl_core/math.h>
+#include <scm/gl_core/buffer_objects.h>
+#include <scm/gl_core/render_device.h>
+#include <scm/gl_core/buffer_objects/scoped_buffer_map.h>
+
+#include <scm/gl_util/font/font_face.h>
+#include <scm/gl_util/font/text.h>
+
+namespace {
+
+struct vertex {
+    scm::math::vec4f position_bbox;
+    scm::math::vec4f texcoord_bbox;
+    scm::math::vec4f color;
+    scm::math::vec4f outline_color;
+    scm::math::vec4f transform;
+    scm::math::vec4f translation_style;
+};
+
+} // namespace
+
+namespace scm {
+namespace gl {
+
+text_batch::text_batch(const render_device_ptr& device,
+                       const font_face_cptr&    font,
+                       int                      glyph_capacity)
+  : _font(font)
+  , _glyph_capacity(math::max(1, glyph_capacity))
+  , _plain_glyph_count(0)
+  , _outline_glyph_count(0)
+  , _render_device(device)
+{
+    using boost::assign::list_of;
+
+    _vertex_buffer = device->create_buffer(BIND_VERTEX_BUFFER, USAGE_STREAM_DRAW, _glyph_capacity * sizeof(vertex), 0);
+    _vertex_array  = device->create_vertex_array(vertex_format(0, 0, TYPE_VEC4F, sizeof(vertex))
+                                                              (0, 1, TYPE_VEC4F, sizeof(vertex))
+                                                              (0, 2, TYPE_VEC4F, sizeof(vertex))
+                                                              (0, 3, TYPE_VEC4F, sizeof(vertex))
+                                                              (0, 4, TYPE_VEC4F, sizeof(vertex))
+                                                              (0, 5, TYPE_VEC4F, sizeof(vertex)),
+                                                 list_of(_vertex_buffer));
+}
+
+text_batch::~text_batch()
+{
+    _instances.clear();
+    _vertex_array.reset();
+    _vertex_buffer.reset();
+}
+
+const font_face_cptr&
+text_batch::font() const
+{
+    return _font;
+}
+
+bool
+text_batch::add(const text_ptr&    txt,
+                const math::vec2i& pos,
+                draw_mode          mode)
+{
+    return add(txt, math::make_translation(math::vec3f(math::vec2f(pos), 0.0f)), mode);
+}
+
+bool
+text_batch::add(const text_ptr&    txt,
+                const math::mat4f& transform,
+                draw_mode          mode)
+{
+    if (!txt || txt->font() != _font) {
+        err() << log::error
+              << "text_batch::add(): text missing or not using the font of the batch." << log::end;
+        return false;
+    }
+
+    text_instance   i;
+    i._text        = txt;
+    i._transform   = math::vec4f(transform[0], transform[1], transform[4], transform[5]);
+    i._translation = math::vec2f(transform[12], transform[13]);
+    i._mode        = (mode == draw_outlined && !_font->styles_border_texture_array()) ? draw_regular : mode;
+
+    _instances.push_back(i);
+
+    return true;
+}
+
+void
+text_batch::clear()
+{
+    _instances.clear();
+}
+
+bool
+text_batch::empty() const
+{
+    return _instances.empty();
+}
+
+scm::size_t
+text_batch::size() const
+{
+    return _instances.size();
+}
+
+bool
+text_batch::update(const render_context_ptr& context)
+{
+    using namespace scm::math;
+
+    _plain_glyph_count   = 0;
+    _outline_glyph_count = 0;
+
+    // glyphs added to the atlas for one text may evict glyphs of texts refreshed before
+    for (int pass = 0; pass < 2; ++pass) {
+        const scm::uint64 generation = _font->atlas_generation();
+        for (instance_array::const_iterator i = _instances.begin(); i != _instances.end(); ++i) {
+            i->_text->refresh();
+        }
+        if (generation == _font->atlas_generation()) {
+            break;
+        }
+    }
+
+    int shadow_glyph_count  = 0;
+    int regular_glyph_count = 0;
+    for (instance_array::const_iterator i = _instances.begin(); i != _instances.end(); ++i) {
+        const int glyph_count = static_cast<int>(i->_text->_glyph_quads.size());
+        switch (i->_mode) {
+            case draw_shadowed: shadow_glyph_count   += glyph_count;
+                                regular_glyph_count  += glyph_count; break;
+            case draw_regular:  regular_glyph_count  += glyph_count; break;
+            case draw_outlined: _outline_glyph_count += glyph_count; break;
+            default: break;
+        }
+    }
+    _plain_glyph_count = shadow_glyph_count + regular_glyph_count;
+
+    const int glyph_count = _plain_glyph_count + _outline_glyph_count;
+    if (0 == glyph_count) {
+        return false;
+    }
+
+    if (_glyph_capacity < glyph_count) {
+        render_device_ptr device = _render_device.lock();
+        if (!device) {
+            err() << log::error
+                  << "text_batch::update(): unable to optain render device from weak pointer." << log::end;
+            return false;
+        }
+        const int new_capacity = glyph_count + glyph_count / 2; // make it 50% bigger as required currently
+        if (!device->resize_buffer(_vertex_buffer, new_capacity * sizeof(vertex))) {
+            err() << log::error
+                  << "text_batch::update(): unable to resize vertex buffer (size : " << new_capacity * sizeof(vertex) << ")." << log::end;
+            return false;
+        }
+        _glyph_capacity = new_capacity;
+    }
+
+    // the buffer is orphaned every update, draws of the previous update are not waited for
+    scoped_buffer_map vb_map(context, _vertex_buffer, 0, glyph_count * sizeof(vertex), ACCESS_WRITE_INVALIDATE_BUFFER);
+    if (!vb_map) {
+        err() << log::error
+              << "text_batch::update(): unable to map vertex buffer." << log::end;
+        return false;
+    }
+
+    vertex*const    vertex_data    = reinterpret_cast<vertex*>(vb_map.data_ptr());
+    vertex*         shadow_vertex  = vertex_data;
+    vertex*         regular_vertex = vertex_data + shadow_glyph_count;
+    vertex*         outline_vertex = vertex_data + _plain_glyph_count;
+
+    for (instance_array::const_iterator i = _instances.begin(); i != _instances.end(); ++i) {
+        const text&     txt   = *i->_text;
+        const float     style = static_cast<float>(txt.text_style());
+        vertex*&        out_v = (i->_mode == draw_outlined) ? outline_vertex : regular_vertex;
+
+        for (text::glyph_quad_array::const_iterator q = txt._glyph_quads.begin(); q != txt._glyph_quads.end(); ++q) {
+            out_v->position_bbox     = q->_position_bbox;
+            out_v->texcoord_bbox     = q->_texcoord_bbox;
+            out_v->color             = txt.text_color();
+            out_v->outline_color     = txt.text_outline_color();
+            out_v->transform         = i->_transform;
+            out_v->translation_style = vec4f(i->_translation, style, 0.0f);
+            ++out_v;
+        }
+        if (i->_mode == draw_shadowed) {
+            const vec2f shadow_translation = i->_translation + vec2f(txt.text_shadow_offset());
+            for (text::glyph_quad_array::const_iterator q = txt._glyph_quads.begin(); q != txt._glyph_quads.end(); ++q) {
+                shadow_vertex->position_bbox     = q->_position_bbox;
+                shadow_vertex->texcoord_bbox     = q->_texcoord_bbox;
+                shadow_vertex->color             = txt.text_shadow_color();
+                shadow_vertex->outline_color     = txt.text_shadow_color();
+                shadow_vertex->transform         = i->_transform;
+                shadow_vertex->translation_style = vec4f(shadow_translation, style, 0.0f);
+                ++shadow_vertex;
+            }
+        }
+    }
+
+    return true;
+}
+
+} // namespace gl
+} // namespace scm
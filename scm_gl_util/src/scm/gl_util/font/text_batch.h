@@ -0,0 +1,92 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_TEXT_BATCH_H_INCLUDED
+#define SCM_GL_UTIL_TEXT_BATCH_H_INCLUDED
+
+#include <vector>
+
+#include <scm/core/math.h>
+#include <scm/core/numeric_types.h>
+
+#include <scm/gl_core/gl_core_fwd.h>
+
+#include <scm/gl_util/font/font_fwd.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// collects text objects of one font for drawing them with text_renderer in one go
+//  - the glyphs of all texts are streamed into one vertex buffer with the color, outline color,
+//    style and transformation of their text per glyph
+//  - regular and shadowed texts are drawn in a single call, all shadows below all texts,
+//    outlined texts in a second call on top (regular if the font has no border textures)
+//  - the texts are referenced until clear(), their layout and colors are read when drawn
+class __scm_export(gl_util) text_batch
+{
+public:
+    typedef enum {
+        draw_regular    = 0x00,
+        draw_shadowed,
+        draw_outlined,
+
+        draw_mode_count
+    } draw_mode;
+
+public:
+    text_batch(const render_device_ptr& device,
+               const font_face_cptr&    font,
+               int                      glyph_capacity = 1024);
+    virtual ~text_batch();
+
+    const font_face_cptr&       font() const;
+
+    bool                        add(const text_ptr&    txt,
+                                    const math::vec2i& pos,
+                                    draw_mode          mode = draw_regular);
+    // only the upper 2x2 part and the x and y translation of the transformation are used
+    bool                        add(const text_ptr&    txt,
+                                    const math::mat4f& transform,
+                                    draw_mode          mode = draw_regular);
+    void                        clear();
+
+    bool                        empty() const;
+    scm::size_t                 size() const;
+
+protected:
+    struct text_instance {
+        text_ptr                _text;
+        math::vec4f             _transform;         // column major 2x2 matrix
+        math::vec2f             _translation;
+        draw_mode               _mode;
+    }; // struct text_instance
+    typedef std::vector<text_instance>  instance_array;
+
+    // lays out changed texts and streams the glyphs into the vertex buffer
+    bool                        update(const render_context_ptr& context);
+
+protected:
+    font_face_cptr              _font;
+    instance_array              _instances;
+
+    int                         _glyph_capacity;
+    buffer_ptr                  _vertex_buffer;
+    vertex_array_ptr            _vertex_array;
+    int                         _plain_glyph_count;     // shadows and regular glyphs
+    int                         _outline_glyph_count;   // behind the plain glyphs
+
+    render_device_wptr          _render_device;
+
+    friend class text_renderer;
+}; // class text_batch
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_UTIL_TEXT_BATCH_H_INCLUDED
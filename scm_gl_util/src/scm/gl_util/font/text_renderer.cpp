@@ -20,6 +20,7 @@
 
 #include <scm/gl_util/font/font_face.h>
 #include <scm/gl_util/font/text.h>
+#include <scm/gl_util/font/text_batch.h>
 #include <scm/gl_util/primitives/quad.h>
 
 #define GEOM_SHADER_FONT  1
@@ -258,6 +259,178 @@ std::string f_source_outline_lcd = "\
     }                                                                                               \n\
     ";
 
+// text_batch shaders, colors, style and transformation are read per glyph
+std::string v_source_batch = "\
+    #version 330 core                                                                               \n\
+                                                                                                    \n\
+    layout(location = 0) in vec4 in_position_bbox;                                                  \n\
+    layout(location = 1) in vec4 in_texcoord_bbox;                                                  \n\
+    layout(location = 2) in vec4 in_color;                                                          \n\
+    layout(location = 3) in vec4 in_outline_color;                                                  \n\
+    layout(location = 4) in vec4 in_transform;                                                      \n\
+    layout(location = 5) in vec4 in_translation_style;                                              \n\
+                                                                                                    \n\
+    out per_vertex {                                                                                \n\
+        vec4 position_bbox;                                                                         \n\
+        vec4 texcoord_bbox;                                                                         \n\
+        vec4 color;                                                                                 \n\
+        vec4 outline_color;                                                                         \n\
+        vec4 transform;                                                                             \n\
+        vec4 translation_style;                                                                     \n\
+    } v_out;                                                                                        \n\
+                                                                                                    \n\
+    void main()                                                                                     \n\
+    {                                                                                               \n\
+        v_out.position_bbox     = in_position_bbox;                                                 \n\
+        v_out.texcoord_bbox     = in_texcoord_bbox;                                                 \n\
+        v_out.color             = in_color;                                                         \n\
+        v_out.outline_color     = in_outline_color;                                                 \n\
+        v_out.transform         = in_transform;                                                     \n\
+        v_out.translation_style = in_translation_style;                                             \n\
+    }                                                                                               \n\
+    ";
+
+std::string g_source_batch = "\
+    #version 330 core                                                                               \n\
+                                                                                                    \n\
+    layout(points, invocations = 1)          in;                                                    \n\
+    layout(triangle_strip, max_vertices = 4) out;                                                   \n\
+                                                                                                    \n\
+    uniform mat4  in_mvp;                                                                           \n\
+                                                                                                    \n\
+    in per_vertex {                                                                                 \n\
+        vec4 position_bbox;                                                                         \n\
+        vec4 texcoord_bbox;                                                                         \n\
+        vec4 color;                                                                                 \n\
+        vec4 outline_color;                                                                         \n\
+        vec4 transform;                                                                             \n\
+        vec4 translation_style;                                                                     \n\
+    } v_in[];                                                                                       \n\
+                                                                                                    \n\
+    out per_vertex {                                                                                \n\
+        vec3      tex_coord;                                                                        \n\
+        flat vec4 color;                                                                            \n\
+        flat vec4 outline_color;                                                                    \n\
+    } v_out;                                                                                        \n\
+                                                                                                    \n\
+    void emit_corner(vec2 c)                                                                        \n\
+    {                                                                                               \n\
+        mat2 m = mat2(v_in[0].transform.xy, v_in[0].transform.zw);                                  \n\
+        vec2 p = v_in[0].position_bbox.xy + c * v_in[0].position_bbox.zw;                           \n\
+        vec2 t = v_in[0].texcoord_bbox.xy + c * v_in[0].texcoord_bbox.zw;                           \n\
+                                                                                                    \n\
+        gl_Position         = in_mvp * vec4(m * p + v_in[0].translation_style.xy, 0.0, 1.0);        \n\
+        v_out.tex_coord     = vec3(t, v_in[0].translation_style.z);                                 \n\
+        v_out.color         = v_in[0].color;                                                        \n\
+        v_out.outline_color = v_in[0].outline_color;                                                \n\
+        EmitVertex();                                                                               \n\
+    }                                                                                               \n\
+                                                                                                    \n\
+    void main()                                                                                     \n\
+    {                                                                                               \n\
+        emit_corner(vec2(1.0, 0.0));                                                                \n\
+        emit_corner(vec2(1.0, 1.0));                                                                \n\
+        emit_corner(vec2(0.0, 0.0));                                                                \n\
+        emit_corner(vec2(0.0, 1.0));                                                                \n\
+        EndPrimitive();                                                                             \n\
+    }                                                                                               \n\
+    ";
+
+std::string f_source_batch_gray = "\
+    #version 330 core                                                                               \n\
+                                                                                                    \n\
+    uniform sampler2DArray  in_font_array;                                                          \n\
+                                                                                                    \n\
+    layout(location = 0) out vec4 out_color;                                                        \n\
+                                                                                                    \n\
+    in per_vertex {                                                                                 \n\
+        vec3      tex_coord;                                                                        \n\
+        flat vec4 color;                                                                            \n\
+        flat vec4 outline_color;                                                                    \n\
+    } v_in;                                                                                         \n\
+                                                                                                    \n\
+    void main()                                                                                     \n\
+    {                                                                                               \n\
+        float core    = texture(in_font_array, v_in.tex_coord).r;                                   \n\
+        out_color.rgb = v_in.color.rgb;                                                             \n\
+        out_color.a   = core * v_in.color.a;                                                        \n\
+    }                                                                                               \n\
+    ";
+
+std::string f_source_batch_outline_gray = "\
+    #version 330 core                                                                               \n\
+                                                                                                    \n\
+    uniform sampler2DArray  in_font_array;                                                          \n\
+    uniform sampler2DArray  in_font_border_array;                                                   \n\
+                                                                                                    \n\
+    layout(location = 0) out vec4 out_color;                                                        \n\
+                                                                                                    \n\
+    in per_vertex {                                                                                 \n\
+        vec3      tex_coord;                                                                        \n\
+        flat vec4 color;                                                                            \n\
+        flat vec4 outline_color;                                                                    \n\
+    } v_in;                                                                                         \n\
+                                                                                                    \n\
+    void main()                                                                                     \n\
+    {                                                                                               \n\
+        float core    = texture(in_font_array, v_in.tex_coord).r;                                   \n\
+        float outline = texture(in_font_border_array, v_in.tex_coord).r;                            \n\
+                                                                                                    \n\
+        out_color.a   = core + outline - core * outline;                                            \n\
+        out_color.rgb =   mix(v_in.outline_color.rgb * outline, v_in.color.rgb, core)               \n\
+                        / out_color.a;                                                              \n\
+    }                                                                                               \n\
+    ";
+
+std::string f_source_batch_lcd = "\
+    #version 330 core                                                                               \n\
+                                                                                                    \n\
+    uniform sampler2DArray  in_font_array;                                                          \n\
+                                                                                                    \n\
+    layout(location = 0, index = 0) out vec4 out_color;                                             \n\
+    layout(location = 0, index = 1) out vec4 out_sup_pixel_blend;                                   \n\
+                                                                                                    \n\
+    in per_vertex {                                                                                 \n\
+        vec3      tex_coord;                                                                        \n\
+        flat vec4 color;                                                                            \n\
+        flat vec4 outline_color;                                                                    \n\
+    } v_in;                                                                                         \n\
+                                                                                                    \n\
+    void main()                                                                                     \n\
+    {                                                                                               \n\
+        vec3 core           = texture(in_font_array, v_in.tex_coord).rgb;                           \n\
+                                                                                                    \n\
+        out_color           = v_in.color;                                                           \n\
+        out_sup_pixel_blend = vec4(core.rgb * v_in.color.a, 1.0);                                   \n\
+    }                                                                                               \n\
+    ";
+
+std::string f_source_batch_outline_lcd = "\
+    #version 330 core                                                                               \n\
+                                                                                                    \n\
+    uniform sampler2DArray  in_font_array;                                                          \n\
+    uniform sampler2DArray  in_font_border_array;                                                   \n\
+                                                                                                    \n\
+    layout(location = 0, index = 0) out vec4 out_color;                                             \n\
+    layout(location = 0, index = 1) out vec4 out_sup_pixel_blend;                                   \n\
+                                                                                                    \n\
+    in per_vertex {                                                                                 \n\
+        vec3      tex_coord;                                                                        \n\
+        flat vec4 color;                                                                            \n\
+        flat vec4 outline_color;                                                                    \n\
+    } v_in;                                                                                         \n\
+                                                                                                    \n\
+    void main()                                                                                     \n\
+    {                                                                                               \n\
+        vec3 core    = texture(in_font_array, v_in.tex_coord).rgb;                                  \n\
+        vec3 outline = texture(in_font_border_array, v_in.tex_coord).rgb;                           \n\
+                                                                                                    \n\
+        out_sup_pixel_blend.rgb = core.rgb + outline.rgb - core.rgb * outline.rgb;                  \n\
+        out_color.rgb       =   mix(v_in.outline_color.rgb * outline.rgb, v_in.color.rgb, core.rgb) \n\
+                              / out_sup_pixel_blend.rgb;                                            \n\
+    }                                                                                               \n\
+    ";
+
 } // namespace
 
 
@@ -296,10 +469,31 @@ text_renderer::text_renderer(const render_device_ptr& device)
                                                                (device->create_shader(STAGE_FRAGMENT_SHADER, f_source_outline_lcd,  "text_renderer::f_source_outline_lcd")),
                                                 "text_renderer::font_program_outline_lcd");
 
+    _batch_program_gray         = device->create_program(list_of(device->create_shader(STAGE_VERTEX_SHADER,   v_source_batch,              "text_renderer::v_source_batch"))
+                                                                (device->create_shader(STAGE_GEOMETRY_SHADER, g_source_batch,              "text_renderer::g_source_batch"))
+                                                                (device->create_shader(STAGE_FRAGMENT_SHADER, f_source_batch_gray,         "text_renderer::f_source_batch_gray")),
+                                                         "text_renderer::batch_program_gray");
+    _batch_program_lcd          = device->create_program(list_of(device->create_shader(STAGE_VERTEX_SHADER,   v_source_batch,              "text_renderer::v_source_batch"))
+                                                                (device->create_shader(STAGE_GEOMETRY_SHADER, g_source_batch,              "text_renderer::g_source_batch"))
+                                                                (device->create_shader(STAGE_FRAGMENT_SHADER, f_source_batch_lcd,          "text_renderer::f_source_batch_lcd")),
+                                                         "text_renderer::batch_program_lcd");
+    _batch_program_outline_gray = device->create_program(list_of(device->create_shader(STAGE_VERTEX_SHADER,   v_source_batch,              "text_renderer::v_source_batch"))
+                                                                (device->create_shader(STAGE_GEOMETRY_SHADER, g_source_batch,              "text_renderer::g_source_batch"))
+                                                                (device->create_shader(STAGE_FRAGMENT_SHADER, f_source_batch_outline_gray, "text_renderer::f_source_batch_outline_gray")),
+                                                         "text_renderer::batch_program_outline_gray");
+    _batch_program_outline_lcd  = device->create_program(list_of(device->create_shader(STAGE_VERTEX_SHADER,   v_source_batch,              "text_renderer::v_source_batch"))
+                                                                (device->create_shader(STAGE_GEOMETRY_SHADER, g_source_batch,              "text_renderer::g_source_batch"))
+                                                                (device->create_shader(STAGE_FRAGMENT_SHADER, f_source_batch_outline_lcd,  "text_renderer::f_source_batch_outline_lcd")),
+                                                         "text_renderer::batch_program_outline_lcd");
+
     if (   !_font_program_gray
         || !_font_program_lcd
         || !_font_program_outline_gray
-        || !_font_program_outline_lcd) {
+        || !_font_program_outline_lcd
+        || !_batch_program_gray
+        || !_batch_program_lcd
+        || !_batch_program_outline_gray
+        || !_batch_program_outline_lcd) {
         scm::err() << "font_renderer::font_renderer(): error creating shader programs." << log::end;
         throw std::runtime_error("font_renderer::font_renderer(): error creating shader programs.");
     }
@@ -320,6 +514,19 @@ text_renderer::text_renderer(const render_device_ptr& device)
         throw std::runtime_error("font_renderer::font_renderer(): error creating state objects.");
     }
 
+    // the batch programs only change the projection per draw
+    _batch_program_gray->uniform("in_font_array", 0);
+    _batch_program_lcd->uniform("in_font_array", 0);
+    _batch_program_outline_gray->uniform("in_font_array",        0);
+    _batch_program_outline_gray->uniform("in_font_border_array", 1);
+    _batch_program_outline_lcd->uniform("in_font_array",         0);
+    _batch_program_outline_lcd->uniform("in_font_border_array",  1);
+
+    _batch_mvp_gray         = _batch_program_gray->resolve_uniform<mat4f>("in_mvp");
+    _batch_mvp_lcd          = _batch_program_lcd->resolve_uniform<mat4f>("in_mvp");
+    _batch_mvp_outline_gray = _batch_program_outline_gray->resolve_uniform<mat4f>("in_mvp");
+    _batch_mvp_outline_lcd  = _batch_program_outline_lcd->resolve_uniform<mat4f>("in_mvp");
+
     //_quad.reset(new quad_geometry(device, vec2f(0.0f), vec2f(1.0f), vec2f(0.0f), vec2f(1.0f)));
 }
 
@@ -327,6 +534,12 @@ text_renderer::~text_renderer()
 {
     _font_program_gray.reset();
     _font_program_lcd.reset();
+    _font_program_outline_gray.reset();
+    _font_program_outline_lcd.reset();
+    _batch_program_gray.reset();
+    _batch_program_lcd.reset();
+    _batch_program_outline_gray.reset();
+    _batch_program_outline_lcd.reset();
     _font_sampler_state.reset();
     _font_dstate.reset();
     _font_raster_state.reset();
@@ -345,6 +558,8 @@ text_renderer::draw(const render_context_ptr& context,
     using namespace scm::gl;
     using namespace scm::math;
 
+    txt->refresh();
+
     context_vertex_input_guard  vig(context);
     context_state_objects_guard csg(context);
     context_texture_units_guard tug(context);
@@ -413,6 +628,8 @@ text_renderer::draw_outlined(const render_context_ptr& context,
     using namespace scm::gl;
     using namespace scm::math;
 
+    txt->refresh();
+
     context_vertex_input_guard  vig(context);
     context_state_objects_guard csg(context);
     context_texture_units_guard tug(context);
@@ -574,6 +791,8 @@ text_renderer::draw_shadowed(const render_context_ptr& context,
     using namespace scm::gl;
     using namespace scm::math;
 
+    txt->refresh();
+
     context_vertex_input_guard  vig(context);
     context_state_objects_guard csg(context);
     context_texture_units_guard tug(context);
@@ -691,6 +910,49 @@ text_renderer::draw_shadowed(const render_context_ptr& context,
     //_quad->draw(context, geometry::MODE_SOLID);
 }
 
+void
+text_renderer::draw(const render_context_ptr& context,
+                    const text_batch_ptr&     batch) const
+{
+    using namespace scm;
+    using namespace scm::gl;
+    using namespace scm::math;
+
+    if (!batch->update(context)) {
+        return;
+    }
+
+    context_vertex_input_guard  vig(context);
+    context_state_objects_guard csg(context);
+    context_texture_units_guard tug(context);
+    context_program_guard       cpg(context);
+
+    const font_face_cptr&   font = batch->font();
+    const bool              lcd  = font->smooth_style() == font_face::smooth_lcd;
+
+    context->set_depth_stencil_state(_font_dstate);
+    context->set_rasterizer_state(_font_raster_state);
+    context->set_blend_state(lcd ? _font_blend_lcd : _font_blend_gray);
+    context->bind_vertex_array(batch->_vertex_array);
+    context->bind_texture(font->styles_texture_array(), _font_sampler_state, 0);
+
+    if (batch->_plain_glyph_count > 0) { // shadows and regular texts
+        (lcd ? _batch_mvp_lcd : _batch_mvp_gray).value(_projection_matrix);
+        context->bind_program(lcd ? _batch_program_lcd : _batch_program_gray);
+
+        context->apply();
+        context->draw_arrays(PRIMITIVE_POINT_LIST, 0, batch->_plain_glyph_count);
+    }
+    if (batch->_outline_glyph_count > 0) {
+        (lcd ? _batch_mvp_outline_lcd : _batch_mvp_outline_gray).value(_projection_matrix);
+        context->bind_program(lcd ? _batch_program_outline_lcd : _batch_program_outline_gray);
+        context->bind_texture(font->styles_border_texture_array(), _font_sampler_state, 1);
+
+        context->apply();
+        context->draw_arrays(PRIMITIVE_POINT_LIST, batch->_plain_glyph_count, batch->_outline_glyph_count);
+    }
+}
+
 void
 text_renderer::projection_matrix(const math::mat4f& m)
 {
@@ -8,6 +8,7 @@
 #include <scm/core/math.h>
 
 #include <scm/gl_core/gl_core_fwd.h>
+#include <scm/gl_core/shader_objects/uniform.h>
 
 #include <scm/gl_util/font/font_fwd.h>
 #include <scm/gl_util/primitives/primitives_fwd.h>
@@ -33,6 +34,10 @@ public:
     void            draw_outlined(const render_context_ptr& context,
                                   const math::vec2i&        pos,
                                   const text_ptr&           txt) const;
+    // draws all texts of the batch, one draw call for regular and shadowed texts and one for
+    // outlined texts
+    void            draw(const render_context_ptr& context,
+                         const text_batch_ptr&     batch) const;
 
     void            projection_matrix(const math::mat4f& m);
 
@@ -41,6 +46,14 @@ protected:
     program_ptr                 _font_program_lcd;
     program_ptr                 _font_program_outline_gray;
     program_ptr                 _font_program_outline_lcd;
+    program_ptr                 _batch_program_gray;
+    program_ptr                 _batch_program_lcd;
+    program_ptr                 _batch_program_outline_gray;
+    program_ptr                 _batch_program_outline_lcd;
+    uniform_handle<math::mat4f> _batch_mvp_gray;
+    uniform_handle<math::mat4f> _batch_mvp_lcd;
+    uniform_handle<math::mat4f> _batch_mvp_outline_gray;
+    uniform_handle<math::mat4f> _batch_mvp_outline_lcd;
     sampler_state_ptr           _font_sampler_state;
     depth_stencil_state_ptr     _font_dstate;
     rasterizer_state_ptr        _font_raster_state;
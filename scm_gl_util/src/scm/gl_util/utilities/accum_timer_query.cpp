@@ -20,128 +20,168 @@
 namespace scm {
 namespace gl {
 
-accum_timer_query::accum_timer_query(const render_device_ptr& device)
+accum_timer_query::accum_timer_query(const render_device_ptr& device,
+                                     int                      frames_in_flight)
   : time::accum_timer_base()
-  , _timer_query_finished(true)
+  , _next_slot(0)
+  , _oldest_slot(0)
+  , _timing_active(false)
+  , _start_count(0)
+  , _dropped_samples(0)
   , _cpu_timer()
 {
     reset();
-    _detailed_average_time.gl =
-    _detailed_average_time.wall =
-    _detailed_average_time.user =
-    _detailed_average_time.system = 0;
+    _detailed_last_time.gl =
+    _detailed_last_time.wall =
+    _detailed_last_time.user =
+    _detailed_last_time.system = 0;
+    _detailed_last_time.frame = 0;
+    _detailed_average_time = _detailed_last_time;
+
+    if (frames_in_flight < 1) {
+        throw std::runtime_error("accum_timer_query::accum_timer_query(): invalid number of frames in flight.");
+    }
 
-    _timer_query_begin = device->create_timer_query();
-    _timer_query_end = device->create_timer_query();
+    _query_slots.resize(frames_in_flight);
+    for (query_slot_array::iterator s = _query_slots.begin(); s != _query_slots.end(); ++s) {
+        s->_begin   = device->create_timer_query();
+        s->_end     = device->create_timer_query();
+        s->_frame   = 0;
+        s->_pending = false;
 
-    if (   !_timer_query_begin
-        || !_timer_query_end) {
-        throw std::runtime_error("accum_timer_query::accum_timer_query(): error creating query object.");
+        if (   !s->_begin
+            || !s->_end) {
+            throw std::runtime_error("accum_timer_query::accum_timer_query(): error creating query object.");
+        }
     }
 }
 
 accum_timer_query::~accum_timer_query()
 {
-    _timer_query_begin.reset();
-    _timer_query_end.reset();
+    _query_slots.clear();
 }
 
 void
 accum_timer_query::start(const render_context_ptr& context)
 {
-    assert(_timer_query_begin);
-    assert(_timer_query_end);
-
-    if (_timer_query_finished) {
-        _cpu_timer.start();
-        context->query_time_stamp(_timer_query_begin);
-        _timer_context = context;
-    }
+    start(context, _start_count);
 }
 
 void
-accum_timer_query::stop()
+accum_timer_query::start(const render_context_ptr& context, scm::uint64 frame)
 {
-    assert(_timer_query_begin);
-    assert(_timer_query_end);
+    ++_start_count;
 
-    if (_timer_query_finished && _timer_context) {
-        _timer_context->query_time_stamp(_timer_query_end);
-        _cpu_timer.stop();
+    query_slot& s = _query_slots[_next_slot];
+
+    if (s._pending) {
+        // pick up finished timings before giving up on this one
+        collect();
+        if (s._pending) {
+            ++_dropped_samples;
+            _timing_active = false;
+            return;
+        }
     }
+
+    _cpu_timer.start();
+    context->query_time_stamp(s._begin);
+
+    s._context     = context;
+    s._frame       = frame;
+    _timing_active = true;
 }
 
 void
-accum_timer_query::collect()
+accum_timer_query::stop()
 {
-    assert(_timer_query_begin);
-    assert(_timer_query_end);
-
-    if (_timer_context) {
-        if (_timer_context->query_result_available(_timer_query_end)) {
-            _timer_context->collect_query_results(_timer_query_begin);
-            _timer_context->collect_query_results(_timer_query_end);
+    if (!_timing_active) {
+        return;
+    }
 
-            scm::uint64 start = _timer_query_begin->result();
-            scm::uint64 end   = _timer_query_end->result();
-            scm::uint64 diff  = ((end > start) ? (end - start) : (~start + 1 + end));
+    query_slot& s = _query_slots[_next_slot];
 
-            time::cpu_timer::cpu_times t = _cpu_timer.detailed_elapsed();
+    s._context->query_time_stamp(s._end);
+    _cpu_timer.stop();
 
-            _last_time         = static_cast<nanosec_type>(diff);
-            _accumulated_time += _last_time;
+    s._cpu_times   = _cpu_timer.detailed_elapsed();
+    s._pending     = true;
 
-            _detailed_last_time.gl     = _last_time;
-            _detailed_last_time.wall   = t.wall;
-            _detailed_last_time.user   = t.user;
-            _detailed_last_time.system = t.system;
+    _next_slot     = (_next_slot + 1) % frames_in_flight();
+    _timing_active = false;
+}
 
-            _detailed_accumulated_time.gl     += _detailed_last_time.gl;
-            _detailed_accumulated_time.wall   += _detailed_last_time.wall;
-            _detailed_accumulated_time.user   += _detailed_last_time.user;
-            _detailed_accumulated_time.system += _detailed_last_time.system;
+void
+accum_timer_query::collect()
+{
+    // the timings finish in order, stop at the first one still running on the gpu
+    while (_query_slots[_oldest_slot]._pending) {
+        query_slot& s = _query_slots[_oldest_slot];
 
-            ++_accumulation_count;
-            _timer_query_finished = true;
-        }
-        else {
-            _timer_query_finished = false;
+        if (!s._context->query_result_available(s._end)) {
+            break;
         }
+        accumulate(s);
+        _oldest_slot = (_oldest_slot + 1) % frames_in_flight();
     }
 }
 
 void
 accum_timer_query::force_collect()
 {
-    assert(_timer_query_begin);
-    assert(_timer_query_end);
+    while (_query_slots[_oldest_slot]._pending) {
+        accumulate(_query_slots[_oldest_slot]);
+        _oldest_slot = (_oldest_slot + 1) % frames_in_flight();
+    }
+}
+
+int
+accum_timer_query::frames_in_flight() const
+{
+    return static_cast<int>(_query_slots.size());
+}
+
+scm::uint64
+accum_timer_query::last_frame() const
+{
+    return _detailed_last_time.frame;
+}
+
+unsigned
+accum_timer_query::dropped_samples() const
+{
+    return _dropped_samples;
+}
 
-    if (_timer_context) {
-        _timer_context->collect_query_results(_timer_query_begin);
-        _timer_context->collect_query_results(_timer_query_end);
+void
+accum_timer_query::accumulate(query_slot& slot)
+{
+    slot._context->collect_query_results(slot._begin);
+    slot._context->collect_query_results(slot._end);
 
-        scm::uint64 start = _timer_query_begin->result();
-        scm::uint64 end   = _timer_query_end->result();
-        scm::uint64 diff  = ((end > start) ? (end - start) : (~start + 1 + end));
+    scm::uint64 start = slot._begin->result();
+    scm::uint64 end   = slot._end->result();
+    scm::uint64 diff  = ((end > start) ? (end - start) : (~start + 1 + end));
 
-        time::cpu_timer::cpu_times t = _cpu_timer.detailed_elapsed();
+    _last_time         = static_cast<nanosec_type>(diff);
+    _accumulated_time += _last_time;
 
-        _last_time         = static_cast<nanosec_type>(diff);
-        _accumulated_time += _last_time;
+    _detailed_last_time.gl     = _last_time;
+    _detailed_last_time.wall   = slot._cpu_times.wall;
+    _detailed_last_time.user   = slot._cpu_times.user;
+    _detailed_last_time.system = slot._cpu_times.system;
+    _detailed_last_time.frame  = slot._frame;
 
-        _detailed_last_time.gl     = _last_time;
-        _detailed_last_time.wall   = t.wall;
-        _detailed_last_time.user   = t.user;
-        _detailed_last_time.system = t.system;
+    _detailed_accumulated_time.gl     += _detailed_last_time.gl;
+    _detailed_accumulated_time.wall   += _detailed_last_time.wall;
+    _detailed_accumulated_time.user   += _detailed_last_time.user;
+    _detailed_accumulated_time.system += _detailed_last_time.system;
+    _detailed_accumulated_time.frame   = slot._frame;
 
-        _detailed_accumulated_time.gl     += _detailed_last_time.gl;
-        _detailed_accumulated_time.wall   += _detailed_last_time.wall;
-        _detailed_accumulated_time.user   += _detailed_last_time.user;
-        _detailed_accumulated_time.system += _detailed_last_time.system;
+    ++_accumulation_count;
 
-        ++_accumulation_count;
-        _timer_query_finished = true;
-    }
+    slot._pending = false;
+    slot._context.reset();
 }
 
 void
@@ -164,6 +204,7 @@ accum_timer_query::update(int interval)
             _detailed_average_time.user   = _detailed_accumulated_time.user   / _accumulation_count;
             _detailed_average_time.system = _detailed_accumulated_time.system / _accumulation_count;
         }
+        _detailed_average_time.frame = _detailed_last_time.frame;
 
         reset();
     }
@@ -174,13 +215,12 @@ accum_timer_query::reset()
 {
     time::accum_timer_base::reset();
 
-    _timer_query_finished   = true;
-    _timer_context.reset();
-
+    // pending timings stay in flight and are accumulated into the next interval
     _detailed_accumulated_time.gl     = 
     _detailed_accumulated_time.wall   = 
     _detailed_accumulated_time.user   = 
     _detailed_accumulated_time.system = 0;
+    _detailed_accumulated_time.frame  = 0;
 }
 
 accum_timer_query::gl_times
@@ -5,6 +5,9 @@
 #ifndef SCM_GL_UTIL_accum_timer_query_H_INCLUDED
 #define SCM_GL_UTIL_accum_timer_query_H_INCLUDED
 
+#include <vector>
+
+#include <scm/core/numeric_types.h>
 #include <scm/core/time/accum_timer_base.h>
 #include <scm/core/time/cpu_timer.h>
 
@@ -18,6 +21,12 @@
 namespace scm {
 namespace gl {
 
+// gl timer using a ring of timer query pairs
+//  - every start()/stop() pair uses the next query pair of the ring, so up to
+//    frames_in_flight timings can be pending on the gpu
+//  - collect() picks up all finished timings in order without waiting for the gpu,
+//    force_collect() waits for all pending timings
+//  - if all query pairs are pending a start()/stop() pair is skipped (dropped_samples())
 class __scm_export(gl_util) accum_timer_query : public time::accum_timer_base
 {
 public:
@@ -25,17 +34,25 @@ public:
     struct gl_times : public time::cpu_timer::cpu_times
     {
         nanosec_type    gl;
+        scm::uint64     frame;  // frame of the (last) timing
     };
 
 public:
-    accum_timer_query(const render_device_ptr& device);
+    accum_timer_query(const render_device_ptr& device,
+                      int                      frames_in_flight = 3);
     virtual ~accum_timer_query();
 
+    // the frame is reported with the timing, the number of start() calls is used if not given
     void                    start(const render_context_ptr& context);
+    void                    start(const render_context_ptr& context, scm::uint64 frame);
     void                    stop();
     void                    collect();
     void                    force_collect();
 
+    int                     frames_in_flight() const;
+    scm::uint64             last_frame() const;
+    unsigned                dropped_samples() const;
+
     void                    update(int interval = 100);
     void                    reset();
 
@@ -49,11 +66,25 @@ public:
     void                    detailed_report(std::ostream& os, size_t dsize, time::time_io unit  = time::time_io(time::time_io::msec, time::time_io::MiBps)) const;
 
 protected:
-    timer_query_ptr         _timer_query_begin;
-    timer_query_ptr         _timer_query_end;
-    bool                    _timer_query_finished;
+    struct query_slot {
+        timer_query_ptr             _begin;
+        timer_query_ptr             _end;
+        render_context_ptr          _context;
+        time::cpu_timer::cpu_times  _cpu_times;
+        scm::uint64                 _frame;
+        bool                        _pending;
+    }; // struct query_slot
+    typedef std::vector<query_slot> query_slot_array;
+
+    void                    accumulate(query_slot& slot);
 
-    render_context_ptr      _timer_context;
+protected:
+    query_slot_array        _query_slots;
+    int                     _next_slot;         // slot of the next start()
+    int                     _oldest_slot;       // oldest pending slot
+    bool                    _timing_active;     // between start() and stop()
+    scm::uint64             _start_count;
+    unsigned                _dropped_samples;
 
     gl_times                _detailed_last_time;
     gl_times                _detailed_accumulated_time;
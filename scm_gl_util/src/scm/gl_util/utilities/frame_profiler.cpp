@@ -0,0 +1,556 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "frame_profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+
+#include <boost/thread/locks.hpp>
+
+#include <scm/log.h>
+
+#include <scm/gl_core/render_device.h>
+#include <scm/gl_core/query_objects.h>
+
+namespace {
+
+void
+write_json_string(std::ostream& os, const char* s)
+{
+    os << '"';
+    for (; 0 != *s; ++s) {
+        const unsigned char c = static_cast<unsigned char>(*s);
+        switch (c) {
+            case '"':  os << "\\\""; break;
+            case '\\': os << "\\\\"; break;
+            case '\n': os << "\\n";  break;
+            case '\r': os << "\\r";  break;
+            case '\t': os << "\\t";  break;
+            default:
+                if (c < 0x20) {
+                    char e[8];
+                    std::sprintf(e, "\\u%04x", c);
+                    os << e;
+                }
+                else {
+                    os << *s;
+                }
+        }
+    }
+    os << '"';
+}
+
+void
+write_separator(std::ostream& os, bool& first_event)
+{
+    os << (first_event ? "\n" : ",\n");
+    first_event = false;
+}
+
+// chrome trace timestamps are microseconds
+void
+write_microseconds(std::ostream& os, scm::int64 ns)
+{
+    if (ns < 0) {
+        os << '-';
+        ns = -ns;
+    }
+    char f[8];
+    std::sprintf(f, ".%03d", static_cast<int>(ns % 1000));
+    os << ns / 1000 << f;
+}
+
+const char* device_track_names[] = {
+    "OpenGL",
+    "CUDA",
+    "OpenCL"
+};
+
+const int   cpu_process_id    = 1;
+const int   device_process_id = 2;
+
+// open scope stack entry of a scope that is not recorded
+const scm::size_t   unrecorded_scope = ~scm::size_t(0);
+
+} // namespace
+
+namespace scm {
+namespace gl {
+namespace util {
+
+frame_profiler::frame_profiler()
+  : _frame(0)
+  , _capturing(false)
+  , _capture_end_frame(0)
+  , _local_track(&frame_profiler::release_track)
+  , _gl_retired_scopes(0)
+  , _gl_time_offset(0)
+  , _gl_time_offset_valid(false)
+{
+    _clock.start();
+}
+
+frame_profiler::~frame_profiler()
+{
+    _gl_scopes.clear();
+    _gl_free_queries.clear();
+    _thread_tracks.clear();
+}
+
+void
+frame_profiler::begin_frame()
+{
+    resolve_gl_scopes(false);
+
+    bool capture_finished = false;
+    {
+        boost::mutex::scoped_lock   lock(_device_mutex);
+        ++_frame;
+
+        if (_capturing) {
+            if (0 != _capture_end_frame && _frame >= _capture_end_frame) {
+                capture_finished = true;
+            }
+            else {
+                _frame_starts.push_back(now());
+            }
+        }
+    }
+
+    if (capture_finished) {
+        stop_capture();
+    }
+
+    update_tracks();
+}
+
+scm::uint64
+frame_profiler::frame() const
+{
+    return _frame;
+}
+
+void
+frame_profiler::start_capture(unsigned in_frame_count)
+{
+    clear_capture();
+
+    _capture_end_frame    = (0 < in_frame_count) ? _frame + in_frame_count : 0;
+    _gl_time_offset_valid = false; // the clocks drift apart, calibrated again on the first gl scope
+
+    {
+        boost::mutex::scoped_lock   lock(_device_mutex);
+        _capturing = true;
+        _frame_starts.push_back(now());
+    }
+
+    update_tracks();
+}
+
+void
+frame_profiler::stop_capture()
+{
+    {
+        boost::mutex::scoped_lock   lock(_device_mutex);
+        _capturing = false;
+    }
+
+    update_tracks();
+    resolve_gl_scopes(true);
+}
+
+bool
+frame_profiler::capturing() const
+{
+    boost::mutex::scoped_lock   lock(_device_mutex);
+    return _capturing;
+}
+
+void
+frame_profiler::clear_capture()
+{
+    {
+        boost::mutex::scoped_lock   lock(_tracks_mutex);
+        for (std::vector<thread_track_ptr>::iterator t = _thread_tracks.begin(); t != _thread_tracks.end(); ++t) {
+            boost::mutex::scoped_lock   track_lock((*t)->_mutex);
+            (*t)->_events.clear();
+            // the events of open scopes are gone, their end calls still pop the entries
+            std::fill((*t)->_open_scopes.begin(), (*t)->_open_scopes.end(), unrecorded_scope);
+        }
+    }
+    {
+        boost::mutex::scoped_lock   lock(_device_mutex);
+        for (int d = 0; d < DEVICE_TRACK_COUNT; ++d) {
+            _device_events[d].clear();
+        }
+        _frame_starts.clear();
+    }
+    // open gl scopes stay on the stack, they are closed by their gl_end() calls
+}
+
+const char*
+frame_profiler::intern(const std::string& in_name)
+{
+    boost::mutex::scoped_lock   lock(_names_mutex);
+    return _names.insert(in_name).first->c_str();
+}
+
+void
+frame_profiler::thread_name(const std::string& in_name)
+{
+    thread_track&               t = local_track();
+    boost::mutex::scoped_lock   lock(t._mutex);
+    t._name = in_name;
+}
+
+frame_profiler::nanosec_type
+frame_profiler::now() const
+{
+    return _clock.elapsed();
+}
+
+void
+frame_profiler::cpu_begin(const char* in_name)
+{
+    thread_track&               t = local_track();
+    boost::mutex::scoped_lock   lock(t._mutex);
+
+    if (t._capturing) {
+        trace_event e;
+        e._name  = in_name;
+        e._begin = now();
+        e._end   = e._begin;
+        e._frame = t._frame;
+
+        t._open_scopes.push_back(t._events.size());
+        t._events.push_back(e);
+    }
+    else {
+        // keeps the stack matching the begin/end pairs if the capture starts or stops in between
+        t._open_scopes.push_back(unrecorded_scope);
+    }
+}
+
+void
+frame_profiler::cpu_end()
+{
+    thread_track&               t = local_track();
+    boost::mutex::scoped_lock   lock(t._mutex);
+
+    if (t._open_scopes.empty()) {
+        return; // unbalanced cpu_end()
+    }
+
+    const scm::size_t   s = t._open_scopes.back();
+    t._open_scopes.pop_back();
+
+    if (unrecorded_scope != s) {
+        t._events[s]._end = now();
+    }
+}
+
+void
+frame_profiler::gl_begin(const char* in_name, const render_context_ptr& in_context)
+{
+    if (!in_context) {
+        return;
+    }
+    if (!_capturing) {
+        _gl_open_scopes.push_back(unrecorded_scope);
+        return;
+    }
+
+    if (!_gl_time_offset_valid) {
+        const nanosec_type  cpu_time = now();
+        const nanosec_type  gpu_time = static_cast<nanosec_type>(in_context->current_time_stamp());
+
+        _gl_time_offset       = cpu_time - gpu_time;
+        _gl_time_offset_valid = true;
+    }
+
+    gl_scope s;
+    s._event._name   = in_name;
+    s._event._begin  = 0;
+    s._event._end    = 0;
+    s._event._frame  = _frame;
+    s._begin_query   = allocate_query(in_context);
+    s._end_query     = allocate_query(in_context);
+    s._context       = in_context;
+    s._closed        = false;
+
+    if (!s._begin_query || !s._end_query) {
+        _gl_open_scopes.push_back(unrecorded_scope);
+        return;
+    }
+
+    in_context->query_time_stamp(s._begin_query);
+
+    _gl_open_scopes.push_back(_gl_retired_scopes + _gl_scopes.size());
+    _gl_scopes.push_back(s);
+}
+
+void
+frame_profiler::gl_end(const render_context_ptr& in_context)
+{
+    if (_gl_open_scopes.empty() || !in_context) {
+        return;
+    }
+
+    const scm::size_t   open_scope = _gl_open_scopes.back();
+    _gl_open_scopes.pop_back();
+
+    if (unrecorded_scope == open_scope) {
+        return;
+    }
+
+    gl_scope& s = _gl_scopes[open_scope - _gl_retired_scopes];
+
+    in_context->query_time_stamp(s._end_query);
+    s._closed = true;
+}
+
+void
+frame_profiler::device_interval(device_track  in_track,
+                                const char*   in_name,
+                                nanosec_type  in_issue_time,
+                                nanosec_type  in_duration)
+{
+    if (GL_TRACK == in_track || DEVICE_TRACK_COUNT <= in_track) {
+        return;
+    }
+
+    boost::mutex::scoped_lock   lock(_device_mutex);
+    if (!_capturing) {
+        return;
+    }
+
+    trace_event e;
+    e._name  = in_name;
+    e._begin = in_issue_time;
+    e._end   = in_issue_time + in_duration;
+    e._frame = _frame;
+
+    _device_events[in_track].push_back(e);
+}
+
+bool
+frame_profiler::write_chrome_trace(std::ostream& out_stream)
+{
+    if (!out_stream) {
+        return false;
+    }
+
+    bool first_event = true;
+    out_stream << "{\"traceEvents\":[";
+
+    // process and track names
+    write_separator(out_stream, first_event);
+    out_stream << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << cpu_process_id
+               << ",\"args\":{\"name\":\"CPU\"}}";
+    write_separator(out_stream, first_event);
+    out_stream << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << device_process_id
+               << ",\"args\":{\"name\":\"devices\"}}";
+
+    {
+        boost::mutex::scoped_lock   lock(_tracks_mutex);
+        for (std::vector<thread_track_ptr>::const_iterator ti = _thread_tracks.begin(); ti != _thread_tracks.end(); ++ti) {
+            const thread_track&         t = **ti;
+            boost::mutex::scoped_lock   track_lock((*ti)->_mutex);
+
+            write_separator(out_stream, first_event);
+            out_stream << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << cpu_process_id
+                       << ",\"tid\":" << t._id << ",\"args\":{\"name\":";
+            write_json_string(out_stream, t._name.c_str());
+            out_stream << "}}";
+
+            for (trace_event_array::const_iterator e = t._events.begin(); e != t._events.end(); ++e) {
+                write_separator(out_stream, first_event);
+                out_stream << "{\"ph\":\"X\",\"name\":";
+                write_json_string(out_stream, e->_name);
+                out_stream << ",\"pid\":" << cpu_process_id << ",\"tid\":" << t._id << ",\"ts\":";
+                write_microseconds(out_stream, e->_begin);
+                out_stream << ",\"dur\":";
+                write_microseconds(out_stream, e->_end - e->_begin);
+                out_stream << ",\"args\":{\"frame\":" << e->_frame << "}}";
+            }
+        }
+    }
+    {
+        boost::mutex::scoped_lock   lock(_device_mutex);
+        for (int d = 0; d < DEVICE_TRACK_COUNT; ++d) {
+            if (_device_events[d].empty()) {
+                continue;
+            }
+
+            write_separator(out_stream, first_event);
+            out_stream << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << device_process_id
+                       << ",\"tid\":" << d << ",\"args\":{\"name\":\"" << device_track_names[d] << "\"}}";
+
+            for (trace_event_array::const_iterator e = _device_events[d].begin(); e != _device_events[d].end(); ++e) {
+                write_separator(out_stream, first_event);
+                out_stream << "{\"ph\":\"X\",\"name\":";
+                write_json_string(out_stream, e->_name);
+                out_stream << ",\"pid\":" << device_process_id << ",\"tid\":" << d << ",\"ts\":";
+                write_microseconds(out_stream, e->_begin);
+                out_stream << ",\"dur\":";
+                write_microseconds(out_stream, e->_end - e->_begin);
+                out_stream << ",\"args\":{\"frame\":" << e->_frame << "}}";
+            }
+        }
+
+        for (std::vector<nanosec_type>::const_iterator f = _frame_starts.begin(); f != _frame_starts.end(); ++f) {
+            write_separator(out_stream, first_event);
+            out_stream << "{\"ph\":\"i\",\"s\":\"g\",\"name\":\"frame\",\"pid\":" << cpu_process_id << ",\"tid\":0,\"ts\":";
+            write_microseconds(out_stream, *f);
+            out_stream << "}";
+        }
+    }
+
+    out_stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return out_stream.good();
+}
+
+bool
+frame_profiler::write_chrome_trace(const std::string& in_file_name)
+{
+    std::ofstream   trace_file(in_file_name.c_str(), std::ios_base::out | std::ios_base::trunc);
+
+    if (!trace_file) {
+        scm::err() << "frame_profiler::write_chrome_trace(): "
+                   << "unable to open file (" << in_file_name << ")." << log::end;
+        return false;
+    }
+
+    return write_chrome_trace(trace_file);
+}
+
+void
+frame_profiler::release_track(thread_track*)
+{
+    // the tracks are owned by the profiler, they are kept when their thread exits
+}
+
+frame_profiler::thread_track&
+frame_profiler::local_track()
+{
+    thread_track* t = _local_track.get();
+
+    if (0 == t) {
+        thread_track_ptr    new_track(new thread_track);
+
+        boost::mutex::scoped_lock   lock(_tracks_mutex);
+        new_track->_id        = static_cast<unsigned>(_thread_tracks.size()) + 1;
+        {
+            boost::mutex::scoped_lock   device_lock(_device_mutex);
+            new_track->_capturing = _capturing;
+            new_track->_frame     = _frame;
+        }
+
+        char n[32];
+        std::sprintf(n, "thread %u", new_track->_id);
+        new_track->_name = n;
+
+        _thread_tracks.push_back(new_track);
+        _local_track.reset(new_track.get());
+        t = new_track.get();
+    }
+
+    return *t;
+}
+
+void
+frame_profiler::update_tracks()
+{
+    boost::mutex::scoped_lock   lock(_tracks_mutex);
+    for (std::vector<thread_track_ptr>::iterator t = _thread_tracks.begin(); t != _thread_tracks.end(); ++t) {
+        boost::mutex::scoped_lock   track_lock((*t)->_mutex);
+        (*t)->_capturing = _capturing;
+        (*t)->_frame     = _frame;
+    }
+}
+
+void
+frame_profiler::resolve_gl_scopes(bool in_wait)
+{
+    // scopes are closed in reverse issue order, an open scope blocks all later ones
+    while (!_gl_scopes.empty() && _gl_scopes.front()._closed) {
+        gl_scope&   s = _gl_scopes.front();
+
+        if (!in_wait && !s._context->query_result_available(s._end_query)) {
+            break;
+        }
+
+        s._context->collect_query_results(s._begin_query);
+        s._context->collect_query_results(s._end_query);
+
+        // scopes resolved in begin_frame() outside of a capture are dropped
+        if (_capturing || in_wait) {
+            trace_event e = s._event;
+            e._begin = static_cast<nanosec_type>(s._begin_query->result()) + _gl_time_offset;
+            e._end   = static_cast<nanosec_type>(s._end_query->result())   + _gl_time_offset;
+
+            boost::mutex::scoped_lock   lock(_device_mutex);
+            _device_events[GL_TRACK].push_back(e);
+        }
+
+        _gl_free_queries.push_back(s._begin_query);
+        _gl_free_queries.push_back(s._end_query);
+
+        _gl_scopes.pop_front();
+        ++_gl_retired_scopes;
+    }
+
+    if (in_wait && !_gl_scopes.empty()) {
+        scm::err() << "frame_profiler::resolve_gl_scopes(): "
+                   << _gl_scopes.size() << " gl scope(s) still open." << log::end;
+    }
+}
+
+timer_query_ptr
+frame_profiler::allocate_query(const render_context_ptr& in_context)
+{
+    if (!_gl_free_queries.empty()) {
+        timer_query_ptr q = _gl_free_queries.back();
+        _gl_free_queries.pop_back();
+        return q;
+    }
+
+    timer_query_ptr q = in_context->parent_device().create_timer_query();
+    if (!q) {
+        scm::err() << "frame_profiler::allocate_query(): unable to create timer query." << log::end;
+    }
+
+    return q;
+}
+
+// scoped_trace ///////////////////////////////////////////////////////////////////////////////////
+scoped_trace::scoped_trace(frame_profiler& in_profiler, const char* in_name)
+  : _profiler(in_profiler)
+{
+    _profiler.cpu_begin(in_name);
+}
+
+scoped_trace::scoped_trace(frame_profiler& in_profiler, const char* in_name, const render_context_ptr& in_context)
+  : _profiler(in_profiler)
+  , _context(in_context)
+{
+    _profiler.cpu_begin(in_name);
+    _profiler.gl_begin(in_name, _context);
+}
+
+scoped_trace::~scoped_trace()
+{
+    if (_context) {
+        _profiler.gl_end(_context);
+    }
+    _profiler.cpu_end();
+}
+
+} // namespace util
+} // namespace gl
+} // namespace scm
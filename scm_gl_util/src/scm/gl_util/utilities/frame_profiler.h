@@ -0,0 +1,178 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_FRAME_PROFILER_H_INCLUDED
+#define SCM_GL_UTIL_FRAME_PROFILER_H_INCLUDED
+
+#include <deque>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/unordered_set.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <scm/core/memory.h>
+#include <scm/core/numeric_types.h>
+#include <scm/core/time/cpu_timer.h>
+
+#include <scm/gl_core/gl_core_fwd.h>
+
+#include <scm/gl_util/utilities/utilities_fwd.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+namespace util {
+
+// timeline profiler recording nested scopes per thread and on the gpu
+//  - cpu scopes are recorded into a buffer per thread, recording only takes the (uncontended)
+//    lock of the thread buffer, scope names are not copied and have to outlive the capture
+//    (string literals or names returned by intern())
+//  - gl scopes use timestamp queries, they are resolved without waiting in begin_frame() and
+//    mapped to the cpu clock using an offset measured when the capture starts, gl scopes,
+//    begin_frame() and stop_capture() have to be called on the thread of the context
+//  - cuda and opencl timers only deliver durations, their intervals are placed at the cpu time
+//    they were issued (device_interval())
+//  - events are only recorded between start_capture() and stop_capture(), the capture is written
+//    as chrome trace event json (chrome://tracing, ui.perfetto.dev)
+class __scm_export(gl_util) frame_profiler : boost::noncopyable
+{
+public:
+    typedef scm::int64          nanosec_type;
+
+    enum device_track {
+        GL_TRACK = 0x00,
+        CU_TRACK,
+        CL_TRACK,
+
+        DEVICE_TRACK_COUNT
+    }; // enum device_track
+
+public:
+    frame_profiler();
+    virtual ~frame_profiler();
+
+    // advances the frame number and resolves finished gl scopes
+    void                        begin_frame();
+    scm::uint64                 frame() const;
+
+    // records the next in_frame_count frames, 0 records until stop_capture()
+    void                        start_capture(unsigned in_frame_count = 0);
+    void                        stop_capture();
+    bool                        capturing() const;
+    void                        clear_capture();
+
+    // names with the lifetime of the profiler
+    const char*                 intern(const std::string& in_name);
+    // display name of the track of the calling thread
+    void                        thread_name(const std::string& in_name);
+
+    // time of the profiler clock in nanoseconds
+    nanosec_type                now() const;
+
+    void                        cpu_begin(const char* in_name);
+    void                        cpu_end();
+    void                        gl_begin(const char* in_name, const render_context_ptr& in_context);
+    void                        gl_end(const render_context_ptr& in_context);
+    void                        device_interval(device_track  in_track,
+                                                const char*   in_name,
+                                                nanosec_type  in_issue_time,
+                                                nanosec_type  in_duration);
+
+    bool                        write_chrome_trace(std::ostream& out_stream);
+    bool                        write_chrome_trace(const std::string& in_file_name);
+
+protected:
+    struct trace_event {
+        const char*             _name;
+        nanosec_type            _begin;
+        nanosec_type            _end;
+        scm::uint64             _frame;
+    }; // struct trace_event
+    typedef std::vector<trace_event>    trace_event_array;
+
+    // the capture state is mirrored into every track, recording threads only lock their own track
+    struct thread_track {
+        boost::mutex            _mutex;
+        std::string             _name;
+        unsigned                _id;
+        bool                    _capturing;
+        scm::uint64             _frame;
+        trace_event_array       _events;
+        std::vector<scm::size_t> _open_scopes;  // event indices, one entry per open scope
+    }; // struct thread_track
+    typedef shared_ptr<thread_track>    thread_track_ptr;
+
+    struct gl_scope {
+        trace_event             _event;
+        timer_query_ptr         _begin_query;
+        timer_query_ptr         _end_query;
+        render_context_ptr      _context;
+        bool                    _closed;
+    }; // struct gl_scope
+
+    static void                 release_track(thread_track* in_track);
+    thread_track&               local_track();
+    void                        update_tracks();
+    void                        resolve_gl_scopes(bool in_wait);
+    timer_query_ptr             allocate_query(const render_context_ptr& in_context);
+
+protected:
+    scm::uint64                 _frame;
+    bool                        _capturing;
+    scm::uint64                 _capture_end_frame;     // 0: no frame limit
+    time::cpu_timer             _clock;
+
+    boost::mutex                            _tracks_mutex;
+    std::vector<thread_track_ptr>           _thread_tracks;
+    boost::thread_specific_ptr<thread_track> _local_track;
+
+    boost::mutex                            _names_mutex;
+    boost::unordered_set<std::string>       _names;
+
+    // device tracks, gl scopes are accessed from the context thread only
+    std::deque<gl_scope>        _gl_scopes;             // in issue order
+    scm::size_t                 _gl_retired_scopes;     // scopes popped from _gl_scopes
+    std::vector<scm::size_t>    _gl_open_scopes;        // absolute scope indices, one entry per open scope
+    std::vector<timer_query_ptr> _gl_free_queries;
+    nanosec_type                _gl_time_offset;        // cpu time - gpu time
+    bool                        _gl_time_offset_valid;
+
+    // also guards _capturing and _frame, they are written on the context thread and read by
+    // device_interval() and local_track() from any thread
+    mutable boost::mutex        _device_mutex;
+    trace_event_array           _device_events[DEVICE_TRACK_COUNT];
+    std::vector<nanosec_type>   _frame_starts;
+
+}; // class frame_profiler
+
+// records a cpu scope, and a gl scope if a context is given
+class __scm_export(gl_util) scoped_trace
+{
+public:
+    scoped_trace(frame_profiler& in_profiler, const char* in_name);
+    scoped_trace(frame_profiler& in_profiler, const char* in_name, const render_context_ptr& in_context);
+    ~scoped_trace();
+
+private:
+    frame_profiler&             _profiler;
+    render_context_ptr          _context;
+
+private: // declared, never defined
+    scoped_trace(const scoped_trace&);
+    const scoped_trace& operator=(const scoped_trace&);
+}; // class scoped_trace
+
+} // namespace util
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_UTIL_FRAME_PROFILER_H_INCLUDED
@@ -23,6 +23,7 @@
 
 #include <scm/gl_core/render_device.h>
 #include <scm/gl_util/utilities/accum_timer_query.h>
+#include <scm/gl_util/utilities/frame_profiler.h>
 
 namespace {
 
@@ -39,9 +40,11 @@ namespace scm {
 namespace gl {
 namespace util {
 
-profiling_host::profiling_host()
+profiling_host::profiling_host(int gl_frames_in_flight)
   : _enabled(false)
   , _update_interval(0)
+  , _gl_frames_in_flight(gl_frames_in_flight)
+  , _frame(0)
 {
 }
 
@@ -62,6 +65,24 @@ profiling_host::enabled(bool e)
     _enabled = e;
 }
 
+const frame_profiler_ptr&
+profiling_host::profiler() const
+{
+    return _profiler;
+}
+
+void
+profiling_host::profiler(const frame_profiler_ptr& p)
+{
+    if (_profiler != p) {
+        // interned names belong to the previous profiler
+        for (timer_map::iterator ti = _timers.begin(); ti != _timers.end(); ++ti) {
+            ti->second._trace_name = 0;
+        }
+    }
+    _profiler = p;
+}
+
 void
 profiling_host::cpu_start(const std::string& tname)
 {
@@ -70,7 +91,7 @@ profiling_host::cpu_start(const std::string& tname)
         auto             ti = _timers.find(tname);
         if (ti == _timers.end()) {
             t  = new cpu_accum_timer();
-            _timers.insert(timer_map::value_type(tname, timer_instance(CPU_TIMER, t)));
+            ti = _timers.insert(timer_map::value_type(tname, timer_instance(CPU_TIMER, t))).first;
         }
         else {
             if (CPU_TIMER != ti->second._type) {
@@ -86,6 +107,10 @@ profiling_host::cpu_start(const std::string& tname)
         assert(0 != t);
 
         t->start();
+
+        if (_profiler) {
+            _profiler->cpu_begin(trace_name(ti->second, tname));
+        }
     }
 }
 
@@ -98,8 +123,8 @@ profiling_host::gl_start(const std::string& tname, const render_context_ptr& con
         if (ti == _timers.end()) {
             // EVIL!!!111einseinself
             render_device_ptr d(&(context->parent_device()), null_deleter());
-            t = new gl_accum_timer(d);
-            _timers.insert(timer_map::value_type(tname, timer_instance(GL_TIMER, t)));
+            t  = new gl_accum_timer(d, _gl_frames_in_flight);
+            ti = _timers.insert(timer_map::value_type(tname, timer_instance(GL_TIMER, t))).first;
         }
         else {
             if (GL_TIMER != ti->second._type) {
@@ -114,7 +139,12 @@ profiling_host::gl_start(const std::string& tname, const render_context_ptr& con
 
         assert(0 != t);
 
-        t->start(context);
+        t->start(context, _frame);
+
+        if (_profiler) {
+            ti->second._context = context;
+            _profiler->gl_begin(trace_name(ti->second, tname), context);
+        }
     }
 }
 
@@ -126,7 +156,7 @@ profiling_host::cu_start(const std::string& tname, const cu::cuda_command_stream
         auto            ti = _timers.find(tname);
         if (ti == _timers.end()) {
             t  = new cu_accum_timer();
-            _timers.insert(timer_map::value_type(tname, timer_instance(CU_TIMER, t)));
+            ti = _timers.insert(timer_map::value_type(tname, timer_instance(CU_TIMER, t))).first;
         }
         else {
             if (CU_TIMER != ti->second._type) {
@@ -147,6 +177,10 @@ profiling_host::cu_start(const std::string& tname, const cu::cuda_command_stream
         else {
             t->start();
         }
+
+        if (_profiler) {
+            ti->second._issue_time = _profiler->now();
+        }
     }
 }
 
@@ -158,7 +192,7 @@ profiling_host::cl_start(const std::string& tname)
         auto            ti = _timers.find(tname);
         if (ti == _timers.end()) {
             t  = new cl_accum_timer();
-            _timers.insert(timer_map::value_type(tname, timer_instance(CL_TIMER, t)));
+            ti = _timers.insert(timer_map::value_type(tname, timer_instance(CL_TIMER, t))).first;
         }
         else {
             if (CL_TIMER != ti->second._type) {
@@ -173,6 +207,10 @@ profiling_host::cl_start(const std::string& tname)
 
         assert(0 != t);
 
+        if (_profiler) {
+            ti->second._issue_time = _profiler->now();
+        }
+
         return t->event();
     }
     else {
@@ -184,9 +222,18 @@ void
 profiling_host::stop(const std::string& tname) const
 {
     if (_enabled) {
-        timer_ptr t = find_timer(tname);
-        if (t) {
-            t->stop();
+        auto ti = _timers.find(tname);
+        if (ti != _timers.end()) {
+            ti->second._timer->stop();
+
+            if (_profiler) {
+                if (CPU_TIMER == ti->second._type) {
+                    _profiler->cpu_end();
+                }
+                else if (GL_TIMER == ti->second._type) {
+                    _profiler->gl_end(ti->second._context);
+                }
+            }
         }
     }
 }
@@ -209,7 +256,12 @@ profiling_host::update(int interval)
         using namespace std;
 
         collect_all();
+        trace_device_timers();
+        if (_profiler) {
+            _profiler->begin_frame();
+        }
         ++_update_interval;
+        ++_frame;
 
         if (_update_interval >= interval) {
             _update_interval = 0;
@@ -231,8 +283,13 @@ profiling_host::force_update()
         using namespace std;
 
         force_collect_all();
+        trace_device_timers();
+        if (_profiler) {
+            _profiler->begin_frame();
+        }
 
         _update_interval = 0;
+        ++_frame;
 
         for_each(_timers.begin(), _timers.end(), [](timer_map::value_type& t) -> void {
             t.second._timer->update(0);
@@ -243,6 +300,12 @@ profiling_host::force_update()
     }
 }
 
+scm::uint64
+profiling_host::frame() const
+{
+    return _frame;
+}
+
 void
 profiling_host::collect_all()
 {
@@ -377,6 +440,38 @@ profiling_host::find_timer(const std::string& tname) const
     }
 }
 
+const char*
+profiling_host::trace_name(timer_instance& t, const std::string& tname) const
+{
+    assert(_profiler);
+
+    if (0 == t._trace_name) {
+        t._trace_name = _profiler->intern(tname);
+    }
+
+    return t._trace_name;
+}
+
+void
+profiling_host::trace_device_timers()
+{
+    if (!_profiler) {
+        return;
+    }
+
+    // the cu and cl timers only deliver durations, the intervals are placed at their start on the
+    // cpu, the last collected duration is used for the last start
+    for (timer_map::iterator ti = _timers.begin(); ti != _timers.end(); ++ti) {
+        timer_instance& t = ti->second;
+        if (0 <= t._issue_time && 0 < t._timer->accumulation_count()) {
+            const frame_profiler::device_track track = (CU_TIMER == t._type) ? frame_profiler::CU_TRACK
+                                                                            : frame_profiler::CL_TRACK;
+            _profiler->device_interval(track, trace_name(t, ti->first), t._issue_time, t._timer->last_time());
+            t._issue_time = -1;
+        }
+    }
+}
+
 scoped_timer::scoped_timer(profiling_host& phost, const std::string& tname)
   : _phost(phost)
   , _tname(tname)
@@ -55,20 +55,30 @@ protected:
         CL_TIMER
     };
     struct timer_instance {
-        timer_instance(timer_type t, time::accum_timer_base* tm) : _type(t), _timer(tm), _time(0) {}
-        timer_type      _type;
-        timer_ptr       _timer;
-        nanosec_type    _time;
+        timer_instance(timer_type t, time::accum_timer_base* tm) : _type(t), _timer(tm), _time(0), _trace_name(0), _issue_time(-1) {}
+        timer_type          _type;
+        timer_ptr           _timer;
+        nanosec_type        _time;
+        // frame profiler tracing
+        const char*         _trace_name;    // name interned by the attached profiler, 0 until first traced
+        render_context_ptr  _context;       // gl timers, context of the last start
+        nanosec_type        _issue_time;    // cu and cl timers, profiler time of the last start, -1 if traced
     };
     typedef std::map<std::string, timer_instance> timer_map;
 
 public:
-    profiling_host();
+    // gl timers keep gl_frames_in_flight timings pending on the gpu before dropping samples
+    profiling_host(int gl_frames_in_flight = 3);
     virtual ~profiling_host();
 
     bool                    enabled() const;
     void                    enabled(bool e);
 
+    // timers of an enabled host are also recorded as scopes by the attached profiler, update()
+    // begins the profiler frames
+    const frame_profiler_ptr& profiler() const;
+    void                    profiler(const frame_profiler_ptr& p);
+
     void                    cpu_start(const std::string& tname);
     void                    gl_start(const std::string& tname, const render_context_ptr& context);
     void                    cu_start(const std::string& tname, const cu::cuda_command_stream_ptr& cu_stream);
@@ -77,8 +87,10 @@ public:
     void                    stop(const std::string& tname) const;
     nanosec_type            time(const std::string& tname) const;
 
+    // call once per frame, advances the frame number reported with gl timings
     void                    update(int interval = 100);
     void                    force_update();
+    scm::uint64             frame() const;
 
     void                    collect_all();
     void                    force_collect_all();
@@ -98,11 +110,16 @@ public:
 
     timer_ptr               find_timer(const std::string& tname) const;
 protected:
+    const char*             trace_name(timer_instance& t, const std::string& tname) const;
+    void                    trace_device_timers();
 
 protected:
     bool                    _enabled;
     timer_map               _timers;
     int                     _update_interval;
+    int                     _gl_frames_in_flight;
+    scm::uint64             _frame;
+    frame_profiler_ptr      _profiler;
 
 }; // profiling_host
 
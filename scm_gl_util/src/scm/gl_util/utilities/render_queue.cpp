@@ -0,0 +1,383 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "render_queue.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <boost/functional/hash.hpp>
+
+#include <scm/log.h>
+
+#include <scm/gl_core/render_device.h>
+#include <scm/gl_core/shader_objects.h>
+#include <scm/gl_core/state_objects.h>
+
+namespace {
+
+const unsigned      key_field_bits  = 12;
+const scm::uint64   key_field_mask  = (1u << key_field_bits) - 1;
+const unsigned      key_layer_bits  = 4;
+
+const unsigned      key_depth_shift         = 0;
+const unsigned      key_vertex_array_shift  = key_depth_shift        + key_field_bits;
+const unsigned      key_textures_shift      = key_vertex_array_shift + key_field_bits;
+const unsigned      key_state_shift         = key_textures_shift     + key_field_bits;
+const unsigned      key_program_shift       = key_state_shift        + key_field_bits;
+const unsigned      key_layer_shift         = key_program_shift      + key_field_bits;
+
+// ids are assigned in order of first appearance, ids beyond the key field wrap around and only
+// weaken the grouping of the sort
+template<typename map_type>
+scm::uint64
+dense_id(map_type& ids, std::size_t key)
+{
+    typename map_type::const_iterator i = ids.find(key);
+    if (i != ids.end()) {
+        return i->second;
+    }
+
+    const unsigned new_id = static_cast<unsigned>(ids.size() & key_field_mask);
+    ids.insert(std::make_pair(key, new_id));
+    return new_id;
+}
+
+template<typename ptr_type>
+std::size_t
+pointer_key(const ptr_type& p)
+{
+    return reinterpret_cast<std::size_t>(p.get());
+}
+
+scm::size_t
+saved_binds(scm::size_t unsorted, scm::size_t sorted)
+{
+    return unsorted > sorted ? unsorted - sorted : 0;
+}
+
+} // namespace
+
+namespace scm {
+namespace gl {
+
+// render_queue::draw_packet //////////////////////////////////////////////////////////////////////
+render_queue::draw_packet::draw_packet()
+  : _texture_count(0)
+  , _topology(PRIMITIVE_TRIANGLE_LIST)
+  , _first(0)
+  , _count(0)
+  , _base_vertex(0)
+  , _instance_count(0)
+  , _layer(0)
+  , _depth(0.0f)
+{
+}
+
+void
+render_queue::draw_packet::add_texture(const texture_ptr&       in_texture,
+                                       const sampler_state_ptr& in_sampler_state,
+                                       unsigned                 in_unit)
+{
+    assert(_texture_count < max_texture_bindings);
+
+    if (_texture_count < max_texture_bindings) {
+        _textures[_texture_count]._texture       = in_texture;
+        _textures[_texture_count]._sampler_state = in_sampler_state;
+        _textures[_texture_count]._unit          = in_unit;
+        ++_texture_count;
+    }
+    else {
+        scm::err() << "render_queue::draw_packet::add_texture(): "
+                   << "maximum number of texture bindings exceeded (" << max_texture_bindings << ")." << log::end;
+    }
+}
+
+// render_queue ///////////////////////////////////////////////////////////////////////////////////
+render_queue::render_queue()
+{
+    std::memset(&_statistics, 0, sizeof(statistics));
+}
+
+render_queue::~render_queue()
+{
+}
+
+scm::size_t
+render_queue::push(const draw_packet& in_packet)
+{
+    packet_entry e;
+    e._packet        = in_packet;
+    e._first_uniform = _uniforms.size();
+    e._uniform_count = 0;
+
+    _packets.push_back(e);
+
+    return _packets.size() - 1;
+}
+
+bool
+render_queue::empty() const
+{
+    return _packets.empty();
+}
+
+scm::size_t
+render_queue::size() const
+{
+    return _packets.size();
+}
+
+void
+render_queue::clear()
+{
+    _packets.clear();
+    _uniforms.clear();
+    _uniform_data.clear();
+}
+
+void
+render_queue::submit(const render_context_ptr& in_context)
+{
+    std::memset(&_statistics, 0, sizeof(statistics));
+
+    if (_packets.empty()) {
+        return;
+    }
+
+    // sort keys
+    _program_ids.clear();
+    _state_ids.clear();
+    _texture_ids.clear();
+    _vertex_array_ids.clear();
+
+    _sort_entries.resize(_packets.size());
+    for (scm::size_t i = 0; i < _packets.size(); ++i) {
+        _sort_entries[i]._key    = sort_key(_packets[i]._packet);
+        _sort_entries[i]._packet = static_cast<unsigned>(i);
+    }
+
+    sort_packets();
+
+    // bind counters of the submission and the sorted order
+    statistics  unsorted;
+    std::memset(&unsorted, 0, sizeof(statistics));
+
+    for (scm::size_t i = 0; i < _packets.size(); ++i) {
+        count_binds(i > 0 ? &_packets[i - 1]._packet : 0, _packets[i]._packet, unsorted);
+    }
+
+    const draw_packet*  previous = 0;
+    for (sort_array::const_iterator s = _sort_entries.begin(); s != _sort_entries.end(); ++s) {
+        const packet_entry& current = _packets[s->_packet];
+
+        count_binds(previous, current._packet, _statistics);
+        draw(in_context, current);
+
+        previous = &current._packet;
+    }
+
+    _statistics._packets                = _packets.size();
+    _statistics._program._saved         = saved_binds(unsorted._program._issued,       _statistics._program._issued);
+    _statistics._vertex_array._saved    = saved_binds(unsorted._vertex_array._issued,  _statistics._vertex_array._issued);
+    _statistics._textures._saved        = saved_binds(unsorted._textures._issued,      _statistics._textures._issued);
+    _statistics._state_objects._saved   = saved_binds(unsorted._state_objects._issued, _statistics._state_objects._issued);
+
+    clear();
+}
+
+const render_queue::statistics&
+render_queue::frame_statistics() const
+{
+    return _statistics;
+}
+
+void
+render_queue::record_uniform(const uniform_ptr& in_uniform,
+                             int                in_element,
+                             const void*        in_value,
+                             scm::size_t        in_value_size)
+{
+    if (_packets.empty()) {
+        scm::err() << "render_queue::uniform(): no draw packet pushed for uniform "
+                   << "(name: " << in_uniform->name() << ")." << log::end;
+        return;
+    }
+
+    uniform_entry u;
+    u._uniform     = in_uniform;
+    u._element     = in_element;
+    u._data_offset = _uniform_data.size();
+
+    _uniform_data.resize(_uniform_data.size() + in_value_size);
+    std::memcpy(&_uniform_data[u._data_offset], in_value, in_value_size);
+
+    _uniforms.push_back(u);
+    ++_packets.back()._uniform_count;
+}
+
+scm::uint64
+render_queue::sort_key(const draw_packet& in_packet)
+{
+    std::size_t state_key = 0;
+    boost::hash_combine(state_key, pointer_key(in_packet._depth_stencil_state));
+    boost::hash_combine(state_key, pointer_key(in_packet._rasterizer_state));
+    boost::hash_combine(state_key, pointer_key(in_packet._blend_state));
+
+    std::size_t texture_key = 0;
+    for (unsigned t = 0; t < in_packet._texture_count; ++t) {
+        boost::hash_combine(texture_key, pointer_key(in_packet._textures[t]._texture));
+        boost::hash_combine(texture_key, pointer_key(in_packet._textures[t]._sampler_state));
+        boost::hash_combine(texture_key, in_packet._textures[t]._unit);
+    }
+
+    const unsigned  layer = (std::min)(in_packet._layer, (1u << key_layer_bits) - 1);
+    const float     depth = (std::max)(0.0f, (std::min)(in_packet._depth, 1.0f));
+
+    return   (static_cast<scm::uint64>(layer)                                                  << key_layer_shift)
+           | (dense_id(_program_ids,      pointer_key(in_packet._program))                    << key_program_shift)
+           | (dense_id(_state_ids,        state_key)                                          << key_state_shift)
+           | (dense_id(_texture_ids,      texture_key)                                        << key_textures_shift)
+           | (dense_id(_vertex_array_ids, pointer_key(in_packet._vertex_array))               << key_vertex_array_shift)
+           | (static_cast<scm::uint64>(depth * static_cast<float>(key_field_mask))            << key_depth_shift);
+}
+
+// lsd radix sort over 8bit digits, passes where all keys share the digit are skipped
+void
+render_queue::sort_packets()
+{
+    const scm::size_t   count = _sort_entries.size();
+
+    if (count < 2) {
+        return;
+    }
+
+    _sort_scratch.resize(count);
+
+    sort_entry*     src = &_sort_entries.front();
+    sort_entry*     dst = &_sort_scratch.front();
+
+    for (unsigned shift = 0; shift < 64; shift += 8) {
+        scm::size_t     offsets[256] = { 0 };
+
+        for (scm::size_t i = 0; i < count; ++i) {
+            ++offsets[(src[i]._key >> shift) & 0xff];
+        }
+        if (offsets[(src[0]._key >> shift) & 0xff] == count) {
+            continue;
+        }
+
+        scm::size_t     offset = 0;
+        for (unsigned d = 0; d < 256; ++d) {
+            const scm::size_t c = offsets[d];
+            offsets[d] = offset;
+            offset    += c;
+        }
+        for (scm::size_t i = 0; i < count; ++i) {
+            dst[offsets[(src[i]._key >> shift) & 0xff]++] = src[i];
+        }
+
+        std::swap(src, dst);
+    }
+
+    if (src != &_sort_entries.front()) {
+        _sort_entries.swap(_sort_scratch);
+    }
+}
+
+void
+render_queue::count_binds(const draw_packet* in_previous,
+                          const draw_packet& in_current,
+                          statistics&        out_statistics) const
+{
+    if (!in_previous) {
+        out_statistics._program._issued       += 1;
+        out_statistics._vertex_array._issued  += 1;
+        out_statistics._textures._issued      += in_current._texture_count;
+        out_statistics._state_objects._issued += (in_current._depth_stencil_state ? 1 : 0)
+                                               + (in_current._rasterizer_state    ? 1 : 0)
+                                               + (in_current._blend_state         ? 1 : 0);
+        return;
+    }
+
+    if (in_previous->_program != in_current._program) {
+        ++out_statistics._program._issued;
+    }
+    if (in_previous->_vertex_array != in_current._vertex_array) {
+        ++out_statistics._vertex_array._issued;
+    }
+    for (unsigned t = 0; t < in_current._texture_count; ++t) {
+        if (   t >= in_previous->_texture_count
+            || in_previous->_textures[t]._texture       != in_current._textures[t]._texture
+            || in_previous->_textures[t]._sampler_state != in_current._textures[t]._sampler_state
+            || in_previous->_textures[t]._unit          != in_current._textures[t]._unit) {
+            ++out_statistics._textures._issued;
+        }
+    }
+    if (in_previous->_depth_stencil_state != in_current._depth_stencil_state) {
+        ++out_statistics._state_objects._issued;
+    }
+    if (in_previous->_rasterizer_state != in_current._rasterizer_state) {
+        ++out_statistics._state_objects._issued;
+    }
+    if (in_previous->_blend_state != in_current._blend_state) {
+        ++out_statistics._state_objects._issued;
+    }
+}
+
+void
+render_queue::draw(const render_context_ptr& in_context,
+                   const packet_entry&       in_entry) const
+{
+    const draw_packet&  p = in_entry._packet;
+
+    in_context->bind_program(p._program);
+    in_context->bind_vertex_array(p._vertex_array);
+
+    for (unsigned t = 0; t < p._texture_count; ++t) {
+        in_context->bind_texture(p._textures[t]._texture, p._textures[t]._sampler_state, p._textures[t]._unit);
+    }
+
+    // unset state objects fall back to the defaults of the context, the state of previously
+    // drawn packets must not leak into this packet
+    in_context->reset_state_objects();
+    if (p._depth_stencil_state) {
+        in_context->set_depth_stencil_state(p._depth_stencil_state);
+    }
+    if (p._rasterizer_state) {
+        in_context->set_rasterizer_state(p._rasterizer_state);
+    }
+    if (p._blend_state) {
+        in_context->set_blend_state(p._blend_state);
+    }
+
+    for (scm::size_t u = in_entry._first_uniform; u < in_entry._first_uniform + in_entry._uniform_count; ++u) {
+        const uniform_entry& e = _uniforms[u];
+        e._uniform->value_data(e._element, &_uniform_data[e._data_offset]);
+    }
+
+    if (p._index_buffer._index_buffer) {
+        in_context->set_index_buffer_binding(p._index_buffer);
+        in_context->apply();
+        if (0 < p._instance_count) {
+            in_context->draw_elements_instanced(p._count, p._instance_count, p._first, p._base_vertex);
+        }
+        else {
+            in_context->draw_elements(p._count, p._first, p._base_vertex);
+        }
+    }
+    else {
+        in_context->apply();
+        if (0 < p._instance_count) {
+            in_context->draw_arrays_instanced(p._topology, p._first, p._count, p._instance_count);
+        }
+        else {
+            in_context->draw_arrays(p._topology, p._first, p._count);
+        }
+    }
+}
+
+} // namespace gl
+} // namespace scm
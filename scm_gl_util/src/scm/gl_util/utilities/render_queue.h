@@ -0,0 +1,170 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_RENDER_QUEUE_H_INCLUDED
+#define SCM_GL_UTIL_RENDER_QUEUE_H_INCLUDED
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <scm/core/memory.h>
+#include <scm/core/numeric_types.h>
+
+#include <scm/gl_core/constants.h>
+#include <scm/gl_core/gl_core_fwd.h>
+#include <scm/gl_core/render_device/context.h>
+#include <scm/gl_core/shader_objects/uniform.h>
+
+#include <scm/gl_util/utilities/utilities_fwd.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// collects the draws of a frame and submits them sorted by their state
+//  - every draw packet gets a 64bit sort key (high to low bits):
+//      layer (4) | program (12) | state objects (12) | textures (12) | vertex array (12) | depth (12)
+//    the object ids are assigned per frame in order of first appearance
+//  - the packets are radix sorted by their keys, draws with equal keys keep their submission order
+//  - uniform values are copied into the queue and set right before the draw of their packet,
+//    uniform values are state of the program, values not set for a packet persist from the
+//    packets drawn before it with the same program
+//  - unset state objects of a packet are drawn with the default state objects of the context,
+//    they are not counted as state binds for the first packet
+class __scm_export(gl_util) render_queue : boost::noncopyable
+{
+public:
+    static const unsigned       max_texture_bindings = 8;
+
+    struct texture_binding {
+        texture_ptr             _texture;
+        sampler_state_ptr       _sampler_state;
+        unsigned                _unit;
+    }; // struct texture_binding
+
+    struct __scm_export(gl_util) draw_packet {
+        draw_packet();
+
+        void                    add_texture(const texture_ptr&       in_texture,
+                                            const sampler_state_ptr& in_sampler_state,
+                                            unsigned                 in_unit);
+
+        program_ptr                             _program;
+        vertex_array_ptr                        _vertex_array;
+        render_context::index_buffer_binding    _index_buffer;      // draw_elements if the buffer is set
+        texture_binding                         _textures[max_texture_bindings];
+        unsigned                                _texture_count;
+        depth_stencil_state_ptr                 _depth_stencil_state;
+        rasterizer_state_ptr                    _rasterizer_state;
+        blend_state_ptr                         _blend_state;
+
+        primitive_topology                      _topology;          // draw_arrays only
+        int                                     _first;             // first vertex or start index
+        int                                     _count;
+        int                                     _base_vertex;       // draw_elements only
+        int                                     _instance_count;    // 0: non-instanced draw
+
+        unsigned                                _layer;             // coarse order, [0, 15]
+        float                                   _depth;             // front to back within equal state, [0, 1]
+    }; // struct draw_packet
+
+    struct bind_counter {
+        scm::size_t             _issued;            // binds in sorted order
+        scm::size_t             _saved;             // binds saved compared to the submission order
+    }; // struct bind_counter
+
+    struct statistics {
+        scm::size_t             _packets;
+        bind_counter            _program;
+        bind_counter            _vertex_array;
+        bind_counter            _textures;
+        bind_counter            _state_objects;
+    }; // struct statistics
+
+public:
+    render_queue();
+    virtual ~render_queue();
+
+    // returns the index of the packet in the queue
+    scm::size_t                 push(const draw_packet& in_packet);
+    // uniform values for the last pushed packet
+    template<typename T> void   uniform(const uniform_handle<T>& in_uniform, const T& in_value);
+    template<typename T> void   uniform(const uniform_handle<T>& in_uniform, int in_element, const T& in_value);
+
+    bool                        empty() const;
+    scm::size_t                 size() const;
+    void                        clear();
+
+    // sorts and draws all queued packets, the queue is cleared afterwards
+    void                        submit(const render_context_ptr& in_context);
+
+    // counters of the last submit
+    const statistics&           frame_statistics() const;
+
+protected:
+    struct packet_entry {
+        draw_packet             _packet;
+        scm::size_t             _first_uniform;
+        scm::size_t             _uniform_count;
+    }; // struct packet_entry
+    struct uniform_entry {
+        uniform_ptr             _uniform;
+        int                     _element;
+        scm::size_t             _data_offset;
+    }; // struct uniform_entry
+    struct sort_entry {
+        scm::uint64             _key;
+        unsigned                _packet;
+    }; // struct sort_entry
+
+    typedef std::vector<packet_entry>                   packet_array;
+    typedef std::vector<uniform_entry>                  uniform_array;
+    typedef std::vector<char>                           data_array;
+    typedef std::vector<sort_entry>                     sort_array;
+    typedef boost::unordered_map<std::size_t, unsigned> id_map;
+
+protected:
+    void                        record_uniform(const uniform_ptr& in_uniform,
+                                               int                in_element,
+                                               const void*        in_value,
+                                               scm::size_t        in_value_size);
+
+    scm::uint64                 sort_key(const draw_packet& in_packet);
+    void                        sort_packets();
+    // in_previous is 0 for the first packet
+    void                        count_binds(const draw_packet* in_previous,
+                                            const draw_packet& in_current,
+                                            statistics&        out_statistics) const;
+    void                        draw(const render_context_ptr& in_context,
+                                     const packet_entry&       in_entry) const;
+
+protected:
+    packet_array                _packets;
+    uniform_array               _uniforms;
+    data_array                  _uniform_data;
+
+    sort_array                  _sort_entries;
+    sort_array                  _sort_scratch;
+
+    id_map                      _program_ids;
+    id_map                      _state_ids;
+    id_map                      _texture_ids;
+    id_map                      _vertex_array_ids;
+
+    statistics                  _statistics;
+
+}; // class render_queue
+
+} // namespace gl
+} // namespace scm
+
+#include "render_queue.inl"
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_UTIL_RENDER_QUEUE_H_INCLUDED
@@ -0,0 +1,30 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+namespace scm {
+namespace gl {
+
+template<typename T>
+inline
+void
+render_queue::uniform(const uniform_handle<T>& in_uniform, const T& in_value)
+{
+    uniform(in_uniform, 0, in_value);
+}
+
+template<typename T>
+inline
+void
+render_queue::uniform(const uniform_handle<T>& in_uniform, int in_element, const T& in_value)
+{
+    typedef typename uniform_handle<T>::uniform_value_type::value_type  stored_type;
+
+    if (in_uniform.valid()) {
+        const stored_type v(in_value);
+        record_uniform(in_uniform.get(), in_element, &v, sizeof(stored_type));
+    }
+}
+
+} // namespace gl
+} // namespace scm
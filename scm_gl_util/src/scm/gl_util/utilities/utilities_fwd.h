@@ -22,12 +22,20 @@ class geometry_highlight;
 typedef shared_ptr<geometry_highlight>              geometry_highlight_ptr;
 typedef shared_ptr<geometry_highlight const>        geometry_highlight_cptr;
 
+class render_queue;
+typedef shared_ptr<render_queue>                    render_queue_ptr;
+typedef shared_ptr<render_queue const>              render_queue_cptr;
+
 class texture_output;
 typedef shared_ptr<texture_output>                  texture_output_ptr;
 typedef shared_ptr<texture_output const>            texture_output_cptr;
 
 namespace util {
 
+class frame_profiler;
+typedef shared_ptr<frame_profiler>                  frame_profiler_ptr;
+typedef shared_ptr<frame_profiler const>            frame_profiler_cptr;
+
 class  profiling_host;
 struct profiling_result;
 typedef shared_ptr<profiling_host>                  profiling_host_ptr;
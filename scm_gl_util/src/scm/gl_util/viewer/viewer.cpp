@@ -160,6 +160,10 @@ viewer::viewer(const math::vec2ui&                  vp_dim,
         _frame_counter_text->text_color(math::vec4f(1.0f, 1.0f, 0.0f, 1.0f));
         _frame_counter_text->text_outline_color(math::vec4f(0.0f, 0.0f, 0.0f, 1.0f));
         _frame_counter_text->text_kerning(true);
+        _call_statistics_text.reset(new text(_device, counter_font, font_face::style_regular, "gl calls"));
+        _call_statistics_text->text_color(math::vec4f(1.0f, 1.0f, 0.0f, 1.0f));
+        _call_statistics_text->text_outline_color(math::vec4f(0.0f, 0.0f, 0.0f, 1.0f));
+        _call_statistics_text->text_kerning(true);
 
         _device_space_navigator = make_shared<inp::space_navigator>();
     }
@@ -181,6 +185,7 @@ viewer::~viewer()
     _render_target.reset();
     _text_renderer.reset();
     _frame_counter_text.reset();
+    _call_statistics_text.reset();
 
     _context.reset();
     _device.reset();
@@ -461,6 +466,10 @@ viewer::send_render_display()
 
     _frame_time_us = static_cast<float>(_frame_timer.last_time(time::time_io::usec));//static_cast<float>(scm::time::to_microseconds(_frame_timer.last_time()));
 
+    // the gl call counters are shown with the frame times
+    context()->end_statistics_frame();
+    context()->collect_statistics(_settings._show_frame_times);
+
     if (_display_scene_func) {
 
         // clear
@@ -532,6 +541,9 @@ viewer::send_render_display()
             vec2i text_ur = vec2i(_viewport._dimensions) - _frame_counter_text->text_bounding_box() - vec2i(5, 0);
             _text_renderer->draw_outlined(context(), text_ur, _frame_counter_text);
             //_text_renderer->draw_shadowed(context(), text_ur, _frame_counter_text);
+
+            vec2i stats_ur = vec2i(static_cast<int>(_viewport._dimensions.x), text_ur.y) - _call_statistics_text->text_bounding_box() - vec2i(5, 0);
+            _text_renderer->draw_outlined(context(), stats_ur, _call_statistics_text);
         }
     }
 
@@ -563,6 +575,21 @@ viewer::send_render_display()
                 _frame_counter_text->text_outline_color(math::vec4f(0.0f, 0.0f, 0.0f, 1.0f));
             }
             _frame_timer.reset();
+
+            const render_context::call_statistics& cstats = context()->last_frame_statistics();
+            std::stringstream   stats_output;
+            stats_output.precision(1);
+            stats_output << std::fixed
+                         << "draws: "      << cstats._draw_calls
+                         << " programs: "  << cstats._program_binds
+                         << " textures: "  << cstats._texture_binds
+                         << " vaos: "      << cstats._vertex_array_binds
+                         << " fbos: "      << cstats._frame_buffer_binds
+                         << " states: "    << cstats._state_object_changes
+                         << " uniforms: "  << cstats._uniform_updates
+                         << " mapped: "    << static_cast<double>(cstats._buffer_bytes_mapped)    / 1024.0 << "KiB buf,"
+                         << " upload: "    << static_cast<double>(cstats._texture_bytes_uploaded) / 1024.0 << "KiB tex";
+            _call_statistics_text->text_string(stats_output.str());
         }
     }
 
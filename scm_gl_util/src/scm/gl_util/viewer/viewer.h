@@ -240,6 +240,7 @@ protected:
 
     gl::text_renderer_ptr           _text_renderer;
     gl::text_ptr                    _frame_counter_text;
+    gl::text_ptr                    _call_statistics_text;
 
     trackball_manipulator           _trackball;
     math::vec2f                     _trackball_start_pos;